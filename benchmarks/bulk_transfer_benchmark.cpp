@@ -0,0 +1,236 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file bulk_transfer_benchmark.cpp
+ * @brief Measures the throughput of sending a file over a stream socket.
+ *
+ * Each iteration sends the same file over a `SOCK_STREAM` socket pair. The
+ * copying variant reads a chunk of the file into a buffer with `pread` and
+ * sends it with a `sendmsg` sender, while the zero-copy variant sends the
+ * whole file with one `sendfile` sender. The receiver drains the socket with
+ * `recvmsg` senders in both variants.
+ *
+ * Arguments: file size, chunk size.
+ */
+// NOLINTBEGIN
+#include <benchmark/benchmark.h>
+#include <io/io.hpp>
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Using declarations for brevity
+using namespace exec;
+
+/**
+ * @class BulkTransferFixture
+ * @brief Fixture for the bulk transfer benchmarks.
+ * @tparam Mux The multiplexer backend to benchmark.
+ */
+template <typename Mux> class BulkTransferFixture : public benchmark::Fixture {
+public:
+  using basic_triggers = ::io::execution::basic_triggers<Mux>;
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+  using socket_message = ::io::socket::socket_message<>;
+
+  void SetUp(benchmark::State &state) override
+  {
+    filesize = state.range(0);
+    chunksize = state.range(1);
+
+    file = std::tmpfile();
+    if (!file)
+      throw std::system_error(errno, std::system_category(), "tmpfile()!");
+
+    auto contents = std::vector<char>(filesize, 'a');
+    if (std::fwrite(contents.data(), 1, contents.size(), file) != filesize ||
+        std::fflush(file))
+    {
+      throw std::system_error(errno, std::system_category(), "fwrite()!");
+    }
+  }
+  void TearDown(benchmark::State &state) override { std::fclose(file); }
+
+  /** @brief Simple error handler that prints to stderr. */
+  static constexpr auto error_handler = [](const auto &error) {
+    std::cerr << "Error!" << std::endl;
+  };
+
+  /**
+   * @struct endpoint
+   * @brief One end of the transfer.
+   */
+  struct endpoint {
+    /** @brief The buffer for one chunk. */
+    std::vector<std::byte> buffer;
+    /** @brief The message for the receiver. */
+    socket_message msg;
+    /** @brief The number of bytes transferred. */
+    std::size_t count{0};
+
+    explicit endpoint(std::size_t chunksize) : buffer(chunksize)
+    {
+      msg.buffers.push_back(buffer);
+    }
+  };
+
+  /**
+   * @brief Receives until `total` bytes have been received.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The receiving socket.
+   * @param self The receiving endpoint.
+   * @param total The number of bytes to receive.
+   */
+  static auto receive(async_scope &scope, const socket_dialog &dialog,
+                      endpoint &self, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::recvmsg(dialog, self.msg, 0) |
+                then([&, dialog, total](auto len) {
+                  if (len > 0 && (self.count += len) < total)
+                    receive(scope, dialog, self, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Sends the file one chunk at a time through a user space buffer.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The sending socket.
+   * @param self The sending endpoint.
+   * @param fd The file to send.
+   * @param total The number of bytes to send.
+   */
+  static auto send_copy(async_scope &scope, const socket_dialog &dialog,
+                        endpoint &self, int fd, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    auto len = ::pread(fd, self.buffer.data(),
+                       std::min(self.buffer.size(), total - self.count),
+                       static_cast<off_t>(self.count));
+    if (len <= 0)
+      return;
+
+    auto buf = std::span(self.buffer).first(static_cast<std::size_t>(len));
+    scope.spawn(::io::sendmsg(dialog, socket_message{.buffers = buf}, 0) |
+                then([&, dialog, fd, total](auto len) {
+                  if ((self.count += len) < total)
+                    send_copy(scope, dialog, self, fd, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Sends the file with one sendfile operation.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The sending socket.
+   * @param self The sending endpoint.
+   * @param fd The file to send.
+   * @param total The number of bytes to send.
+   */
+  static auto send_file(async_scope &scope, const socket_dialog &dialog,
+                        endpoint &self, int fd, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::sendfile(dialog, fd, 0, total) |
+                then([&](auto len) { self.count += len; }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Runs one variant of the benchmark.
+   * @param state The benchmark state.
+   * @param zero_copy Whether to use sendfile.
+   */
+  auto run(benchmark::State &state, bool zero_copy) -> void
+  {
+    int fd = ::fileno(file);
+    for (auto _ : state)
+    {
+      async_scope scope;
+      basic_triggers triggers;
+
+      std::array<int, 2> pair{};
+      if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()))
+        throw std::system_error(errno, std::system_category(), "socketpair()!");
+
+      auto sender = endpoint(chunksize);
+      auto receiver = endpoint(chunksize);
+      auto send_dialog = triggers.emplace(pair[0]);
+      auto recv_dialog = triggers.emplace(pair[1]);
+
+      receive(scope, recv_dialog, receiver, filesize);
+      if (zero_copy)
+        send_file(scope, send_dialog, sender, fd, filesize);
+      else
+        send_copy(scope, send_dialog, sender, fd, filesize);
+
+      while (triggers.wait());
+
+      if (sender.count != filesize || receiver.count != filesize)
+        state.SkipWithError("Incomplete transfer!");
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() *
+                                                      filesize));
+  }
+
+  std::FILE *file = nullptr;
+  std::size_t filesize;
+  std::size_t chunksize;
+};
+
+BENCHMARK_TEMPLATE_DEFINE_F(BulkTransferFixture, RecvSendLoop,
+                            ::io::execution::poll_multiplexer)
+(benchmark::State &state) { run(state, false); }
+BENCHMARK_REGISTER_F(BulkTransferFixture, RecvSendLoop)
+    ->Args({1 << 20, 65536})
+    ->Args({1 << 26, 65536})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE_DEFINE_F(BulkTransferFixture, Sendfile,
+                            ::io::execution::poll_multiplexer)
+(benchmark::State &state) { run(state, true); }
+BENCHMARK_REGISTER_F(BulkTransferFixture, Sendfile)
+    ->Args({1 << 20, 65536})
+    ->Args({1 << 26, 65536})
+    ->Unit(benchmark::kMillisecond);
+
+#if OS_LINUX
+BENCHMARK_TEMPLATE_DEFINE_F(BulkTransferFixture, EpollRecvSendLoop,
+                            ::io::execution::epoll_multiplexer)
+(benchmark::State &state) { run(state, false); }
+BENCHMARK_REGISTER_F(BulkTransferFixture, EpollRecvSendLoop)
+    ->Args({1 << 20, 65536})
+    ->Args({1 << 26, 65536})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE_DEFINE_F(BulkTransferFixture, EpollSendfile,
+                            ::io::execution::epoll_multiplexer)
+(benchmark::State &state) { run(state, true); }
+BENCHMARK_REGISTER_F(BulkTransferFixture, EpollSendfile)
+    ->Args({1 << 20, 65536})
+    ->Args({1 << 26, 65536})
+    ->Unit(benchmark::kMillisecond);
+#endif // OS_LINUX
+
+BENCHMARK_MAIN();
+// NOLINTEND
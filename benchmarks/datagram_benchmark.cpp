@@ -0,0 +1,244 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file datagram_benchmark.cpp
+ * @brief Measures the datagram rate of batched and unbatched datagram I/O.
+ *
+ * Each iteration sends a fixed number of datagrams over a `SOCK_DGRAM`
+ * socket pair. The unbatched variant completes one `sendmsg`/`recvmsg` sender
+ * per datagram, while the batched variant moves up to `batch` datagrams per
+ * `sendmmsg`/`recvmmsg` sender.
+ *
+ * Arguments: datagram size, datagrams per iteration, batch size.
+ */
+// NOLINTBEGIN
+#include <benchmark/benchmark.h>
+#include <io/io.hpp>
+
+#include <array>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+
+// Using declarations for brevity
+using namespace exec;
+
+/**
+ * @class DatagramFixture
+ * @brief Fixture for the datagram rate benchmarks.
+ * @tparam Mux The multiplexer backend to benchmark.
+ */
+template <typename Mux> class DatagramFixture : public benchmark::Fixture {
+public:
+  using basic_triggers = ::io::execution::basic_triggers<Mux>;
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+  using message_batch = ::io::socket::message_batch<>;
+  using socket_message = ::io::socket::socket_message<>;
+
+  void SetUp(benchmark::State &state) override
+  {
+    bufsize = state.range(0);
+    datagrams = state.range(1);
+    batch = state.range(2);
+  }
+  void TearDown(benchmark::State &state) override {}
+
+  /** @brief Simple error handler that prints to stderr. */
+  static constexpr auto error_handler = [](const auto &error) {
+    std::cerr << "Error!" << std::endl;
+  };
+
+  /**
+   * @struct endpoint
+   * @brief One end of the datagram stream.
+   */
+  struct endpoint {
+    /** @brief The datagram buffers. */
+    std::vector<std::vector<std::byte>> buffers;
+    /** @brief The batch of datagrams for the batched variant. */
+    message_batch batch;
+    /** @brief The message for the unbatched variant. */
+    socket_message msg;
+    /** @brief The number of datagrams transferred. */
+    std::size_t count{0};
+
+    endpoint(std::size_t bufsize, std::size_t size)
+        : buffers(size, std::vector<std::byte>(bufsize))
+    {
+      for (auto &buf : buffers)
+        batch.push_back(buf);
+      msg.buffers.push_back(buffers.front());
+    }
+  };
+
+  /**
+   * @brief Sends datagrams in batches until `total` have been sent.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The sending socket.
+   * @param self The sending endpoint.
+   * @param total The number of datagrams to send.
+   */
+  static auto send_batches(async_scope &scope, const socket_dialog &dialog,
+                           endpoint &self, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::sendmmsg(dialog, self.batch, 0) |
+                then([&, dialog, total](auto count) {
+                  if ((self.count += count) < total)
+                    send_batches(scope, dialog, self, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Receives datagrams in batches until `total` have been received.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The receiving socket.
+   * @param self The receiving endpoint.
+   * @param total The number of datagrams to receive.
+   */
+  static auto recv_batches(async_scope &scope, const socket_dialog &dialog,
+                           endpoint &self, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::recvmmsg(dialog, self.batch, 0) |
+                then([&, dialog, total](auto count) {
+                  if ((self.count += count) < total)
+                    recv_batches(scope, dialog, self, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Sends one datagram at a time until `total` have been sent.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The sending socket.
+   * @param self The sending endpoint.
+   * @param total The number of datagrams to send.
+   */
+  static auto send_each(async_scope &scope, const socket_dialog &dialog,
+                        endpoint &self, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::sendmsg(dialog, self.msg, 0) |
+                then([&, dialog, total](auto) {
+                  if (++self.count < total)
+                    send_each(scope, dialog, self, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Receives one datagram at a time until `total` have been received.
+   * @param scope The async_scope to spawn the operation on.
+   * @param dialog The receiving socket.
+   * @param self The receiving endpoint.
+   * @param total The number of datagrams to receive.
+   */
+  static auto recv_each(async_scope &scope, const socket_dialog &dialog,
+                        endpoint &self, std::size_t total) -> void
+  {
+    using namespace stdexec;
+    scope.spawn(::io::recvmsg(dialog, self.msg, 0) |
+                then([&, dialog, total](auto) {
+                  if (++self.count < total)
+                    recv_each(scope, dialog, self, total);
+                }) |
+                upon_error(error_handler));
+  }
+
+  /**
+   * @brief Runs one variant of the benchmark.
+   * @param state The benchmark state.
+   * @param batched Whether to use recvmmsg/sendmmsg.
+   */
+  auto run(benchmark::State &state, bool batched) -> void
+  {
+    for (auto _ : state)
+    {
+      async_scope scope;
+      basic_triggers triggers;
+
+      std::array<int, 2> pair{};
+      if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, pair.data()))
+        throw std::system_error(errno, std::system_category(), "socketpair()!");
+
+      auto sender = endpoint(bufsize, batch);
+      auto receiver = endpoint(bufsize, batch);
+      auto send_dialog = triggers.emplace(pair[0]);
+      auto recv_dialog = triggers.emplace(pair[1]);
+
+      if (batched)
+      {
+        recv_batches(scope, recv_dialog, receiver, datagrams);
+        send_batches(scope, send_dialog, sender, datagrams);
+      }
+      else
+      {
+        recv_each(scope, recv_dialog, receiver, datagrams);
+        send_each(scope, send_dialog, sender, datagrams);
+      }
+
+      while (triggers.wait());
+    }
+    state.counters["datagrams"] =
+        benchmark::Counter(static_cast<double>(datagrams),
+                           benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  std::size_t bufsize;
+  std::size_t datagrams;
+  std::size_t batch;
+};
+
+BENCHMARK_TEMPLATE_DEFINE_F(DatagramFixture, SendmsgRecvmsg,
+                            ::io::execution::poll_multiplexer)
+(benchmark::State &state) { run(state, false); }
+BENCHMARK_REGISTER_F(DatagramFixture, SendmsgRecvmsg)
+    ->Args({64, 100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE_DEFINE_F(DatagramFixture, SendmmsgRecvmmsg,
+                            ::io::execution::poll_multiplexer)
+(benchmark::State &state) { run(state, true); }
+BENCHMARK_REGISTER_F(DatagramFixture, SendmmsgRecvmmsg)
+    ->Args({64, 100000, 8})
+    ->Args({64, 100000, 32})
+    ->Args({64, 100000, 64})
+    ->Unit(benchmark::kMillisecond);
+
+#if OS_LINUX
+BENCHMARK_TEMPLATE_DEFINE_F(DatagramFixture, EpollSendmsgRecvmsg,
+                            ::io::execution::epoll_multiplexer)
+(benchmark::State &state) { run(state, false); }
+BENCHMARK_REGISTER_F(DatagramFixture, EpollSendmsgRecvmsg)
+    ->Args({64, 100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE_DEFINE_F(DatagramFixture, EpollSendmmsgRecvmmsg,
+                            ::io::execution::epoll_multiplexer)
+(benchmark::State &state) { run(state, true); }
+BENCHMARK_REGISTER_F(DatagramFixture, EpollSendmmsgRecvmmsg)
+    ->Args({64, 100000, 8})
+    ->Args({64, 100000, 32})
+    ->Args({64, 100000, 64})
+    ->Unit(benchmark::kMillisecond);
+#endif // OS_LINUX
+
+BENCHMARK_MAIN();
+// NOLINTEND
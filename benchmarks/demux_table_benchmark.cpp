@@ -0,0 +1,159 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file demux_table_benchmark.cpp
+ * @brief Compares the memory used by the demultiplexer tables.
+ *
+ * Each benchmark registers a number of sockets whose file descriptors are
+ * spread evenly over a range, and reports the bytes that are allocated to
+ * hold their demultiplexers. The deque is the dense table that was used
+ * before the paged table, which is resized to the largest file descriptor.
+ *
+ * ------------------------------------------------------------
+ * Benchmark                  bytes        bytes_per_socket
+ * ------------------------------------------------------------
+ * DequeTable/1000/1          90.12k       90.12k
+ * DequeTable/100000/1        8.96052M     8.96052M
+ * DequeTable/1000000/1       89.6005M     89.6005M
+ * DequeTable/1000000/1000    91.4738M     91.473k
+ * PagedTable/1000/1          5.768k       5.768k
+ * PagedTable/100000/1        18.144k      18.144k
+ * PagedTable/1000000/1       130.64k      130.64k
+ * PagedTable/1000000/1000    5.768M       5.768k
+ */
+// NOLINTBEGIN
+#include <benchmark/benchmark.h>
+#include <io/io.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+/** @brief The demultiplexer type that is stored in the tables. */
+using demultiplexer = ::io::execution::poll_multiplexer::demultiplexer;
+
+/** @brief The number of bytes that are currently allocated. */
+static std::size_t allocated_bytes = 0;
+
+/**
+ * @brief An allocator that counts the bytes it allocates.
+ * @tparam T The value type.
+ */
+template <typename T> struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &) noexcept
+  {}
+
+  auto allocate(std::size_t n) -> T *
+  {
+    allocated_bytes += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  auto deallocate(T *ptr, std::size_t n) noexcept -> void
+  {
+    allocated_bytes -= n * sizeof(T);
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+
+  template <typename U>
+  auto operator==(const counting_allocator<U> &) const noexcept -> bool
+  {
+    return true;
+  }
+};
+
+/**
+ * @brief Registers sockets in a dense deque that is resized on demand.
+ * @param state The benchmark state. The first argument is the file
+ * descriptor range and the second is the number of sockets.
+ */
+static void DequeTable(benchmark::State &state)
+{
+  using table_type =
+      std::deque<demultiplexer, counting_allocator<demultiplexer>>;
+
+  auto range = static_cast<std::size_t>(state.range(0));
+  auto sockets = static_cast<std::size_t>(state.range(1));
+  std::size_t bytes = 0;
+
+  for (auto _ : state)
+  {
+    table_type table;
+    for (std::size_t i = 1; i <= sockets; ++i)
+    {
+      auto fd = (range / sockets) * i - 1;
+      if (table.size() < fd + 1)
+        table.resize(fd + 1);
+      benchmark::DoNotOptimize(&table[fd]);
+    }
+    bytes = allocated_bytes;
+  }
+
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.counters["bytes_per_socket"] = static_cast<double>(bytes / sockets);
+}
+
+/**
+ * @brief Registers sockets in a paged table.
+ * @param state The benchmark state. The first argument is the file
+ * descriptor range and the second is the number of sockets.
+ */
+static void PagedTable(benchmark::State &state)
+{
+  using table_type =
+      ::io::execution::detail::paged_table<demultiplexer,
+                                           counting_allocator<demultiplexer>>;
+
+  auto range = static_cast<std::size_t>(state.range(0));
+  auto sockets = static_cast<std::size_t>(state.range(1));
+  std::size_t bytes = 0;
+
+  for (auto _ : state)
+  {
+    table_type table;
+    for (std::size_t i = 1; i <= sockets; ++i)
+    {
+      auto fd = (range / sockets) * i - 1;
+      benchmark::DoNotOptimize(&table[fd]);
+    }
+    bytes = allocated_bytes;
+  }
+
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.counters["bytes_per_socket"] = static_cast<double>(bytes / sockets);
+}
+
+BENCHMARK(DequeTable)
+    ->Args({1'000, 1})
+    ->Args({100'000, 1})
+    ->Args({1'000'000, 1})
+    ->Args({1'000, 1'000})
+    ->Args({100'000, 1'000})
+    ->Args({1'000'000, 1'000});
+BENCHMARK(PagedTable)
+    ->Args({1'000, 1})
+    ->Args({100'000, 1})
+    ->Args({1'000'000, 1})
+    ->Args({1'000, 1'000})
+    ->Args({100'000, 1'000})
+    ->Args({1'000'000, 1'000});
+
+BENCHMARK_MAIN();
+// NOLINTEND
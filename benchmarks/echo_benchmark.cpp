@@ -67,10 +67,7 @@
 using namespace exec;
 
 // Type aliases for the specific implementations used in this benchmark.
-using multiplexer = ::io::execution::poll_multiplexer;
 using socket_type = ::io::socket::native_socket_type;
-using basic_triggers = ::io::execution::basic_triggers<multiplexer>;
-using socket_dialog = ::io::socket::socket_dialog<multiplexer>;
 using message_buffer = std::string;
 using socket_message = ::io::socket::socket_message<sockaddr_in>;
 
@@ -98,9 +95,14 @@ public:
 /**
  * @class AsyncBerkeleyEchoFixture
  * @brief Fixture for benchmarking the async-berkeley echo implementation.
+ * @tparam Mux The multiplexer backend to benchmark.
  */
+template <typename Mux>
 class AsyncBerkeleyEchoFixture : public BaseEchoFixture {
 public:
+  using basic_triggers = ::io::execution::basic_triggers<Mux>;
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+
   /**
    * @struct session
    * @brief Manages an echo session, handling reading and writing of data.
@@ -184,16 +186,21 @@ public:
  *
  * This benchmark measures the performance of the echo implementation by
  * creating a number of socket pairs and echoing data between them.
+ *
+ * @tparam Mux The multiplexer backend to benchmark.
  */
-BENCHMARK_DEFINE_F(AsyncBerkeleyEchoFixture, EchoTest)
-(benchmark::State &state)
+template <typename Mux>
+auto async_berkeley_echo(benchmark::State &state,
+                         AsyncBerkeleyEchoFixture<Mux> &fixture) -> void
 {
+  using session = typename AsyncBerkeleyEchoFixture<Mux>::session;
+
   async_scope scope;
-  basic_triggers poller;
+  typename AsyncBerkeleyEchoFixture<Mux>::basic_triggers poller;
 
-  std::vector<socket_type> sockets(2 * connections);
+  std::vector<socket_type> sockets(2 * fixture.connections);
   std::vector<session> sessions;
-  sessions.reserve(connections);
+  sessions.reserve(fixture.connections);
 
   for (auto _ : state)
   {
@@ -201,14 +208,18 @@ BENCHMARK_DEFINE_F(AsyncBerkeleyEchoFixture, EchoTest)
     {
       if (::socketpair(AF_UNIX, SOCK_STREAM, 0, &sockets[i]))
         throw std::system_error(errno, std::system_category(), "socketpair()!");
-      auto &echo = sessions.emplace_back(bufsize);
-      echo.reader(scope, poller.emplace(sockets[i]), iterations);
-      echo.writer(scope, poller.emplace(sockets[i + 1]), {.buffers = message},
-                  iterations);
+      auto &echo = sessions.emplace_back(fixture.bufsize);
+      echo.reader(scope, poller.emplace(sockets[i]), fixture.iterations);
+      echo.writer(scope, poller.emplace(sockets[i + 1]),
+                  {.buffers = fixture.message}, fixture.iterations);
     }
     while (poller.wait());
   }
 }
+
+BENCHMARK_TEMPLATE_DEFINE_F(AsyncBerkeleyEchoFixture, EchoTest,
+                            ::io::execution::poll_multiplexer)
+(benchmark::State &state) { async_berkeley_echo(state, *this); }
 BENCHMARK_REGISTER_F(AsyncBerkeleyEchoFixture, EchoTest)
     ->Args({64, 100, 100})
     ->Args({64, 100, 1000})
@@ -216,6 +227,39 @@ BENCHMARK_REGISTER_F(AsyncBerkeleyEchoFixture, EchoTest)
     ->Args({64, 100000, 100})
     ->Unit(benchmark::kMillisecond);
 
+BENCHMARK_TEMPLATE_DEFINE_F(
+    AsyncBerkeleyEchoFixture, NullMutexEchoTest,
+    ::io::execution::basic_poll_multiplexer<std::allocator<char>,
+                                            ::io::execution::null_mutex>)
+(benchmark::State &state) { async_berkeley_echo(state, *this); }
+BENCHMARK_REGISTER_F(AsyncBerkeleyEchoFixture, NullMutexEchoTest)
+    ->Args({64, 100, 100})
+    ->Args({64, 100, 1000})
+    ->Args({64, 1000, 100})
+    ->Args({64, 100000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+#if OS_LINUX
+BENCHMARK_TEMPLATE_DEFINE_F(AsyncBerkeleyEchoFixture, EpollEchoTest,
+                            ::io::execution::epoll_multiplexer)
+(benchmark::State &state) { async_berkeley_echo(state, *this); }
+BENCHMARK_REGISTER_F(AsyncBerkeleyEchoFixture, EpollEchoTest)
+    ->Args({64, 100, 100})
+    ->Args({64, 100, 1000})
+    ->Args({64, 1000, 100})
+    ->Args({64, 100000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE_DEFINE_F(AsyncBerkeleyEchoFixture, IoUringEchoTest,
+                            ::io::execution::io_uring_multiplexer)
+(benchmark::State &state) { async_berkeley_echo(state, *this); }
+BENCHMARK_REGISTER_F(AsyncBerkeleyEchoFixture, IoUringEchoTest)
+    ->Args({64, 100, 100})
+    ->Args({64, 100, 1000})
+    ->Args({64, 1000, 100})
+    ->Args({64, 100000, 100})
+    ->Unit(benchmark::kMillisecond);
+#endif // OS_LINUX
 
 using namespace boost::asio;
 using local::stream_protocol;
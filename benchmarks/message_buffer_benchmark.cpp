@@ -0,0 +1,140 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file message_buffer_benchmark.cpp
+ * @brief Compares the cost of consuming a message_buffer in partial writes.
+ *
+ * Each benchmark gathers a number of 64 byte buffers and consumes them the
+ * way a writer does after a series of short writes: 100 bytes at a time,
+ * checking whether anything is left after each write. The erase buffer is
+ * the previous implementation, which erased the consumed buffers with
+ * `remove_if` and summed every buffer length to test for emptiness.
+ *
+ * -----------------------------------------------------------------
+ * Benchmark             Time      CPU       items_per_second
+ * -----------------------------------------------------------------
+ * EraseBuffer/1         18.4 ns   18.3 ns   54.6359M/s
+ * EraseBuffer/8         131 ns    127 ns    62.8328M/s
+ * EraseBuffer/64        1350 ns   1336 ns   47.9203M/s
+ * EraseBuffer/512       89875 ns  89255 ns  5.73638M/s
+ * CursorBuffer/1        18.2 ns   18.0 ns   55.4582M/s
+ * CursorBuffer/8        100.0 ns  99.5 ns   80.3634M/s
+ * CursorBuffer/64       315 ns    314 ns    203.947M/s
+ * CursorBuffer/512      1866 ns   1856 ns   275.874M/s
+ */
+// NOLINTBEGIN
+#include <benchmark/benchmark.h>
+#include <io/io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/** @brief The size of each gathered buffer. */
+static constexpr std::size_t buffer_size = 64;
+/** @brief The number of bytes consumed by each write. */
+static constexpr std::size_t write_size = 100;
+
+/** @brief A message buffer that erases the buffers it consumes. */
+struct erase_buffer {
+  std::vector<::io::socket::native_buffer_type> buffer;
+
+  auto push_back(std::span<std::byte> buf) -> void
+  {
+    buffer.push_back({.iov_base = buf.data(), .iov_len = buf.size()});
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    std::size_t len = 0;
+    for (const auto &buf : buffer)
+      len += buf.iov_len;
+    return len == 0;
+  }
+
+  explicit operator bool() const noexcept { return !empty(); }
+
+  auto operator+=(std::size_t len) noexcept -> erase_buffer &
+  {
+    auto [ret, last] = std::ranges::remove_if(buffer, [&](auto &buf) -> bool {
+      if (!len)
+        return false;
+
+      auto count = buf.iov_len;
+      ::io::socket::operator+=(buf, len);
+      return (len < count) ? (len = 0) : (len -= count) >= 0;
+    });
+
+    buffer.erase(ret, last);
+    return *this;
+  }
+};
+
+/**
+ * @brief Gathers buffers and consumes them in partial writes.
+ * @tparam Buffer The message buffer type.
+ * @param state The benchmark state. The argument is the number of buffers.
+ */
+template <typename Buffer> static void Consume(benchmark::State &state)
+{
+  auto count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::array<std::byte, buffer_size>> storage(count);
+
+  for (auto _ : state)
+  {
+    Buffer buffers;
+    for (auto &buf : storage)
+      buffers.push_back(buf);
+
+    std::size_t writes = 0;
+    while (buffers)
+    {
+      buffers += write_size;
+      ++writes;
+    }
+    benchmark::DoNotOptimize(writes);
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() *
+                                                    count));
+}
+
+/**
+ * @brief Consumes the previous implementation.
+ * @param state The benchmark state.
+ */
+static void EraseBuffer(benchmark::State &state)
+{
+  Consume<erase_buffer>(state);
+}
+
+/**
+ * @brief Consumes a message_buffer.
+ * @param state The benchmark state.
+ */
+static void CursorBuffer(benchmark::State &state)
+{
+  Consume<::io::socket::message_buffer<>>(state);
+}
+
+BENCHMARK(EraseBuffer)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(CursorBuffer)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+
+BENCHMARK_MAIN();
+// NOLINTEND
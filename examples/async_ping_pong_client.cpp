@@ -30,7 +30,6 @@
 #include <cstring>
 #include <iostream>
 #include <string>
-#include <thread>
 #include <utility>
 
 #include <arpa/inet.h>
@@ -133,12 +132,16 @@ private:
   void schedule_next_ping(const socket_dialog<poll_multiplexer> &client,
                           int sequence)
   {
-    // Add a small delay between pings to make the demo more visible
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-    // Continue with next ping if we haven't reached the limit
-    if (sequence < ping_count_)
-      start_ping_pong(client, sequence);
+    // Add a small delay between pings to make the demo more visible,
+    // without blocking the event loop.
+    auto delay = triggers_.schedule_after(std::chrono::milliseconds(100)) |
+                 then([this, client, sequence]() {
+                   // Continue with next ping if we haven't reached the limit
+                   if (sequence < ping_count_)
+                     start_ping_pong(client, sequence);
+                 });
+
+    scope_.spawn(std::move(delay));
   }
 
   socket_address<T> server_;
@@ -20,7 +20,8 @@
  * This example demonstrates a basic TCP echo server that listens for incoming
  * connections and echoes back any data it receives. It showcases the use of
  * asynchronous operations for accepting connections, reading data, and writing
- * data.
+ * data. The server runs one event loop per hardware thread, and each loop
+ * accepts connections on its own `SO_REUSEPORT` listener.
  */
 // NOLINTBEGIN
 #include <io/io.hpp>
@@ -37,10 +38,29 @@ using namespace stdexec;
 using namespace exec;
 
 // Type aliases for the specific implementations used in this example
-using triggers = basic_triggers<poll_multiplexer>;
+using pool = executor_pool<poll_multiplexer>;
 using dialog = socket_dialog<poll_multiplexer>;
-using buffer = std::vector<char>;
 using message = socket_message<sockaddr_in>;
+using reader_type = stream_reader<poll_multiplexer>;
+
+/**
+ * @brief The state of one client connection.
+ *
+ * The read buffer and the message used to echo it back are allocated once
+ * per connection and reused for every read and write.
+ */
+struct session {
+  /**
+   * @brief Constructs a session.
+   * @param client The client socket.
+   */
+  explicit session(const dialog &client) : reader{client, 1024} {}
+
+  /** @brief Reads from the client into a ring buffer. */
+  reader_type reader;
+  /** @brief The message that echoes the buffered bytes. */
+  message msg;
+};
 
 /**
  * @brief A simple error handler for asynchronous operations.
@@ -58,31 +78,39 @@ static constexpr auto error_handler = [](const auto &error) {
 };
 
 // Forward declare the reader so that it can be used from writer().
-static auto reader(async_scope &scope, const dialog &client) -> void;
+static auto reader(async_scope &scope,
+                   const std::shared_ptr<session> &client) -> void;
 
 /**
- * @brief Asynchronously writes data to a client socket.
+ * @brief Asynchronously writes the buffered data back to a client socket.
  * @param scope The async_scope to spawn the operation on.
- * @param client The client socket to write to.
- * @param msg The socket_message containing the data to write.
- * @param buf The buffer holding the data.
+ * @param client The client session to write to.
  */
-static auto writer(async_scope &scope, const dialog &client,
-                   const std::shared_ptr<message> &msg,
-                   const std::shared_ptr<buffer> &buf) -> void
+static auto writer(async_scope &scope,
+                   const std::shared_ptr<session> &client) -> void
 {
+  // Point the message at the buffered bytes, without copying them.
+  auto &msg = client->msg;
+  msg.buffers.clear();
+  for (auto buf : client->reader.data())
+  {
+    if (!buf.empty())
+      msg.buffers.push_back(buf);
+  }
+
   // Create a sender that sends the message and, upon completion, either
   // continues writing if not all data was sent, or starts reading again.
-  sender auto send_sendmsg = sendmsg(client, *msg, 0) |
-                             then([=, &scope](auto len) {
-                               // len is guaranteed >= 0 since errors are
-                               // reported separately.
-                               if (msg->buffers += len)
-                                 return writer(scope, client, msg, buf);
-
-                               reader(scope, client);
-                             }) |
-                             upon_error(error_handler);
+  sender auto send_sendmsg =
+      sendmsg(client->reader.dialog(), msg, 0) |
+      then([=, &scope](auto len) {
+        // len is guaranteed >= 0 since errors are reported separately.
+        client->reader.consume(len);
+        if (!client->reader.empty())
+          return writer(scope, client);
+
+        reader(scope, client);
+      }) |
+      upon_error(error_handler);
 
   scope.spawn(std::move(send_sendmsg));
 }
@@ -90,24 +118,21 @@ static auto writer(async_scope &scope, const dialog &client,
 /**
  * @brief Asynchronously reads data from a client socket.
  * @param scope The async_scope to spawn the operation on.
- * @param client The client socket to read from.
+ * @param client The client session to read from.
  */
-static auto reader(async_scope &scope, const dialog &client) -> void
+static auto reader(async_scope &scope,
+                   const std::shared_ptr<session> &client) -> void
 {
-  auto msg = std::make_shared<message>();
-  auto buf = std::make_shared<buffer>(1024);
-  msg->buffers.push_back(*buf);
-
-  // Create a sender that receives a message and, upon completion, echoes it
-  // back to the client by calling writer.
-  sender auto send_recvmsg = recvmsg(client, *msg, 0) |
+  // Create a sender that receives into the session's buffer and, upon
+  // completion, echoes it back to the client by calling writer.
+  sender auto send_recvmsg = client->reader.read() |
                              then([=, &scope](auto len) {
                                // len is guaranteed >= 0 since errors are
                                // reported separately.
                                if (!len) // 0 indicates the client disconnected
                                  return;
 
-                               writer(scope, client, msg, buf);
+                               writer(scope, client);
                              }) |
                              upon_error(error_handler);
 
@@ -125,7 +150,7 @@ static auto acceptor(async_scope &scope, const dialog &server) -> void
   // starts reading from the new client and continues to accept more clients.
   sender auto send_accept = accept(server) | then([&, server](auto result) {
                               auto [client, addr] = std::move(result);
-                              reader(scope, client);
+                              reader(scope, std::make_shared<session>(client));
                               acceptor(scope, server);
                             }) |
                             upon_error(error_handler);
@@ -134,31 +159,21 @@ static auto acceptor(async_scope &scope, const dialog &server) -> void
 }
 
 /**
- * @brief Creates and configures the server socket.
- * @param scope The async_scope to spawn the acceptor on.
- * @param server The server socket to configure.
+ * @brief Creates one server socket per event loop and starts accepting.
+ * @param scope The async_scope to spawn the acceptors on.
+ * @param loops The event loops to create the server sockets on.
  */
-static auto make_server(async_scope &scope, const dialog &server) -> void
+static auto make_servers(async_scope &scope, pool &loops) -> void
 {
   auto server_address = make_address<sockaddr_in>();
   server_address->sin_family = AF_INET;
   server_address->sin_addr.s_addr = inet_addr("127.0.0.1");
   server_address->sin_port = htons(8080);
 
-  // Set SO_REUSEADDR to allow the server to restart quickly
-  socket_option<int> reuse{1};
-  if (setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reuse))
-    throw std::system_error({errno, std::system_category()},
-                            "setsockopt failed.");
-
-  if (::io::bind(server, server_address))
-    throw std::system_error({errno, std::system_category()}, "bind failed.");
-
-  if (::io::listen(server, SOMAXCONN))
-    throw std::system_error({errno, std::system_category()}, "listen failed.");
-
-  // Start accepting connections
-  acceptor(scope, server);
+  // Each listener sets SO_REUSEPORT, so the kernel balances connections
+  // between the event loops.
+  for (const auto &server : loops.make_listeners(server_address))
+    acceptor(scope, server);
 }
 
 /**
@@ -167,13 +182,13 @@ static auto make_server(async_scope &scope, const dialog &server) -> void
 auto main(int argc, char *argv[]) -> int
 {
   async_scope scope;
-  triggers trigs;
+  pool loops;
 
-  // Create the server socket
-  make_server(scope, trigs.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+  // Create the server sockets
+  make_servers(scope, loops);
 
-  // Run the event loop until there are no more pending operations
-  while (trigs.wait());
+  // Run the event loops until they are stopped
+  loops.run();
   return 0;
 }
 // NOLINTEND
@@ -38,6 +38,17 @@
 #define OS_WINDOWS 1
 #endif
 
+/**
+ * @ingroup config
+ * @def OS_LINUX
+ * @brief True if the Linux OS is detected.
+ */
+#define OS_LINUX 0
+#if defined(__linux__)
+#undef OS_LINUX
+#define OS_LINUX 1
+#endif
+
 /**
  * @ingroup config
  * @def IO_EAGER_ACCEPT
@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <optional>
+#include <span>
 #include <type_traits>
 // Forward declarations
 namespace io {
@@ -102,7 +103,8 @@ concept Completion = requires(Fn &&func) {
  * @brief Concept for a multiplexer.
  *
  * A multiplexer is responsible for waiting for events and dispatching them to
- * completion handlers.
+ * completion handlers. `notify()` wakes up a thread that is blocked waiting
+ * for events.
  *
  * @tparam T The type to check.
  */
@@ -117,6 +119,7 @@ concept Multiplexer = requires(T mux) {
           execution::execution_trigger{},
           []() -> std::optional<int> { return std::nullopt; });
   mux.wait_for(typename T::interval_type{});
+  mux.notify();
 };
 
 /**
@@ -148,5 +151,23 @@ template <typename Message>
 concept MessageLike =
     requires(Message msg) { static_cast<socket::socket_message_type>(msg); };
 
+#if !OS_WINDOWS
+/**
+ * @brief Concept for types that behave like a batch of socket messages.
+ * @details `prepare_recv()` and `prepare_send()` return the native message
+ * vector, ready to be passed to `recvmmsg` or `sendmmsg`.
+ * @tparam Batch The type to check.
+ */
+template <typename Batch>
+concept MessageBatchLike = requires(Batch &batch) {
+  {
+    batch.prepare_recv()
+  } -> std::same_as<std::span<socket::socket_mmsg_type>>;
+  {
+    batch.prepare_send()
+  } -> std::same_as<std::span<socket::socket_mmsg_type>>;
+};
+#endif // !OS_WINDOWS
+
 } // namespace io
 #endif // IO_CONCEPTS_HPP
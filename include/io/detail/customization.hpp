@@ -20,6 +20,8 @@
 #pragma once
 #ifndef IO_CUSTOMIZATION_HPP
 #define IO_CUSTOMIZATION_HPP
+#include <cstddef>
+#include <ios>
 #include <span>
 #include <utility>
 /**
@@ -42,7 +44,11 @@ struct getpeername_t {};
 struct getsockname_t {};
 struct getsockopt_t {};
 struct listen_t {};
+struct recv_t {};
+struct recvmmsg_t {};
 struct recvmsg_t {};
+struct sendfile_t {};
+struct sendmmsg_t {};
 struct sendmsg_t {};
 struct setsockopt_t {};
 struct shutdown_t {};
@@ -50,7 +56,6 @@ struct shutdown_t {};
 // TODO: Implement free-standing functions in the berkeley sockets APIs
 // - send
 // - sendto
-// - recv
 // - recvfrom
 
 /**
@@ -196,6 +201,35 @@ inline auto listen(auto &&socket, int backlog) -> decltype(auto)
   return listen(std::forward<decltype(socket)>(socket), backlog);
 }
 
+/**
+ * @brief Receives into a buffer taken from the executor's buffer pool.
+ * @details The buffer is only taken once the socket is readable.
+ * @param socket A socket-like object.
+ * @param flags Flags to control the receive operation.
+ * @return A `stdexec::sender` that completes with a `pooled_buffer` that holds
+ *         the bytes received. An empty buffer means the end of the stream.
+ */
+inline auto recv(auto &&socket, int flags) -> decltype(auto)
+{
+  static constexpr cpo<recv_t> recv{};
+  return recv(std::forward<decltype(socket)>(socket), flags);
+}
+
+/**
+ * @brief Receives a batch of messages from a socket.
+ * @param socket A socket-like object.
+ * @param batch A message batch to receive data into.
+ * @param flags Flags to control the receive operation.
+ * @return The number of messages received for synchronous operations. A
+ *         `stdexec::sender` for asynchronous operations.
+ */
+inline auto recvmmsg(auto &&socket, auto &&batch, int flags) -> decltype(auto)
+{
+  static constexpr cpo<recvmmsg_t> recvmmsg{};
+  return recvmmsg(std::forward<decltype(socket)>(socket),
+                  std::forward<decltype(batch)>(batch), flags);
+}
+
 /**
  * @brief Receives a message from a socket.
  * @param socket A socket-like object.
@@ -211,6 +245,39 @@ inline auto recvmsg(auto &&socket, auto &&msg, int flags) -> decltype(auto)
                  std::forward<decltype(msg)>(msg), flags);
 }
 
+/**
+ * @brief Sends part of a file on a socket without copying it through user
+ *        space.
+ * @param socket A socket-like object.
+ * @param fd The file descriptor to read from.
+ * @param offset The offset in the file to start reading from.
+ * @param count The number of bytes to send.
+ * @return The number of bytes sent for synchronous operations. A
+ *         `stdexec::sender` for asynchronous operations.
+ */
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline auto sendfile(auto &&socket, int fd, std::streamoff offset,
+                     std::size_t count) -> decltype(auto)
+{
+  static constexpr cpo<sendfile_t> sendfile{};
+  return sendfile(std::forward<decltype(socket)>(socket), fd, offset, count);
+}
+
+/**
+ * @brief Sends a batch of messages on a socket.
+ * @param socket A socket-like object.
+ * @param batch The message batch to send.
+ * @param flags Flags to control the send operation.
+ * @return The number of messages sent for synchronous operations. A
+ *         `stdexec::sender` for asynchronous operations.
+ */
+inline auto sendmmsg(auto &&socket, auto &&batch, int flags) -> decltype(auto)
+{
+  static constexpr cpo<sendmmsg_t> sendmmsg{};
+  return sendmmsg(std::forward<decltype(socket)>(socket),
+                  std::forward<decltype(batch)>(batch), flags);
+}
+
 /**
  * @brief Sends a message on a socket.
  * @param socket A socket-like object.
@@ -0,0 +1,70 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file deadline.hpp
+ * @brief This file defines a helper that bounds the time a sender may take.
+ */
+#pragma once
+#ifndef IO_DEADLINE_HPP
+#define IO_DEADLINE_HPP
+#include <exec/when_any.hpp>
+#include <stdexec/execution.hpp>
+
+#include <chrono>
+#include <system_error>
+#include <utility>
+/**
+ * @namespace io
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io {
+/**
+ * @brief Bounds the time that a sender may take to complete.
+ * @details The sender races a timer from `timers`. Whichever completes first
+ * requests the other to stop, and the result is sent when both have
+ * completed. If the timer wins, the result is `set_error()` with
+ * `std::errc::timed_out`. The poll and epoll operations are removed from
+ * their multiplexer when they are stopped, so they release their socket and
+ * buffers as soon as the deadline passes. Submitted io_uring operations are
+ * cancelled with `IORING_OP_ASYNC_CANCEL`, so they release them on the next
+ * wait. Senders that don't honor stop requests are waited for.
+ * @tparam Timers A type that creates timer senders, such as `basic_triggers`.
+ * @tparam Sender The sender type.
+ * @tparam Rep The tick type of the timeout.
+ * @tparam Period The tick period of the timeout.
+ * @param timers The source of the deadline timer.
+ * @param sender The sender to bound.
+ * @param timeout The time that the sender may take.
+ * @return A sender that completes like `sender`, or with `set_error()` if the
+ * timeout expires first.
+ */
+template <typename Timers, typename Sender, typename Rep, typename Period>
+  requires requires(Timers &timers, std::chrono::duration<Rep, Period> delay) {
+    timers.schedule_after(delay);
+  }
+auto with_deadline(Timers &timers, Sender &&sender,
+                   std::chrono::duration<Rep, Period> timeout)
+    -> decltype(auto)
+{
+  auto expired = stdexec::let_value(timers.schedule_after(timeout), [] {
+    return stdexec::just_error(std::make_error_code(std::errc::timed_out));
+  });
+
+  return exec::when_any(std::forward<Sender>(sender), std::move(expired));
+}
+
+} // namespace io
+#endif // IO_DEADLINE_HPP
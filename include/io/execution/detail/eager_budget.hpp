@@ -0,0 +1,181 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file eager_budget.hpp
+ * @brief This file defines the budget that bounds how many operations an
+ * executor completes inline before falling back to the multiplexer.
+ */
+#pragma once
+#ifndef IO_EAGER_BUDGET_HPP
+#define IO_EAGER_BUDGET_HPP
+#include "immovable.hpp"
+
+#include <atomic>
+#include <cstddef>
+namespace io::execution::detail {
+/**
+ * @brief Decides whether an eager operation may try to complete inline.
+ * @details Each executor owns one budget. An operation that is granted the
+ * budget calls into the socket API immediately; otherwise it waits for
+ * readiness on the multiplexer like a lazy operation. The budget forces a
+ * fallback after `budget` consecutive grants, so that the event loop gets a
+ * chance to poll, and after `socket_limit` consecutive grants to the same
+ * socket, so that one hot socket cannot starve the others.
+ *
+ * The counters belong to the event loop that owns the executor and are only
+ * ever loaded and stored, never read-modify-written, so they cost the same as
+ * plain integers. If several threads initiate operations on the same executor
+ * the counts are approximate, which only affects when the next fallback
+ * happens.
+ */
+class eager_budget : immovable {
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+
+  /** @brief Counters describing how the budget was spent. */
+  struct statistics {
+    /** @brief The number of operations allowed to complete inline. */
+    size_type eager = 0;
+    /** @brief The number of fallbacks forced by the executor budget. */
+    size_type budget_fallbacks = 0;
+    /** @brief The number of fallbacks forced by the per-socket limit. */
+    size_type socket_fallbacks = 0;
+  };
+
+  /** @brief Every 256th operation goes through the multiplexer by default. */
+  static constexpr size_type default_budget = 255;
+  /** @brief The default limit of consecutive grants to one socket. */
+  static constexpr size_type default_socket_limit = 64;
+
+  /**
+   * @brief Constructs a budget.
+   * @param budget The number of consecutive grants before a fallback.
+   * @param socket_limit The number of consecutive grants to the same socket
+   * before a fallback.
+   */
+  explicit eager_budget(size_type budget = default_budget,
+                        size_type socket_limit = default_socket_limit) noexcept
+      : budget_{budget}, socket_limit_{socket_limit}
+  {}
+
+  /**
+   * @brief Tries to take one unit of the budget for an operation.
+   * @param socket Identifies the socket the operation runs on.
+   * @return true if the operation may complete inline, false if it must
+   * wait on the multiplexer.
+   */
+  auto try_acquire(const void *socket) noexcept -> bool;
+
+  /**
+   * @brief Changes the limits and restarts the budget.
+   * @param budget The number of consecutive grants before a fallback. Zero
+   * makes every operation wait on the multiplexer.
+   * @param socket_limit The number of consecutive grants to the same socket
+   * before a fallback.
+   */
+  auto set_limits(size_type budget,
+                  size_type socket_limit = default_socket_limit) noexcept
+      -> void;
+
+  /**
+   * @brief Gets the counters.
+   * @return A snapshot of the counters.
+   */
+  [[nodiscard]] auto stats() const noexcept -> statistics;
+
+private:
+  /**
+   * @brief Increments a counter without a read-modify-write instruction.
+   * @param counter The counter to increment.
+   */
+  static auto bump(std::atomic<size_type> &counter) noexcept -> void
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  /** @brief The number of consecutive grants before a fallback. */
+  std::atomic<size_type> budget_;
+  /** @brief The number of consecutive grants to one socket. */
+  std::atomic<size_type> socket_limit_;
+  /** @brief The number of grants since the last budget fallback. */
+  std::atomic<size_type> used_{0};
+  /** @brief The socket of the most recent grant. */
+  std::atomic<const void *> last_{nullptr};
+  /** @brief The number of consecutive grants to `last_`. */
+  std::atomic<size_type> streak_{0};
+  /** @brief The number of operations allowed to complete inline. */
+  std::atomic<size_type> eager_{0};
+  /** @brief The number of fallbacks forced by the budget. */
+  std::atomic<size_type> budget_fallbacks_{0};
+  /** @brief The number of fallbacks forced by the per-socket limit. */
+  std::atomic<size_type> socket_fallbacks_{0};
+};
+
+inline auto eager_budget::try_acquire(const void *socket) noexcept -> bool
+{
+  static constexpr auto relaxed = std::memory_order_relaxed;
+
+  auto used = used_.load(relaxed);
+  if (used >= budget_.load(relaxed))
+  {
+    used_.store(0, relaxed);
+    streak_.store(0, relaxed);
+    last_.store(nullptr, relaxed);
+    bump(budget_fallbacks_);
+    return false;
+  }
+
+  auto streak = (last_.load(relaxed) == socket) ? streak_.load(relaxed) : 0;
+  if (streak >= socket_limit_.load(relaxed))
+  {
+    streak_.store(0, relaxed);
+    last_.store(nullptr, relaxed);
+    bump(socket_fallbacks_);
+    return false;
+  }
+
+  used_.store(used + 1, relaxed);
+  streak_.store(streak + 1, relaxed);
+  last_.store(socket, relaxed);
+  bump(eager_);
+  return true;
+}
+
+inline auto eager_budget::set_limits(size_type budget,
+                                     size_type socket_limit) noexcept -> void
+{
+  static constexpr auto relaxed = std::memory_order_relaxed;
+
+  budget_.store(budget, relaxed);
+  socket_limit_.store(socket_limit, relaxed);
+  used_.store(0, relaxed);
+  streak_.store(0, relaxed);
+  last_.store(nullptr, relaxed);
+}
+
+inline auto eager_budget::stats() const noexcept -> statistics
+{
+  static constexpr auto relaxed = std::memory_order_relaxed;
+
+  return {.eager = eager_.load(relaxed),
+          .budget_fallbacks = budget_fallbacks_.load(relaxed),
+          .socket_fallbacks = socket_fallbacks_.load(relaxed)};
+}
+
+} // namespace io::execution::detail
+#endif // IO_EAGER_BUDGET_HPP
@@ -0,0 +1,174 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file eager_sender.hpp
+ * @brief This file defines a sender that completes the result of an eager
+ * operation without going through the executor.
+ */
+#pragma once
+#ifndef IO_EAGER_SENDER_HPP
+#define IO_EAGER_SENDER_HPP
+#include "immovable.hpp"
+#include "trampoline.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+namespace io::execution::detail {
+/**
+ * @brief A sender for an operation that may already have completed.
+ * @details An eager operation calls into the socket API before its sender is
+ * returned. If that call finished the operation, the sender holds the result,
+ * and its operation state completes the receiver directly when it is
+ * started, through the trampoline, without the executor's scope and without
+ * a copy of the socket handle. Otherwise the sender holds the lazy sender
+ * that waits on the multiplexer, and forwards to it.
+ * @tparam T The value type of the operation.
+ * @tparam Lazy The type of the lazy sender.
+ */
+template <typename T, stdexec::sender Lazy> class eager_sender {
+  static_assert(!std::is_same_v<T, std::error_code>);
+
+  /**
+   * @brief Converts to the result of a function, so that a function that
+   * returns an immovable type can be emplaced.
+   * @tparam Fn The function type.
+   */
+  template <typename Fn> struct emplace_from {
+    /** @brief Calls the function. */
+    operator std::invoke_result_t<Fn &>() && { return fn(); }
+    /** @brief The function. */
+    Fn fn;
+  };
+
+public:
+  /** @brief The sender concept type. */
+  using sender_concept = stdexec::sender_t;
+  /** @brief The completion signatures for the sender. */
+  using completion_signatures =
+      stdexec::completion_signatures<stdexec::set_value_t(T),
+                                     stdexec::set_error_t(std::error_code),
+                                     stdexec::set_stopped_t()>;
+
+  /**
+   * @brief An operation state for the eager sender.
+   * @tparam Receiver The receiver type.
+   */
+  template <typename Receiver>
+  class state : public trampoline::task, immovable {
+    /** @brief The operation state of the lazy sender. */
+    using lazy_state = decltype(stdexec::connect(std::declval<Lazy>(),
+                                                 std::declval<Receiver>()));
+
+  public:
+    /**
+     * @brief Connects a sender to a receiver.
+     * @param sender The sender to connect.
+     * @param receiver The receiver to complete.
+     */
+    state(eager_sender &&sender, Receiver receiver)
+        : trampoline::task{.complete = state::complete}
+    {
+      if (sender.lazy_)
+      {
+        lazy_.emplace(emplace_from{[&] {
+          return stdexec::connect(std::move(*sender.lazy_),
+                                  std::move(receiver));
+        }});
+        return;
+      }
+
+      receiver_.emplace(std::move(receiver));
+      value_ = std::move(sender.value_);
+      error_ = sender.error_;
+    }
+
+    /** @brief Starts the operation. */
+    auto start() noexcept -> void
+    {
+      if (lazy_)
+        return stdexec::start(*lazy_);
+
+      trampoline::run(this);
+    }
+
+  private:
+    /**
+     * @brief Completes the receiver with the result.
+     * @param task_ptr The operation to complete.
+     */
+    static auto complete(trampoline::task *task_ptr) noexcept -> void
+    {
+      auto *self = static_cast<state *>(task_ptr);
+      auto &receiver = *self->receiver_;
+      if (self->value_)
+        return stdexec::set_value(std::move(receiver),
+                                  std::move(*self->value_));
+
+      stdexec::set_error(std::move(receiver), self->error_);
+    }
+
+    /** @brief The receiver, if the operation has completed. */
+    std::optional<Receiver> receiver_;
+    /** @brief The value, if the operation has succeeded. */
+    std::optional<T> value_;
+    /** @brief The error, if the operation has failed. */
+    std::error_code error_;
+    /** @brief The lazy operation, if the operation hasn't completed. */
+    std::optional<lazy_state> lazy_;
+  };
+
+  /**
+   * @brief Constructs a sender that waits on the multiplexer.
+   * @param lazy The lazy sender.
+   */
+  explicit eager_sender(Lazy lazy) : lazy_{std::move(lazy)} {}
+  /**
+   * @brief Constructs a sender that completes with a value.
+   * @param value The value.
+   */
+  explicit eager_sender(T value) : value_{std::move(value)} {}
+  /**
+   * @brief Constructs a sender that completes with an error.
+   * @param error The error.
+   */
+  explicit eager_sender(std::error_code error) noexcept : error_{error} {}
+
+  /**
+   * @brief Connects the sender to a receiver.
+   * @param receiver The receiver to connect to.
+   * @return The operation state.
+   */
+  template <typename Receiver>
+  auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>
+  {
+    return {std::move(*this), std::forward<Receiver>(receiver)};
+  }
+
+private:
+  /** @brief The lazy sender, if the operation hasn't completed. */
+  std::optional<Lazy> lazy_;
+  /** @brief The value, if the operation has succeeded. */
+  std::optional<T> value_;
+  /** @brief The error, if the operation has failed. */
+  std::error_code error_;
+};
+
+} // namespace io::execution::detail
+#endif // IO_EAGER_SENDER_HPP
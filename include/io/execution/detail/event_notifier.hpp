@@ -0,0 +1,135 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file event_notifier.hpp
+ * @brief This file defines a file descriptor that wakes up a blocked
+ * multiplexer.
+ */
+#pragma once
+#ifndef IO_EVENT_NOTIFIER_HPP
+#define IO_EVENT_NOTIFIER_HPP
+#include "immovable.hpp"
+#include "io/config.h"
+#include "io/error.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+#if OS_LINUX
+#include <sys/eventfd.h>
+#endif
+/**
+ * @namespace io::execution::detail
+ * @brief Implementation details of the execution components.
+ */
+namespace io::execution::detail {
+/**
+ * @brief A file descriptor that becomes readable when it is notified.
+ * @details The notifier is an `eventfd` on Linux and a non-blocking pipe
+ * elsewhere. Notifications are coalesced: only the first notification after
+ * the notifier is cleared writes to the file descriptor, so a burst of
+ * notifications costs a single `write()`. The caller is responsible for
+ * serializing calls to `notify()` and `clear()`.
+ */
+class event_notifier : immovable {
+public:
+  /**
+   * @brief Creates the notifier.
+   * @throws std::system_error if the file descriptor can't be created.
+   */
+  event_notifier();
+
+  /**
+   * @brief Gets the file descriptor to wait on for readability.
+   * @return The file descriptor.
+   */
+  [[nodiscard]] auto native_handle() const noexcept -> int;
+
+  /**
+   * @brief Makes the file descriptor readable.
+   * @details Does nothing if the notifier has already been notified since it
+   * was last cleared.
+   */
+  auto notify() noexcept -> void;
+
+  /** @brief Drains the file descriptor so that it is no longer readable. */
+  auto clear() noexcept -> void;
+
+  /** @brief Closes the file descriptor. */
+  ~event_notifier();
+
+private:
+  /** @brief The read and write ends. They are the same for an eventfd. */
+  std::array<int, 2> fds_{-1, -1};
+  /** @brief True if the notifier is readable or about to become readable. */
+  bool pending_ = false;
+};
+
+inline event_notifier::event_notifier()
+{
+#if OS_LINUX
+  fds_[0] = fds_[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fds_[0] < 0)
+    throw_system_error(IO_ERROR_MESSAGE("eventfd failed."));
+#else
+  if (::pipe(fds_.data()))
+    throw_system_error(IO_ERROR_MESSAGE("pipe failed."));
+
+  for (auto fd : fds_)
+  {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+#endif
+}
+
+inline auto event_notifier::native_handle() const noexcept -> int
+{
+  return fds_[0];
+}
+
+inline auto event_notifier::notify() noexcept -> void
+{
+  if (pending_)
+    return;
+
+  // A full pipe or a saturated eventfd is already readable.
+  std::uint64_t value = 1;
+  pending_ = true;
+  [[maybe_unused]] auto ret = ::write(fds_[1], &value, sizeof(value));
+}
+
+inline auto event_notifier::clear() noexcept -> void
+{
+  std::array<std::uint64_t, 8> buf{};
+  while (::read(fds_[0], buf.data(), sizeof(buf)) > 0)
+    ;
+  pending_ = false;
+}
+
+inline event_notifier::~event_notifier()
+{
+  if (fds_[1] != fds_[0])
+    ::close(fds_[1]);
+
+  if (fds_[0] >= 0)
+    ::close(fds_[0]);
+}
+
+} // namespace io::execution::detail
+#endif // IO_EVENT_NOTIFIER_HPP
@@ -34,6 +34,11 @@ enum struct execution_trigger : std::uint8_t {
   READ = 1 << 0,
   /** @brief A write event. */
   WRITE = 1 << 1,
+  /**
+   * @brief An error queue event, such as a `MSG_ZEROCOPY` completion
+   * notification that can be read with `MSG_ERRQUEUE`.
+   */
+  ERRQUEUE = 1 << 2,
   /**
    * @brief A sentinel value that indicates that
    * the event should evaluate immediately.
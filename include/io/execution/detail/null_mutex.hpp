@@ -0,0 +1,47 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file null_mutex.hpp
+ * @brief This file defines a mutex that doesn't lock.
+ */
+#pragma once
+#ifndef IO_NULL_MUTEX_HPP
+#define IO_NULL_MUTEX_HPP
+
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief A BasicLockable type that doesn't lock.
+ * @details Multiplexers that are only ever used from a single thread can use
+ * this as their mutex type, so that their locks compile away.
+ */
+struct null_mutex {
+  /** @brief Does nothing. */
+  static constexpr auto lock() noexcept -> void {}
+  /** @brief Does nothing. */
+  static constexpr auto unlock() noexcept -> void {}
+  /**
+   * @brief Does nothing.
+   * @return true.
+   */
+  static constexpr auto try_lock() noexcept -> bool { return true; }
+};
+} // namespace io::execution
+
+#endif // IO_NULL_MUTEX_HPP
@@ -0,0 +1,245 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file paged_table.hpp
+ * @brief This file defines a sparse table that is indexed by file descriptor.
+ */
+#pragma once
+#ifndef IO_PAGED_TABLE_HPP
+#define IO_PAGED_TABLE_HPP
+#include "io/detail/concepts.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <vector>
+/**
+ * @namespace io::execution::detail
+ * @brief Implementation details of the execution components.
+ */
+namespace io::execution::detail {
+/**
+ * @brief A two-level table that maps small integer keys to values.
+ * @details The keys are split into a page number and an offset into the
+ * page. Pages are allocated when the first key in the page is accessed and
+ * are freed when the last key in the page is erased, so memory use is bounded
+ * by one page per live key plus one pointer per page in the key range.
+ * References to values are stable until the value is erased.
+ * @tparam T The value type. It must be default constructible.
+ * @tparam Allocator The allocator type.
+ * @tparam PageSize The number of values in a page.
+ */
+template <typename T, AllocatorLike Allocator = std::allocator<T>,
+          std::size_t PageSize = 64>
+class paged_table {
+public:
+  /** @brief The key type. */
+  using key_type = std::size_t;
+  /** @brief The value type. */
+  using value_type = T;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+  /** @brief The number of values in a page. */
+  static constexpr size_type page_size = PageSize;
+
+  /** @brief A page of values. */
+  struct page {
+    /** @brief The values in the page. */
+    std::array<value_type, page_size> values{};
+    /** @brief Marks the values that are in use. */
+    std::bitset<page_size> live;
+  };
+
+  /** @brief The allocator for pages. */
+  using page_allocator =
+      std::allocator_traits<Allocator>::template rebind_alloc<page>;
+  /** @brief The allocator for the page directory. */
+  using directory_allocator =
+      std::allocator_traits<Allocator>::template rebind_alloc<page *>;
+
+  /**
+   * @brief Constructs an empty table.
+   * @param alloc The allocator to use for all allocations.
+   */
+  explicit paged_table(const Allocator &alloc = Allocator()) noexcept(
+      noexcept(Allocator()));
+
+  /** @brief Deleted copy constructor. */
+  paged_table(const paged_table &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const paged_table &) -> paged_table & = delete;
+
+  /**
+   * @brief Gets the value for a key, inserting it if it doesn't exist.
+   * @param key The key to look up.
+   * @return A reference to the value.
+   */
+  auto operator[](key_type key) -> value_type &;
+
+  /**
+   * @brief Finds the value for a key.
+   * @param key The key to look up.
+   * @return A pointer to the value, or nullptr if the key doesn't exist.
+   */
+  [[nodiscard]] auto find(key_type key) noexcept -> value_type *;
+
+  /**
+   * @brief Erases a key and resets its value.
+   * @details The page that contains the key is freed if it has no other live
+   * keys.
+   * @param key The key to erase.
+   */
+  auto erase(key_type key) -> void;
+
+  /** @brief Returns the number of live keys. */
+  [[nodiscard]] auto size() const noexcept -> size_type;
+
+  /** @brief Returns the number of allocated pages. */
+  [[nodiscard]] auto pages() const noexcept -> size_type;
+
+  /** @brief Frees all pages. */
+  ~paged_table();
+
+private:
+  /** @brief The page allocator. */
+  page_allocator alloc_;
+  /** @brief The pages indexed by page number. */
+  std::vector<page *, directory_allocator> directory_;
+  /** @brief The number of live keys. */
+  size_type size_ = 0;
+  /** @brief The number of allocated pages. */
+  size_type pages_ = 0;
+};
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+paged_table<T, Allocator, PageSize>::paged_table(
+    const Allocator &alloc) noexcept(noexcept(Allocator()))
+    : alloc_{alloc}, directory_{directory_allocator{alloc}}
+{}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+auto paged_table<T, Allocator, PageSize>::operator[](key_type key)
+    -> value_type &
+{
+  using traits = std::allocator_traits<page_allocator>;
+
+  auto number = key / page_size;
+  if (directory_.size() <= number)
+    directory_.resize(number + 1);
+
+  auto *&ptr = directory_[number];
+  if (!ptr)
+  {
+    auto *tmp = traits::allocate(alloc_, 1);
+    try
+    {
+      traits::construct(alloc_, tmp);
+    }
+    catch (...)
+    {
+      traits::deallocate(alloc_, tmp, 1);
+      throw;
+    }
+    ptr = tmp;
+    ++pages_;
+  }
+
+  auto offset = key % page_size;
+  if (!ptr->live.test(offset))
+  {
+    ptr->live.set(offset);
+    ++size_;
+  }
+
+  return ptr->values[offset];
+}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+auto paged_table<T, Allocator, PageSize>::find(key_type key) noexcept
+    -> value_type *
+{
+  auto number = key / page_size;
+  if (directory_.size() <= number || !directory_[number])
+    return nullptr;
+
+  auto *ptr = directory_[number];
+  auto offset = key % page_size;
+  return ptr->live.test(offset) ? &ptr->values[offset] : nullptr;
+}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+auto paged_table<T, Allocator, PageSize>::erase(key_type key) -> void
+{
+  using traits = std::allocator_traits<page_allocator>;
+
+  auto number = key / page_size;
+  if (directory_.size() <= number || !directory_[number])
+    return;
+
+  auto *&ptr = directory_[number];
+  auto offset = key % page_size;
+  if (!ptr->live.test(offset))
+    return;
+
+  ptr->live.reset(offset);
+  --size_;
+
+  if (ptr->live.any())
+  {
+    std::destroy_at(&ptr->values[offset]);
+    std::construct_at(&ptr->values[offset]);
+    return;
+  }
+
+  traits::destroy(alloc_, ptr);
+  traits::deallocate(alloc_, ptr, 1);
+  ptr = nullptr;
+  --pages_;
+
+  while (!directory_.empty() && !directory_.back())
+    directory_.pop_back();
+}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+auto paged_table<T, Allocator, PageSize>::size() const noexcept -> size_type
+{
+  return size_;
+}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+auto paged_table<T, Allocator, PageSize>::pages() const noexcept -> size_type
+{
+  return pages_;
+}
+
+template <typename T, AllocatorLike Allocator, std::size_t PageSize>
+paged_table<T, Allocator, PageSize>::~paged_table()
+{
+  using traits = std::allocator_traits<page_allocator>;
+
+  for (auto *ptr : directory_)
+  {
+    if (ptr)
+    {
+      traits::destroy(alloc_, ptr);
+      traits::deallocate(alloc_, ptr, 1);
+    }
+  }
+}
+
+} // namespace io::execution::detail
+#endif // IO_PAGED_TABLE_HPP
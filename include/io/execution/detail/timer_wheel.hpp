@@ -0,0 +1,341 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file timer_wheel.hpp
+ * @brief This file defines a hierarchical timing wheel.
+ */
+#pragma once
+#ifndef IO_TIMER_WHEEL_HPP
+#define IO_TIMER_WHEEL_HPP
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+/**
+ * @namespace io::execution::detail
+ * @brief Implementation details of the execution components.
+ */
+namespace io::execution::detail {
+/** @brief An intrusive link in a timer wheel. */
+struct timer_node {
+  /** @brief The previous node in the slot. */
+  timer_node *prev = nullptr;
+  /** @brief The next node in the slot. */
+  timer_node *next = nullptr;
+  /** @brief The tick at which the timer expires. */
+  std::uint64_t expiry = 0;
+
+  /** @brief Checks if the node is in a wheel. */
+  [[nodiscard]] auto is_linked() const noexcept -> bool
+  {
+    return prev != nullptr;
+  }
+};
+
+/**
+ * @brief A hierarchical timing wheel with a resolution of one millisecond.
+ * @details The wheel has four levels of 256 slots. A timer is placed on the
+ * lowest level whose range covers its deadline, and timers are cascaded down
+ * a level when the level below wraps around, so inserting and erasing a
+ * timer are O(1) and memory use doesn't depend on the number of timers.
+ * Deadlines beyond the range of the wheel (about 49 days) are cascaded
+ * until they are in range.
+ *
+ * The wheel isn't thread-safe, and the nodes must stay alive until they
+ * expire or are erased.
+ */
+class timer_wheel {
+public:
+  /** @brief The clock type. */
+  using clock = std::chrono::steady_clock;
+  /** @brief The time point type. */
+  using time_point = clock::time_point;
+  /** @brief The duration of a tick. */
+  using tick_duration = std::chrono::milliseconds;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /** @brief The number of levels. */
+  static constexpr size_type levels = 4;
+  /** @brief The number of bits of a tick that index a level. */
+  static constexpr size_type slot_bits = 8;
+  /** @brief The number of slots in a level. */
+  static constexpr size_type slots = size_type{1} << slot_bits;
+
+  /**
+   * @brief Constructs an empty wheel.
+   * @param now The time of the wheel's first tick.
+   */
+  explicit timer_wheel(time_point now = clock::now()) noexcept : epoch_{now}
+  {
+    for (auto &level : slots_)
+    {
+      for (auto &slot : level)
+        slot.prev = slot.next = &slot;
+    }
+  }
+
+  /** @brief Deleted copy constructor. */
+  timer_wheel(const timer_wheel &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const timer_wheel &) -> timer_wheel & = delete;
+
+  /**
+   * @brief Inserts a timer.
+   * @details Deadlines that have already passed expire on the next tick.
+   * @param node The timer's node. It must not be in a wheel.
+   * @param deadline The time at which the timer expires.
+   */
+  auto insert(timer_node *node, time_point deadline) noexcept -> void
+  {
+    auto ticks = std::chrono::ceil<tick_duration>(deadline - epoch_).count();
+    node->expiry = ticks > static_cast<std::int64_t>(current_)
+                       ? static_cast<std::uint64_t>(ticks)
+                       : current_ + 1;
+    link(node);
+    ++size_;
+  }
+
+  /**
+   * @brief Erases a timer.
+   * @param node The timer's node. It must be in this wheel.
+   */
+  auto erase(timer_node *node) noexcept -> void
+  {
+    unlink(node);
+    --size_;
+  }
+
+  /**
+   * @brief Advances the wheel and expires the timers that are due.
+   * @tparam Fn A callable that accepts a `timer_node *`.
+   * @param now The current time.
+   * @param expire Called with each expired node after it is unlinked.
+   * @return The number of expired timers.
+   */
+  template <typename Fn>
+  auto advance(time_point now, Fn &&expire) -> size_type
+  {
+    auto elapsed = std::chrono::floor<tick_duration>(now - epoch_).count();
+    auto target = elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+
+    size_type count = 0;
+    while (current_ < target)
+    {
+      if (!size_)
+      {
+        current_ = target;
+        break;
+      }
+
+      current_ = std::min(target, next_tick());
+      for (auto level = levels - 1; level > 0; --level)
+      {
+        if (!(current_ & mask(level - 1)))
+          cascade(level, index(current_, level));
+      }
+
+      auto &head = slots_[0][index(current_, 0)];
+      while (head.next != &head)
+      {
+        auto *node = head.next;
+        erase(node);
+        expire(node);
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Gets the earliest time at which the wheel has work to do.
+   * @details This is either the deadline of a timer or the time at which
+   * timers are cascaded, so it is never later than the earliest deadline.
+   * @return The time, or nothing if the wheel is empty.
+   */
+  [[nodiscard]] auto next_expiry() const noexcept -> std::optional<time_point>
+  {
+    if (!size_)
+      return std::nullopt;
+    return epoch_ + tick_duration(next_tick());
+  }
+
+  /** @brief Returns the number of timers. */
+  [[nodiscard]] auto size() const noexcept -> size_type { return size_; }
+
+  /** @brief Checks if the wheel is empty. */
+  [[nodiscard]] auto empty() const noexcept -> bool { return !size_; }
+
+private:
+  /** @brief The number of 64-bit words in a level's bitmap. */
+  static constexpr size_type words = slots / 64;
+
+  /** @brief Gets the mask of the tick bits below a level. */
+  static constexpr auto mask(size_type level) noexcept -> std::uint64_t
+  {
+    return (std::uint64_t{1} << (slot_bits * (level + 1))) - 1;
+  }
+
+  /** @brief Gets the slot index of a tick on a level. */
+  static constexpr auto index(std::uint64_t tick,
+                              size_type level) noexcept -> size_type
+  {
+    return (tick >> (slot_bits * level)) & (slots - 1);
+  }
+
+  /**
+   * @brief Finds the next occupied slot of a level after a slot.
+   * @param level The level.
+   * @param from The slot to start after.
+   * @return The distance to the next occupied slot in 1 to `slots`, or 0 if
+   * the level is empty.
+   */
+  [[nodiscard]] auto next_occupied(size_type level,
+                                   size_type from) const noexcept -> size_type
+  {
+    const auto &bitmap = occupied_[level];
+    auto start = (from + 1) % slots;
+    auto offset = start % 64;
+    for (size_type i = 0; i <= words; ++i)
+    {
+      auto word = (start / 64 + i) % words;
+      auto bits = bitmap[word];
+      if (i == 0)
+        bits &= ~std::uint64_t{0} << offset;
+      if (i == words)
+        bits &= ~(~std::uint64_t{0} << offset);
+      if (bits)
+      {
+        auto slot = word * 64 + static_cast<size_type>(std::countr_zero(bits));
+        return (slot + slots - start) % slots + 1;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Gets the next tick at which a slot expires or cascades.
+   * @return The tick. The wheel must not be empty.
+   */
+  [[nodiscard]] auto next_tick() const noexcept -> std::uint64_t
+  {
+    auto next = ~std::uint64_t{0};
+    for (size_type level = 0; level < levels; ++level)
+    {
+      auto shift = slot_bits * level;
+      if (auto distance = next_occupied(level, index(current_, level)))
+        next = std::min(next, ((current_ >> shift) + distance) << shift);
+    }
+    return next;
+  }
+
+  /**
+   * @brief Links a node into the slot for its expiry.
+   * @param node The node to link.
+   */
+  auto link(timer_node *node) noexcept -> void
+  {
+    auto delta = node->expiry - current_;
+    size_type level = 0;
+    while (level < levels - 1 && delta > mask(level))
+      ++level;
+
+    auto slot = index(node->expiry, level);
+    if (delta > mask(levels - 1))
+      slot = index(current_, levels - 1);
+
+    auto &head = slots_[level][slot];
+    node->prev = head.prev;
+    node->next = &head;
+    head.prev->next = node;
+    head.prev = node;
+    occupied_[level][slot / 64] |= std::uint64_t{1} << (slot % 64);
+  }
+
+  /**
+   * @brief Unlinks a node from its slot.
+   * @param node The node to unlink.
+   */
+  auto unlink(timer_node *node) noexcept -> void
+  {
+    auto *next = node->next;
+    node->prev->next = next;
+    next->prev = node->prev;
+    node->prev = node->next = nullptr;
+
+    // The slot is empty if the node's successor is a head with no nodes.
+    if (next->next == next && is_head(next))
+      clear_bit(next);
+  }
+
+  /** @brief Checks if a node is the head of a slot. */
+  [[nodiscard]] auto is_head(const timer_node *node) const noexcept -> bool
+  {
+    const auto *first = &slots_[0][0];
+    const auto *last = &slots_[levels - 1][slots - 1];
+    return node >= first && node <= last;
+  }
+
+  /** @brief Clears the occupied bit of an empty slot. */
+  auto clear_bit(const timer_node *head) noexcept -> void
+  {
+    auto offset = static_cast<size_type>(head - &slots_[0][0]);
+    auto level = offset / slots;
+    auto slot = offset % slots;
+    occupied_[level][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+  }
+
+  /**
+   * @brief Moves the timers of a slot to lower levels.
+   * @param level The level of the slot.
+   * @param slot The slot.
+   */
+  auto cascade(size_type level, size_type slot) noexcept -> void
+  {
+    auto &head = slots_[level][slot];
+    if (head.next == &head)
+      return;
+
+    auto *node = head.next;
+    head.prev->next = nullptr;
+    head.prev = head.next = &head;
+    clear_bit(&head);
+
+    while (node)
+    {
+      auto *next = node->next;
+      link(node);
+      node = next;
+    }
+  }
+
+  /** @brief The slots of each level. */
+  std::array<std::array<timer_node, slots>, levels> slots_{};
+  /** @brief A bitmap of the occupied slots of each level. */
+  std::array<std::array<std::uint64_t, words>, levels> occupied_{};
+  /** @brief The time of tick 0. */
+  time_point epoch_;
+  /** @brief The last tick that was processed. */
+  std::uint64_t current_ = 0;
+  /** @brief The number of timers. */
+  size_type size_ = 0;
+};
+
+} // namespace io::execution::detail
+#endif // IO_TIMER_WHEEL_HPP
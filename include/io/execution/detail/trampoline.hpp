@@ -0,0 +1,108 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file trampoline.hpp
+ * @brief This file defines a trampoline that bounds the recursion of inline
+ * completions.
+ */
+#pragma once
+#ifndef IO_TRAMPOLINE_HPP
+#define IO_TRAMPOLINE_HPP
+#include <cstddef>
+namespace io::execution::detail {
+/**
+ * @brief Runs completions inline until they nest too deeply.
+ * @details A continuation that starts another operation which completes
+ * inline, such as a reader loop on a socket that always has data, recurses
+ * once per completion. Each thread counts how deeply the completions that it
+ * runs through the trampoline are nested. Beyond `max_depth`, a completion is
+ * queued instead, and the outermost completion on the thread runs the queue
+ * once it returns, so the stack depth stays bounded while the completions
+ * still run in the order they were started.
+ */
+class trampoline {
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+
+  /** @brief A completion that may be deferred by the trampoline. */
+  struct task {
+    /** @brief Runs the completion. */
+    void (*complete)(task *) noexcept = nullptr;
+    /** @brief The next deferred completion. */
+    task *next = nullptr;
+  };
+
+  /** @brief The number of completions that may be nested on a thread. */
+  static constexpr size_type max_depth = 16;
+
+  /**
+   * @brief Runs a completion now, or after the outermost completion returns.
+   * @param ptr The completion to run. It must stay valid until it has run.
+   */
+  static auto run(task *ptr) noexcept -> void;
+
+private:
+  /** @brief The state of the trampoline on one thread. */
+  struct frame {
+    /** @brief The number of nested completions. */
+    size_type depth = 0;
+    /** @brief The first deferred completion. */
+    task *head = nullptr;
+    /** @brief The last deferred completion. */
+    task *tail = nullptr;
+  };
+
+  /** @brief Gets the state of the trampoline on this thread. */
+  static auto local() noexcept -> frame &
+  {
+    thread_local frame state;
+    return state;
+  }
+};
+
+inline auto trampoline::run(task *ptr) noexcept -> void
+{
+  auto &state = local();
+  if (state.depth >= max_depth)
+  {
+    ptr->next = nullptr;
+    if (state.tail)
+      state.tail->next = ptr;
+    else
+      state.head = ptr;
+    state.tail = ptr;
+    return;
+  }
+
+  ++state.depth;
+  ptr->complete(ptr);
+
+  if (state.depth == 1)
+  {
+    while (auto *next = state.head)
+    {
+      state.head = next->next;
+      if (!state.head)
+        state.tail = nullptr;
+      next->complete(next);
+    }
+  }
+  --state.depth;
+}
+
+} // namespace io::execution::detail
+#endif // IO_TRAMPOLINE_HPP
@@ -0,0 +1,266 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file uring.hpp
+ * @brief This file defines a minimal io_uring instance.
+ * @details The instance is set up with the raw `io_uring_setup` and
+ * `io_uring_enter` system calls, so AsyncBerkeley does not depend on
+ * liburing.
+ */
+#pragma once
+#ifndef IO_URING_HPP
+#define IO_URING_HPP
+#include "immovable.hpp"
+#include "io/error.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+/**
+ * @namespace io::execution::detail
+ * @brief Implementation details of the execution components.
+ */
+namespace io::execution::detail {
+/**
+ * @brief An io_uring submission and completion queue pair.
+ * @details The submission queue is filled with `get_sqe()` and published to
+ * the kernel with `enter()`. Completions are consumed with `for_each_cqe()`.
+ * The caller is responsible for serializing access to the submission queue
+ * and to the completion queue.
+ */
+class uring : immovable {
+public:
+  /**
+   * @brief Sets up an io_uring instance.
+   * @param entries The requested number of submission queue entries.
+   * @throws std::system_error if the instance can't be set up or if the
+   * kernel doesn't support `IORING_FEAT_EXT_ARG`.
+   */
+  explicit uring(unsigned entries);
+
+  /**
+   * @brief Gets the next free submission queue entry.
+   * @details The entry is zeroed. It is submitted on the next call to
+   * `enter()`.
+   * @return A pointer to the entry, or nullptr if the submission queue is
+   * full.
+   */
+  auto get_sqe() noexcept -> io_uring_sqe *;
+
+  /**
+   * @brief Publishes the queued entries to the kernel.
+   * @return The number of published entries that the kernel hasn't consumed.
+   */
+  auto flush() noexcept -> unsigned;
+
+  /**
+   * @brief Submits published entries and optionally waits for a completion.
+   * @details Unlike the other members, this may be called concurrently with
+   * `get_sqe()` and `flush()`.
+   * @param to_submit The number of entries to submit.
+   * @param timeout The maximum time to wait for a completion in milliseconds.
+   * A negative value waits indefinitely and 0 doesn't wait.
+   * @return The number of entries submitted, or -1 with errno set on error.
+   * Timing out is not an error.
+   */
+  auto enter(unsigned to_submit, int timeout) noexcept -> int;
+
+  /**
+   * @brief Consumes all available completion queue entries.
+   * @tparam Fn A callable that accepts a `const io_uring_cqe &`.
+   * @param func The callable to invoke for each entry.
+   * @return The number of entries consumed.
+   */
+  template <typename Fn> auto for_each_cqe(Fn &&func) -> unsigned;
+
+  /** @brief Unmaps the queues and closes the instance. */
+  ~uring();
+
+private:
+  /** @brief Loads a value shared with the kernel. */
+  static auto load_acquire(unsigned *ptr) noexcept -> unsigned
+  {
+    return std::atomic_ref<unsigned>(*ptr).load(std::memory_order_acquire);
+  }
+
+  /** @brief Stores a value shared with the kernel. */
+  static auto store_release(unsigned *ptr, unsigned value) noexcept -> void
+  {
+    std::atomic_ref<unsigned>(*ptr).store(value, std::memory_order_release);
+  }
+
+  /** @brief Gets a pointer at an offset into a mapped ring. */
+  template <typename T>
+  static auto at(void *ring, std::uint32_t offset) noexcept -> T *
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+  }
+
+  /** @brief Unmaps the queues and closes the instance. */
+  auto release() noexcept -> void;
+
+  /** @brief The parameters returned by io_uring_setup. */
+  io_uring_params params_{};
+  /** @brief The io_uring file descriptor. */
+  int fd_ = -1;
+  /** @brief The size of the submission queue mapping. */
+  std::size_t sq_size_ = 0;
+  /** @brief The size of the completion queue mapping. */
+  std::size_t cq_size_ = 0;
+  /** @brief The submission queue mapping. */
+  void *sq_ring_ = MAP_FAILED;
+  /** @brief The completion queue mapping. */
+  void *cq_ring_ = MAP_FAILED;
+  /** @brief The submission queue entries. */
+  io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+  /** @brief The local submission queue tail. */
+  unsigned sqe_tail_ = 0;
+};
+
+inline uring::uring(unsigned entries)
+    : fd_{static_cast<int>(syscall(__NR_io_uring_setup, entries, &params_))}
+{
+  if (fd_ < 0)
+    throw_system_error(IO_ERROR_MESSAGE("io_uring_setup failed."));
+
+  if (!(params_.features & IORING_FEAT_EXT_ARG))
+  {
+    release();
+    throw std::system_error(std::make_error_code(std::errc::not_supported),
+                            IO_ERROR_MESSAGE("io_uring is too old."));
+  }
+
+  sq_size_ = params_.sq_off.array + (params_.sq_entries * sizeof(unsigned));
+  cq_size_ =
+      params_.cq_off.cqes + (params_.cq_entries * sizeof(io_uring_cqe));
+  if (params_.features & IORING_FEAT_SINGLE_MMAP)
+    sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+  constexpr auto prot = PROT_READ | PROT_WRITE;
+  constexpr auto flags = MAP_SHARED | MAP_POPULATE;
+  sq_ring_ = mmap(nullptr, sq_size_, prot, flags, fd_, IORING_OFF_SQ_RING);
+  cq_ring_ = (params_.features & IORING_FEAT_SINGLE_MMAP)
+                 ? sq_ring_
+                 : mmap(nullptr, cq_size_, prot, flags, fd_,
+                        IORING_OFF_CQ_RING);
+  sqes_ = static_cast<io_uring_sqe *>(
+      mmap(nullptr, params_.sq_entries * sizeof(io_uring_sqe), prot, flags,
+           fd_, IORING_OFF_SQES));
+
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED ||
+      sqes_ == MAP_FAILED)
+  {
+    auto error = errno;
+    release();
+    throw std::system_error(error, std::system_category(),
+                            IO_ERROR_MESSAGE("io_uring mmap failed."));
+  }
+
+  sqe_tail_ = load_acquire(at<unsigned>(sq_ring_, params_.sq_off.tail));
+}
+
+inline auto uring::get_sqe() noexcept -> io_uring_sqe *
+{
+  auto head = load_acquire(at<unsigned>(sq_ring_, params_.sq_off.head));
+  if (sqe_tail_ - head >= params_.sq_entries)
+    return nullptr;
+
+  auto mask = *at<unsigned>(sq_ring_, params_.sq_off.ring_mask);
+  auto index = sqe_tail_++ & mask;
+  at<unsigned>(sq_ring_, params_.sq_off.array)[index] = index;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  auto *sqe = sqes_ + index;
+  *sqe = {};
+  return sqe;
+}
+
+inline auto uring::flush() noexcept -> unsigned
+{
+  store_release(at<unsigned>(sq_ring_, params_.sq_off.tail), sqe_tail_);
+  return sqe_tail_ - load_acquire(at<unsigned>(sq_ring_, params_.sq_off.head));
+}
+
+inline auto uring::enter(unsigned to_submit, int timeout) noexcept -> int
+{
+  unsigned wait_nr = timeout ? 1 : 0;
+  unsigned flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+  if (!to_submit && !wait_nr)
+    return 0;
+
+  __kernel_timespec ts = {.tv_sec = timeout / 1000,
+                          .tv_nsec = (timeout % 1000) * 1000000LL};
+  io_uring_getevents_arg arg = {.ts = reinterpret_cast<std::uintptr_t>(&ts)};
+  void *argp = nullptr;
+  std::size_t argsz = 0;
+  if (timeout > 0)
+  {
+    flags |= IORING_ENTER_EXT_ARG;
+    argp = &arg;
+    argsz = sizeof(arg);
+  }
+
+  auto ret =
+      syscall(__NR_io_uring_enter, fd_, to_submit, wait_nr, flags, argp, argsz);
+  if (ret < 0 && errno == ETIME)
+    return 0;
+
+  return static_cast<int>(ret);
+}
+
+template <typename Fn> auto uring::for_each_cqe(Fn &&func) -> unsigned
+{
+  auto *head = at<unsigned>(cq_ring_, params_.cq_off.head);
+  auto tail = load_acquire(at<unsigned>(cq_ring_, params_.cq_off.tail));
+  auto mask = *at<unsigned>(cq_ring_, params_.cq_off.ring_mask);
+  auto *cqes = at<io_uring_cqe>(cq_ring_, params_.cq_off.cqes);
+
+  auto first = *head;
+  for (auto index = first; index != tail; ++index)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    func(cqes[index & mask]);
+  }
+
+  store_release(head, tail);
+  return tail - first;
+}
+
+inline uring::~uring() { release(); }
+
+inline auto uring::release() noexcept -> void
+{
+  if (sqes_ != MAP_FAILED)
+    munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_size_);
+
+  if (sq_ring_ != MAP_FAILED)
+    munmap(sq_ring_, sq_size_);
+
+  if (fd_ >= 0)
+    ::close(fd_);
+}
+
+} // namespace io::execution::detail
+#endif // IO_URING_HPP
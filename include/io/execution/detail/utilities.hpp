@@ -21,7 +21,14 @@
 #ifndef IO_UTILITIES_HPP
 #define IO_UTILITIES_HPP
 #include "io/detail/concepts.hpp"
+#include "io/error.hpp"
+#include "io/socket/socket_handle.hpp"
+#include "io/socket/socket_option.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <system_error>
 #include <type_traits>
 
 /**
@@ -45,5 +52,111 @@ auto with_lock(Lock &mtx, Fn &&func) -> decltype(auto)
   return std::forward<Fn>(func)();
 }
 
+/**
+ * @brief Executes all tasks in a queue.
+ * @tparam Queue The intrusive task queue type.
+ * @param queue The queue of tasks to execute.
+ */
+template <typename Queue> auto run_queue(Queue &queue) -> void
+{
+  while (!queue.is_empty())
+  {
+    auto *task = queue.pop();
+    task->execute();
+  }
+}
+
+/**
+ * @brief Moves the operations that wait in a queue to a ready queue.
+ * @details Ready operations can no longer be cancelled.
+ * @tparam Operation The operation type.
+ * @tparam Queue The queue type.
+ * @param queue The queue that the operations wait in.
+ * @param ready The queue to which the operations will be moved.
+ */
+template <typename Operation, typename Queue>
+auto release_operations(Queue &queue, Queue &ready) noexcept -> void
+{
+  while (!queue.is_empty())
+  {
+    auto *op = static_cast<Operation *>(queue.pop());
+    op->queue = nullptr;
+    ready.push(op);
+  }
+}
+
+/**
+ * @brief Checks if the error is recoverable.
+ *
+ * This function checks if the error set by getsockopt is a recoverable
+ * one. If it is recoverable, return the value. Otherwise throw an exception.
+ *
+ * @param error The error code to test.
+ * @returns The error code to set on the socket.
+ */
+inline auto handle_getsockopt_error(std::error_code error) -> int
+{
+  if (error != std::errc::bad_file_descriptor &&
+      error != std::errc::not_a_socket)
+  {
+    throw_system_error(IO_ERROR_MESSAGE("getsockopt failed."));
+  }
+
+  return error.value();
+}
+
+/**
+ * @brief Gets the socket error and sets it on the socket handle.
+ * @details This function gets the value of the SO_ERROR socket option and sets
+ * it on the socket handle. This is used to get the error that occurred during
+ * an asynchronous operation.
+ * @param socket The socket handle to set the error on.
+ */
+inline auto set_error(::io::socket::socket_handle &socket) -> void
+{
+  using socket_option = ::io::socket::socket_option<int>;
+
+  socket_option error{0};
+  auto [ret, optval] = ::io::getsockopt(socket, SOL_SOCKET, SO_ERROR, error);
+  if (ret)
+    *error = handle_getsockopt_error({errno, std::system_category()});
+  socket.set_error(*error);
+}
+
+namespace detail {
+
+/**
+ * @brief Calculates the remaining duration from a start time and updates the
+ * start time.
+ *
+ * This function measures the time elapsed since the `start` time_point,
+ * subtracts it from the initial `duration`, and returns the remaining time. It
+ * also updates the `start` time_point to the current time.
+ *
+ * @tparam Clock The clock type used for the time_point.
+ * @tparam Duration The duration type used for the time_point.
+ * @param duration The initial duration in milliseconds.
+ * @param[in,out] start The time_point marking the beginning of the duration.
+ * This parameter is updated to the current time (`Clock::now()`) on each call.
+ * @return The remaining time in milliseconds, guaranteed to be non-negative.
+ */
+template <typename Clock, typename Duration>
+auto remaining_duration(int duration,
+                        std::chrono::time_point<Clock, Duration> &start) -> int
+{
+  using clock = std::decay_t<decltype(start)>::clock;
+  static constexpr auto to_milliseconds = [](const auto &duration) -> int {
+    using namespace std::chrono;
+
+    return duration_cast<milliseconds>(duration).count();
+  };
+
+  auto old_start = start;
+  start = clock::now();
+  return std::max(0, duration - to_milliseconds(start - old_start));
+}
+
+} // namespace detail
+
 } // namespace io::execution
 #endif // IO_UTILITIES_HPP
@@ -0,0 +1,169 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file work_stealing_deque.hpp
+ * @brief This file defines a bounded Chase-Lev work-stealing deque.
+ */
+#pragma once
+#ifndef IO_WORK_STEALING_DEQUE_HPP
+#define IO_WORK_STEALING_DEQUE_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+/**
+ * @namespace io::execution::detail
+ * @brief Implementation details of the execution components.
+ */
+namespace io::execution::detail {
+/**
+ * @brief A bounded Chase-Lev deque of pointers.
+ * @details The owner pushes and pops at the bottom of the deque while any
+ * number of thieves steal from the top. The memory orderings follow Lê et
+ * al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+ *
+ * The deque doesn't grow. `reset` sets the capacity, and must not be called
+ * concurrently with any other member function.
+ * @tparam T The pointee type.
+ */
+template <typename T> class work_stealing_deque {
+public:
+  /** @brief The value type. */
+  using value_type = T *;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /** @brief Constructs an empty deque with no capacity. */
+  work_stealing_deque() = default;
+
+  /** @brief Deleted copy constructor. */
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const work_stealing_deque &) -> work_stealing_deque & = delete;
+
+  /**
+   * @brief Empties the deque and makes room for at least `capacity` values.
+   * @param capacity The number of values the deque must hold.
+   */
+  auto reset(size_type capacity) -> void
+  {
+    if (capacity > capacity_)
+    {
+      buffer_ = std::make_unique<std::atomic<value_type>[]>(capacity);
+      capacity_ = capacity;
+    }
+    top_.store(0, std::memory_order_relaxed);
+    bottom_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pushes a value onto the bottom of the deque.
+   * @note Only the owner may push, and the deque must not be full.
+   * @param value The value to push.
+   */
+  auto push(value_type value) noexcept -> void
+  {
+    auto bottom = bottom_.load(std::memory_order_relaxed);
+    slot(bottom).store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pops a value from the bottom of the deque.
+   * @note Only the owner may pop.
+   * @return The value, or nullptr if the deque is empty.
+   */
+  auto pop() noexcept -> value_type
+  {
+    auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    auto *value = slot(bottom).load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+      // The last value; race the thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+      {
+        value = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  /**
+   * @brief Steals a value from the top of the deque.
+   * @details May be called by any thread.
+   * @return The value, or nullptr if the deque is empty or the steal lost a
+   * race with another thread.
+   */
+  auto steal() noexcept -> value_type
+  {
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+      return nullptr;
+
+    auto *value = slot(top).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+    {
+      return nullptr;
+    }
+    return value;
+  }
+
+  /** @brief Returns the capacity of the deque. */
+  [[nodiscard]] auto capacity() const noexcept -> size_type
+  {
+    return capacity_;
+  }
+
+private:
+  /**
+   * @brief Gets the slot for an index.
+   * @param index The index.
+   * @return The slot.
+   */
+  auto slot(std::int64_t index) noexcept -> std::atomic<value_type> &
+  {
+    return buffer_[static_cast<size_type>(index) % capacity_];
+  }
+
+  /** @brief The index of the next value to steal. */
+  alignas(64) std::atomic<std::int64_t> top_ = 0;
+  /** @brief The index one past the last value. */
+  alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+  /** @brief The values. */
+  std::unique_ptr<std::atomic<value_type>[]> buffer_;
+  /** @brief The number of slots in the buffer. */
+  size_type capacity_ = 0;
+};
+
+} // namespace io::execution::detail
+#endif // IO_WORK_STEALING_DEQUE_HPP
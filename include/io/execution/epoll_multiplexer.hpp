@@ -0,0 +1,399 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file epoll_multiplexer.hpp
+ * @brief This file defines the epoll multiplexer.
+ * @details The epoll multiplexer is a Linux specific multiplexer that
+ * keeps the interest list registered in the kernel between waits. This
+ * means that the cost of a wakeup is proportional to the number of ready
+ * file descriptors rather than the number of registered file descriptors.
+ */
+#pragma once
+#ifndef IO_EPOLL_MULTIPLEXER_HPP
+#define IO_EPOLL_MULTIPLEXER_HPP
+#include "detail/event_notifier.hpp"
+#include "detail/execution_trigger.hpp"
+#include "detail/null_mutex.hpp"
+#include "detail/paged_table.hpp"
+#include "multiplexer.hpp"
+#include "timer_queue.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+
+#include <sys/epoll.h>
+// Forward declarations.
+namespace io::socket {
+class socket_handle;
+} // namespace io::socket
+
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief Tag type for an epoll multiplexer.
+ * @details This tag type is used to specialize the `basic_multiplexer`
+ * template for an epoll multiplexer.
+ */
+struct epoll_t {
+  /** @brief The multiplexed event type. */
+  using event_type = struct epoll_event;
+  /** @brief The type used to specify timeouts. */
+  using interval_type = std::chrono::milliseconds;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+  /**
+   * @brief Type trait to check if an operation should evaluate eagerly.
+   * @tparam Op The operation to check.
+   */
+  template <typename Op> struct is_eager_t : public std::false_type {};
+  /**
+   * @brief Helper variable template for is_eager_t.
+   * @tparam Op The type to check.
+   */
+  template <typename Op>
+  static constexpr bool is_eager_v = is_eager_t<Op>::value;
+};
+
+/**
+ * @brief A multiplexer that uses the Linux `epoll` API.
+ * @details This class is a concrete implementation of the `basic_multiplexer`
+ * that uses `epoll` to wait for I/O events. Interest in a file descriptor is
+ * registered when the first operation is started on it and it is only
+ * modified when the set of pending operations on the file descriptor changes.
+ * The kernel applies interest registered by another thread to a blocked
+ * `epoll_wait`, so the internal notifier only serves `notify()`.
+ * @tparam Allocator The allocator to use for all allocations.
+ * @tparam Mutex The mutex type. Use `null_mutex` if the multiplexer is only
+ * used from a single thread.
+ */
+template <AllocatorLike Allocator = std::allocator<char>,
+          BasicLockable Mutex = std::mutex>
+class basic_epoll_multiplexer : public basic_multiplexer<epoll_t> {
+public:
+  /** @brief The base class for the multiplexer. */
+  using Base = basic_multiplexer<epoll_t>;
+  /** @brief The mutex type. */
+  using mutex = Mutex;
+  /** @brief The socket handle type. */
+  using socket_handle = ::io::socket::socket_handle;
+  /** @brief The task type. */
+  using task = Base::intrusive_task_queue::task;
+  /** @brief The timer queue type. */
+  using timer_queue = basic_timer_queue<task, Mutex>;
+  /** @brief The clock type of the timers. */
+  using clock_type = typename timer_queue::clock;
+  /** @brief The time point type of the timers. */
+  using time_point = typename timer_queue::time_point;
+  /** @brief The timer sender type. */
+  using timer_sender =
+      typename timer_queue::template sender<basic_epoll_multiplexer>;
+  /** @brief The native socket type. */
+  using native_socket_type = ::io::socket::native_socket_type;
+  /** @brief The allocator type. */
+  using allocator_type = Allocator;
+
+  /** @brief The maximum number of events handled by one call to wait_for. */
+  static constexpr int max_events = 128;
+
+  /**
+   * @brief Demultiplexes I/O operations for a socket.
+   * @details This struct contains the read and write queues for a socket, and
+   * the interest set that is currently registered with the kernel.
+   */
+  struct demultiplexer {
+    /** @brief Pending read operations. */
+    intrusive_task_queue read_queue;
+    /** @brief Pending write operations. */
+    intrusive_task_queue write_queue;
+    /** @brief Pending error queue operations. */
+    intrusive_task_queue error_queue;
+
+    /**
+     * @brief Associated socket used for setting and getting errors.
+     * @note Only valid when the operation state is valid.
+     */
+    socket_handle *socket = nullptr;
+
+    /**
+     * @brief The socket that owns the registered interest set.
+     * @details File descriptors are recycled by the kernel, so this is used
+     * to detect when a new socket has been assigned to the same descriptor.
+     */
+    std::weak_ptr<socket_handle> owner;
+
+    /** @brief The events registered with the kernel. */
+    std::uint32_t events = 0;
+  };
+
+  /** @brief The allocator for the map. */
+  using map_allocator =
+      std::allocator_traits<Allocator>::template rebind_alloc<demultiplexer>;
+  /** @brief The map type. */
+  using map_type = detail::paged_table<demultiplexer, map_allocator>;
+
+  /**
+   * @brief The base of the operation states that wait in a demultiplexer.
+   * @details The members are guarded by the multiplexer's mutex.
+   */
+  struct operation : public task {
+    /** @brief The queue that the operation waits in, if any. */
+    intrusive_task_queue *queue = nullptr;
+    /** @brief True if the operation was cancelled before it was queued. */
+    bool cancelled = false;
+  };
+
+  /**
+   * @brief A sender for the epoll multiplexer.
+   * @details This sender is used to submit I/O operations to the multiplexer.
+   * It will complete when the I/O operation is ready, or with
+   * `set_stopped()` if a stop is requested while it is waiting.
+   * @tparam Fn The function type.
+   */
+  template <Completion Fn> struct sender {
+    /** @brief The sender concept type. */
+    using sender_concept = stdexec::sender_t;
+    /** @brief The completion signatures for the sender. */
+    using completion_signatures = stdexec::completion_signatures<
+        stdexec::set_value_t(typename std::invoke_result_t<Fn>::value_type),
+        stdexec::set_error_t(std::error_code), stdexec::set_stopped_t()>;
+
+    /**
+     * @brief An operation state for the epoll multiplexer.
+     * @details This struct contains the state for an I/O operation. It is
+     * created when a sender is connected to a receiver.
+     * @tparam Receiver The receiver type.
+     */
+    template <typename Receiver> struct state : public operation {
+      /** @brief Cancels the operation when a stop is requested. */
+      struct on_stop {
+        /** @brief The operation to cancel. */
+        state *self;
+        /** @brief Cancels the operation. */
+        auto operator()() const noexcept -> void;
+      };
+
+      /** @brief The stop token type of the receiver. */
+      using stop_token =
+          stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+      /** @brief The stop callback type. */
+      using stop_callback = stdexec::stop_callback_for_t<stop_token, on_stop>;
+
+      /**
+       * @brief Completes the operation.
+       * @param task_ptr The task to complete.
+       */
+      static auto complete(task *task_ptr) noexcept -> void;
+      /** @brief Starts the operation. */
+      auto start() noexcept -> void;
+
+      /** @brief The completion handler. */
+      Fn func;
+      /** @brief The socket to operate on. */
+      std::shared_ptr<socket_handle> socket;
+      /** @brief The receiver to complete. */
+      Receiver receiver{};
+      /** @brief The multiplexer to register the operation with. */
+      basic_epoll_multiplexer *mux = nullptr;
+      /** @brief The epoll trigger. */
+      execution_trigger trigger{};
+      /** @brief Cancels the operation on a stop request. */
+      std::optional<stop_callback> callback;
+    };
+
+    /**
+     * @brief Connects the sender to a receiver.
+     * @param receiver The receiver to connect to.
+     * @return The operation state.
+     */
+    template <typename Receiver>
+    auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>;
+
+    /** @brief The completion handler. */
+    Fn func;
+    /** @brief The socket to operate on. */
+    std::shared_ptr<socket_handle> socket;
+    /** @brief The multiplexer to submit the operation to. */
+    basic_epoll_multiplexer *mux = nullptr;
+    /** @brief The epoll trigger. */
+    execution_trigger trigger{};
+  };
+
+  /**
+   * @brief Waits for events to occur.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @return The number of events that occurred.
+   */
+  auto wait_for(interval_type interval) -> size_type;
+
+  /**
+   * @brief Waits for events to occur and hands the ready operations to a
+   * dispatcher instead of executing them.
+   * @details `dispatch(key, queue)` is called once for each socket that has
+   * ready operations, while the multiplexer's mutex is held. `key` identifies
+   * the socket and `queue` holds its ready operations. `dispatch` must move
+   * the operations out of `queue` without executing them or calling back into
+   * the multiplexer.
+   * Expired timers are handed over together, keyed by the multiplexer's
+   * notifier, which is never the key of a socket.
+   * @tparam Fn The dispatcher type.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @param dispatch Takes the ready operations of a socket.
+   * @return The number of events that occurred.
+   */
+  template <typename Fn>
+  auto wait_for(interval_type interval, Fn &&dispatch) -> size_type;
+
+  /**
+   * @brief Sets a completion handler for an event.
+   * @param socket The socket to set the completion handler for.
+   * @param trigger The event type to trigger on.
+   * @param func The completion handler.
+   * @return A sender that will complete when the event occurs.
+   */
+  template <Completion Fn>
+  auto set(std::shared_ptr<socket_handle> socket, execution_trigger trigger,
+           Fn &&func) -> sender<std::decay_t<Fn>>;
+
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @param deadline The deadline.
+   * @return A sender that completes with `set_value()` at the deadline, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  auto schedule_at(time_point deadline) -> timer_sender;
+
+  /**
+   * @brief Creates a sender that completes after a delay.
+   * @param delay The delay.
+   * @return A sender that completes with `set_value()` after the delay, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  template <typename Rep, typename Period>
+  auto schedule_after(std::chrono::duration<Rep, Period> delay)
+      -> timer_sender
+  {
+    using duration = typename clock_type::duration;
+    return schedule_at(clock_type::now() +
+                       std::chrono::duration_cast<duration>(delay));
+  }
+
+  /**
+   * @brief Wakes up a thread that is blocked in `wait_for`.
+   * @details Notifications are coalesced, so a burst of notifications wakes
+   * the waiting thread up once.
+   */
+  auto notify() -> void;
+
+  /**
+   * @brief Default constructor.
+   * @param alloc The allocator to use for all allocations.
+   * @throws std::system_error if the epoll instance or the notifier can't be
+   * created.
+   */
+  explicit basic_epoll_multiplexer(const Allocator &alloc = Allocator());
+
+  /**
+   * @brief Gets the allocator.
+   * @return A copy of the allocator the multiplexer was constructed with.
+   */
+  [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+  {
+    return alloc_;
+  }
+
+  /** @brief Deleted copy constructor. */
+  basic_epoll_multiplexer(const basic_epoll_multiplexer &) = delete;
+
+  /** @brief Deleted copy assignment. */
+  auto operator=(const basic_epoll_multiplexer &)
+      -> basic_epoll_multiplexer & = delete;
+
+  /** @brief Closes the epoll instance. */
+  ~basic_epoll_multiplexer();
+
+private:
+  /**
+   * @brief Registers interest in a trigger for the demultiplexer's socket.
+   * @note Must be called while holding the mutex.
+   * @param demux The demultiplexer to register interest for.
+   * @param socket The socket that owns the pending operation.
+   * @param trigger The trigger to register interest in.
+   * @return 0 on success, otherwise the error number.
+   */
+  auto arm(demultiplexer &demux, const std::shared_ptr<socket_handle> &socket,
+           execution_trigger trigger) -> int;
+
+  /**
+   * @brief Drops interest in triggers that no longer have pending operations.
+   * @note Must be called while holding the mutex.
+   * @param fd The file descriptor of the demultiplexer to update.
+   */
+  auto disarm(native_socket_type fd) -> void;
+
+  /**
+   * @brief Cancels an operation.
+   * @details If the operation is waiting in a demultiplexer, it is removed
+   * and the socket's interest in the operation's trigger is dropped when no
+   * other operations wait for it.
+   * @param op The operation to cancel.
+   * @param fd The socket of the operation.
+   * @return True if the operation was removed.
+   */
+  auto cancel(operation *op, native_socket_type fd) -> bool;
+
+  /** @brief A map of file descriptors to demultiplexers. */
+  map_type demux_;
+  /** @brief The number of demultiplexers with a registered interest set. */
+  size_type active_ = 0;
+  /** @brief Wakes up a blocked wait. */
+  detail::event_notifier notifier_;
+  /** @brief The timers. */
+  timer_queue timers_;
+  /** @brief The epoll file descriptor. */
+  int epfd_ = -1;
+  /** @brief The allocator. */
+  [[no_unique_address]] allocator_type alloc_;
+  /** @brief A mutex for thread safety. */
+  mutable mutex mtx_;
+};
+
+/**
+ * @brief A multiplexer that uses `epoll` with the default allocator.
+ */
+using epoll_multiplexer = basic_epoll_multiplexer<>;
+
+namespace pmr {
+/**
+ * @brief A multiplexer that uses `epoll` and allocates from a
+ * `std::pmr::memory_resource`.
+ */
+using epoll_multiplexer =
+    basic_epoll_multiplexer<std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
+
+} // namespace io::execution
+
+#include "io/execution/impl/epoll_multiplexer_impl.hpp" // IWYU pragma: export
+
+#endif // IO_EPOLL_MULTIPLEXER_HPP
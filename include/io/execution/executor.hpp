@@ -20,14 +20,20 @@
 #pragma once
 #ifndef IO_EXECUTOR_HPP
 #define IO_EXECUTOR_HPP
+#include "detail/eager_budget.hpp"
 #include "io/detail/concepts.hpp"
 #include "io/detail/customization.hpp"
 #include "io/error.hpp"
+#include "io/socket/buffer_pool.hpp"
+#include "io/socket/connection_arena.hpp"
 #include "io/socket/socket_handle.hpp"
 
 #include <exec/async_scope.hpp>
 #include <stdexec/execution.hpp>
 
+#include <concepts>
+#include <memory>
+#include <memory_resource>
 #include <utility>
 // Forward declarations
 namespace io::execution {
@@ -59,8 +65,21 @@ template <Multiplexer Mux> class executor : public Mux {
    * @brief The type of async_scope
    */
   using async_scope = exec::async_scope;
+  /**
+   * @internal
+   * @brief The type of the receive buffer pool.
+   */
+  using buffer_pool = ::io::socket::buffer_pool;
+  /**
+   * @internal
+   * @brief The type of the per-connection arena.
+   */
+  using connection_arena = ::io::socket::connection_arena;
 
 public:
+  /** @brief The eager budget statistics type. */
+  using eager_statistics = detail::eager_budget::statistics;
+
   /** @brief Use the base class constructor. */
   using Mux::Mux;
   /**
@@ -85,13 +104,33 @@ public:
   }
   /**
    * @brief Pushes a socket handle to the collection.
+   * @details The handle is allocated with the multiplexer's allocator.
    * @param handle The socket handle to push.
    * @return A weak pointer to the pushed socket handle.
    */
+  template <SocketLike Socket> auto push(Socket &&handle) -> decltype(auto)
+  {
+    return push(std::allocate_shared<Socket>(Mux::get_allocator(),
+                                             std::forward<Socket>(handle)));
+  }
+  /**
+   * @brief Pushes a socket handle that is allocated from an arena.
+   * @tparam Socket A socket handle like object.
+   * @param handle The socket handle to push.
+   * @param arena The arena, or nullptr to use the multiplexer's allocator.
+   * @return A shared pointer to the pushed socket handle. Its control block
+   * keeps the arena alive.
+   */
   template <SocketLike Socket>
-  static auto push(Socket &&handle) -> decltype(auto)
+  auto push(Socket &&handle, const std::shared_ptr<connection_arena> &arena)
+      -> decltype(auto)
   {
-    return push(std::make_shared<Socket>(std::forward<Socket>(handle)));
+    using allocator = ::io::socket::arena_allocator<Socket>;
+    if (!arena)
+      return push(std::forward<Socket>(handle));
+
+    return push(std::allocate_shared<Socket>(allocator(arena),
+                                             std::forward<Socket>(handle)));
   }
   /**
    * @brief Emplaces a socket handle in the collection.
@@ -99,7 +138,7 @@ public:
    * @return A shared pointer to the emplaced socket handle.
    */
   template <typename... Args>
-  static auto emplace(Args &&...args) -> std::shared_ptr<socket_handle>
+  auto emplace(Args &&...args) -> std::shared_ptr<socket_handle>
   {
     return push(socket_handle{std::forward<Args>(args)...});
   }
@@ -113,11 +152,127 @@ public:
   {
     return scope_.nest(Mux::set(std::forward<Args>(args)...));
   }
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @tparam TimePoint The time point type.
+   * @param deadline The deadline.
+   * @return A timer sender, scoped to the lifetime of the executor.
+   */
+  template <typename TimePoint>
+  auto schedule_at(TimePoint deadline) -> decltype(auto)
+  {
+    return scope_.nest(Mux::schedule_at(deadline));
+  }
+  /**
+   * @brief Creates a sender that completes after a delay.
+   * @tparam Duration The duration type.
+   * @param delay The delay.
+   * @return A timer sender, scoped to the lifetime of the executor.
+   */
+  template <typename Duration>
+  auto schedule_after(Duration delay) -> decltype(auto)
+  {
+    return scope_.nest(Mux::schedule_after(delay));
+  }
   /**
    * @brief Sends a notice when the executor is empty.
    * @returns A sender that notifies when the executor is empty.
    */
   [[nodiscard]] auto on_empty() -> decltype(auto) { return scope_.on_empty(); }
+  /**
+   * @brief Starts a detached operation in the executor's scope.
+   * @tparam Sender The sender type. It must not complete with an error.
+   * @param sender The sender to start.
+   */
+  template <typename Sender> auto spawn(Sender &&sender) -> void
+  {
+    scope_.spawn(std::forward<Sender>(sender));
+  }
+  /**
+   * @brief Decides whether an eager operation may complete inline.
+   * @param socket The socket the operation runs on.
+   * @return true if the operation may call into the socket API now, false
+   * if it must wait for readiness on the multiplexer.
+   */
+  auto try_eager(const socket_handle &socket) noexcept -> bool
+  {
+    return eager_.try_acquire(&socket);
+  }
+  /**
+   * @brief Configures the eager budget.
+   * @param budget The number of consecutive inline completions before an
+   * operation is sent through the multiplexer. Zero disables eager
+   * completions.
+   * @param socket_limit The number of consecutive inline completions on the
+   * same socket before an operation is sent through the multiplexer.
+   */
+  auto set_eager_budget(std::size_t budget,
+                        std::size_t socket_limit =
+                            detail::eager_budget::default_socket_limit) noexcept
+      -> void
+  {
+    eager_.set_limits(budget, socket_limit);
+  }
+  /**
+   * @brief Gets the eager budget statistics.
+   * @return How often operations completed inline and how often the budget
+   * forced a fallback to the multiplexer.
+   */
+  [[nodiscard]] auto eager_stats() const noexcept -> eager_statistics
+  {
+    return eager_.stats();
+  }
+  /**
+   * @brief Gets the pool that receives take their buffers from.
+   * @return The executor's buffer pool.
+   */
+  [[nodiscard]] auto buffers() const noexcept
+      -> const std::shared_ptr<buffer_pool> &
+  {
+    return buffers_;
+  }
+  /**
+   * @brief Replaces the buffer pool, for example to change the buffer size or
+   * to share one pool between executors.
+   * @details Buffers taken from the previous pool stay valid.
+   * @param pool The new buffer pool. It must not be nullptr.
+   */
+  auto set_buffers(std::shared_ptr<buffer_pool> pool) noexcept -> void
+  {
+    buffers_ = std::move(pool);
+  }
+  /**
+   * @brief Gets the pool that connection arenas take their blocks from.
+   * @return The pool, or nullptr if accepted connections don't get an arena.
+   */
+  [[nodiscard]] auto arena_blocks() const noexcept
+      -> const std::shared_ptr<buffer_pool> &
+  {
+    return arenas_;
+  }
+  /**
+   * @brief Gives every accepted connection its own arena.
+   * @details The socket handle, and the write queue and zero-copy tracker of
+   * the connection's dialogs, are then allocated from the arena, which is
+   * given back to the pool in one go when the last reference to the socket
+   * is dropped. Arenas are disabled by default.
+   * @param blocks The pool the arenas take their blocks from, or nullptr to
+   * disable arenas. Its buffer size is the block size of the arenas, such as
+   * `connection_arena::default_block_size`.
+   */
+  auto set_arena_blocks(std::shared_ptr<buffer_pool> blocks) noexcept -> void
+  {
+    arenas_ = std::move(blocks);
+  }
+  /**
+   * @brief Makes the arena for a new connection.
+   * @throws std::bad_alloc if a block can't be taken from the pool.
+   * @return The arena, or nullptr if arenas are disabled.
+   */
+  [[nodiscard]] auto make_arena() const -> std::shared_ptr<connection_arena>
+  {
+    return arenas_ ? connection_arena::make(arenas_) : nullptr;
+  }
 
 private:
   /**
@@ -134,6 +289,36 @@ private:
    * @return The number of events that occurred.
    */
   constexpr auto wait() -> decltype(auto) { return wait_for(); }
+  /** @brief The budget for eager operations. */
+  detail::eager_budget eager_;
+  /**
+   * @brief Makes the default buffer pool with the multiplexer's allocator.
+   * @details If the allocator has a memory resource, the slabs of the pool
+   * are allocated from it too.
+   * @return The buffer pool.
+   */
+  auto make_buffer_pool() const -> std::shared_ptr<buffer_pool>
+  {
+    auto alloc = Mux::get_allocator();
+    if constexpr (requires {
+                    {
+                      alloc.resource()
+                    } -> std::convertible_to<std::pmr::memory_resource *>;
+                  })
+    {
+      return std::allocate_shared<buffer_pool>(
+          alloc, buffer_pool::default_buffer_size,
+          buffer_pool::default_slab_size, alloc.resource());
+    }
+    else
+    {
+      return std::allocate_shared<buffer_pool>(alloc);
+    }
+  }
+  /** @brief The pool of receive buffers. */
+  std::shared_ptr<buffer_pool> buffers_ = make_buffer_pool();
+  /** @brief The pool of arena blocks, or nullptr if arenas are disabled. */
+  std::shared_ptr<buffer_pool> arenas_;
   /** @brief The async scope for the executor. */
   async_scope scope_;
 };
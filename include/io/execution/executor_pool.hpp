@@ -0,0 +1,206 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file executor_pool.hpp
+ * @brief This file defines a pool of executors that each run on their own
+ * thread.
+ */
+#pragma once
+#ifndef IO_EXECUTOR_POOL_HPP
+#define IO_EXECUTOR_POOL_HPP
+#include "io/detail/concepts.hpp"
+#include "io/socket/socket_dialog.hpp"
+#include "io/socket/socket_handle.hpp"
+#include "triggers.hpp"
+
+#include <exec/async_scope.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief Pins a thread to one of the CPUs that the process may run on.
+ * @details The CPUs are numbered in the order of the process's affinity mask
+ * and `index` wraps around the number of available CPUs. Pinning is best
+ * effort, and it does nothing on platforms that don't support it.
+ * @param thread The thread to pin.
+ * @param index The index of the CPU to pin the thread to.
+ * @return 0 on success, otherwise the error number.
+ */
+inline auto pin_thread(std::thread &thread, std::size_t index) -> int;
+
+/**
+ * @brief A pool of executors with one executor per thread.
+ * @details Each shard of the pool owns a `basic_triggers` instance that is
+ * only waited on by the shard's thread, so shards don't share any state on
+ * the hot path. Sockets are assigned to a shard by creating them with the
+ * shard's triggers, and `make_listeners()` creates one `SO_REUSEPORT`
+ * listener per shard so that the kernel load balances incoming connections
+ * across the shards.
+ *
+ * `run()` starts one thread per shard, pins it to a CPU and blocks until
+ * `stop()` is called. Operations can be started on a shard from any thread,
+ * as long as the multiplexer's mutex is not a `null_mutex`.
+ *
+ * With the io_uring multiplexer, an operation is submitted to the kernel by
+ * the shard's thread when it next waits, wherever the operation was started,
+ * and the kernel cancels the requests that a thread submitted when that
+ * thread exits. The shard threads exit when `run()` returns, so operations
+ * that are still pending on a shard at that point fail with
+ * `std::errc::operation_canceled` once the shard is waited on again, for
+ * instance by the next `run()`.
+ * @tparam Mux The multiplexer type.
+ */
+template <Multiplexer Mux> class executor_pool {
+public:
+  /** @brief The triggers type of a shard. */
+  using triggers_type = basic_triggers<Mux>;
+  /** @brief The socket dialog type. */
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+  /** @brief The socket handle type. */
+  using socket_handle = ::io::socket::socket_handle;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /**
+   * @brief Constructs a pool.
+   * @param size The number of shards. Defaults to the number of hardware
+   * threads.
+   * @throws std::system_error if a shard can't be set up.
+   */
+  explicit executor_pool(size_type size = default_size());
+
+  /** @brief Deleted copy constructor. */
+  executor_pool(const executor_pool &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const executor_pool &) -> executor_pool & = delete;
+
+  /**
+   * @brief Gets the number of shards.
+   * @return The number of shards.
+   */
+  [[nodiscard]] auto size() const noexcept -> size_type;
+
+  /**
+   * @brief Gets the triggers of a shard.
+   * @param index The index of the shard.
+   * @return The shard's triggers.
+   */
+  auto operator[](size_type index) noexcept -> triggers_type &;
+
+  /**
+   * @brief Creates one listening socket per shard on the same address.
+   * @details Each socket sets `SO_REUSEADDR` and `SO_REUSEPORT` before it is
+   * bound. If the address has port 0, the port chosen for the first socket
+   * is used for the others.
+   * @param address The local address to listen on.
+   * @param backlog The maximum length of each pending connections queue.
+   * @param type The socket type.
+   * @param protocol The socket protocol.
+   * @return The listening sockets, where the i-th socket belongs to the i-th
+   * shard.
+   * @throws std::system_error if a socket can't be set up.
+   */
+  auto make_listeners(std::span<const std::byte> address,
+                      int backlog = SOMAXCONN, int type = SOCK_STREAM,
+                      int protocol = 0) -> std::vector<socket_dialog>;
+
+  /**
+   * @brief Runs every shard on its own thread until `stop()` is called.
+   * @details If a shard fails, the other shards are stopped and the first
+   * failure is rethrown once every thread has been joined. If `stop()` was
+   * called before `run()`, `run()` returns as soon as the threads have
+   * started. A thread that can't be pinned to a CPU still runs, and the
+   * error is reported by `pin_error()`.
+   */
+  auto run() -> void;
+
+  /**
+   * @brief Stops the shards.
+   * @details This can be called from any thread, including from completion
+   * handlers that run on a shard. It doesn't wait for the shards to stop.
+   */
+  auto stop() noexcept -> void;
+
+  /**
+   * @brief Gets the error of pinning a shard's thread to a CPU.
+   * @param index The index of the shard.
+   * @return 0 if the thread was pinned or hasn't been started yet, otherwise
+   * the error number returned by `pin_thread()` on the last `run()`.
+   */
+  [[nodiscard]] auto pin_error(size_type index) const noexcept -> int;
+
+  /** @brief Default destructor. */
+  ~executor_pool() = default;
+
+private:
+  /** @brief An executor and the socket pair used to stop it. */
+  struct shard {
+    /** @brief Creates the stop socket pair. */
+    shard();
+
+    /** @brief The shard's triggers. */
+    triggers_type triggers;
+    /** @brief Becomes readable when the shard should stop. */
+    std::shared_ptr<socket_handle> stop_reader;
+    /** @brief Written to stop the shard. */
+    socket_handle stop_writer;
+    /** @brief The shard's thread. */
+    std::thread thread;
+    /** @brief True once the shard has read from its stop socket. */
+    bool stopped = false;
+    /** @brief The failure that ended the shard's thread. */
+    std::exception_ptr error;
+    /** @brief The error of pinning the shard's thread to a CPU. */
+    std::atomic<int> pin_error = 0;
+    /**
+     * @brief The scope of the stop operation.
+     * @details It is declared last so that it is destroyed before the
+     * triggers and the stop socket that its operation refers to.
+     */
+    exec::async_scope scope;
+  };
+
+  /**
+   * @brief Runs a shard until it is stopped.
+   * @param shard The shard to run.
+   */
+  auto run_shard(shard &shard) -> void;
+
+  /** @brief Gets the number of hardware threads. */
+  static auto default_size() noexcept -> size_type;
+
+  /** @brief The shards. */
+  std::vector<shard> shards_;
+  /** @brief True if the shards have been asked to stop. */
+  std::atomic<bool> stopping_ = false;
+};
+
+} // namespace io::execution
+
+#include "impl/executor_pool_impl.hpp" // IWYU pragma: export
+
+#endif // IO_EXECUTOR_POOL_HPP
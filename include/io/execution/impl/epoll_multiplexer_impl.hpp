@@ -0,0 +1,648 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file epoll_multiplexer_impl.hpp
+ * @brief This file implements the epoll_multiplexer class.
+ * @details This file contains the implementation of the epoll_multiplexer
+ * class, which is a concrete implementation of the multiplexer concept using
+ * the Linux `epoll` API.
+ */
+#pragma once
+#ifndef IO_EPOLL_MULTIPLEXER_IMPL_HPP
+#define IO_EPOLL_MULTIPLEXER_IMPL_HPP
+#include "io/error.hpp"
+#include "io/execution/detail/utilities.hpp"
+#include "io/execution/epoll_multiplexer.hpp"
+#include "io/socket/detail/socket.hpp"
+#include "io/socket/socket_handle.hpp"
+
+#include <array>
+#include <cerrno>
+#include <new>
+#include <span>
+#include <system_error>
+
+#include <unistd.h>
+// Customization point forward declarations
+namespace io {
+struct accept_t;
+struct recvmmsg_t;
+struct recvmsg_t;
+struct sendfile_t;
+struct sendmmsg_t;
+struct sendmsg_t;
+} // namespace io
+
+namespace io::execution {
+#if IO_EAGER_ACCEPT
+template <> struct epoll_t::is_eager_t<accept_t> : public std::true_type {};
+#endif
+
+#if IO_EAGER_RECV
+template <> struct epoll_t::is_eager_t<recvmsg_t> : public std::true_type {};
+template <> struct epoll_t::is_eager_t<recvmmsg_t> : public std::true_type {};
+#endif
+
+#if IO_EAGER_SEND
+template <> struct epoll_t::is_eager_t<sendmsg_t> : public std::true_type {};
+template <> struct epoll_t::is_eager_t<sendmmsg_t> : public std::true_type {};
+template <> struct epoll_t::is_eager_t<sendfile_t> : public std::true_type {};
+#endif
+
+/**
+ * @brief Cancels the operation.
+ * @details If the operation was still waiting, it completes with
+ * `set_stopped()`. Otherwise it is ready or hasn't been queued yet, and the
+ * stop is handled by the code that owns it.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_epoll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::on_stop::operator()() const noexcept -> void
+{
+  if (self->mux->cancel(self, static_cast<native_socket_type>(*self->socket)))
+    stdexec::set_stopped(std::move(self->receiver));
+}
+
+/**
+ * @brief Completes the operation and sends the result to the receiver.
+ * @details This function is called when the operation is complete. It gets the
+ * result of the operation and sends it to the receiver. If the operation
+ * failed, it sends the error to the receiver.
+ * @param task_ptr A pointer to the task to complete.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_epoll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::complete(task *task_ptr) noexcept -> void
+{
+  auto *self = static_cast<state *>(task_ptr);
+  self->callback.reset();
+
+  auto error = self->socket->get_error();
+  if (error && error != std::errc::operation_would_block)
+    return stdexec::set_error(std::move(self->receiver), error);
+
+  if (auto result = self->func())
+    return stdexec::set_value(std::move(self->receiver), std::move(*result));
+
+  return stdexec::set_error(std::move(self->receiver),
+                            std::error_code{errno, std::system_category()});
+}
+
+/**
+ * @brief Starts the operation.
+ * @details This function is called to start the operation. If the operation can
+ * be completed eagerly, it is completed immediately. Otherwise, interest in the
+ * trigger is registered with the kernel and the operation is added to the
+ * appropriate queue to be completed later. If interest can't be registered,
+ * the error is set on the socket and the operation is completed immediately.
+ * The stop callback is registered before the operation is queued, so a stop
+ * that is requested in between is seen by the registration.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_epoll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::start() noexcept -> void
+{
+  using enum execution_trigger;
+  auto error = socket->get_error();
+  if (trigger == EAGER || (error && error != std::errc::operation_would_block))
+    return complete(this);
+
+  if constexpr (!stdexec::unstoppable_token<stop_token>)
+  {
+    auto token = stdexec::get_stop_token(stdexec::get_env(receiver));
+    if (token.stop_requested())
+      return stdexec::set_stopped(std::move(receiver));
+    callback.emplace(token, on_stop{this});
+  }
+
+  auto status = with_lock(mux->mtx_, [&] {
+    if (operation::cancelled)
+      return ECANCELED;
+
+    try
+    {
+      auto &demux = mux->demux_[static_cast<native_socket_type>(*socket)];
+      if (auto status = mux->arm(demux, socket, trigger))
+      {
+        mux->disarm(static_cast<native_socket_type>(*socket));
+        return status;
+      }
+
+      task::tail = state::complete;
+
+      if (trigger == WRITE)
+        operation::queue = &demux.write_queue;
+
+      if (trigger == READ)
+        operation::queue = &demux.read_queue;
+
+      if (trigger == ERRQUEUE)
+        operation::queue = &demux.error_queue;
+
+      operation::queue->push(this);
+
+      demux.socket = socket.get();
+      return 0;
+    }
+    catch (const std::bad_alloc &)
+    {
+      return ENOMEM;
+    }
+  });
+
+  if (status == ECANCELED)
+  {
+    callback.reset();
+    return stdexec::set_stopped(std::move(receiver));
+  }
+
+  if (status)
+  {
+    socket->set_error(status);
+    complete(this);
+  }
+}
+
+/**
+ * @brief Converts an execution trigger to an epoll event mask.
+ * @param trigger The execution trigger to convert.
+ * @return The epoll events that correspond to the trigger.
+ */
+constexpr auto make_epoll_events(execution_trigger trigger) noexcept
+    -> std::uint32_t
+{
+  using enum execution_trigger;
+
+  if (trigger == READ)
+    return EPOLLIN;
+
+  if (trigger == WRITE)
+    return EPOLLOUT;
+
+  // EPOLLERR is always reported, but it keeps the socket registered.
+  if (trigger == ERRQUEUE)
+    return EPOLLERR;
+
+  return 0;
+}
+
+/**
+ * @brief Changes the interest set of a file descriptor.
+ * @details This function selects the `epoll_ctl` operation needed to move the
+ * registered interest set of `fd` from `from` to `to`. Since the kernel drops
+ * a file descriptor from the interest list when it is closed, and file
+ * descriptors are recycled, the registered state may be stale. A failed
+ * modification is retried as an addition, a failed addition is retried as a
+ * modification and deleting a file descriptor that isn't registered is
+ * treated as a success.
+ * @param epfd The epoll file descriptor.
+ * @param fd The file descriptor to update.
+ * @param from The events that are currently registered.
+ * @param to The events that should be registered.
+ * @return 0 on success, otherwise the error number.
+ */
+inline auto epoll_ctl_(int epfd, int fd, std::uint32_t from,
+                       std::uint32_t to) -> int
+{
+  struct epoll_event event = {.events = to, .data = {.fd = fd}};
+
+  if (!to)
+  {
+    if (!epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr) || errno == ENOENT ||
+        errno == EBADF)
+    {
+      return 0;
+    }
+    return errno;
+  }
+
+  auto op = from ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  if (!epoll_ctl(epfd, op, fd, &event))
+    return 0;
+
+  if (op == EPOLL_CTL_MOD && errno == ENOENT)
+    op = EPOLL_CTL_ADD;
+  else if (op == EPOLL_CTL_ADD && errno == EEXIST)
+    op = EPOLL_CTL_MOD;
+  else
+    return errno;
+
+  if (!epoll_ctl(epfd, op, fd, &event))
+    return 0;
+
+  return errno;
+}
+
+/**
+ * @brief Connects a sender to a receiver.
+ * @details This function is called to connect a sender to a receiver. It
+ * creates a state object that will be used to manage the operation.
+ * @param receiver The receiver to connect to.
+ * @return The state object for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_epoll_multiplexer<Allocator, Mutex>::sender<Fn>::connect(
+    Receiver &&receiver) -> state<std::decay_t<Receiver>>
+{
+  return {.func = std::move(func),
+          .socket = std::move(socket),
+          .receiver = std::forward<Receiver>(receiver),
+          .mux = mux,
+          .trigger = trigger};
+}
+
+/**
+ * @brief Creates a sender for an operation.
+ * @details This function is called to create a sender for an operation. The
+ * sender will be used to connect to a receiver and start the operation.
+ * @param socket The socket to perform the operation on.
+ * @param trigger The execution trigger to wait for.
+ * @param func The function to execute when the operation is ready.
+ * @return A sender for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+auto basic_epoll_multiplexer<Allocator, Mutex>::set(
+    // NOLINTNEXTLINE(performance-unnecessary-value-param)
+    std::shared_ptr<socket_handle> socket, execution_trigger trigger,
+    Fn &&func) -> sender<std::decay_t<Fn>>
+{
+  return {.func = std::forward<Fn>(func),
+          .socket = std::move(socket),
+          .mux = this,
+          .trigger = trigger};
+}
+
+/**
+ * @brief Registers interest in a trigger for the demultiplexer's socket.
+ * @details If the demultiplexer was last registered by a different socket,
+ * the file descriptor has been recycled by the kernel and the registered
+ * interest set is discarded.
+ * @param demux The demultiplexer to register interest for.
+ * @param socket The socket that owns the pending operation.
+ * @param trigger The trigger to register interest in.
+ * @return 0 on success, otherwise the error number.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::arm(
+    demultiplexer &demux, const std::shared_ptr<socket_handle> &socket,
+    execution_trigger trigger) -> int
+{
+  if (demux.owner.owner_before(socket) || socket.owner_before(demux.owner))
+  {
+    if (demux.events)
+      --active_;
+
+    demux.events = 0;
+    demux.owner = socket;
+  }
+
+  auto events = demux.events | make_epoll_events(trigger);
+  if (events == demux.events)
+    return 0;
+
+  auto sockfd = static_cast<native_socket_type>(*socket);
+  if (auto status = epoll_ctl_(epfd_, sockfd, demux.events, events))
+    return status;
+
+  if (!demux.events)
+    ++active_;
+
+  demux.events = events;
+  return 0;
+}
+
+/**
+ * @brief Drops interest in triggers that no longer have pending operations.
+ * @details This is called after the ready operations have been executed, so
+ * that an operation that is resubmitted by its own completion handler does
+ * not need to update the interest list. A demultiplexer that has no interest
+ * left is erased.
+ * @param fd The file descriptor of the demultiplexer to update.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::disarm(native_socket_type fd)
+    -> void
+{
+  auto *entry = demux_.find(fd);
+  if (!entry)
+    return;
+
+  auto &demux = *entry;
+  std::uint32_t events = 0;
+  if (!demux.read_queue.is_empty())
+    events |= EPOLLIN;
+
+  if (!demux.write_queue.is_empty())
+    events |= EPOLLOUT;
+
+  if (!demux.error_queue.is_empty())
+    events |= EPOLLERR;
+
+  if (events != demux.events)
+  {
+    if (epoll_ctl_(epfd_, fd, demux.events, events))
+      return;
+
+    if (!events)
+      --active_;
+
+    demux.events = events;
+  }
+
+  if (!events)
+    demux_.erase(fd);
+}
+
+/**
+ * @brief Cancels an operation.
+ * @details If the operation isn't waiting, it is marked as cancelled so that
+ * an operation that hasn't been queued yet isn't queued.
+ * @param op The operation to cancel.
+ * @param fd The socket of the operation.
+ * @return True if the operation was removed.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::cancel(operation *op,
+                                                       native_socket_type fd)
+    -> bool
+{
+  return with_lock(mtx_, [&] {
+    if (!op->queue)
+    {
+      op->cancelled = true;
+      return false;
+    }
+
+    op->queue = nullptr;
+    intrusive_task_queue::erase(op);
+    disarm(fd);
+    return true;
+  });
+}
+
+/**
+ * @brief Handles errors from the epoll_wait system call.
+ * @details This function is called when epoll_wait returns an error.
+ * It throws a system_error if the error is not an interrupt.
+ * @param error The error code to handle.
+ */
+inline auto handle_epoll_error(const std::error_code &error) -> void
+{
+  if (error != std::errc::interrupted)
+    throw_system_error(IO_ERROR_MESSAGE("epoll_wait failed."));
+}
+
+/**
+ * @brief A wrapper around the epoll_wait system call.
+ * @details This function calls epoll_wait and retries if it is interrupted.
+ * @param epfd The epoll file descriptor.
+ * @param events The buffer to write ready events into.
+ * @param duration The timeout for the epoll_wait call.
+ * @return The number of ready events written into `events`.
+ */
+inline auto epoll_wait_(int epfd, std::span<epoll_event> events,
+                        int duration) -> std::size_t
+{
+  using namespace detail;
+  using clock = std::chrono::steady_clock;
+
+  auto start = clock::now();
+  int count = 0;
+  while ((count = epoll_wait(epfd, events.data(),
+                             static_cast<int>(events.size()), duration)) < 0)
+  {
+    handle_epoll_error({errno, std::system_category()});
+    if (duration > -1)
+      duration = remaining_duration(duration, start);
+  }
+
+  return count;
+}
+
+/**
+ * @brief Moves tasks from the demultiplexer's task queues to the ready queue
+ * based on epoll events.
+ * @details An EPOLLERR without a pending socket error means that the socket's
+ * error queue is readable, for example because `MSG_ZEROCOPY` sends have
+ * completed. Only the operations that wait on the error queue are released
+ * for it.
+ * @param events The events returned from an epoll_wait call.
+ * @param demux The demultiplexer containing the task queues.
+ * @param ready The queue to which ready tasks will be moved.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto prepare_handles(
+    std::uint32_t events,
+    typename basic_epoll_multiplexer<Allocator, Mutex>::demultiplexer &demux,
+    typename basic_epoll_multiplexer<Allocator,
+                                     Mutex>::intrusive_task_queue &ready)
+    -> void
+{
+  using operation = basic_epoll_multiplexer<Allocator, Mutex>::operation;
+
+  if ((events & EPOLLERR) && demux.socket)
+  {
+    set_error(*demux.socket);
+    if (!demux.socket->get_error())
+    {
+      release_operations<operation>(demux.error_queue, ready);
+      events &= ~EPOLLERR;
+    }
+  }
+
+  if (events & (EPOLLHUP | EPOLLERR))
+    release_operations<operation>(demux.error_queue, ready);
+
+  if (events & (EPOLLOUT | EPOLLERR))
+    release_operations<operation>(demux.write_queue, ready);
+
+  if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+    release_operations<operation>(demux.read_queue, ready);
+}
+
+/**
+ * @brief Waits for events on the file descriptors in the interest list.
+ * @details This function is the main entry point for the epoll_multiplexer.
+ * It waits for events on the registered file descriptors, executes the
+ * corresponding tasks and expired timers, and then drops interest in any
+ * trigger that no longer has pending operations. The wait is shortened to
+ * the next timer expiry. It returns immediately if no interest is registered
+ * and no timers are pending.
+ * @param interval The maximum time to wait for an event.
+ * @return The number of events that were handled.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::wait_for(interval_type interval)
+    -> size_type
+{
+  if (!with_lock(mtx_, [&] { return active_; }) && timers_.empty())
+    return 0;
+
+  auto timeout = timers_.timeout(static_cast<int>(interval.count()));
+  std::array<event_type, max_events> buffer{};
+  auto events = std::span(buffer).first(epoll_wait_(epfd_, buffer, timeout));
+
+  intrusive_task_queue ready_queue;
+
+  auto count = with_lock(mtx_, [&] {
+    auto count = events.size();
+    for (const auto &event : events)
+    {
+      if (event.data.fd == notifier_.native_handle())
+      {
+        notifier_.clear();
+        --count;
+        continue;
+      }
+
+      if (auto *demux = demux_.find(event.data.fd))
+        prepare_handles<Allocator, Mutex>(event.events, *demux, ready_queue);
+    }
+
+    return count + timers_.expire(ready_queue);
+  });
+
+  run_queue(ready_queue);
+
+  with_lock(mtx_, [&] {
+    for (const auto &event : events)
+      disarm(event.data.fd);
+  });
+
+  return count;
+}
+
+/**
+ * @brief Waits for events on the file descriptors in the interest list.
+ * @details The ready operations of each socket are handed to `dispatch`,
+ * followed by the expired timers.
+ * Since the operations are executed after this function returns, interest in
+ * triggers that no longer have pending operations is dropped before it
+ * returns.
+ * @param interval The maximum time to wait for an event.
+ * @param dispatch Takes the ready operations of a socket.
+ * @return The number of events that were handled.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <typename Fn>
+auto basic_epoll_multiplexer<Allocator, Mutex>::wait_for(interval_type interval,
+                                                         Fn &&dispatch)
+    -> size_type
+{
+  if (!with_lock(mtx_, [&] { return active_; }) && timers_.empty())
+    return 0;
+
+  auto timeout = timers_.timeout(static_cast<int>(interval.count()));
+  std::array<event_type, max_events> buffer{};
+  auto events = std::span(buffer).first(epoll_wait_(epfd_, buffer, timeout));
+
+  return with_lock(mtx_, [&] {
+    auto count = events.size();
+    for (const auto &event : events)
+    {
+      if (event.data.fd == notifier_.native_handle())
+      {
+        notifier_.clear();
+        --count;
+        continue;
+      }
+
+      auto *demux = demux_.find(event.data.fd);
+      if (!demux)
+        continue;
+
+      intrusive_task_queue ready_queue;
+      prepare_handles<Allocator, Mutex>(event.events, *demux, ready_queue);
+      if (!ready_queue.is_empty())
+        dispatch(static_cast<std::size_t>(event.data.fd), ready_queue);
+    }
+
+    intrusive_task_queue expired;
+    count += timers_.expire(expired);
+    if (!expired.is_empty())
+      dispatch(static_cast<std::size_t>(notifier_.native_handle()), expired);
+
+    for (const auto &event : events)
+      disarm(event.data.fd);
+
+    return count;
+  });
+}
+
+/**
+ * @brief Creates a sender that completes at a deadline.
+ * @param deadline The deadline.
+ * @return The timer sender.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::schedule_at(time_point deadline)
+    -> timer_sender
+{
+  return timers_.schedule_at(this, deadline);
+}
+
+/**
+ * @brief Wakes up a thread that is blocked in `wait_for`.
+ * @details If no thread is waiting, the next wait that has interest to poll
+ * returns immediately.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_epoll_multiplexer<Allocator, Mutex>::notify() -> void
+{
+  with_lock(mtx_, [&] { notifier_.notify(); });
+}
+
+/**
+ * @brief Constructs a basic_epoll_multiplexer.
+ * @param alloc The allocator to use for all allocations.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+basic_epoll_multiplexer<Allocator, Mutex>::basic_epoll_multiplexer(
+    const Allocator &alloc)
+    : demux_{alloc}, epfd_{epoll_create1(EPOLL_CLOEXEC)}, alloc_{alloc}
+{
+  if (epfd_ < 0)
+    throw_system_error(IO_ERROR_MESSAGE("epoll_create1 failed."));
+
+  auto fd = notifier_.native_handle();
+  struct epoll_event event = {.events = EPOLLIN, .data = {.fd = fd}};
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event))
+  {
+    auto error = errno;
+    ::close(epfd_);
+    errno = error;
+    throw_system_error(IO_ERROR_MESSAGE("epoll_ctl failed."));
+  }
+}
+
+/** @brief Closes the epoll instance. */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+basic_epoll_multiplexer<Allocator, Mutex>::~basic_epoll_multiplexer()
+{
+  ::close(epfd_);
+}
+
+} // namespace io::execution
+#endif // IO_EPOLL_MULTIPLEXER_IMPL_HPP
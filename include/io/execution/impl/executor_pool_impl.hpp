@@ -0,0 +1,297 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file executor_pool_impl.hpp
+ * @brief This file implements the executor_pool class.
+ */
+#pragma once
+#ifndef IO_EXECUTOR_POOL_IMPL_HPP
+#define IO_EXECUTOR_POOL_IMPL_HPP
+#include "io/config.h"
+#include "io/error.hpp"
+#include "io/execution/executor_pool.hpp"
+#include "io/socket/socket_address.hpp"
+#include "io/socket/socket_option.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#if OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+namespace io::execution {
+
+inline auto pin_thread([[maybe_unused]] std::thread &thread,
+                       [[maybe_unused]] std::size_t index) -> int
+{
+#if OS_LINUX
+  cpu_set_t available;
+  CPU_ZERO(&available);
+  if (sched_getaffinity(0, sizeof(available), &available))
+    return errno;
+
+  auto count = static_cast<std::size_t>(CPU_COUNT(&available));
+  if (!count)
+    return EINVAL;
+
+  auto target = index % count;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (!CPU_ISSET(cpu, &available) || target--)
+      continue;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+  }
+
+  return EINVAL;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Creates the stop socket pair of a shard.
+ * @throws std::system_error if the socket pair can't be created.
+ */
+template <Multiplexer Mux> executor_pool<Mux>::shard::shard()
+{
+  std::array<::io::socket::native_socket_type, 2> pair{};
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()))
+    throw_system_error(IO_ERROR_MESSAGE("socketpair failed."));
+
+  stop_writer = socket_handle{pair[1]};
+  stop_reader = triggers.push(std::make_shared<socket_handle>(pair[0])).socket;
+}
+
+/**
+ * @brief Constructs a pool.
+ * @param size The number of shards.
+ */
+template <Multiplexer Mux>
+executor_pool<Mux>::executor_pool(size_type size)
+    : shards_(std::max<size_type>(size, 1))
+{}
+
+/**
+ * @brief Gets the number of shards.
+ * @return The number of shards.
+ */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::size() const noexcept -> size_type
+{
+  return shards_.size();
+}
+
+/**
+ * @brief Gets the triggers of a shard.
+ * @param index The index of the shard.
+ * @return The shard's triggers.
+ */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::operator[](size_type index) noexcept
+    -> triggers_type &
+{
+  return shards_[index].triggers;
+}
+
+/**
+ * @brief Creates one listening socket per shard on the same address.
+ * @param address The local address to listen on.
+ * @param backlog The maximum length of each pending connections queue.
+ * @param type The socket type.
+ * @param protocol The socket protocol.
+ * @return The listening sockets.
+ */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::make_listeners(std::span<const std::byte> address,
+                                        int backlog, int type,
+                                        int protocol)
+    -> std::vector<socket_dialog>
+{
+  using namespace ::io::socket;
+  using socket_option = ::io::socket::socket_option<int>;
+
+  socket_address<sockaddr_storage_type> local{address};
+  auto bound = std::span<const std::byte>(local);
+
+  std::vector<socket_dialog> listeners;
+  listeners.reserve(shards_.size());
+  for (auto &shard : shards_)
+  {
+    auto dialog = shard.triggers.emplace(local->ss_family, type, protocol);
+
+    socket_option enable{1};
+    if (::io::setsockopt(dialog, SOL_SOCKET, SO_REUSEADDR, enable) ||
+        ::io::setsockopt(dialog, SOL_SOCKET, SO_REUSEPORT, enable))
+    {
+      throw_system_error(IO_ERROR_MESSAGE("setsockopt failed."));
+    }
+
+    if (::io::bind(dialog, bound))
+      throw_system_error(IO_ERROR_MESSAGE("bind failed."));
+
+    if (::io::listen(dialog, backlog))
+      throw_system_error(IO_ERROR_MESSAGE("listen failed."));
+
+    // Bind the remaining sockets to the port that was chosen for the first.
+    if (listeners.empty())
+    {
+      bound = ::io::getsockname(dialog, local);
+      if (bound.empty())
+        throw_system_error(IO_ERROR_MESSAGE("getsockname failed."));
+    }
+
+    listeners.push_back(std::move(dialog));
+  }
+
+  return listeners;
+}
+
+/**
+ * @brief Runs a shard until it is stopped.
+ * @details The shard waits for a read on its stop socket, so that it always
+ * has interest registered and `wait_for` blocks until there is work to do.
+ * If waiting fails, the failure is recorded and the pool is stopped, but the
+ * shard keeps waiting until the read on its stop socket has completed, so
+ * that the operation never outlives the shard. The program is terminated if
+ * it can't be completed.
+ * @param shard The shard to run.
+ */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::run_shard(shard &shard) -> void
+{
+  using enum execution_trigger;
+  static constexpr int max_failures = 8;
+
+  auto fd = static_cast<::io::socket::native_socket_type>(*shard.stop_reader);
+  shard.stopped = false;
+  shard.scope.spawn(
+      shard.triggers.set(shard.stop_reader, READ,
+                         [fd] {
+                           std::array<char, 16> buf{};
+                           return std::optional(
+                               ::recv(fd, buf.data(), buf.size(), 0));
+                         }) |
+      stdexec::then([&](auto) { shard.stopped = true; }) |
+      stdexec::upon_error([&](auto) { shard.stopped = true; }) |
+      stdexec::upon_stopped([&] { shard.stopped = true; }));
+
+  for (int failures = 0; !shard.stopped;)
+  {
+    try
+    {
+      shard.triggers.wait_for(-1);
+    }
+    catch (...)
+    {
+      if (!failures++)
+      {
+        shard.error = std::current_exception();
+        stop();
+      }
+      else if (failures > max_failures)
+      {
+        std::terminate();
+      }
+    }
+  }
+
+  stdexec::sync_wait(shard.scope.on_empty());
+}
+
+/**
+ * @brief Runs every shard on its own thread until `stop()` is called.
+ */
+template <Multiplexer Mux> auto executor_pool<Mux>::run() -> void
+{
+  auto join = [&] {
+    for (auto &shard : shards_)
+    {
+      if (shard.thread.joinable())
+        shard.thread.join();
+    }
+    stopping_ = false;
+  };
+
+  try
+  {
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+      auto &shard = shards_[i];
+      shard.error = nullptr;
+      shard.thread = std::thread([&] { run_shard(shard); });
+      shard.pin_error = pin_thread(shard.thread, i);
+    }
+  }
+  catch (...)
+  {
+    stop();
+    join();
+    throw;
+  }
+
+  join();
+  for (auto &shard : shards_)
+  {
+    if (shard.error)
+      std::rethrow_exception(shard.error);
+  }
+}
+
+/**
+ * @brief Stops the shards.
+ * @details Only the first call after `run()` writes to the stop sockets.
+ */
+template <Multiplexer Mux> auto executor_pool<Mux>::stop() noexcept -> void
+{
+  if (stopping_.exchange(true))
+    return;
+
+  for (auto &shard : shards_)
+  {
+    [[maybe_unused]] auto ret =
+        ::send(static_cast<::io::socket::native_socket_type>(shard.stop_writer),
+               "", 1, MSG_NOSIGNAL);
+  }
+}
+
+/**
+ * @brief Gets the error of pinning a shard's thread to a CPU.
+ * @param index The index of the shard.
+ * @return 0 if the thread was pinned, otherwise the error number.
+ */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::pin_error(size_type index) const noexcept -> int
+{
+  return shards_[index].pin_error;
+}
+
+/** @brief Gets the number of hardware threads. */
+template <Multiplexer Mux>
+auto executor_pool<Mux>::default_size() noexcept -> size_type
+{
+  return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+} // namespace io::execution
+#endif // IO_EXECUTOR_POOL_IMPL_HPP
@@ -0,0 +1,618 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file io_uring_multiplexer_impl.hpp
+ * @brief This file implements the io_uring_multiplexer class.
+ * @details This file contains the implementation of the io_uring_multiplexer
+ * class, which is a concrete implementation of the multiplexer concept using
+ * the Linux `io_uring` API.
+ */
+#pragma once
+#ifndef IO_IO_URING_MULTIPLEXER_IMPL_HPP
+#define IO_IO_URING_MULTIPLEXER_IMPL_HPP
+#include "io/error.hpp"
+#include "io/execution/detail/utilities.hpp"
+#include "io/execution/io_uring_multiplexer.hpp"
+#include "io/socket/detail/socket.hpp"
+#include "io/socket/socket_handle.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <poll.h>
+
+namespace io::execution {
+/**
+ * @brief Cancels the operation.
+ * @details If the operation hasn't been submitted yet, it completes with
+ * `set_stopped()` immediately. Otherwise, it completes with `set_stopped()`
+ * when the kernel cancels it.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::on_stop::operator()() const noexcept -> void
+{
+  if (self->mux->cancel(self))
+    stdexec::set_stopped(std::move(self->receiver));
+}
+
+/**
+ * @brief Completes the operation and sends the result to the receiver.
+ * @details The result of the poll is used to set any pending error on the
+ * socket before the completion handler is invoked. A poll that the kernel
+ * cancelled on a stop request completes with `set_stopped()`.
+ * @param task_ptr A pointer to the task to complete.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::complete(task *task_ptr) noexcept -> void
+{
+  auto *self = static_cast<state *>(task_ptr);
+  self->callback.reset();
+
+  if (self->cancelled && self->result == -ECANCELED)
+    return stdexec::set_stopped(std::move(self->receiver));
+
+  if (self->result < 0)
+    self->socket->set_error(-self->result);
+  else if (self->result & (POLLERR | POLLNVAL))
+    set_error(*self->socket); // GCOVR_EXCL_LINE
+
+  auto error = self->socket->get_error();
+  if (error && error != std::errc::operation_would_block)
+    return stdexec::set_error(std::move(self->receiver), error);
+
+  if (auto result = self->func())
+    return stdexec::set_value(std::move(self->receiver), std::move(*result));
+
+  return stdexec::set_error(std::move(self->receiver),
+                            std::error_code{errno, std::system_category()});
+}
+
+/**
+ * @brief Prepares a poll for the trigger.
+ * @param op_ptr The operation to prepare.
+ * @param sqe The submission queue entry to fill.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::prepare(operation *op_ptr, io_uring_sqe &sqe) noexcept -> void
+{
+  using enum execution_trigger;
+  auto *self = static_cast<state *>(op_ptr);
+
+  sqe.opcode = IORING_OP_POLL_ADD;
+  sqe.fd = static_cast<native_socket_type>(*self->socket);
+  sqe.poll32_events = POLLOUT;
+  if (self->trigger == READ)
+    sqe.poll32_events = POLLIN;
+
+  if (self->trigger == ERRQUEUE)
+    sqe.poll32_events = POLLERR;
+}
+
+/**
+ * @brief Starts the operation.
+ * @details If the operation can be completed eagerly, it is completed
+ * immediately. Otherwise, it is queued to be submitted on the next wait. The
+ * stop callback is registered before the operation is queued, so a stop that
+ * is requested in between is seen by the submission.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::start() noexcept -> void
+{
+  using enum execution_trigger;
+  auto error = socket->get_error();
+  if (trigger == EAGER || (error && error != std::errc::operation_would_block))
+    return complete(this);
+
+  if constexpr (!stdexec::unstoppable_token<stop_token>)
+  {
+    auto token = stdexec::get_stop_token(stdexec::get_env(receiver));
+    if (token.stop_requested())
+      return stdexec::set_stopped(std::move(receiver));
+    callback.emplace(token, on_stop{this});
+  }
+
+  task::tail = state::complete;
+  operation::prepare = state::prepare;
+  if (!mux->submit(this))
+  {
+    callback.reset();
+    stdexec::set_stopped(std::move(receiver));
+  }
+}
+
+/**
+ * @brief Connects a sender to a receiver.
+ * @param receiver The receiver to connect to.
+ * @return The state object for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::sender<Fn>::connect(
+    Receiver &&receiver) -> state<std::decay_t<Receiver>>
+{
+  return {.func = std::move(func),
+          .socket = std::move(socket),
+          .receiver = std::forward<Receiver>(receiver),
+          .mux = mux,
+          .trigger = trigger};
+}
+
+/**
+ * @brief Cancels the operation.
+ * @details If the operation hasn't been submitted yet, it completes with
+ * `set_stopped()` immediately. Otherwise, it completes with `set_stopped()`
+ * when the kernel cancels it.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submission<Op>::state<
+    Receiver>::on_stop::operator()() const noexcept -> void
+{
+  if (self->mux->cancel(self))
+    stdexec::set_stopped(std::move(self->receiver));
+}
+
+/**
+ * @brief Completes the operation and sends the result to the receiver.
+ * @details A negative result is the negated error number of the operation.
+ * An operation that the kernel cancelled on a stop request completes with
+ * `set_stopped()`.
+ * @param task_ptr A pointer to the task to complete.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submission<Op>::state<
+    Receiver>::complete(task *task_ptr) noexcept -> void
+{
+  auto *self = static_cast<state *>(task_ptr);
+  self->callback.reset();
+
+  if (self->cancelled && self->result == -ECANCELED)
+    return stdexec::set_stopped(std::move(self->receiver));
+
+  auto error = self->socket->get_error();
+  if (error && error != std::errc::operation_would_block)
+    return stdexec::set_error(std::move(self->receiver), error);
+
+  if (self->result < 0)
+  {
+    return stdexec::set_error(
+        std::move(self->receiver),
+        std::error_code{-self->result, std::system_category()});
+  }
+
+  if (auto result = self->op.complete(self->result))
+    return stdexec::set_value(std::move(self->receiver), std::move(*result));
+
+  return stdexec::set_error(std::move(self->receiver),
+                            std::error_code{errno, std::system_category()});
+}
+
+/**
+ * @brief Prepares the operation.
+ * @param op_ptr The operation to prepare.
+ * @param sqe The submission queue entry to fill.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submission<Op>::state<
+    Receiver>::prepare(operation *op_ptr, io_uring_sqe &sqe) noexcept -> void
+{
+  auto *self = static_cast<state *>(op_ptr);
+  self->op.prepare(sqe, static_cast<native_socket_type>(*self->socket));
+}
+
+/**
+ * @brief Starts the operation.
+ * @details If the socket has a pending error the operation completes
+ * immediately. Otherwise, it is queued to be submitted on the next wait. The
+ * stop callback is registered before the operation is queued, so a stop that
+ * is requested in between is seen by the submission.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submission<Op>::state<
+    Receiver>::start() noexcept -> void
+{
+  auto error = socket->get_error();
+  if (error && error != std::errc::operation_would_block)
+    return complete(this);
+
+  if constexpr (!stdexec::unstoppable_token<stop_token>)
+  {
+    auto token = stdexec::get_stop_token(stdexec::get_env(receiver));
+    if (token.stop_requested())
+      return stdexec::set_stopped(std::move(receiver));
+    callback.emplace(token, on_stop{this});
+  }
+
+  task::tail = state::complete;
+  operation::prepare = state::prepare;
+  if (!mux->submit(this))
+  {
+    callback.reset();
+    stdexec::set_stopped(std::move(receiver));
+  }
+}
+
+/**
+ * @brief Connects a submission to a receiver.
+ * @param receiver The receiver to connect to.
+ * @return The state object for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+template <typename Receiver>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submission<Op>::connect(
+    Receiver &&receiver) -> state<std::decay_t<Receiver>>
+{
+  return {.op = std::move(op),
+          .socket = std::move(socket),
+          .receiver = std::forward<Receiver>(receiver),
+          .mux = mux};
+}
+
+/**
+ * @brief Creates a sender for an operation.
+ * @param socket The socket to perform the operation on.
+ * @param trigger The execution trigger to wait for.
+ * @param func The function to execute when the operation is ready.
+ * @return A sender for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::set(
+    // NOLINTNEXTLINE(performance-unnecessary-value-param)
+    std::shared_ptr<socket_handle> socket, execution_trigger trigger,
+    Fn &&func) -> sender<std::decay_t<Fn>>
+{
+  return {.func = std::forward<Fn>(func),
+          .socket = std::move(socket),
+          .mux = this,
+          .trigger = trigger};
+}
+
+/**
+ * @brief Creates a sender for an io_uring operation.
+ * @param socket The socket to perform the operation on.
+ * @param op The operation.
+ * @return A sender for the operation.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <UringOperation Op>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::set(
+    // NOLINTNEXTLINE(performance-unnecessary-value-param)
+    std::shared_ptr<socket_handle> socket,
+    Op &&op) -> submission<std::decay_t<Op>>
+{
+  return {.op = std::forward<Op>(op), .socket = std::move(socket), .mux = this};
+}
+
+/**
+ * @brief Queues an operation to be submitted on the next wait.
+ * @details If another thread is blocked in `wait_for`, it is woken up so that
+ * the operation is submitted.
+ * @param op The operation to queue.
+ * @return False if the operation was cancelled before it was queued.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::submit(operation *op) -> bool
+{
+  std::lock_guard lock{mtx_};
+  if (op->cancelled)
+    return false;
+
+  op->queue = &pending_;
+  pending_.push(op);
+  ++inflight_;
+  if (waiting_)
+    notifier_.notify();
+
+  return true;
+}
+
+/**
+ * @brief Cancels an operation.
+ * @details If the operation isn't waiting, it is marked as cancelled so that
+ * an operation that hasn't been queued yet isn't queued. A submitted
+ * operation is queued for an `IORING_OP_ASYNC_CANCEL`, and a blocked wait is
+ * woken up so that it is submitted.
+ * @param op The operation to cancel.
+ * @return True if the operation was removed.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::cancel(operation *op)
+    -> bool
+{
+  std::lock_guard lock{mtx_};
+  op->cancelled = true;
+  if (op->queue == &pending_)
+  {
+    op->queue = nullptr;
+    intrusive_task_queue::erase(op);
+    --inflight_;
+    return true;
+  }
+
+  if (op->submitted && !op->queue)
+  {
+    op->queue = &cancels_;
+    cancels_.push(op);
+    if (waiting_)
+      notifier_.notify();
+  }
+
+  return false;
+}
+
+/**
+ * @brief Prepares a poll on the notifier.
+ * @param op_ptr The operation to prepare.
+ * @param sqe The submission queue entry to fill.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::wakeup::prepare_poll(
+    operation *op_ptr, io_uring_sqe &sqe) noexcept -> void
+{
+  sqe.opcode = IORING_OP_POLL_ADD;
+  sqe.fd = static_cast<wakeup *>(op_ptr)->fd;
+  sqe.poll32_events = POLLIN;
+}
+
+/**
+ * @brief Handles errors from the io_uring_enter system call.
+ * @details This function throws a system_error if the error is not an
+ * interrupt.
+ * @param error The error code to handle.
+ */
+inline auto handle_uring_error(const std::error_code &error) -> void
+{
+  if (error != std::errc::interrupted)
+    throw_system_error(IO_ERROR_MESSAGE("io_uring_enter failed."));
+}
+
+/**
+ * @brief Moves queued operations into the submission queue.
+ * @details Operations that don't fit into the submission queue stay queued
+ * until the next wait.
+ * @tparam Queue The intrusive task queue type.
+ * @tparam Operation The operation type.
+ * @param ring The io_uring instance.
+ * @param pending The queue of operations to submit.
+ * @return The number of entries that are ready to be submitted.
+ */
+template <typename Operation, typename Queue>
+auto prepare_submissions(detail::uring &ring, Queue &pending) -> unsigned
+{
+  io_uring_sqe *sqe = nullptr;
+  while (!pending.is_empty() && (sqe = ring.get_sqe()))
+  {
+    auto *op = static_cast<Operation *>(pending.pop());
+    op->queue = nullptr;
+    op->submitted = true;
+    op->prepare(op, *sqe);
+    op->fd = sqe->fd;
+    sqe->user_data = reinterpret_cast<std::uintptr_t>(op);
+  }
+
+  return ring.flush();
+}
+
+/**
+ * @brief Moves queued cancellations into the submission queue.
+ * @details Each submitted operation is cancelled with an
+ * `IORING_OP_ASYNC_CANCEL` that is keyed on its `user_data`. The `user_data`
+ * of the cancellation itself is tagged, so that its completion can be told
+ * apart. Cancellations that don't fit into the submission queue stay queued
+ * until the next wait.
+ * @tparam Operation The operation type.
+ * @tparam Queue The intrusive task queue type.
+ * @param ring The io_uring instance.
+ * @param cancels The queue of operations to cancel.
+ * @param tag The tag for the `user_data` of the cancellations.
+ */
+template <typename Operation, typename Queue>
+auto prepare_cancellations(detail::uring &ring, Queue &cancels,
+                           std::uintptr_t tag) -> void
+{
+  io_uring_sqe *sqe = nullptr;
+  while (!cancels.is_empty() && (sqe = ring.get_sqe()))
+  {
+    auto *op = static_cast<Operation *>(cancels.pop());
+    op->queue = nullptr;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<std::uintptr_t>(op);
+    sqe->user_data = reinterpret_cast<std::uintptr_t>(op) | tag;
+  }
+}
+
+/**
+ * @brief Submits queued operations and waits for completions.
+ * @details All operations queued since the last wait are submitted with a
+ * single `io_uring_enter` call, which also waits for the first completion.
+ * A poll on the notifier is submitted with the operations, so that
+ * `notify()` and operations started by other threads wake the wait up. The
+ * wait is shortened to the next timer expiry, and it waits on the notifier
+ * alone if only timers are pending. Each completed operation is handed to
+ * `dispatch`, followed by the expired timers.
+ * @param interval The maximum time to wait for a completion.
+ * @param dispatch Takes a completed operation.
+ * @return The number of completions that were handled.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <typename Fn>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::wait_for(
+    interval_type interval, Fn &&dispatch) -> size_type
+{
+  using namespace detail;
+  using clock = std::chrono::steady_clock;
+
+  auto timed = !timers_.empty();
+  auto duration = timers_.timeout(static_cast<int>(interval.count()));
+  auto [inflight, to_submit] = with_lock(mtx_, [&] {
+    if ((inflight_ || timed) && !wakeup_.armed)
+    {
+      wakeup_.armed = true;
+      pending_.push(&wakeup_);
+    }
+
+    waiting_ = inflight_ > 0 || timed;
+    prepare_cancellations<operation>(ring_, cancels_, cancel_tag);
+    return std::make_pair(inflight_,
+                          prepare_submissions<operation>(ring_, pending_));
+  });
+
+  if (!inflight && !timed)
+    return 0;
+
+  auto start = clock::now();
+  // EBUSY means that the completion queue must be drained first.
+  while (ring_.enter(to_submit, duration) < 0 && errno != EBUSY)
+  {
+    handle_uring_error({errno, std::system_category()});
+    if (duration > -1)
+      duration = remaining_duration(duration, start);
+  }
+
+  return with_lock(mtx_, [&] {
+    waiting_ = false;
+    bool woken = false;
+    unsigned cancels = 0;
+    auto count = ring_.for_each_cqe([&](const io_uring_cqe &cqe) {
+      if (cqe.user_data & cancel_tag)
+      {
+        ++cancels;
+        return;
+      }
+
+      auto *op = reinterpret_cast<operation *>(cqe.user_data);
+      if (op == &wakeup_)
+      {
+        wakeup_.armed = false;
+        woken = true;
+        notifier_.clear();
+        return;
+      }
+
+      // A cancellation that hasn't been submitted yet is no longer needed.
+      if (op->queue == &cancels_)
+        intrusive_task_queue::erase(op);
+
+      intrusive_task_queue ready_queue;
+      op->queue = nullptr;
+      op->submitted = false;
+      op->result = cqe.res;
+      ready_queue.push(op);
+      dispatch(static_cast<std::size_t>(op->fd), ready_queue);
+    });
+
+    if (woken)
+      --count;
+
+    count -= cancels;
+    inflight_ -= count;
+
+    intrusive_task_queue expired;
+    auto timers = timers_.expire(expired);
+    if (!expired.is_empty())
+      dispatch(static_cast<std::size_t>(notifier_.native_handle()), expired);
+
+    return count + timers;
+  });
+}
+
+/**
+ * @brief Submits queued operations and waits for completions.
+ * @details All operations queued since the last wait are submitted with a
+ * single `io_uring_enter` call, which also waits for the first completion.
+ * Completions are then executed outside of the lock.
+ * @param interval The maximum time to wait for a completion.
+ * @return The number of completions that were handled.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::wait_for(
+    interval_type interval) -> size_type
+{
+  intrusive_task_queue ready_queue;
+  auto count =
+      wait_for(interval, [&](std::size_t, intrusive_task_queue &ready) {
+        ready_queue.move_back(std::move(ready));
+      });
+
+  run_queue(ready_queue);
+
+  return count;
+}
+
+/**
+ * @brief Constructs a basic_io_uring_multiplexer.
+ * @param alloc The allocator.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+basic_io_uring_multiplexer<Allocator, Mutex>::basic_io_uring_multiplexer(
+    const Allocator &alloc)
+    : ring_{queue_depth}, alloc_{alloc}
+{
+  wakeup_.prepare = wakeup::prepare_poll;
+  wakeup_.fd = notifier_.native_handle();
+}
+
+/**
+ * @brief Creates a sender that completes at a deadline.
+ * @param deadline The deadline.
+ * @return The timer sender.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::schedule_at(
+    time_point deadline) -> timer_sender
+{
+  return timers_.schedule_at(this, deadline);
+}
+
+/**
+ * @brief Wakes up a thread that is blocked in `wait_for`.
+ * @details If no thread is waiting, the next wait that has operations in
+ * flight returns immediately.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_io_uring_multiplexer<Allocator, Mutex>::notify() -> void
+{
+  with_lock(mtx_, [&] { notifier_.notify(); });
+}
+
+} // namespace io::execution
+
+#include "io/socket/detail/io_uring_operations.hpp" // IWYU pragma: export
+
+#endif // IO_IO_URING_MULTIPLEXER_IMPL_HPP
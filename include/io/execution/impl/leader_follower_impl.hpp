@@ -0,0 +1,186 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file leader_follower_impl.hpp
+ * @brief This file implements the leader_follower class.
+ */
+#pragma once
+#ifndef IO_LEADER_FOLLOWER_IMPL_HPP
+#define IO_LEADER_FOLLOWER_IMPL_HPP
+#include "io/execution/detail/utilities.hpp"
+#include "io/execution/leader_follower.hpp"
+
+#include <algorithm>
+#include <chrono>
+namespace io::execution {
+/**
+ * @brief Constructs a leader_follower for the executor of a triggers.
+ * @param triggers The triggers whose executor is driven.
+ * @param strands The number of strands that sockets are hashed into.
+ */
+template <Multiplexer Mux>
+leader_follower<Mux>::leader_follower(const triggers_type &triggers,
+                                      size_type strands)
+    : executor_{triggers.get_executor().lock()},
+      strands_(std::max<size_type>(strands, 1))
+{}
+
+/**
+ * @brief Hands the ready operations of a socket to its strand.
+ * @param key The socket key.
+ * @param ready The ready operations.
+ */
+template <Multiplexer Mux>
+auto leader_follower<Mux>::dispatch(std::size_t key, task_queue &ready) -> void
+{
+  auto index = key % strands_.size();
+  auto &strand = strands_[index];
+
+  std::lock_guard lock{mtx_};
+  strand.queue.move_back(std::move(ready));
+  if (!strand.queued && !strand.running)
+  {
+    strand.queued = true;
+    runnable_.push_back(index);
+  }
+}
+
+/**
+ * @brief Executes the next runnable strand.
+ * @details If more operations were handed to the strand while it was
+ * executing, it is made runnable again. The waiting threads are woken up
+ * because the executed operations may have registered new interest.
+ * @param lock The held lock on `mtx_`.
+ * @return 1.
+ */
+template <Multiplexer Mux>
+auto leader_follower<Mux>::run_next(std::unique_lock<std::mutex> &lock)
+    -> size_type
+{
+  auto index = runnable_.front();
+  runnable_.pop_front();
+
+  auto &strand = strands_[index];
+  strand.queued = false;
+  strand.running = true;
+  ++running_;
+
+  task_queue ready;
+  ready.move_back(std::move(strand.queue));
+  if (!runnable_.empty())
+    cv_.notify_one();
+
+  lock.unlock();
+  run_queue(ready);
+  lock.lock();
+
+  strand.running = false;
+  --running_;
+  if (!strand.queue.is_empty())
+  {
+    strand.queued = true;
+    runnable_.push_back(index);
+  }
+  cv_.notify_all();
+
+  return 1;
+}
+
+/**
+ * @brief Leads a wait on the multiplexer.
+ * @details The ready operations are handed to the strands. When the wait
+ * returns, the followers are woken up so that one of them can lead the next
+ * wait.
+ * @param lock The held lock on `mtx_`.
+ * @param interval The maximum time to wait for, in milliseconds.
+ * @return The number of events that occurred.
+ */
+template <Multiplexer Mux>
+auto leader_follower<Mux>::lead(std::unique_lock<std::mutex> &lock,
+                                int interval) -> size_type
+{
+  using interval_type = typename Mux::interval_type;
+
+  leading_ = true;
+  lock.unlock();
+
+  size_type count = 0;
+  try
+  {
+    count = executor_->Mux::wait_for(
+        interval_type{interval},
+        [&](std::size_t key, task_queue &ready) { dispatch(key, ready); });
+  }
+  catch (...)
+  {
+    lock.lock();
+    leading_ = false;
+    cv_.notify_all();
+    throw;
+  }
+
+  lock.lock();
+  leading_ = false;
+  cv_.notify_all();
+  return count;
+}
+
+/**
+ * @brief Waits for events and executes ready operations.
+ * @param interval The maximum time to wait for, in milliseconds.
+ * @return The number of events that were waited for as the leader plus the
+ * number of strands that were executed.
+ */
+template <Multiplexer Mux>
+auto leader_follower<Mux>::wait_for(int interval) -> size_type
+{
+  using clock = std::chrono::steady_clock;
+
+  auto start = clock::now();
+  std::unique_lock lock{mtx_};
+  while (true)
+  {
+    if (!runnable_.empty())
+      return run_next(lock);
+
+    if (!leading_)
+    {
+      auto count = lead(lock, interval);
+      if (!runnable_.empty())
+        count += run_next(lock);
+      if (count || !running_)
+        return count;
+      // Nothing is registered until the running strands finish.
+    }
+
+    if (interval < 0)
+    {
+      cv_.wait(lock);
+      continue;
+    }
+
+    interval = detail::remaining_duration(interval, start);
+    if (!interval ||
+        cv_.wait_for(lock, std::chrono::milliseconds(interval)) ==
+            std::cv_status::timeout)
+    {
+      return 0;
+    }
+  }
+}
+
+} // namespace io::execution
+#endif // IO_LEADER_FOLLOWER_IMPL_HPP
@@ -28,14 +28,20 @@
 #include "io/execution/poll_multiplexer.hpp"
 #include "io/socket/detail/socket.hpp"
 #include "io/socket/socket_handle.hpp"
-#include "io/socket/socket_option.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <new>
+#include <span>
 #include <system_error>
+#include <utility>
 // Customization point forward declarations
 namespace io {
 struct accept_t;
+struct recvmmsg_t;
 struct recvmsg_t;
+struct sendfile_t;
+struct sendmmsg_t;
 struct sendmsg_t;
 } // namespace io
 
@@ -46,12 +52,90 @@ template <> struct poll_t::is_eager_t<accept_t> : public std::true_type {};
 
 #if IO_EAGER_RECV
 template <> struct poll_t::is_eager_t<recvmsg_t> : public std::true_type {};
+template <> struct poll_t::is_eager_t<recvmmsg_t> : public std::true_type {};
 #endif
 
 #if IO_EAGER_SEND
 template <> struct poll_t::is_eager_t<sendmsg_t> : public std::true_type {};
+template <> struct poll_t::is_eager_t<sendmmsg_t> : public std::true_type {};
+template <> struct poll_t::is_eager_t<sendfile_t> : public std::true_type {};
 #endif
 
+/**
+ * @brief Updates or inserts an event into a list of events.
+ * @details The demultiplexer records the position of the socket's event in
+ * the list. If the socket already has an event, its interest set is updated.
+ * Otherwise, the event is appended to the list.
+ * @tparam Demux The demultiplexer type.
+ * @param list The list of events.
+ * @param event The event to update or insert.
+ * @param demux The demultiplexer for the event's socket.
+ * @return A pointer to the updated or inserted event.
+ */
+template <AllocatorLike Allocator, typename Demux>
+auto update_or_insert_event(std::vector<pollfd, Allocator> *list,
+                            const pollfd &event,
+                            Demux &demux) -> poll_t::event_type *
+{
+  if (demux.index == Demux::npos)
+  {
+    demux.index = list->size();
+    list->push_back(event);
+  }
+  else
+  {
+    // NOLINTNEXTLINE(bugprone-narrowing-conversions)
+    (*list)[demux.index].events |= event.events;
+  }
+
+  return &(*list)[demux.index];
+}
+
+/**
+ * @brief Creates a pollfd structure for a given socket and trigger.
+ * @details This function creates a pollfd structure for a given socket and
+ * trigger. The pollfd structure is used to specify the events to wait for on a
+ * file descriptor.
+ * @tparam Socket The type of the socket.
+ * @param socket The socket to create the poll event for.
+ * @param trigger The execution trigger to wait for.
+ * @return A pollfd structure.
+ */
+template <SocketLike Socket>
+auto make_poll_event(const Socket &socket,
+                     execution_trigger trigger) -> struct pollfd {
+  using socket_t = socket::native_socket_type;
+  using enum execution_trigger;
+
+  struct pollfd event = {.fd = static_cast<socket_t>(socket)};
+
+  if (trigger == READ)
+    event.events |= POLLIN;
+
+  if (trigger == WRITE)
+    event.events |= POLLOUT;
+
+  // POLLERR is always reported, so an ERRQUEUE trigger only needs the socket
+  // to be in the list.
+  return event;
+}
+
+/**
+ * @brief Cancels the operation.
+ * @details If the operation was still waiting, it completes with
+ * `set_stopped()`. Otherwise it is ready or hasn't been queued yet, and the
+ * stop is handled by the code that owns it.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <Completion Fn>
+template <typename Receiver>
+auto basic_poll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::on_stop::operator()() const noexcept -> void
+{
+  if (self->mux->cancel(self, static_cast<native_socket_type>(*self->socket)))
+    stdexec::set_stopped(std::move(self->receiver));
+}
+
 /**
  * @brief Completes the operation and sends the result to the receiver.
  * @details This function is called when the operation is complete. It gets the
@@ -59,13 +143,14 @@ template <> struct poll_t::is_eager_t<sendmsg_t> : public std::true_type {};
  * failed, it sends the error to the receiver.
  * @param task_ptr A pointer to the task to complete.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, BasicLockable Mutex>
 template <Completion Fn>
 template <typename Receiver>
-auto basic_poll_multiplexer<Allocator>::sender<Fn>::state<Receiver>::complete(
-    task *task_ptr) noexcept -> void
+auto basic_poll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
+    Receiver>::complete(task *task_ptr) noexcept -> void
 {
   auto *self = static_cast<state *>(task_ptr);
+  self->callback.reset();
 
   auto error = self->socket->get_error();
   if (error && error != std::errc::operation_would_block)
@@ -81,13 +166,18 @@ auto basic_poll_multiplexer<Allocator>::sender<Fn>::state<Receiver>::complete(
 /**
  * @brief Starts the operation.
  * @details This function is called to start the operation. If the operation can
- * be completed eagerly, it is completed immediately. Otherwise, it is added to
- * the appropriate queue to be completed later.
+ * be completed eagerly, it is completed immediately. Otherwise, interest in the
+ * trigger is registered and the operation is added to the appropriate queue to
+ * be completed later. If another thread is blocked in `wait_for`, it is woken
+ * up so that it polls the new interest. If the registration can't be
+ * allocated, the operation completes immediately with `ENOMEM`. The stop
+ * callback is registered before the operation is queued, so a stop that is
+ * requested in between is seen by the registration.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, BasicLockable Mutex>
 template <Completion Fn>
 template <typename Receiver>
-auto basic_poll_multiplexer<Allocator>::sender<Fn>::state<
+auto basic_poll_multiplexer<Allocator, Mutex>::sender<Fn>::state<
     Receiver>::start() noexcept -> void
 {
   using enum execution_trigger;
@@ -95,73 +185,60 @@ auto basic_poll_multiplexer<Allocator>::sender<Fn>::state<
   if (trigger == EAGER || (error && error != std::errc::operation_would_block))
     return complete(this);
 
-  std::lock_guard lock{*mtx};
-  task::tail = state::complete;
+  if constexpr (!stdexec::unstoppable_token<stop_token>)
+  {
+    auto token = stdexec::get_stop_token(stdexec::get_env(receiver));
+    if (token.stop_requested())
+      return stdexec::set_stopped(std::move(receiver));
+    callback.emplace(token, on_stop{this});
+  }
 
-  if (trigger == WRITE)
-    demux->write_queue.push(this);
+  auto status = with_lock(mux->mtx_, [&] {
+    if (operation::cancelled)
+      return ECANCELED;
 
-  if (trigger == READ)
-    demux->read_queue.push(this);
+    try
+    {
+      auto &demux = mux->demux_[static_cast<native_socket_type>(*socket)];
+      update_or_insert_event(&mux->list_, make_poll_event(*socket, trigger),
+                             demux);
 
-  demux->socket = socket.get();
-}
+      task::tail = state::complete;
 
-/**
- * @brief Updates or inserts an event into a list of events.
- * @details This function searches for an event with the same file descriptor
- * in the list. If it finds one, it updates the event's interest set. Otherwise,
- * it inserts a new event into the list. The list is kept sorted by file
- * descriptor.
- * @param list The list of events.
- * @param event The event to update or insert.
- * @return A pointer to the updated or inserted event.
- */
-template <AllocatorLike Allocator>
-auto update_or_insert_event(std::vector<pollfd, Allocator> *list,
-                            const pollfd &event) -> poll_t::event_type *
-{
-  auto pos = std::ranges::lower_bound(
-      *list, event.fd, {}, [](const auto &event) { return event.fd; });
+      if (trigger == WRITE)
+        operation::queue = &demux.write_queue;
 
-  if (pos != std::end(*list) && pos->fd == event.fd)
-  {
-    // NOLINTNEXTLINE(bugprone-narrowing-conversions)
-    pos->events |= event.events;
-  }
-  else
-  {
-    pos = list->insert(pos, event);
-  }
+      if (trigger == READ)
+        operation::queue = &demux.read_queue;
 
-  return &*pos;
-}
+      if (trigger == ERRQUEUE)
+        operation::queue = &demux.error_queue;
 
-/**
- * @brief Creates a pollfd structure for a given socket and trigger.
- * @details This function creates a pollfd structure for a given socket and
- * trigger. The pollfd structure is used to specify the events to wait for on a
- * file descriptor.
- * @tparam Socket The type of the socket.
- * @param socket The socket to create the poll event for.
- * @param trigger The execution trigger to wait for.
- * @return A pollfd structure.
- */
-template <SocketLike Socket>
-auto make_poll_event(const Socket &socket,
-                     execution_trigger trigger) -> struct pollfd {
-  using socket_t = socket::native_socket_type;
-  using enum execution_trigger;
+      operation::queue->push(this);
 
-  struct pollfd event = {.fd = static_cast<socket_t>(socket)};
+      demux.socket = socket.get();
+      if (mux->waiting_)
+        mux->notifier_.notify();
 
-  if (trigger == READ)
-    event.events |= POLLIN;
+      return 0;
+    }
+    catch (const std::bad_alloc &)
+    {
+      return ENOMEM;
+    }
+  });
 
-  if (trigger == WRITE)
-    event.events |= POLLOUT;
+  if (status == ECANCELED)
+  {
+    callback.reset();
+    return stdexec::set_stopped(std::move(receiver));
+  }
 
-  return event;
+  if (status)
+  {
+    socket->set_error(status);
+    complete(this);
+  }
 }
 
 /**
@@ -171,35 +248,16 @@ auto make_poll_event(const Socket &socket,
  * @param receiver The receiver to connect to.
  * @return The state object for the operation.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, BasicLockable Mutex>
 template <Completion Fn>
 template <typename Receiver>
-auto basic_poll_multiplexer<Allocator>::sender<Fn>::connect(Receiver &&receiver)
-    -> state<std::decay_t<Receiver>>
+auto basic_poll_multiplexer<Allocator, Mutex>::sender<Fn>::connect(
+    Receiver &&receiver) -> state<std::decay_t<Receiver>>
 {
-  using socket_type = socket::native_socket_type;
-  using enum execution_trigger;
-
-  demultiplexer *demux_ptr = nullptr;
-  auto error = socket->get_error();
-  if ((!error || error == std::errc::operation_would_block) && trigger != EAGER)
-  {
-    std::lock_guard lock{*mtx};
-
-    auto sockfd = static_cast<socket_type>(*socket);
-    if (demux->size() < static_cast<std::size_t>(sockfd) + 1)
-      demux->resize(sockfd + 1);
-
-    demux_ptr = std::addressof(demux->at(sockfd));
-
-    update_or_insert_event(list, make_poll_event(*socket, trigger));
-  }
-
   return {.func = std::move(func),
           .socket = std::move(socket),
           .receiver = std::forward<Receiver>(receiver),
-          .demux = demux_ptr,
-          .mtx = mtx,
+          .mux = mux,
           .trigger = trigger};
 }
 
@@ -212,36 +270,19 @@ auto basic_poll_multiplexer<Allocator>::sender<Fn>::connect(Receiver &&receiver)
  * @param func The function to execute when the operation is ready.
  * @return A sender for the operation.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, BasicLockable Mutex>
 template <Completion Fn>
-auto basic_poll_multiplexer<Allocator>::set(
+auto basic_poll_multiplexer<Allocator, Mutex>::set(
     // NOLINTNEXTLINE(performance-unnecessary-value-param)
     std::shared_ptr<socket_handle> socket, execution_trigger trigger,
     Fn &&func) -> sender<std::decay_t<Fn>>
 {
   return {.func = std::forward<Fn>(func),
           .socket = std::move(socket),
-          .demux = &demux_,
-          .list = &list_,
-          .mtx = &mtx_,
+          .mux = this,
           .trigger = trigger};
 }
 
-/**
- * @brief Executes all tasks in a queue.
- * @param queue The queue of tasks to execute.
- */
-template <AllocatorLike Allocator>
-auto run_queue(typename basic_poll_multiplexer<Allocator>::intrusive_task_queue
-                   &queue) -> void
-{
-  while (!queue.is_empty())
-  {
-    auto *task = queue.pop();
-    task->execute();
-  }
-}
-
 /**
  * @brief Handles errors from the poll system call.
  * @details This function is called when the poll system call returns an error.
@@ -254,52 +295,16 @@ inline auto handle_poll_error(const std::error_code &error) -> void
     throw_system_error(IO_ERROR_MESSAGE("poll failed."));
 }
 
-namespace detail {
-
-/**
- * @brief Calculates the remaining duration from a start time and updates the
- * start time.
- *
- * This function measures the time elapsed since the `start` time_point,
- * subtracts it from the initial `duration`, and returns the remaining time. It
- * also updates the `start` time_point to the current time.
- *
- * @tparam Clock The clock type used for the time_point.
- * @tparam Duration The duration type used for the time_point.
- * @param duration The initial duration in milliseconds.
- * @param[in,out] start The time_point marking the beginning of the duration.
- * This parameter is updated to the current time (`Clock::now()`) on each call.
- * @return The remaining time in milliseconds, guaranteed to be non-negative.
- */
-template <typename Clock, typename Duration>
-auto remaining_duration(int duration,
-                        std::chrono::time_point<Clock, Duration> &start) -> int
-{
-  using clock = std::decay_t<decltype(start)>::clock;
-  static constexpr auto to_milliseconds = [](const auto &duration) -> int {
-    using namespace std::chrono;
-
-    return duration_cast<milliseconds>(duration).count();
-  };
-
-  auto old_start = start;
-  start = clock::now();
-  return std::max(0, duration - to_milliseconds(start - old_start));
-}
-
-} // namespace detail
-
 /**
  * @brief A wrapper around the poll system call.
  * @details This function calls the poll system call and handles any errors. It
- * also removes any file descriptors from the list that do not have any events.
+ * then moves the file descriptors that have events to the front of the list.
  * @param list The list of file descriptors to poll.
  * @param duration The timeout for the poll call.
- * @return The list of file descriptors that have events.
+ * @return The front of the list that contains the file descriptors that have
+ * events.
  */
-template <AllocatorLike Allocator>
-auto poll_(std::vector<pollfd, Allocator> list,
-           int duration) -> std::vector<pollfd>
+inline auto poll_(std::span<pollfd> list, int duration) -> std::span<pollfd>
 {
   using namespace detail;
   using clock = std::chrono::steady_clock;
@@ -315,64 +320,34 @@ auto poll_(std::vector<pollfd, Allocator> list,
       duration = remaining_duration(duration, start);
   }
 
-  auto [first, last] = std::ranges::remove_if(
-      list, [](const auto &event) { return event.revents == 0; });
-  list.erase(first, last);
-  return list;
+  auto [first, last] = std::ranges::partition(
+      list, [](const auto &event) { return event.revents != 0; });
+  return list.first(static_cast<std::size_t>(first - list.begin()));
 }
 
 /**
- * @brief Checks if the error is recoverable.
- *
- * This function checks if the error set by getsockopt is a recoverable
- * one. If it is recoverable, return the value. Otherwise throw an exception.
- *
- * @param error The error code to test.
- * @returns The error code to set on the socket.
- */
-inline auto handle_getsockopt_error(std::error_code error) -> int
-{
-  if (error != std::errc::bad_file_descriptor &&
-      error != std::errc::not_a_socket)
-  {
-    throw_system_error(IO_ERROR_MESSAGE("getsockopt failed."));
-  }
-
-  return error.value();
-}
-
-/**
- * @brief Gets the socket error and sets it on the socket handle.
- * @details This function gets the value of the SO_ERROR socket option and sets
- * it on the socket handle. This is used to get the error that occurred during
- * an asynchronous operation.
- * @param socket The socket handle to set the error on.
- */
-inline auto set_error(::io::socket::socket_handle &socket) -> void
-{
-  using socket_option = ::io::socket::socket_option<int>;
-
-  socket_option error{0};
-  auto [ret, optval] = ::io::getsockopt(socket, SOL_SOCKET, SO_ERROR, error);
-  if (ret)
-    *error = handle_getsockopt_error({errno, std::system_category()});
-  socket.set_error(*error);
-}
-
-/**
- * @brief Moves tasks from the demultiplexer's read and write queues to the
- * ready queue based on poll events.
+ * @brief Moves tasks from the demultiplexer's task queues to the ready queue
+ * based on poll events.
+ * @details A POLLERR without a pending socket error means that the socket's
+ * error queue is readable, for example because `MSG_ZEROCOPY` sends have
+ * completed. Only the operations that wait on the error queue are released
+ * for it, and it isn't reported as handled, so that the socket keeps its
+ * interest set.
  * @param revents The events returned from a poll call.
- * @param demux The demultiplexer containing the read and write task queues.
+ * @param demux The demultiplexer containing the task queues.
  * @param ready The queue to which ready tasks will be moved.
+ * @return The events that were handled.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, BasicLockable Mutex>
 auto prepare_handles(
     short revents,
-    typename basic_poll_multiplexer<Allocator>::demultiplexer &demux,
-    typename basic_poll_multiplexer<Allocator>::intrusive_task_queue &ready)
-    -> void
+    typename basic_poll_multiplexer<Allocator, Mutex>::demultiplexer &demux,
+    typename basic_poll_multiplexer<Allocator,
+                                    Mutex>::intrusive_task_queue &ready)
+    -> short
 {
+  using operation = basic_poll_multiplexer<Allocator, Mutex>::operation;
+
   /**
    * A POLLNVAL condition can be returned on the socket
    * if the user of the library has statically cast
@@ -386,94 +361,239 @@ auto prepare_handles(
   if (revents & (POLLERR | POLLNVAL))
     set_error(*demux.socket); // GCOVR_EXCL_LINE
 
-  if (revents & (POLLOUT | POLLERR | POLLNVAL))
-    ready.move_back(std::move(demux.write_queue));
+  if ((revents & (POLLERR | POLLNVAL)) == POLLERR && !demux.socket->get_error())
+  {
+    release_operations<operation>(demux.error_queue, ready);
+    revents = static_cast<short>(revents & ~POLLERR);
+  }
 
-  if (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
-    ready.move_back(std::move(demux.read_queue));
-}
+  if (revents & (POLLHUP | POLLERR | POLLNVAL))
+    release_operations<operation>(demux.error_queue, ready);
 
-/**
- * @brief Copies a list of pollfds and clears the events in the original list.
- * @param list The list of pollfds to copy and clear.
- * @return A copy of the list.
- */
-template <AllocatorLike Allocator>
-auto copy_active(std::vector<pollfd, Allocator> &list)
-    -> std::vector<pollfd, Allocator>
-{
-  std::vector<pollfd, Allocator> tmp{list.get_allocator()};
-  tmp.reserve(list.size());
+  if (revents & (POLLOUT | POLLERR | POLLNVAL))
+    release_operations<operation>(demux.write_queue, ready);
 
-  std::ranges::copy_if(list, std::back_inserter(tmp),
-                       [](const auto &event) { return event.events; });
+  if (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
+    release_operations<operation>(demux.read_queue, ready);
 
-  return tmp;
-} // GCOVR_EXCL_LINE
+  return revents;
+}
 
 /**
  * @brief Clears events that will be handled.
  * @details This function clears the events in the interest list that will be
  * handled. This is done to prevent the same event from being handled multiple
- * times.
- * @param events The list of events to be handled returned by poll_
+ * times. An event whose interest set becomes empty is removed from the list
+ * by moving the last event into its place, unless operations are waiting on
+ * the socket's error queue.
+ * @param event The event to be handled returned by poll_.
  * @param list The interest list managed by the poll_multiplexer.
+ * @param demux The demultiplexers indexed by file descriptor.
  */
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, typename Map>
 auto clear_event(const struct pollfd &event,
-                 std::vector<pollfd, Allocator> &list) -> void
+                 std::vector<pollfd, Allocator> &list, Map &demux) -> void
 {
-  auto pfd = std::ranges::lower_bound(list, event.fd, {},
-                                      [](const auto &tmp) { return tmp.fd; });
-  if (pfd != std::end(list) && pfd->fd == event.fd)
-  {
-    if (event.revents & (POLLERR | POLLNVAL))
-      pfd->events = 0;
+  constexpr auto npos = Map::value_type::npos;
 
-    // NOLINTNEXTLINE(bugprone-narrowing-conversions)
-    pfd->events &= ~(event.revents);
+  auto *entry = demux.find(event.fd);
+  if (!entry || entry->index == npos)
+    return;
+
+  auto &index = entry->index;
+  auto &pfd = list[index];
+  if (event.revents & (POLLERR | POLLNVAL))
+    pfd.events = 0;
+
+  // NOLINTNEXTLINE(bugprone-narrowing-conversions)
+  pfd.events &= ~(event.revents);
+  if (pfd.events || !entry->error_queue.is_empty())
+    return;
+
+  if (index != list.size() - 1)
+  {
+    pfd = list.back();
+    demux.find(pfd.fd)->index = index;
   }
+
+  list.pop_back();
+  index = npos;
+}
+
+/**
+ * @brief Cancels an operation.
+ * @details If the operation isn't waiting, it is marked as cancelled so that
+ * an operation that hasn't been queued yet isn't queued.
+ * @param op The operation to cancel.
+ * @param fd The socket of the operation.
+ * @return True if the operation was removed.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_poll_multiplexer<Allocator, Mutex>::cancel(operation *op,
+                                                      native_socket_type fd)
+    -> bool
+{
+  return with_lock(mtx_, [&] {
+    if (!op->queue)
+    {
+      op->cancelled = true;
+      return false;
+    }
+
+    auto *queue = std::exchange(op->queue, nullptr);
+    intrusive_task_queue::erase(op);
+    if (!queue->is_empty())
+      return true;
+
+    auto *demux = demux_.find(fd);
+    short events = 0;
+    if (queue == &demux->read_queue)
+      events = POLLIN;
+
+    if (queue == &demux->write_queue)
+      events = POLLOUT;
+
+    clear_event({.fd = fd, .revents = events}, list_, demux_);
+    if (demux->index == demultiplexer::npos && demux->read_queue.is_empty() &&
+        demux->write_queue.is_empty() && demux->error_queue.is_empty())
+    {
+      demux_.erase(fd);
+    }
+
+    return true;
+  });
 }
 
 /**
  * @brief Waits for events on the file descriptors in the interest list.
- * @details This function is the main entry point for the poll_multiplexer. It
- * waits for events on the file descriptors in the interest list and then
- * executes the corresponding tasks.
+ * @details The interest list is polled from a copy that is reused by the next
+ * wait, so steady state waits don't allocate. The notifier is appended to the
+ * copy so that `notify()` and interest registered by other threads wake the
+ * wait up. The wait is shortened to the next timer expiry, and it blocks on
+ * the notifier alone if only timers are pending. The ready operations of each
+ * socket are handed to `dispatch`, followed by the expired timers.
  * @param interval The maximum time to wait for an event.
+ * @param dispatch Takes the ready operations of a socket.
  * @return The number of events that were handled.
  */
-template <AllocatorLike Allocator>
-auto basic_poll_multiplexer<Allocator>::wait_for(interval_type interval)
+template <AllocatorLike Allocator, BasicLockable Mutex>
+template <typename Fn>
+auto basic_poll_multiplexer<Allocator, Mutex>::wait_for(interval_type interval,
+                                                        Fn &&dispatch)
     -> size_type
 {
-  auto list = with_lock(mtx_, [&] { return copy_active(list_); });
-
-  list = poll_(std::move(list), static_cast<int>(interval.count()));
+  auto timeout = timers_.timeout(static_cast<int>(interval.count()));
+  auto list = with_lock(mtx_, [&] {
+    auto tmp = std::move(spare_);
+    tmp.assign(list_.begin(), list_.end());
+    if (!tmp.empty() || !timers_.empty())
+    {
+      tmp.push_back({.fd = notifier_.native_handle(), .events = POLLIN});
+      waiting_ = true;
+    }
+    return tmp;
+  });
 
-  intrusive_task_queue ready_queue;
+  auto events = poll_(list, timeout);
 
-  with_lock(mtx_, [&] {
-    for (const auto &event : list)
+  return with_lock(mtx_, [&] {
+    auto count = events.size();
+    waiting_ = false;
+    for (const auto &event : events)
     {
-      clear_event(event, list_);
-      prepare_handles<Allocator>(event.revents, demux_[event.fd], ready_queue);
+      if (event.fd == notifier_.native_handle())
+      {
+        notifier_.clear();
+        --count;
+        continue;
+      }
+
+      auto *demux = demux_.find(event.fd);
+      if (!demux)
+        continue;
+
+      intrusive_task_queue ready_queue;
+      auto revents =
+          prepare_handles<Allocator, Mutex>(event.revents, *demux, ready_queue);
+      clear_event({.fd = event.fd, .revents = revents}, list_, demux_);
+      if (demux->index == demultiplexer::npos &&
+          demux->read_queue.is_empty() && demux->write_queue.is_empty() &&
+          demux->error_queue.is_empty())
+      {
+        demux_.erase(event.fd);
+      }
+
+      if (!ready_queue.is_empty())
+        dispatch(static_cast<std::size_t>(event.fd), ready_queue);
     }
+
+    intrusive_task_queue expired;
+    count += timers_.expire(expired);
+    if (!expired.is_empty())
+      dispatch(static_cast<std::size_t>(notifier_.native_handle()), expired);
+
+    if (list.capacity() > spare_.capacity())
+      spare_ = std::move(list);
+
+    return count;
   });
+}
+
+/**
+ * @brief Waits for events on the file descriptors in the interest list.
+ * @details This function is the main entry point for the poll_multiplexer. It
+ * waits for events on the file descriptors in the interest list and then
+ * executes the corresponding tasks.
+ * @param interval The maximum time to wait for an event.
+ * @return The number of events that were handled.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_poll_multiplexer<Allocator, Mutex>::wait_for(interval_type interval)
+    -> size_type
+{
+  intrusive_task_queue ready_queue;
+  auto count =
+      wait_for(interval, [&](std::size_t, intrusive_task_queue &ready) {
+        ready_queue.move_back(std::move(ready));
+      });
 
-  run_queue<Allocator>(ready_queue);
+  run_queue(ready_queue);
 
-  return list.size();
+  return count;
+}
+
+/**
+ * @brief Creates a sender that completes at a deadline.
+ * @param deadline The deadline.
+ * @return The timer sender.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_poll_multiplexer<Allocator, Mutex>::schedule_at(time_point deadline)
+    -> timer_sender
+{
+  return timers_.schedule_at(this, deadline);
+}
+
+/**
+ * @brief Wakes up a thread that is blocked in `wait_for`.
+ * @details If no thread is waiting, the next wait that has interest to poll
+ * returns immediately.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto basic_poll_multiplexer<Allocator, Mutex>::notify() -> void
+{
+  with_lock(mtx_, [&] { notifier_.notify(); });
 }
 
 /**
  * @brief Constructs a basic_poll_multiplexer.
  * @param alloc The allocator to use for all allocations.
  */
-template <AllocatorLike Allocator>
-constexpr basic_poll_multiplexer<Allocator>::basic_poll_multiplexer(
-    const Allocator &alloc) noexcept(noexcept(Allocator()))
-    : demux_{alloc}, list_{alloc} {};
+template <AllocatorLike Allocator, BasicLockable Mutex>
+basic_poll_multiplexer<Allocator, Mutex>::basic_poll_multiplexer(
+    const Allocator &alloc)
+    : demux_{alloc}, list_{alloc}, spare_{alloc}, alloc_{alloc}
+{}
 
 } // namespace io::execution
 #endif // IO_POLL_MULTIPLEXER_IMPL_HPP
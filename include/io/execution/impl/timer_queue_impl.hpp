@@ -0,0 +1,223 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file timer_queue_impl.hpp
+ * @brief This file implements the basic_timer_queue class.
+ */
+#pragma once
+#ifndef IO_TIMER_QUEUE_IMPL_HPP
+#define IO_TIMER_QUEUE_IMPL_HPP
+#include "io/execution/detail/utilities.hpp"
+#include "io/execution/timer_queue.hpp"
+
+#include <algorithm>
+#include <mutex>
+namespace io::execution {
+/**
+ * @brief Cancels the timer.
+ * @details If the timer was still in the wheel, it completes with
+ * `set_stopped()`. Otherwise it has expired or hasn't been added yet, and
+ * the stop is handled by the code that owns it.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Mux>
+template <typename Receiver>
+auto basic_timer_queue<Task, Mutex>::sender<Mux>::state<
+    Receiver>::on_stop::operator()() const noexcept -> void
+{
+  if (self->timers->cancel(self))
+    stdexec::set_stopped(std::move(self->receiver));
+}
+
+/**
+ * @brief Completes the operation when the timer expires.
+ * @param task_ptr The task to complete.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Mux>
+template <typename Receiver>
+auto basic_timer_queue<Task, Mutex>::sender<Mux>::state<Receiver>::complete(
+    Task *task_ptr) noexcept -> void
+{
+  auto *self = static_cast<state *>(task_ptr);
+  self->callback.reset();
+  stdexec::set_value(std::move(self->receiver));
+}
+
+/**
+ * @brief Starts the timer.
+ * @details The stop callback is registered before the timer is added, so a
+ * stop that is requested in between is seen by `add`. If the timer is the
+ * new earliest deadline, the multiplexer is woken up to shorten its wait.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Mux>
+template <typename Receiver>
+auto basic_timer_queue<Task, Mutex>::sender<Mux>::state<
+    Receiver>::start() noexcept -> void
+{
+  using enum timer_status;
+  Task::tail = state::complete;
+
+  if constexpr (!stdexec::unstoppable_token<stop_token>)
+  {
+    auto token = stdexec::get_stop_token(stdexec::get_env(receiver));
+    if (token.stop_requested())
+      return stdexec::set_stopped(std::move(receiver));
+    callback.emplace(token, on_stop{this});
+  }
+
+  switch (timers->add(this, deadline))
+  {
+    case CANCELLED:
+      callback.reset();
+      return stdexec::set_stopped(std::move(receiver));
+
+    case EARLIEST:
+      mux->notify();
+      return;
+
+    default:
+      return;
+  }
+}
+
+/**
+ * @brief Connects the sender to a receiver.
+ * @param receiver The receiver to connect to.
+ * @return The operation state.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Mux>
+template <typename Receiver>
+auto basic_timer_queue<Task, Mutex>::sender<Mux>::connect(Receiver &&receiver)
+    -> state<std::decay_t<Receiver>>
+{
+  return {.receiver = std::forward<Receiver>(receiver),
+          .timers = timers,
+          .mux = mux,
+          .deadline = deadline};
+}
+
+/**
+ * @brief Creates a sender that completes at a deadline.
+ * @param mux The multiplexer that is woken up by new deadlines.
+ * @param deadline The deadline.
+ * @return The sender.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Mux>
+auto basic_timer_queue<Task, Mutex>::schedule_at(Mux *mux, time_point deadline)
+    -> sender<Mux>
+{
+  return {.timers = this, .mux = mux, .deadline = deadline};
+}
+
+/**
+ * @brief Adds a timer.
+ * @param ptr The timer to add.
+ * @param deadline The deadline.
+ * @return Whether the timer was added, and if it must wake up a waiting
+ * thread.
+ */
+template <typename Task, BasicLockable Mutex>
+auto basic_timer_queue<Task, Mutex>::add(timer *ptr,
+                                         time_point deadline) -> timer_status
+{
+  using enum timer_status;
+
+  return with_lock(mtx_, [&] {
+    if (ptr->cancelled)
+      return CANCELLED;
+
+    wheel_.insert(ptr, deadline);
+    return deadline < sleep_until_ ? EARLIEST : ADDED;
+  });
+}
+
+/**
+ * @brief Cancels a timer.
+ * @param ptr The timer to cancel.
+ * @return True if the timer was removed from the wheel.
+ */
+template <typename Task, BasicLockable Mutex>
+auto basic_timer_queue<Task, Mutex>::cancel(timer *ptr) -> bool
+{
+  return with_lock(mtx_, [&] {
+    if (!ptr->is_linked())
+    {
+      ptr->cancelled = true;
+      return false;
+    }
+
+    wheel_.erase(ptr);
+    return true;
+  });
+}
+
+/**
+ * @brief Shortens a wait to the next expiry.
+ * @param interval The maximum time to wait for, in milliseconds.
+ * @return The time to wait for, in milliseconds.
+ */
+template <typename Task, BasicLockable Mutex>
+auto basic_timer_queue<Task, Mutex>::timeout(int interval) -> int
+{
+  using namespace std::chrono;
+
+  return with_lock(mtx_, [&] {
+    auto now = clock::now();
+    sleep_until_ =
+        interval < 0 ? time_point::max() : now + milliseconds(interval);
+
+    auto next = wheel_.next_expiry();
+    if (!next || *next >= sleep_until_)
+      return interval;
+
+    sleep_until_ = *next;
+    auto remaining = ceil<milliseconds>(*next - now).count();
+    return static_cast<int>(std::max<milliseconds::rep>(0, remaining));
+  });
+}
+
+/**
+ * @brief Moves the expired timers into a queue.
+ * @details The wait is over, so new timers don't need to wake anyone up
+ * until the next call to `timeout`.
+ * @param ready The queue for the expired timers.
+ * @return The number of expired timers.
+ */
+template <typename Task, BasicLockable Mutex>
+template <typename Queue>
+auto basic_timer_queue<Task, Mutex>::expire(Queue &ready) -> size_type
+{
+  return with_lock(mtx_, [&] {
+    sleep_until_ = time_point::min();
+    return wheel_.advance(clock::now(), [&](detail::timer_node *node) {
+      ready.push(static_cast<timer *>(node));
+    });
+  });
+}
+
+/** @brief Checks if there are no timers. */
+template <typename Task, BasicLockable Mutex>
+auto basic_timer_queue<Task, Mutex>::empty() const -> bool
+{
+  return with_lock(mtx_, [&] { return wheel_.empty(); });
+}
+
+} // namespace io::execution
+#endif // IO_TIMER_QUEUE_IMPL_HPP
@@ -0,0 +1,219 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file work_stealing_pool_impl.hpp
+ * @brief This file implements the work_stealing_pool class.
+ */
+#pragma once
+#ifndef IO_WORK_STEALING_POOL_IMPL_HPP
+#define IO_WORK_STEALING_POOL_IMPL_HPP
+#include "io/execution/detail/utilities.hpp"
+#include "io/execution/work_stealing_pool.hpp"
+
+#include <algorithm>
+namespace io::execution {
+/**
+ * @brief Constructs a pool for the executor of a triggers.
+ * @param triggers The triggers whose ready operations are executed.
+ * @param workers The number of workers.
+ */
+template <Multiplexer Mux>
+work_stealing_pool<Mux>::work_stealing_pool(const triggers_type &triggers,
+                                            size_type workers)
+    : executor_{triggers.get_executor().lock()},
+      workers_(std::max<size_type>(workers, 1))
+{
+  try
+  {
+    for (size_type i = 1; i < workers_.size(); ++i)
+      workers_[i].thread = std::thread([this, i] { run_worker(i); });
+  }
+  catch (...)
+  {
+    stop();
+    throw;
+  }
+}
+
+/** @brief Gets the number of workers. */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::size() const noexcept -> size_type
+{
+  return workers_.size();
+}
+
+/**
+ * @brief Adds the ready operations of a socket to the socket's batch.
+ * @details io_uring hands over each completion separately, so the batches
+ * are looked up by key to keep a socket's operations together.
+ * @param key The socket key.
+ * @param ready The ready operations.
+ */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::collect(std::size_t key, task_queue &ready)
+    -> void
+{
+  auto &slot = index_[key];
+  if (!slot)
+  {
+    batches_.emplace_back();
+    keys_.push_back(key);
+    slot = batches_.size();
+  }
+  batches_[slot - 1].move_back(std::move(ready));
+}
+
+/**
+ * @brief Executes and steals batches until all of them have been taken.
+ * @details A worker pops from the bottom of its own deque and steals from the
+ * top of the others, starting with its neighbour. No batches are added during
+ * a round, so once every batch has been taken there is nothing left to steal
+ * and the worker returns instead of waiting for the other workers to finish.
+ * A pass only comes up empty while batches remain if it lost a race to
+ * another worker that is taking one.
+ * @param index The index of the worker.
+ */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::work(size_type index) noexcept -> void
+{
+  auto size = workers_.size();
+  while (unclaimed_.load(std::memory_order_relaxed))
+  {
+    auto *batch = workers_[index].deque.pop();
+    for (size_type i = 1; !batch && i < size; ++i)
+      batch = workers_[(index + i) % size].deque.steal();
+
+    if (!batch)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    unclaimed_.fetch_sub(1, std::memory_order_relaxed);
+    run_queue(*batch);
+  }
+}
+
+/**
+ * @brief Runs a worker thread.
+ * @details The thread sleeps until a round starts, works on it until every
+ * batch has been taken, and reports back to `wait_for`.
+ * @param index The index of the worker.
+ */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::run_worker(size_type index) noexcept -> void
+{
+  size_type round = 0;
+  std::unique_lock lock{mtx_};
+  while (true)
+  {
+    start_.wait(lock, [&] { return stopping_ || round_ != round; });
+    if (stopping_)
+      return;
+
+    round = round_;
+    lock.unlock();
+    work(index);
+    lock.lock();
+
+    if (!--active_)
+      done_.notify_one();
+  }
+}
+
+/**
+ * @brief Waits for events and executes the ready operations on the pool.
+ * @details A round with a single batch, or a pool with a single worker,
+ * executes the batches on the calling thread without waking the workers.
+ * @param interval The maximum time to wait for, in milliseconds.
+ * @return The number of events that occurred.
+ */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::wait_for(int interval) -> size_type
+{
+  using interval_type = typename Mux::interval_type;
+
+  auto count = executor_->Mux::wait_for(
+      interval_type{interval},
+      [&](std::size_t key, task_queue &ready) { collect(key, ready); });
+
+  for (auto key : keys_)
+    index_.erase(key);
+  keys_.clear();
+
+  auto size = workers_.size();
+  if (batches_.size() <= 1 || size == 1)
+  {
+    for (auto &batch : batches_)
+      run_queue(batch);
+    batches_.clear();
+    return count;
+  }
+
+  auto capacity = (batches_.size() + size - 1) / size;
+  for (auto &worker : workers_)
+    worker.deque.reset(capacity);
+  for (size_type i = 0; i < batches_.size(); ++i)
+    workers_[i % size].deque.push(&batches_[i]);
+  unclaimed_.store(batches_.size(), std::memory_order_relaxed);
+
+  {
+    std::lock_guard lock{mtx_};
+    ++round_;
+    active_ = size - 1;
+  }
+  start_.notify_all();
+
+  work(0);
+
+  std::unique_lock lock{mtx_};
+  done_.wait(lock, [&] { return !active_; });
+  batches_.clear();
+
+  return count;
+}
+
+/** @brief Stops and joins the pool's threads. */
+template <Multiplexer Mux> work_stealing_pool<Mux>::~work_stealing_pool()
+{
+  stop();
+}
+
+/** @brief Stops and joins the threads that have been started. */
+template <Multiplexer Mux> auto work_stealing_pool<Mux>::stop() noexcept -> void
+{
+  {
+    std::lock_guard lock{mtx_};
+    stopping_ = true;
+  }
+  start_.notify_all();
+
+  for (auto &worker : workers_)
+  {
+    if (worker.thread.joinable())
+      worker.thread.join();
+  }
+}
+
+/** @brief Gets the number of hardware threads. */
+template <Multiplexer Mux>
+auto work_stealing_pool<Mux>::default_size() noexcept -> size_type
+{
+  return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+} // namespace io::execution
+#endif // IO_WORK_STEALING_POOL_IMPL_HPP
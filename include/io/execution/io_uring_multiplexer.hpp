@@ -0,0 +1,510 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file io_uring_multiplexer.hpp
+ * @brief This file defines the io_uring multiplexer.
+ * @details The io_uring multiplexer is a Linux specific, completion based
+ * multiplexer. Socket operations that have a matching io_uring opcode are
+ * performed by the kernel and complete directly from the completion queue.
+ * All other operations wait for readiness with `IORING_OP_POLL_ADD`.
+ */
+#pragma once
+#ifndef IO_IO_URING_MULTIPLEXER_HPP
+#define IO_IO_URING_MULTIPLEXER_HPP
+#include "detail/event_notifier.hpp"
+#include "detail/execution_trigger.hpp"
+#include "detail/null_mutex.hpp"
+#include "detail/uring.hpp"
+#include "multiplexer.hpp"
+#include "timer_queue.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+// Forward declarations.
+namespace io::socket {
+class socket_handle;
+} // namespace io::socket
+
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief Tag type for an io_uring multiplexer.
+ * @details This tag type is used to specialize the `basic_multiplexer`
+ * template for an io_uring multiplexer.
+ */
+struct io_uring_t {
+  /** @brief The multiplexed event type. */
+  using event_type = struct io_uring_cqe;
+  /** @brief The type used to specify timeouts. */
+  using interval_type = std::chrono::milliseconds;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+  /**
+   * @brief Type trait to check if an operation should evaluate eagerly.
+   * @tparam Op The operation to check.
+   */
+  template <typename Op> struct is_eager_t : public std::false_type {};
+  /**
+   * @brief Helper variable template for is_eager_t.
+   * @tparam Op The type to check.
+   */
+  template <typename Op>
+  static constexpr bool is_eager_v = is_eager_t<Op>::value;
+};
+
+/**
+ * @brief Specifies an operation that is performed by io_uring.
+ * @details `prepare` fills a submission queue entry for the operation on a
+ * file descriptor, and `complete` converts the non-negative result of the
+ * completion queue entry into the value sent by the operation. If `complete`
+ * returns an empty optional, the operation fails with `errno`.
+ * @tparam Op The operation type.
+ */
+template <typename Op>
+concept UringOperation =
+    requires(Op op, io_uring_sqe &sqe, int fd, int result) {
+      typename Op::value_type;
+      { op.prepare(sqe, fd) } noexcept;
+      {
+        op.complete(result)
+      } noexcept -> std::same_as<std::optional<typename Op::value_type>>;
+    };
+
+/**
+ * @brief A multiplexer that uses the Linux `io_uring` API.
+ * @details This class is a concrete implementation of the `basic_multiplexer`
+ * that submits operations to an io_uring instance. Operations are queued when
+ * they are started and are submitted to the kernel in a batch on the next
+ * call to `wait_for`. Operations that are started by another thread while
+ * `wait_for` is blocked wake it up through an internal notifier, so they are
+ * submitted without waiting for an unrelated completion or the timeout.
+ * A stop request cancels a waiting operation: it is removed if it hasn't
+ * been submitted yet, and cancelled with `IORING_OP_ASYNC_CANCEL` on the next
+ * wait otherwise. The kernel cancels submitted operations when the thread
+ * that called `wait_for` to submit them exits.
+ * @tparam Allocator The allocator type. io_uring operations are intrusive, so
+ * the multiplexer itself doesn't allocate, but the executor uses the
+ * allocator for the socket handles and buffers it creates.
+ * @tparam Mutex The mutex type. Use `null_mutex` if the multiplexer is only
+ * used from a single thread.
+ */
+template <AllocatorLike Allocator = std::allocator<char>,
+          BasicLockable Mutex = std::mutex>
+class basic_io_uring_multiplexer : public basic_multiplexer<io_uring_t> {
+public:
+  /** @brief The base class for the multiplexer. */
+  using Base = basic_multiplexer<io_uring_t>;
+  /** @brief The mutex type. */
+  using mutex = Mutex;
+  /** @brief The socket handle type. */
+  using socket_handle = ::io::socket::socket_handle;
+  /** @brief The task type. */
+  using task = Base::intrusive_task_queue::task;
+  /** @brief The timer queue type. */
+  using timer_queue = basic_timer_queue<task, Mutex>;
+  /** @brief The clock type of the timers. */
+  using clock_type = typename timer_queue::clock;
+  /** @brief The time point type of the timers. */
+  using time_point = typename timer_queue::time_point;
+  /** @brief The timer sender type. */
+  using timer_sender =
+      typename timer_queue::template sender<basic_io_uring_multiplexer>;
+  /** @brief The native socket type. */
+  using native_socket_type = ::io::socket::native_socket_type;
+  /** @brief The allocator type. */
+  using allocator_type = Allocator;
+
+  /** @brief The number of submission queue entries. */
+  static constexpr unsigned queue_depth = 256;
+
+  /**
+   * @brief An operation that is submitted to the io_uring instance.
+   * @details The address of the operation is used as the `user_data` of the
+   * submission queue entry, so the completion can be routed back to it and
+   * so that a submitted operation can be cancelled. The members are guarded
+   * by the multiplexer's mutex.
+   */
+  struct operation : public task {
+    /** @brief Fills the submission queue entry for the operation. */
+    void (*prepare)(operation *, io_uring_sqe &) noexcept = nullptr;
+    /** @brief The result of the completion queue entry. */
+    int result = 0;
+    /** @brief The file descriptor that the operation was submitted for. */
+    int fd = -1;
+    /** @brief The queue that the operation waits in, if any. */
+    intrusive_task_queue *queue = nullptr;
+    /** @brief True while the operation is submitted to the kernel. */
+    bool submitted = false;
+    /** @brief True if a stop was requested for the operation. */
+    bool cancelled = false;
+  };
+
+  /**
+   * @brief Demultiplexes completions.
+   * @details Each completion queue entry is routed to its operation through
+   * its `user_data`, so operations don't need to be demultiplexed by socket.
+   */
+  using demultiplexer = operation;
+
+  /**
+   * @brief A sender that waits for readiness on a socket.
+   * @details This sender is used to submit I/O operations to the multiplexer.
+   * It will complete when the socket is ready for the requested trigger, or
+   * with `set_stopped()` if a stop is requested while it is waiting.
+   * @tparam Fn The function type.
+   */
+  template <Completion Fn> struct sender {
+    /** @brief The sender concept type. */
+    using sender_concept = stdexec::sender_t;
+    /** @brief The completion signatures for the sender. */
+    using completion_signatures = stdexec::completion_signatures<
+        stdexec::set_value_t(typename std::invoke_result_t<Fn>::value_type),
+        stdexec::set_error_t(std::error_code), stdexec::set_stopped_t()>;
+
+    /**
+     * @brief An operation state for the io_uring multiplexer.
+     * @details This struct contains the state for an I/O operation. It is
+     * created when a sender is connected to a receiver.
+     * @tparam Receiver The receiver type.
+     */
+    template <typename Receiver> struct state : public operation {
+      /** @brief Cancels the operation when a stop is requested. */
+      struct on_stop {
+        /** @brief The operation to cancel. */
+        state *self;
+        /** @brief Cancels the operation. */
+        auto operator()() const noexcept -> void;
+      };
+
+      /** @brief The stop token type of the receiver. */
+      using stop_token =
+          stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+      /** @brief The stop callback type. */
+      using stop_callback = stdexec::stop_callback_for_t<stop_token, on_stop>;
+
+      /**
+       * @brief Completes the operation.
+       * @param task_ptr The task to complete.
+       */
+      static auto complete(task *task_ptr) noexcept -> void;
+      /**
+       * @brief Prepares a poll for the trigger.
+       * @param op_ptr The operation to prepare.
+       * @param sqe The submission queue entry to fill.
+       */
+      static auto prepare(operation *op_ptr, io_uring_sqe &sqe) noexcept
+          -> void;
+      /** @brief Starts the operation. */
+      auto start() noexcept -> void;
+
+      /** @brief The completion handler. */
+      Fn func;
+      /** @brief The socket to operate on. */
+      std::shared_ptr<socket_handle> socket;
+      /** @brief The receiver to complete. */
+      Receiver receiver{};
+      /** @brief The multiplexer to submit the operation to. */
+      basic_io_uring_multiplexer *mux = nullptr;
+      /** @brief The poll trigger. */
+      execution_trigger trigger{};
+      /** @brief Cancels the operation on a stop request. */
+      std::optional<stop_callback> callback;
+    };
+
+    /**
+     * @brief Connects the sender to a receiver.
+     * @param receiver The receiver to connect to.
+     * @return The operation state.
+     */
+    template <typename Receiver>
+    auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>;
+
+    /** @brief The completion handler. */
+    Fn func;
+    /** @brief The socket to operate on. */
+    std::shared_ptr<socket_handle> socket;
+    /** @brief The multiplexer to submit the operation to. */
+    basic_io_uring_multiplexer *mux = nullptr;
+    /** @brief The poll trigger. */
+    execution_trigger trigger{};
+  };
+
+  /**
+   * @brief A sender for an operation that is performed by io_uring.
+   * @details This sender completes directly from the completion queue entry
+   * of the operation, or with `set_stopped()` if a stop is requested before
+   * the operation completes.
+   * @tparam Op The operation type.
+   */
+  template <UringOperation Op> struct submission {
+    /** @brief The sender concept type. */
+    using sender_concept = stdexec::sender_t;
+    /** @brief The completion signatures for the sender. */
+    using completion_signatures = stdexec::completion_signatures<
+        stdexec::set_value_t(typename Op::value_type),
+        stdexec::set_error_t(std::error_code), stdexec::set_stopped_t()>;
+
+    /**
+     * @brief An operation state for an io_uring operation.
+     * @tparam Receiver The receiver type.
+     */
+    template <typename Receiver> struct state : public operation {
+      /** @brief Cancels the operation when a stop is requested. */
+      struct on_stop {
+        /** @brief The operation to cancel. */
+        state *self;
+        /** @brief Cancels the operation. */
+        auto operator()() const noexcept -> void;
+      };
+
+      /** @brief The stop token type of the receiver. */
+      using stop_token =
+          stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+      /** @brief The stop callback type. */
+      using stop_callback = stdexec::stop_callback_for_t<stop_token, on_stop>;
+
+      /**
+       * @brief Completes the operation.
+       * @param task_ptr The task to complete.
+       */
+      static auto complete(task *task_ptr) noexcept -> void;
+      /**
+       * @brief Prepares the operation.
+       * @param op_ptr The operation to prepare.
+       * @param sqe The submission queue entry to fill.
+       */
+      static auto prepare(operation *op_ptr, io_uring_sqe &sqe) noexcept
+          -> void;
+      /** @brief Starts the operation. */
+      auto start() noexcept -> void;
+
+      /** @brief The io_uring operation. */
+      Op op;
+      /** @brief The socket to operate on. */
+      std::shared_ptr<socket_handle> socket;
+      /** @brief The receiver to complete. */
+      Receiver receiver{};
+      /** @brief The multiplexer to submit the operation to. */
+      basic_io_uring_multiplexer *mux = nullptr;
+      /** @brief Cancels the operation on a stop request. */
+      std::optional<stop_callback> callback;
+    };
+
+    /**
+     * @brief Connects the sender to a receiver.
+     * @param receiver The receiver to connect to.
+     * @return The operation state.
+     */
+    template <typename Receiver>
+    auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>;
+
+    /** @brief The io_uring operation. */
+    Op op;
+    /** @brief The socket to operate on. */
+    std::shared_ptr<socket_handle> socket;
+    /** @brief The multiplexer to submit the operation to. */
+    basic_io_uring_multiplexer *mux = nullptr;
+  };
+
+  /**
+   * @brief Submits queued operations and waits for completions.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @return The number of completions that were handled.
+   */
+  auto wait_for(interval_type interval) -> size_type;
+
+  /**
+   * @brief Submits queued operations, waits for completions and hands the
+   * completed operations to a dispatcher instead of executing them.
+   * @details `dispatch(key, queue)` is called once for each completed
+   * operation, while the multiplexer's mutex is held. `key` identifies the
+   * operation's socket and `queue` holds the operation. `dispatch` must move
+   * the operation out of `queue` without executing it or calling back into
+   * the multiplexer.
+   * Expired timers are handed over together, keyed by the multiplexer's
+   * notifier, which is never the key of a socket.
+   * @tparam Fn The dispatcher type.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @param dispatch Takes a completed operation.
+   * @return The number of completions that occurred.
+   */
+  template <typename Fn>
+  auto wait_for(interval_type interval, Fn &&dispatch) -> size_type;
+
+  /**
+   * @brief Sets a completion handler for an event.
+   * @param socket The socket to set the completion handler for.
+   * @param trigger The event type to trigger on.
+   * @param func The completion handler.
+   * @return A sender that will complete when the event occurs.
+   */
+  template <Completion Fn>
+  auto set(std::shared_ptr<socket_handle> socket, execution_trigger trigger,
+           Fn &&func) -> sender<std::decay_t<Fn>>;
+
+  /**
+   * @brief Sets an operation to be performed by io_uring.
+   * @param socket The socket to perform the operation on.
+   * @param op The operation.
+   * @return A sender that will complete when the operation completes.
+   */
+  template <UringOperation Op>
+  auto set(std::shared_ptr<socket_handle> socket,
+           Op &&op) -> submission<std::decay_t<Op>>;
+
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @param deadline The deadline.
+   * @return A sender that completes with `set_value()` at the deadline, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  auto schedule_at(time_point deadline) -> timer_sender;
+
+  /**
+   * @brief Creates a sender that completes after a delay.
+   * @param delay The delay.
+   * @return A sender that completes with `set_value()` after the delay, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  template <typename Rep, typename Period>
+  auto schedule_after(std::chrono::duration<Rep, Period> delay)
+      -> timer_sender
+  {
+    using duration = typename clock_type::duration;
+    return schedule_at(clock_type::now() +
+                       std::chrono::duration_cast<duration>(delay));
+  }
+
+  /**
+   * @brief Wakes up a thread that is blocked in `wait_for`.
+   * @details Notifications are coalesced, so a burst of notifications wakes
+   * the waiting thread up once.
+   */
+  auto notify() -> void;
+
+  /**
+   * @brief Default constructor.
+   * @param alloc The allocator.
+   * @throws std::system_error if the io_uring instance or the notifier can't
+   * be set up.
+   */
+  explicit basic_io_uring_multiplexer(const Allocator &alloc = Allocator());
+
+  /**
+   * @brief Gets the allocator.
+   * @return A copy of the allocator the multiplexer was constructed with.
+   */
+  [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+  {
+    return alloc_;
+  }
+
+private:
+  /**
+   * @brief Polls the notifier for readability.
+   * @details It is submitted with the operations of a wait that has
+   * operations in flight. It isn't counted as in flight itself, so a wait
+   * without operations still returns immediately.
+   */
+  struct wakeup : public operation {
+    /**
+     * @brief Prepares a poll on the notifier.
+     * @param op_ptr The operation to prepare.
+     * @param sqe The submission queue entry to fill.
+     */
+    static auto prepare_poll(operation *op_ptr, io_uring_sqe &sqe) noexcept
+        -> void;
+
+    /** @brief The notifier file descriptor. */
+    int fd = -1;
+    /** @brief True while the poll is queued or submitted. */
+    bool armed = false;
+  };
+
+  /**
+   * @brief Marks the `user_data` of an `IORING_OP_ASYNC_CANCEL` entry.
+   * @details Operations are at least pointer aligned, so the low bit of
+   * their address is free.
+   */
+  static constexpr std::uintptr_t cancel_tag = 1;
+
+  /**
+   * @brief Queues an operation to be submitted on the next wait.
+   * @param op The operation to queue.
+   * @return False if the operation was cancelled before it was queued.
+   */
+  auto submit(operation *op) -> bool;
+
+  /**
+   * @brief Cancels an operation.
+   * @details An operation that hasn't been submitted yet is removed. A
+   * submitted operation is cancelled with `IORING_OP_ASYNC_CANCEL` on the
+   * next wait, and completes with `-ECANCELED` unless it completes first.
+   * @param op The operation to cancel.
+   * @return True if the operation was removed.
+   */
+  auto cancel(operation *op) -> bool;
+
+  /** @brief Wakes up a blocked wait when an operation is queued. */
+  detail::event_notifier notifier_;
+  /** @brief The timers. */
+  timer_queue timers_;
+  /** @brief The io_uring instance. */
+  detail::uring ring_;
+  /** @brief The poll on the notifier. */
+  wakeup wakeup_;
+  /** @brief True while a thread is blocked in `io_uring_enter`. */
+  bool waiting_ = false;
+  /** @brief Operations that have not been submitted yet. */
+  intrusive_task_queue pending_;
+  /** @brief Submitted operations that are waiting to be cancelled. */
+  intrusive_task_queue cancels_;
+  /** @brief The number of operations that have not completed. */
+  size_type inflight_ = 0;
+  /** @brief The allocator. */
+  [[no_unique_address]] allocator_type alloc_;
+  /** @brief A mutex for thread safety. */
+  mutable mutex mtx_;
+};
+
+/**
+ * @brief A multiplexer that uses `io_uring` with the default allocator.
+ */
+using io_uring_multiplexer = basic_io_uring_multiplexer<>;
+
+namespace pmr {
+/**
+ * @brief A multiplexer that uses `io_uring` and allocates from a
+ * `std::pmr::memory_resource`.
+ */
+using io_uring_multiplexer =
+    basic_io_uring_multiplexer<std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
+
+} // namespace io::execution
+
+#include "io/execution/impl/io_uring_multiplexer_impl.hpp" // IWYU pragma: export
+
+#endif // IO_IO_URING_MULTIPLEXER_HPP
@@ -0,0 +1,161 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file leader_follower.hpp
+ * @brief This file defines a way for several threads to wait on one
+ * executor.
+ */
+#pragma once
+#ifndef IO_LEADER_FOLLOWER_HPP
+#define IO_LEADER_FOLLOWER_HPP
+#include "executor.hpp"
+#include "io/detail/concepts.hpp"
+#include "triggers.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief Lets several threads drive the executor of a `basic_triggers`.
+ * @details Any number of threads may call `wait_for` concurrently. One of
+ * them is the leader and waits on the multiplexer while the others are
+ * followers. When the leader's wait returns, the ready operations are
+ * handed to strands, the leader promotes a follower to lead the next wait
+ * and then executes ready operations alongside the other followers.
+ *
+ * The ready operations of a socket are always handed to the same strand,
+ * and a strand is executed by at most one thread at a time, so the
+ * operations of a socket are never executed by two threads at once.
+ *
+ * The multiplexer must provide `wait_for(interval, dispatch)`, and its mutex
+ * must not be a `null_mutex`.
+ *
+ * With the io_uring multiplexer, pending operations are submitted to the
+ * kernel by whichever thread leads the next wait, and the kernel cancels the
+ * requests that a thread submitted when that thread exits. An operation that
+ * was submitted by a thread that has since exited fails with
+ * `std::errc::operation_canceled`. A thread that has called `wait_for`
+ * should therefore not exit while the executor still has pending
+ * operations, for instance before `on_empty()` of the triggers completes.
+ * @tparam Mux The multiplexer type.
+ */
+template <Multiplexer Mux> class leader_follower {
+public:
+  /** @brief The triggers type. */
+  using triggers_type = basic_triggers<Mux>;
+  /** @brief The executor type. */
+  using executor_type = executor<Mux>;
+  /** @brief The queue type of ready operations. */
+  using task_queue = typename Mux::intrusive_task_queue;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /** @brief The default number of strands. */
+  static constexpr size_type default_strands = 64;
+
+  /**
+   * @brief Constructs a leader_follower for the executor of a triggers.
+   * @param triggers The triggers whose executor is driven.
+   * @param strands The number of strands that sockets are hashed into.
+   */
+  explicit leader_follower(const triggers_type &triggers,
+                           size_type strands = default_strands);
+
+  /**
+   * @brief Waits for events and executes ready operations.
+   * @details The calling thread either leads a wait on the multiplexer or
+   * follows, executing at most one strand of ready operations before it
+   * returns.
+   * @param interval The maximum time to wait for, in milliseconds. A negative
+   * value waits indefinitely.
+   * @return The number of events that were waited for as the leader plus the
+   * number of strands that were executed. 0 means that the wait timed out or
+   * that there was nothing to wait for. While other threads are executing
+   * strands, the call waits for them instead of returning 0, because they
+   * may register new interest.
+   */
+  auto wait_for(int interval = -1) -> size_type;
+
+  /**
+   * @brief Waits for events and executes ready operations.
+   * @return The number of events and strands that were handled.
+   */
+  auto wait() -> size_type { return wait_for(); }
+
+private:
+  /** @brief The ready operations of a set of sockets. */
+  struct strand {
+    /** @brief The operations that are ready to be executed. */
+    task_queue queue;
+    /** @brief True if the strand is in the runnable list. */
+    bool queued = false;
+    /** @brief True while a thread is executing the strand. */
+    bool running = false;
+  };
+
+  /**
+   * @brief Hands the ready operations of a socket to its strand.
+   * @note Called by the multiplexer while its mutex is held.
+   * @param key The socket key.
+   * @param ready The ready operations.
+   */
+  auto dispatch(std::size_t key, task_queue &ready) -> void;
+
+  /**
+   * @brief Executes the next runnable strand.
+   * @param lock The held lock on `mtx_`. It is released while the strand's
+   * operations are executed.
+   * @return 1.
+   */
+  auto run_next(std::unique_lock<std::mutex> &lock) -> size_type;
+
+  /**
+   * @brief Leads a wait on the multiplexer.
+   * @param lock The held lock on `mtx_`. It is released during the wait.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @return The number of events that occurred.
+   */
+  auto lead(std::unique_lock<std::mutex> &lock, int interval) -> size_type;
+
+  /** @brief The executor that is driven. */
+  std::shared_ptr<executor_type> executor_;
+  /** @brief The strands. */
+  std::vector<strand> strands_;
+  /** @brief The strands that have operations and aren't running. */
+  std::deque<size_type> runnable_;
+  /** @brief The number of strands that are executing. */
+  size_type running_ = 0;
+  /** @brief True while a thread is leading a wait. */
+  bool leading_ = false;
+  /** @brief Protects the strands and the leader. */
+  std::mutex mtx_;
+  /** @brief Signals followers when work or the leadership is available. */
+  std::condition_variable cv_;
+};
+
+} // namespace io::execution
+
+#include "impl/leader_follower_impl.hpp" // IWYU pragma: export
+
+#endif // IO_LEADER_FOLLOWER_HPP
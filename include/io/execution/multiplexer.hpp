@@ -22,8 +22,6 @@
 #define IO_MULTIPLEXER_HPP
 #include "detail/immovable.hpp"
 #include "io/detail/concepts.hpp"
-
-#include <variant>
 /**
  * @namespace io::execution
  * @brief Provides high-level interfaces for executors and completion triggers.
@@ -38,43 +36,44 @@ template <MuxTag Tag> struct basic_multiplexer : public Tag {
   /** @brief The tag type for the multiplexer. */
   using multiplexer_type = Tag;
 
-  /** @brief An intrusive queue of tasks. */
+  /**
+   * @brief An intrusive queue of tasks.
+   * @details The queue is a circular doubly linked list, so a task can be
+   * erased from the middle of the queue in constant time.
+   */
   class intrusive_task_queue {
   public:
     /** @brief An intrusive task that can be executed by the multiplexer. */
     struct task : immovable {
       /** @brief Pointer to next in the intrusive queue. */
       task *next = this;
+      /** @brief Pointer to previous in the intrusive queue. */
+      task *prev = this;
 
       /**
-       * @brief Tail pointer variant.
-       *
-       * This variant holds either a tail pointer for an
-       * an intrusive queue, or a function pointer for
-       * a completion task.
-       */
-      std::variant<task *, void (*)(task *) noexcept> tail;
-
-      /**
-       * @brief Executes the task.
+       * @brief The completion function of the task.
        *
        * A completion function MUST be assigned to
        * the task before execute() is called.
        */
-      auto execute() noexcept -> void { std::get<1>(tail)(this); }
+      void (*tail)(task *) noexcept = nullptr;
+
+      /** @brief Executes the task. */
+      auto execute() noexcept -> void { tail(this); }
     };
 
     /** @brief Checks if the intrusive task queue is empty. */
     [[nodiscard]] auto is_empty() const noexcept -> bool
     {
-      return std::get<0>(head_.tail) == &head_;
+      return head_.next == &head_;
     }
 
     /** @brief Pushes a task onto the back of queue. */
     auto push(task *task) noexcept -> void
     {
       task->next = &head_;
-      head_.tail = std::get<0>(head_.tail)->next = task;
+      task->prev = head_.prev;
+      head_.prev = head_.prev->next = task;
     }
 
     /**
@@ -86,24 +85,37 @@ template <MuxTag Tag> struct basic_multiplexer : public Tag {
     {
       if (!other.is_empty())
       {
-        std::get<0>(other.head_.tail)->next = std::get<0>(head_.tail)->next;
-        std::get<0>(head_.tail)->next = other.head_.next;
-        head_.tail = other.head_.tail;
+        other.head_.next->prev = head_.prev;
+        other.head_.prev->next = &head_;
+        head_.prev->next = other.head_.next;
+        head_.prev = other.head_.prev;
 
-        other.head_.next = std::get<0>(other.head_.tail) = &other.head_;
+        other.head_.next = other.head_.prev = &other.head_;
       }
     }
 
     /** @brief Pops a task from the front of the queue. */
     auto pop() noexcept -> task *
     {
-      if (std::get<0>(head_.tail) == head_.next)
-        head_.tail = &head_;
-      return std::exchange(head_.next, head_.next->next);
+      auto *front = head_.next;
+      head_.next = front->next;
+      head_.next->prev = &head_;
+      return front;
+    }
+
+    /**
+     * @brief Erases a task from the queue that it is in.
+     * @param task The task to erase.
+     */
+    static auto erase(task *task) noexcept -> void
+    {
+      task->prev->next = task->next;
+      task->next->prev = task->prev;
+      task->next = task->prev = task;
     }
 
   private:
-    task head_{.next = &head_, .tail = &head_};
+    task head_{.next = &head_, .prev = &head_};
   };
 };
 } // namespace io::execution
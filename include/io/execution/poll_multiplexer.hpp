@@ -23,13 +23,19 @@
 #pragma once
 #ifndef IO_POLL_MULTIPLEXER_HPP
 #define IO_POLL_MULTIPLEXER_HPP
+#include "detail/event_notifier.hpp"
 #include "detail/execution_trigger.hpp"
+#include "detail/null_mutex.hpp"
+#include "detail/paged_table.hpp"
 #include "multiplexer.hpp"
+#include "timer_queue.hpp"
 
 #include <stdexec/execution.hpp>
 
-#include <deque>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 
 #include <poll.h>
 // Forward declarations.
@@ -70,22 +76,39 @@ struct poll_t {
 /**
  * @brief A multiplexer that uses the `poll` system call.
  * @details This class is a concrete implementation of the `basic_multiplexer`
- * that uses the `poll` system call to wait for I/O events.
+ * that uses the `poll` system call to wait for I/O events. An internal
+ * notifier is polled with the interest list, so that interest registered
+ * by another thread wakes up a blocked wait instead of waiting for an
+ * unrelated event or the timeout.
  * @tparam Allocator The allocator to use for all allocations.
+ * @tparam Mutex The mutex type. Use `null_mutex` if the multiplexer is only
+ * used from a single thread.
  */
-template <AllocatorLike Allocator = std::allocator<char>>
+template <AllocatorLike Allocator = std::allocator<char>,
+          BasicLockable Mutex = std::mutex>
 class basic_poll_multiplexer : public basic_multiplexer<poll_t> {
 public:
   /** @brief The base class for the multiplexer. */
   using Base = basic_multiplexer<poll_t>;
   /** @brief The mutex type. */
-  using mutex = std::mutex;
+  using mutex = Mutex;
   /** @brief The socket handle type. */
   using socket_handle = ::io::socket::socket_handle;
   /** @brief The task type. */
   using task = Base::intrusive_task_queue::task;
+  /** @brief The timer queue type. */
+  using timer_queue = basic_timer_queue<task, Mutex>;
+  /** @brief The clock type of the timers. */
+  using clock_type = typename timer_queue::clock;
+  /** @brief The time point type of the timers. */
+  using time_point = typename timer_queue::time_point;
+  /** @brief The timer sender type. */
+  using timer_sender =
+      typename timer_queue::template sender<basic_poll_multiplexer>;
   /** @brief The native socket type. */
   using native_socket_type = ::io::socket::native_socket_type;
+  /** @brief The allocator type. */
+  using allocator_type = Allocator;
   /** @brief The allocator for the vector. */
   using vector_allocator =
       std::allocator_traits<Allocator>::template rebind_alloc<event_type>;
@@ -102,24 +125,43 @@ public:
     intrusive_task_queue read_queue;
     /** @brief Pending write operations. */
     intrusive_task_queue write_queue;
+    /** @brief Pending error queue operations. */
+    intrusive_task_queue error_queue;
 
     /**
      * @brief Associated socket used for setting and getting errors.
      * @note Only valid when the operation state is valid.
      */
     socket_handle *socket = nullptr;
+
+    /** @brief Marks a socket that has no entry in the poll list. */
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    /** @brief The position of the socket's entry in the poll list. */
+    std::size_t index = npos;
   };
 
   /** @brief The allocator for the map. */
   using map_allocator =
       std::allocator_traits<Allocator>::template rebind_alloc<demultiplexer>;
   /** @brief The map type. */
-  using map_type = std::deque<demultiplexer, map_allocator>;
+  using map_type = detail::paged_table<demultiplexer, map_allocator>;
+
+  /**
+   * @brief The base of the operation states that wait in a demultiplexer.
+   * @details The members are guarded by the multiplexer's mutex.
+   */
+  struct operation : public task {
+    /** @brief The queue that the operation waits in, if any. */
+    intrusive_task_queue *queue = nullptr;
+    /** @brief True if the operation was cancelled before it was queued. */
+    bool cancelled = false;
+  };
 
   /**
    * @brief A sender for the poll multiplexer.
    * @details This sender is used to submit I/O operations to the multiplexer.
-   * It will complete when the I/O operation is ready.
+   * It will complete when the I/O operation is ready, or with
+   * `set_stopped()` if a stop is requested while it is waiting.
    * @tparam Fn The function type.
    */
   template <Completion Fn> struct sender {
@@ -128,7 +170,7 @@ public:
     /** @brief The completion signatures for the sender. */
     using completion_signatures = stdexec::completion_signatures<
         stdexec::set_value_t(typename std::invoke_result_t<Fn>::value_type),
-        stdexec::set_error_t(std::error_code)>;
+        stdexec::set_error_t(std::error_code), stdexec::set_stopped_t()>;
 
     /**
      * @brief An operation state for the poll multiplexer.
@@ -136,7 +178,21 @@ public:
      * created when a sender is connected to a receiver.
      * @tparam Receiver The receiver type.
      */
-    template <typename Receiver> struct state : public task {
+    template <typename Receiver> struct state : public operation {
+      /** @brief Cancels the operation when a stop is requested. */
+      struct on_stop {
+        /** @brief The operation to cancel. */
+        state *self;
+        /** @brief Cancels the operation. */
+        auto operator()() const noexcept -> void;
+      };
+
+      /** @brief The stop token type of the receiver. */
+      using stop_token =
+          stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+      /** @brief The stop callback type. */
+      using stop_callback = stdexec::stop_callback_for_t<stop_token, on_stop>;
+
       /**
        * @brief Completes the operation.
        * @param task_ptr The task to complete.
@@ -151,12 +207,12 @@ public:
       std::shared_ptr<socket_handle> socket;
       /** @brief The receiver to complete. */
       Receiver receiver{};
-      /** @brief The demultiplexer for the socket. */
-      demultiplexer *demux = nullptr;
-      /** @brief A mutex for thread safety. */
-      mutex *mtx = nullptr;
+      /** @brief The multiplexer to register the operation with. */
+      basic_poll_multiplexer *mux = nullptr;
       /** @brief The poll trigger. */
       execution_trigger trigger{};
+      /** @brief Cancels the operation on a stop request. */
+      std::optional<stop_callback> callback;
     };
 
     /**
@@ -171,12 +227,8 @@ public:
     Fn func;
     /** @brief The socket to operate on. */
     std::shared_ptr<socket_handle> socket;
-    /** @brief The demultiplexer for the socket. */
-    map_type *demux = nullptr;
-    /** @brief The list of poll events. */
-    vector_type *list = nullptr;
-    /** @brief A mutex for thread safety. */
-    mutex *mtx = nullptr;
+    /** @brief The multiplexer to register the operation with. */
+    basic_poll_multiplexer *mux = nullptr;
     /** @brief The poll trigger. */
     execution_trigger trigger{};
   };
@@ -188,6 +240,24 @@ public:
    */
   auto wait_for(interval_type interval) -> size_type;
 
+  /**
+   * @brief Waits for events to occur and hands the ready operations to a
+   * dispatcher instead of executing them.
+   * @details `dispatch(key, queue)` is called once for each socket that has
+   * ready operations, while the multiplexer's mutex is held. `key` identifies
+   * the socket and `queue` holds its ready operations. `dispatch` must move
+   * the operations out of `queue` without executing them or calling back into
+   * the multiplexer.
+   * Expired timers are handed over together, keyed by the multiplexer's
+   * notifier, which is never the key of a socket.
+   * @tparam Fn The dispatcher type.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @param dispatch Takes the ready operations of a socket.
+   * @return The number of events that occurred.
+   */
+  template <typename Fn>
+  auto wait_for(interval_type interval, Fn &&dispatch) -> size_type;
+
   /**
    * @brief Sets a completion handler for an event.
    * @param socket The socket to set the completion handler for.
@@ -199,18 +269,78 @@ public:
   auto set(std::shared_ptr<socket_handle> socket, execution_trigger trigger,
            Fn &&func) -> sender<std::decay_t<Fn>>;
 
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @param deadline The deadline.
+   * @return A sender that completes with `set_value()` at the deadline, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  auto schedule_at(time_point deadline) -> timer_sender;
+
+  /**
+   * @brief Creates a sender that completes after a delay.
+   * @param delay The delay.
+   * @return A sender that completes with `set_value()` after the delay, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  template <typename Rep, typename Period>
+  auto schedule_after(std::chrono::duration<Rep, Period> delay)
+      -> timer_sender
+  {
+    using duration = typename clock_type::duration;
+    return schedule_at(clock_type::now() +
+                       std::chrono::duration_cast<duration>(delay));
+  }
+
+  /**
+   * @brief Wakes up a thread that is blocked in `wait_for`.
+   * @details Notifications are coalesced, so a burst of notifications wakes
+   * the waiting thread up once.
+   */
+  auto notify() -> void;
+
   /**
    * @brief Default constructor.
    * @param alloc The allocator to use for all allocations.
+   * @throws std::system_error if the notifier can't be created.
    */
-  constexpr basic_poll_multiplexer(
-      const Allocator &alloc = Allocator()) noexcept(noexcept(Allocator()));
+  explicit basic_poll_multiplexer(const Allocator &alloc = Allocator());
+
+  /**
+   * @brief Gets the allocator.
+   * @return A copy of the allocator the multiplexer was constructed with.
+   */
+  [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+  {
+    return alloc_;
+  }
 
 private:
+  /**
+   * @brief Cancels an operation.
+   * @details If the operation is waiting in a demultiplexer, it is removed
+   * and the socket's interest in the operation's trigger is dropped when no
+   * other operations wait for it.
+   * @param op The operation to cancel.
+   * @param fd The socket of the operation.
+   * @return True if the operation was removed.
+   */
+  auto cancel(operation *op, native_socket_type fd) -> bool;
+
   /** @brief A map of file descriptors to demultiplexers. */
   map_type demux_;
-  /** @brief A list of poll events. */
+  /** @brief A dense list of poll events with a non-empty interest set. */
   vector_type list_;
+  /** @brief A spare copy of the poll list that is reused across waits. */
+  vector_type spare_;
+  /** @brief Wakes up a blocked wait when the interest list changes. */
+  detail::event_notifier notifier_;
+  /** @brief The timers. */
+  timer_queue timers_;
+  /** @brief True while a thread is blocked in `poll`. */
+  bool waiting_ = false;
+  /** @brief The allocator. */
+  [[no_unique_address]] allocator_type alloc_;
   /** @brief A mutex for thread safety. */
   mutable mutex mtx_;
 };
@@ -221,6 +351,15 @@ private:
  */
 using poll_multiplexer = basic_poll_multiplexer<>;
 
+namespace pmr {
+/**
+ * @brief A multiplexer that uses the `poll` system call and allocates from a
+ * `std::pmr::memory_resource`.
+ */
+using poll_multiplexer =
+    basic_poll_multiplexer<std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
+
 } // namespace io::execution
 
 #include "io/execution/impl/poll_multiplexer_impl.hpp" // IWYU pragma: export
@@ -0,0 +1,204 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file timer_queue.hpp
+ * @brief This file defines the timers that are owned by a multiplexer.
+ */
+#pragma once
+#ifndef IO_TIMER_QUEUE_HPP
+#define IO_TIMER_QUEUE_HPP
+#include "detail/timer_wheel.hpp"
+#include "io/detail/concepts.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/** @brief The result of adding a timer to a timer queue. */
+enum struct timer_status : std::uint8_t {
+  /** @brief The timer was added. */
+  ADDED,
+  /** @brief The timer was added and is the new earliest deadline. */
+  EARLIEST,
+  /** @brief The timer was cancelled before it was added. */
+  CANCELLED
+};
+
+/**
+ * @brief The timers of a multiplexer.
+ * @details Timers are kept in a hierarchical timing wheel, so starting and
+ * cancelling a timer are O(1). The multiplexer shortens its wait to the
+ * wheel's next expiry, and expired timers are executed with the ready I/O
+ * operations. The queue has its own mutex, so it can be used while the
+ * multiplexer's mutex is held.
+ * @tparam Task The intrusive task type of the multiplexer.
+ * @tparam Mutex The mutex type.
+ */
+template <typename Task, BasicLockable Mutex> class basic_timer_queue {
+public:
+  /** @brief The clock type. */
+  using clock = detail::timer_wheel::clock;
+  /** @brief The time point type. */
+  using time_point = clock::time_point;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /** @brief A timer task. */
+  struct timer : public Task, public detail::timer_node {
+    /** @brief True if the timer was cancelled before it was added. */
+    bool cancelled = false;
+  };
+
+  /**
+   * @brief A sender that completes at a deadline.
+   * @details The sender completes with `set_value()` when the deadline is
+   * reached, or with `set_stopped()` if a stop is requested first.
+   * @tparam Mux The multiplexer that is woken up by new deadlines.
+   */
+  template <typename Mux> struct sender {
+    /** @brief The sender concept type. */
+    using sender_concept = stdexec::sender_t;
+    /** @brief The completion signatures for the sender. */
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t(),
+                                       stdexec::set_stopped_t()>;
+
+    /**
+     * @brief The operation state of a timer.
+     * @tparam Receiver The receiver type.
+     */
+    template <typename Receiver> struct state : public timer {
+      /** @brief Cancels the timer when a stop is requested. */
+      struct on_stop {
+        /** @brief The operation to cancel. */
+        state *self;
+        /** @brief Cancels the timer. */
+        auto operator()() const noexcept -> void;
+      };
+
+      /** @brief The stop token type of the receiver. */
+      using stop_token =
+          stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+      /** @brief The stop callback type. */
+      using stop_callback = stdexec::stop_callback_for_t<stop_token, on_stop>;
+
+      /**
+       * @brief Completes the operation when the timer expires.
+       * @param task_ptr The task to complete.
+       */
+      static auto complete(Task *task_ptr) noexcept -> void;
+      /** @brief Starts the timer. */
+      auto start() noexcept -> void;
+
+      /** @brief The receiver to complete. */
+      Receiver receiver{};
+      /** @brief The timer queue. */
+      basic_timer_queue *timers = nullptr;
+      /** @brief The multiplexer to wake up. */
+      Mux *mux = nullptr;
+      /** @brief The deadline. */
+      time_point deadline{};
+      /** @brief Cancels the timer on a stop request. */
+      std::optional<stop_callback> callback;
+    };
+
+    /**
+     * @brief Connects the sender to a receiver.
+     * @param receiver The receiver to connect to.
+     * @return The operation state.
+     */
+    template <typename Receiver>
+    auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>;
+
+    /** @brief The timer queue. */
+    basic_timer_queue *timers = nullptr;
+    /** @brief The multiplexer to wake up. */
+    Mux *mux = nullptr;
+    /** @brief The deadline. */
+    time_point deadline{};
+  };
+
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @tparam Mux The multiplexer type.
+   * @param mux The multiplexer that is woken up by new deadlines.
+   * @param deadline The deadline.
+   * @return The sender.
+   */
+  template <typename Mux>
+  auto schedule_at(Mux *mux, time_point deadline) -> sender<Mux>;
+
+  /**
+   * @brief Adds a timer.
+   * @param ptr The timer to add.
+   * @param deadline The deadline.
+   * @return Whether the timer was added, and if it must wake up a waiting
+   * thread.
+   */
+  auto add(timer *ptr, time_point deadline) -> timer_status;
+
+  /**
+   * @brief Cancels a timer.
+   * @details If the timer hasn't been added yet, it is marked as cancelled
+   * and `add` refuses it.
+   * @param ptr The timer to cancel.
+   * @return True if the timer was removed and must be completed by the
+   * caller.
+   */
+  auto cancel(timer *ptr) -> bool;
+
+  /**
+   * @brief Shortens a wait to the next expiry.
+   * @details The queue records that a thread is about to wait, so that
+   * adding an earlier timer reports that it must be woken up.
+   * @param interval The maximum time to wait for, in milliseconds.
+   * @return The time to wait for, in milliseconds.
+   */
+  auto timeout(int interval) -> int;
+
+  /**
+   * @brief Moves the expired timers into a queue.
+   * @tparam Queue The intrusive task queue type.
+   * @param ready The queue for the expired timers.
+   * @return The number of expired timers.
+   */
+  template <typename Queue> auto expire(Queue &ready) -> size_type;
+
+  /** @brief Checks if there are no timers. */
+  [[nodiscard]] auto empty() const -> bool;
+
+private:
+  /** @brief The timers. */
+  detail::timer_wheel wheel_;
+  /** @brief The time until which a thread is waiting, if any. */
+  time_point sleep_until_ = time_point::min();
+  /** @brief A mutex for thread safety. */
+  mutable Mutex mtx_;
+};
+
+} // namespace io::execution
+
+#include "impl/timer_queue_impl.hpp" // IWYU pragma: export
+
+#endif // IO_TIMER_QUEUE_HPP
@@ -25,7 +25,9 @@
 #include "io/socket/socket_dialog.hpp"
 #include "io/socket/socket_handle.hpp"
 
+#include <concepts>
 #include <memory>
+#include <memory_resource>
 /**
  * @namespace io::execution
  * @brief Provides high-level interfaces for executors and completion triggers.
@@ -57,7 +59,22 @@ public:
   template <AllocatorLike Allocator>
   explicit basic_triggers(const Allocator &alloc = Allocator()) noexcept(
       noexcept(Allocator()))
-      : executor_{std::allocate_shared<executor_type>(alloc, alloc)}
+      : executor_{make_executor(alloc)}
+  {}
+
+  /**
+   * @brief Construct with a memory resource.
+   * @details The executor, its multiplexer's tables, its buffer pool and the
+   * socket handles it creates are all allocated from the resource, which
+   * must outlive them. The multiplexer must use a
+   * `std::pmr::polymorphic_allocator`, as the multiplexers in
+   * `io::execution::pmr` do.
+   * @param resource The memory resource.
+   */
+  explicit basic_triggers(std::pmr::memory_resource *resource)
+    requires std::constructible_from<executor_type,
+                                     std::pmr::polymorphic_allocator<char>>
+      : basic_triggers(std::pmr::polymorphic_allocator<char>(resource))
   {}
 
   /** @brief Deleted copy assignment operator. */
@@ -79,7 +96,7 @@ public:
   template <SocketLike Socket>
   auto push(std::shared_ptr<Socket> socket) -> socket_dialog
   {
-    return {executor_, executor_type::push(std::move(socket))};
+    return {executor_, executor_->push(std::move(socket))};
   }
 
   /**
@@ -90,7 +107,7 @@ public:
    */
   template <typename... Args> auto emplace(Args &&...args) -> socket_dialog
   {
-    return {executor_, executor_type::emplace(std::forward<Args>(args)...)};
+    return {executor_, executor_->emplace(std::forward<Args>(args)...)};
   }
 
   /**
@@ -104,6 +121,34 @@ public:
     return executor_->set(std::forward<Args>(args)...);
   }
 
+  /**
+   * @brief Creates a sender that completes at a deadline.
+   * @details The timer is owned by the executor's multiplexer, and a blocked
+   * `wait_for` wakes up when it expires.
+   * @tparam TimePoint The time point type.
+   * @param deadline The deadline.
+   * @return A sender that completes with `set_value()` at the deadline, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  template <typename TimePoint>
+  auto schedule_at(TimePoint deadline) -> decltype(auto)
+  {
+    return executor_->schedule_at(deadline);
+  }
+
+  /**
+   * @brief Creates a sender that completes after a delay.
+   * @tparam Duration The duration type.
+   * @param delay The delay.
+   * @return A sender that completes with `set_value()` after the delay, or
+   * with `set_stopped()` if a stop is requested first.
+   */
+  template <typename Duration>
+  auto schedule_after(Duration delay) -> decltype(auto)
+  {
+    return executor_->schedule_after(delay);
+  }
+
   /**
    * @brief Waits for events to occur.
    * @param interval The maximum time to wait for, in milliseconds.
@@ -120,6 +165,12 @@ public:
    */
   constexpr auto wait() -> decltype(auto) { return executor_->wait(); }
 
+  /**
+   * @brief Wakes up a thread that is blocked in `wait_for`.
+   * @details This can be called from any thread.
+   */
+  auto notify() -> decltype(auto) { return executor_->notify(); }
+
   /**
    * @brief Sends a notice when the triggers are empty.
    * @returns A sender that notifies when the triggers are empty.
@@ -143,6 +194,30 @@ public:
   ~basic_triggers() = default;
 
 private:
+  /**
+   * @brief Allocates an executor that uses an allocator.
+   * @tparam Allocator The allocator type.
+   * @param alloc The allocator.
+   * @return A shared pointer to the executor.
+   */
+  template <AllocatorLike Allocator>
+  static auto
+  make_executor(const Allocator &alloc) -> std::shared_ptr<executor_type>
+  {
+    using value_type = typename Allocator::value_type;
+    // A polymorphic allocator already passes itself to the executor, which
+    // is allocator-aware, when it constructs it.
+    if constexpr (std::same_as<Allocator,
+                               std::pmr::polymorphic_allocator<value_type>>)
+    {
+      return std::allocate_shared<executor_type>(alloc);
+    }
+    else
+    {
+      return std::allocate_shared<executor_type>(alloc, alloc);
+    }
+  }
+
   /** @brief The underlying executor. */
   std::shared_ptr<executor_type> executor_{std::make_shared<executor_type>()};
 };
@@ -0,0 +1,175 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file work_stealing_pool.hpp
+ * @brief This file defines a pool of threads that execute the ready
+ * operations of an executor with work stealing.
+ */
+#pragma once
+#ifndef IO_WORK_STEALING_POOL_HPP
+#define IO_WORK_STEALING_POOL_HPP
+#include "detail/paged_table.hpp"
+#include "detail/work_stealing_deque.hpp"
+#include "executor.hpp"
+#include "io/detail/concepts.hpp"
+#include "triggers.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+/**
+ * @namespace io::execution
+ * @brief Provides high-level interfaces for executors and completion triggers.
+ */
+namespace io::execution {
+/**
+ * @brief Executes the ready operations of an executor on a pool of workers.
+ * @details `wait_for` waits on the multiplexer from the calling thread, like
+ * `basic_triggers::wait_for`. Instead of executing the ready operations
+ * serially, it groups them into one batch per socket and deals the batches
+ * out to per-worker Chase-Lev deques. The calling thread is worker 0; it and
+ * the pool's threads execute the batches, and a worker that runs out of
+ * batches steals from the others. A worker that finds nothing left to take
+ * goes back to sleep rather than spinning while the others finish their
+ * batches. `wait_for` returns once every batch has been executed.
+ *
+ * A socket's ready operations are executed in order by one worker, and the
+ * next wait doesn't start until the batches are done, so the read and write
+ * queues of a socket stay FIFO.
+ *
+ * Only one thread may call `wait_for` at a time. The multiplexer must
+ * provide `wait_for(interval, dispatch)`, and its mutex must not be a
+ * `null_mutex` because completions may start operations from any worker.
+ * @tparam Mux The multiplexer type.
+ */
+template <Multiplexer Mux> class work_stealing_pool {
+public:
+  /** @brief The triggers type. */
+  using triggers_type = basic_triggers<Mux>;
+  /** @brief The executor type. */
+  using executor_type = executor<Mux>;
+  /** @brief The queue type of ready operations. */
+  using task_queue = typename Mux::intrusive_task_queue;
+  /** @brief A size type. */
+  using size_type = std::size_t;
+
+  /**
+   * @brief Constructs a pool for the executor of a triggers.
+   * @param triggers The triggers whose ready operations are executed.
+   * @param workers The number of workers, including the thread that calls
+   * `wait_for`. Defaults to the number of hardware threads.
+   */
+  explicit work_stealing_pool(const triggers_type &triggers,
+                              size_type workers = default_size());
+
+  /** @brief Deleted copy constructor. */
+  work_stealing_pool(const work_stealing_pool &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const work_stealing_pool &) -> work_stealing_pool & = delete;
+
+  /**
+   * @brief Gets the number of workers.
+   * @return The number of workers.
+   */
+  [[nodiscard]] auto size() const noexcept -> size_type;
+
+  /**
+   * @brief Waits for events and executes the ready operations on the pool.
+   * @param interval The maximum time to wait for, in milliseconds. A negative
+   * value waits indefinitely.
+   * @return The number of events that occurred.
+   */
+  auto wait_for(int interval = -1) -> size_type;
+
+  /**
+   * @brief Waits for events and executes the ready operations on the pool.
+   * @return The number of events that occurred.
+   */
+  auto wait() -> size_type { return wait_for(); }
+
+  /** @brief Stops and joins the pool's threads. */
+  ~work_stealing_pool();
+
+private:
+  /** @brief A worker's deque and thread. */
+  struct worker {
+    /** @brief The batches that are dealt to the worker. */
+    detail::work_stealing_deque<task_queue> deque;
+    /** @brief The worker's thread. Worker 0 has no thread. */
+    std::thread thread;
+  };
+
+  /** @brief Gets the number of hardware threads. */
+  static auto default_size() noexcept -> size_type;
+
+  /** @brief Stops and joins the threads that have been started. */
+  auto stop() noexcept -> void;
+
+  /**
+   * @brief Adds the ready operations of a socket to the socket's batch.
+   * @param key The socket key.
+   * @param ready The ready operations.
+   */
+  auto collect(std::size_t key, task_queue &ready) -> void;
+
+  /**
+   * @brief Executes and steals batches until all of them have been taken.
+   * @param index The index of the worker.
+   */
+  auto work(size_type index) noexcept -> void;
+
+  /**
+   * @brief Runs a worker thread.
+   * @param index The index of the worker.
+   */
+  auto run_worker(size_type index) noexcept -> void;
+
+  /** @brief The executor whose operations are executed. */
+  std::shared_ptr<executor_type> executor_;
+  /** @brief The workers. */
+  std::vector<worker> workers_;
+  /** @brief The batches of the current round. */
+  std::deque<task_queue> batches_;
+  /** @brief The socket key of each batch. */
+  std::vector<std::size_t> keys_;
+  /** @brief Maps a socket key to one past the index of its batch. */
+  detail::paged_table<size_type> index_;
+  /** @brief The number of batches that no worker has taken yet. */
+  std::atomic<size_type> unclaimed_ = 0;
+  /** @brief The current round. */
+  size_type round_ = 0;
+  /** @brief The number of threads that are working on the current round. */
+  size_type active_ = 0;
+  /** @brief True when the threads must exit. */
+  bool stopping_ = false;
+  /** @brief Protects the round state. */
+  std::mutex mtx_;
+  /** @brief Signals the threads that a round has started. */
+  std::condition_variable start_;
+  /** @brief Signals `wait_for` that the threads are done with a round. */
+  std::condition_variable done_;
+};
+
+} // namespace io::execution
+
+#include "impl/work_stealing_pool_impl.hpp" // IWYU pragma: export
+
+#endif // IO_WORK_STEALING_POOL_HPP
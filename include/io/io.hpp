@@ -22,13 +22,29 @@
 #pragma once
 #ifndef IO_HPP
 #define IO_HPP
-#include "execution/executor.hpp"         // IWYU pragma: export
-#include "execution/multiplexer.hpp"      // IWYU pragma: export
-#include "execution/poll_multiplexer.hpp" // IWYU pragma: export
-#include "execution/triggers.hpp"         // IWYU pragma: export
-#include "socket/socket_address.hpp"      // IWYU pragma: export
-#include "socket/socket_dialog.hpp"       // IWYU pragma: export
-#include "socket/socket_handle.hpp"       // IWYU pragma: export
-#include "socket/socket_message.hpp"      // IWYU pragma: export
-#include "socket/socket_option.hpp"       // IWYU pragma: export
-#endif                                    // IO_HPP
+#include "config.h"
+#include "execution/deadline.hpp"           // IWYU pragma: export
+#include "execution/executor.hpp"           // IWYU pragma: export
+#include "execution/executor_pool.hpp"      // IWYU pragma: export
+#include "execution/leader_follower.hpp"    // IWYU pragma: export
+#include "execution/multiplexer.hpp"        // IWYU pragma: export
+#include "execution/poll_multiplexer.hpp"   // IWYU pragma: export
+#include "execution/triggers.hpp"           // IWYU pragma: export
+#include "execution/work_stealing_pool.hpp" // IWYU pragma: export
+#include "socket/buffer_pool.hpp"           // IWYU pragma: export
+#include "socket/connection_arena.hpp"      // IWYU pragma: export
+#include "socket/socket_address.hpp"        // IWYU pragma: export
+#include "socket/socket_dialog.hpp"         // IWYU pragma: export
+#include "socket/socket_handle.hpp"         // IWYU pragma: export
+#include "socket/socket_message.hpp"        // IWYU pragma: export
+#include "socket/socket_option.hpp"         // IWYU pragma: export
+#if !OS_WINDOWS
+#include "socket/message_batch.hpp"     // IWYU pragma: export
+#include "socket/message_operation.hpp" // IWYU pragma: export
+#include "socket/stream_reader.hpp"     // IWYU pragma: export
+#endif
+#if OS_LINUX
+#include "execution/epoll_multiplexer.hpp"    // IWYU pragma: export
+#include "execution/io_uring_multiplexer.hpp" // IWYU pragma: export
+#endif
+#endif // IO_HPP
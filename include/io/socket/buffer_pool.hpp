@@ -0,0 +1,248 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file buffer_pool.hpp
+ * @brief Defines a pool of fixed-size receive buffers.
+ */
+#pragma once
+#ifndef IO_BUFFER_POOL_HPP
+#define IO_BUFFER_POOL_HPP
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+namespace io::socket {
+// Forward declarations
+class buffer_pool;
+class connection_arena;
+
+/**
+ * @brief A move-only buffer that returns itself to its pool when it is
+ * destroyed.
+ * @details The buffer keeps its pool alive. Its size is the number of bytes
+ * that hold data, and it can grow up to the buffer size of the pool.
+ */
+class pooled_buffer {
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+
+  /** @brief Constructs an empty buffer. */
+  pooled_buffer() noexcept = default;
+  /** @brief Deleted copy constructor. */
+  pooled_buffer(const pooled_buffer &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const pooled_buffer &) -> pooled_buffer & = delete;
+  /**
+   * @brief Move constructor.
+   * @param other The buffer to move from. It is left empty.
+   */
+  pooled_buffer(pooled_buffer &&other) noexcept;
+  /**
+   * @brief Move assignment.
+   * @param other The buffer to move from. It is left empty.
+   * @return A reference to this buffer.
+   */
+  auto operator=(pooled_buffer &&other) noexcept -> pooled_buffer &;
+  /** @brief Returns the buffer to its pool. */
+  ~pooled_buffer();
+
+  /** @brief Gets a pointer to the bytes of the buffer. */
+  [[nodiscard]] auto data() const noexcept -> std::byte * { return data_; }
+
+  /** @brief Gets the number of bytes that hold data. */
+  [[nodiscard]] auto size() const noexcept -> size_type { return size_; }
+
+  /** @brief Gets the number of bytes the buffer can hold. */
+  [[nodiscard]] auto capacity() const noexcept -> size_type;
+
+  /** @brief Checks if no bytes hold data. */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+  /**
+   * @brief Sets the number of bytes that hold data.
+   * @param size The new size. It is clamped to `capacity()`.
+   */
+  auto resize(size_type size) noexcept -> void;
+
+  /** @brief Returns the buffer to its pool early and leaves it empty. */
+  auto reset() noexcept -> void;
+
+  /** @brief Gets the bytes that hold data. */
+  [[nodiscard]] auto span() const noexcept -> std::span<std::byte>
+  {
+    return {data_, size_};
+  }
+
+  /** @brief Checks if the buffer holds memory from a pool. */
+  [[nodiscard]] explicit operator bool() const noexcept { return data_; }
+
+private:
+  /** @brief Grants buffer_pool access to the private constructor. */
+  friend class buffer_pool;
+
+  /**
+   * @brief Takes ownership of memory from a pool.
+   * @param pool The pool that owns the memory.
+   * @param data The memory.
+   */
+  pooled_buffer(std::shared_ptr<buffer_pool> pool, std::byte *data) noexcept
+      : pool_{std::move(pool)}, data_{data}
+  {}
+
+  /** @brief The pool the memory is returned to. */
+  std::shared_ptr<buffer_pool> pool_;
+  /** @brief The memory. */
+  std::byte *data_ = nullptr;
+  /** @brief The number of bytes that hold data. */
+  size_type size_ = 0;
+};
+
+/**
+ * @brief A slab allocator for fixed-size receive buffers.
+ *
+ * Buffers are carved from slabs that hold `slab_size` buffers each. A slab is
+ * only allocated when the pool runs out of free buffers, and slabs are kept
+ * until the pool is destroyed, so the memory of the pool follows the peak
+ * number of buffers in use rather than the number of sockets. Receiving into
+ * a pooled buffer only when a socket is readable means that idle connections
+ * don't hold any buffer.
+ *
+ * A pool must be owned by a `std::shared_ptr`. Buffers can be taken and
+ * returned from any thread, because the completions of an executor may run
+ * on several threads, for example under `leader_follower`, and a pool may be
+ * shared by several executors. Taking a buffer locks a mutex that guards the
+ * free list and the slabs, which is uncontended when a single thread takes
+ * them. Returned buffers are pushed onto a lock-free list instead, which a
+ * taker swaps out whole under the mutex when it runs out of free buffers, so
+ * no buffer is ever popped concurrently.
+ */
+class buffer_pool : public std::enable_shared_from_this<buffer_pool> {
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+
+  /** @brief The default size of a buffer. */
+  static constexpr size_type default_buffer_size = 16384;
+  /** @brief The default number of buffers in a slab. */
+  static constexpr size_type default_slab_size = 64;
+
+  /**
+   * @brief Constructs an empty pool.
+   * @param buffer_size The size of each buffer. It is rounded up to a
+   * multiple of the fundamental alignment.
+   * @param slab_size The number of buffers allocated at a time.
+   * @param upstream The memory resource the slabs are allocated from. It
+   * must outlive the pool.
+   */
+  explicit buffer_pool(
+      size_type buffer_size = default_buffer_size,
+      size_type slab_size = default_slab_size,
+      std::pmr::memory_resource *upstream =
+          std::pmr::get_default_resource()) noexcept;
+
+  /** @brief Deleted copy constructor. */
+  buffer_pool(const buffer_pool &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const buffer_pool &) -> buffer_pool & = delete;
+  /** @brief Deleted move constructor. */
+  buffer_pool(buffer_pool &&) = delete;
+  /** @brief Deleted move assignment. */
+  auto operator=(buffer_pool &&) -> buffer_pool & = delete;
+  /** @brief Gives the slabs back to the memory resource. */
+  ~buffer_pool();
+
+  /**
+   * @brief Takes a buffer from the pool.
+   * @throws std::bad_alloc if a new slab can't be allocated.
+   * @throws std::bad_weak_ptr if the pool isn't owned by a `std::shared_ptr`.
+   * @return An empty buffer with a capacity of `buffer_size()`.
+   */
+  auto acquire() -> pooled_buffer;
+
+  /**
+   * @brief Takes a buffer from the pool without throwing.
+   * @return A buffer, or an empty buffer that holds no memory if none could be
+   * taken.
+   */
+  auto try_acquire() noexcept -> pooled_buffer;
+
+  /** @brief Gets the size of each buffer. */
+  [[nodiscard]] auto buffer_size() const noexcept -> size_type
+  {
+    return buffer_size_;
+  }
+
+  /** @brief Gets the number of buffers allocated so far. */
+  [[nodiscard]] auto capacity() const noexcept -> size_type;
+
+private:
+  /** @brief Grants pooled_buffer access to release(). */
+  friend class pooled_buffer;
+  /** @brief Grants connection_arena access to take() and release(). */
+  friend class connection_arena;
+
+  /** @brief A free buffer, linked through its first bytes. */
+  struct node {
+    /** @brief The next free buffer. */
+    node *next = nullptr;
+  };
+
+  /**
+   * @brief Allocates a slab and adds its buffers to the free list.
+   * @note Called with `mtx_` held.
+   */
+  auto grow() -> void;
+
+  /**
+   * @brief Takes the memory of a buffer from the pool.
+   * @throws std::bad_alloc if a new slab can't be allocated.
+   * @return The memory, which must be given back with release().
+   */
+  auto take() -> std::byte *;
+
+  /**
+   * @brief Returns a buffer to the pool.
+   * @param data The memory of the buffer.
+   */
+  auto release(std::byte *data) noexcept -> void;
+
+  /** @brief The size of each buffer. */
+  size_type buffer_size_;
+  /** @brief The number of buffers in a slab. */
+  size_type slab_size_;
+  /** @brief The memory resource the slabs are allocated from. */
+  std::pmr::memory_resource *upstream_;
+  /** @brief Guards `slabs_` and `free_`. */
+  std::mutex mtx_;
+  /** @brief The slabs. */
+  std::pmr::vector<std::byte *> slabs_;
+  /** @brief The free buffers. */
+  node *free_ = nullptr;
+  /** @brief The buffers returned since the free list was last refilled. */
+  std::atomic<node *> returned_{nullptr};
+  /** @brief The number of buffers allocated so far. */
+  std::atomic<size_type> capacity_{0};
+};
+
+} // namespace io::socket
+
+#include "impl/buffer_pool_impl.hpp" // IWYU pragma: export
+
+#endif // IO_BUFFER_POOL_HPP
@@ -0,0 +1,259 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file connection_arena.hpp
+ * @brief Defines a per-connection arena and its allocator.
+ */
+#pragma once
+#ifndef IO_CONNECTION_ARENA_HPP
+#define IO_CONNECTION_ARENA_HPP
+#include "buffer_pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+namespace io::socket {
+/**
+ * @brief A bump allocator for the memory of a single connection.
+ *
+ * The arena carves allocations from fixed-size blocks that it takes from a
+ * `buffer_pool`, and gives all of them back to the pool at once when it is
+ * destroyed, so accepting and closing a connection costs a few pool
+ * operations no matter how many objects the connection allocated. The arena
+ * itself lives at the start of its first block, and that block is only given
+ * back once the last `std::shared_ptr` to the arena is gone.
+ *
+ * Deallocating only reclaims memory when it is the most recent allocation.
+ * Allocations that don't fit in a block are passed to the global
+ * `operator new`, and must be deallocated individually.
+ *
+ * An arena may be used from several threads at once. The objects of a
+ * connection aren't only released by its completions: a dialog can be
+ * dropped by a stop callback on the thread that requested the stop, or by a
+ * timer completion, while the socket's completions run on another worker. A
+ * mutex guards the bump pointer and the block list, and is uncontended in
+ * the common case where one thread serves the connection. The pool that the
+ * blocks come from is shared by all connections, see `buffer_pool`. The
+ * arena can be destroyed on any thread once it is no longer used.
+ */
+class connection_arena {
+  /** @brief Restricts construction to make(). */
+  struct private_tag {
+    /** @brief Default constructor. */
+    explicit private_tag() = default;
+  };
+
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+
+  /** @brief The default size of the blocks of an arena. */
+  static constexpr size_type default_block_size = 4096;
+
+  /**
+   * @brief Makes an arena that takes its blocks from a pool.
+   * @param blocks The pool. Its buffer size is the block size of the arena.
+   * @throws std::bad_alloc if a block can't be taken from the pool, or if it
+   * is too small to hold the arena.
+   * @return A shared pointer to the arena.
+   */
+  [[nodiscard]] static auto make(const std::shared_ptr<buffer_pool> &blocks)
+      -> std::shared_ptr<connection_arena>;
+
+  /**
+   * @brief Constructs an arena. Use make() instead.
+   * @param blocks The pool the blocks are taken from.
+   * @param first The free part of the block that holds the arena.
+   */
+  connection_arena(private_tag, std::shared_ptr<buffer_pool> blocks,
+                   const std::span<std::byte> &first) noexcept;
+
+  /** @brief Deleted copy constructor. */
+  connection_arena(const connection_arena &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const connection_arena &) -> connection_arena & = delete;
+  /** @brief Deleted move constructor. */
+  connection_arena(connection_arena &&) = delete;
+  /** @brief Deleted move assignment. */
+  auto operator=(connection_arena &&) -> connection_arena & = delete;
+  /** @brief Gives the blocks back to the pool. */
+  ~connection_arena() { release(); }
+
+  /**
+   * @brief Allocates memory from the arena.
+   * @param bytes The number of bytes.
+   * @param alignment The alignment, which must be a power of two.
+   * @throws std::bad_alloc if a block can't be taken from the pool.
+   * @return A pointer to the memory.
+   */
+  [[nodiscard]] auto
+  allocate(size_type bytes,
+           size_type alignment = alignof(std::max_align_t)) -> void *;
+
+  /**
+   * @brief Deallocates memory from the arena.
+   * @param ptr The memory returned by allocate().
+   * @param bytes The number of bytes passed to allocate().
+   * @param alignment The alignment passed to allocate().
+   */
+  auto deallocate(void *ptr, size_type bytes,
+                  size_type alignment = alignof(std::max_align_t)) noexcept
+      -> void;
+
+  /**
+   * @brief Gives every block but the first back to the pool and makes all of
+   * the arena free again.
+   * @details Memory allocated from the arena must not be used afterwards.
+   */
+  auto release() noexcept -> void;
+
+  /** @brief Gets the number of blocks the arena holds. */
+  [[nodiscard]] auto blocks() const noexcept -> size_type
+  {
+    auto lock = std::lock_guard(mtx_);
+    return count_;
+  }
+
+private:
+  /** @brief The header of a block taken after the first one. */
+  struct block {
+    /** @brief The block taken before this one. */
+    block *previous = nullptr;
+  };
+
+  /**
+   * @brief An allocator that places the arena in its first block.
+   * @tparam T The value type.
+   */
+  template <typename T> struct first_block;
+
+  /**
+   * @brief Checks if an allocation is too big for a block.
+   * @param bytes The number of bytes.
+   * @param alignment The alignment.
+   */
+  [[nodiscard]] auto oversized(size_type bytes,
+                               size_type alignment) const noexcept -> bool;
+
+  /**
+   * @brief Takes a block from the pool and allocates from it.
+   * @note Called with `mtx_` held.
+   */
+  auto grow() -> void;
+
+  /** @brief The pool the blocks are taken from. */
+  std::shared_ptr<buffer_pool> pool_;
+  /** @brief The free part of the first block. */
+  std::span<std::byte> first_;
+  /** @brief The most recent block taken after the first one. */
+  block *last_ = nullptr;
+  /** @brief The next free byte. */
+  std::byte *next_ = nullptr;
+  /** @brief The end of the free bytes. */
+  std::byte *end_ = nullptr;
+  /** @brief The number of blocks, including the first one. */
+  size_type count_ = 1;
+  /** @brief Protects the blocks and the free bytes. */
+  mutable std::mutex mtx_;
+};
+
+/**
+ * @brief An allocator that allocates from a `connection_arena`.
+ * @details The allocator keeps the arena alive. A default constructed
+ * allocator has no arena and uses `std::allocator` instead, so allocator-aware
+ * types can be default constructed.
+ * @tparam T The value type.
+ */
+template <typename T> class arena_allocator {
+public:
+  /** @brief The value type. */
+  using value_type = T;
+  /** @brief Containers take the allocator along when they are moved. */
+  using propagate_on_container_move_assignment = std::true_type;
+  /** @brief Containers swap their allocators. */
+  using propagate_on_container_swap = std::true_type;
+
+  /** @brief Constructs an allocator without an arena. */
+  arena_allocator() noexcept = default;
+
+  /**
+   * @brief Constructs an allocator for an arena.
+   * @param arena The arena, or nullptr to use `std::allocator`.
+   */
+  explicit arena_allocator(std::shared_ptr<connection_arena> arena) noexcept
+      : arena_{std::move(arena)}
+  {}
+
+  /**
+   * @brief Constructs an allocator that uses the arena of another one.
+   * @tparam U The value type of the other allocator.
+   * @param other The other allocator.
+   */
+  template <typename U>
+  arena_allocator(const arena_allocator<U> &other) noexcept
+      : arena_{other.arena()}
+  {}
+
+  /**
+   * @brief Allocates memory for `n` objects.
+   * @param n The number of objects.
+   * @throws std::bad_array_new_length if the size overflows.
+   * @throws std::bad_alloc if the memory can't be allocated.
+   * @return A pointer to the memory.
+   */
+  [[nodiscard]] auto allocate(std::size_t n) -> T *;
+
+  /**
+   * @brief Deallocates memory for `n` objects.
+   * @param ptr The memory returned by allocate().
+   * @param n The number of objects passed to allocate().
+   */
+  auto deallocate(T *ptr, std::size_t n) noexcept -> void;
+
+  /** @brief Gets the arena, or nullptr if there is none. */
+  [[nodiscard]] auto
+  arena() const noexcept -> const std::shared_ptr<connection_arena> &
+  {
+    return arena_;
+  }
+
+private:
+  /** @brief The arena. */
+  std::shared_ptr<connection_arena> arena_;
+};
+
+/**
+ * @brief Checks if two allocators use the same arena.
+ * @tparam T The value type of the left-hand side.
+ * @tparam U The value type of the right-hand side.
+ * @param lhs The left-hand side of the comparison.
+ * @param rhs The right-hand side of the comparison.
+ * @returns `true` if memory from one can be deallocated by the other.
+ */
+template <typename T, typename U>
+auto operator==(const arena_allocator<T> &lhs,
+                const arena_allocator<U> &rhs) noexcept -> bool
+{
+  return lhs.arena() == rhs.arena();
+}
+
+} // namespace io::socket
+
+#include "impl/connection_arena_impl.hpp" // IWYU pragma: export
+
+#endif // IO_CONNECTION_ARENA_HPP
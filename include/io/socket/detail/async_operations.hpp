@@ -24,13 +24,21 @@
 #include "io/detail/customization.hpp"
 #include "io/detail/small_functor.hpp"
 #include "io/error.hpp"
+#include "io/execution/detail/eager_sender.hpp"
 #include "io/execution/detail/execution_trigger.hpp"
+#include "io/socket/buffer_pool.hpp"
 #include "io/socket/socket_dialog.hpp"
+#include "queued_sender.hpp"
+#include "sendfile_sender.hpp"
 #include "socket.hpp"
 
 #include <stdexec/execution.hpp>
 
+#include <memory>
 #include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 namespace io::socket {
 namespace detail {
 /**
@@ -50,6 +58,80 @@ auto get_executor(const socket_dialog<Mux> &dialog)
   throw std::invalid_argument(IO_ERROR_MESSAGE("Invalid executor in dialog."));
 }
 
+/**
+ * @brief Makes the dialog for an accepted connection.
+ * @details The connection gets its own arena if the executor has arenas
+ * enabled.
+ * @tparam Mux The multiplexer type.
+ * @param executor The executor that owns the connection.
+ * @param handle The accepted socket handle.
+ * @return The socket dialog for the connection.
+ */
+template <Multiplexer Mux>
+auto make_connection(
+    const std::shared_ptr<::io::execution::executor<Mux>> &executor,
+    socket_handle &&handle) -> socket_dialog<Mux>
+{
+  auto arena = executor->make_arena();
+  auto socket = executor->push(std::move(handle), arena);
+  return {executor, std::move(socket), nullptr, nullptr, std::move(arena)};
+}
+
+#if OS_LINUX
+/**
+ * @brief Starts a detached operation that waits on the socket's error queue
+ * until the kernel has released all of the dialog's zero-copy sends.
+ * @details The operation is owned by the executor. If sends are still
+ * pending after it has read the error queue, it is started again, so that
+ * their notifications never sit unread with nothing waiting on the error
+ * queue. Otherwise the socket would keep polling as ready. If it can't be
+ * started, or it fails or is stopped, the tracker is disarmed so that the
+ * next send retries.
+ * @tparam Mux The multiplexer type.
+ * @param dialog The socket dialog with the zero-copy tracker.
+ */
+template <Multiplexer Mux>
+auto reap_zerocopy(const socket_dialog<Mux> &dialog) noexcept -> void
+{
+  using namespace ::io::detail;
+  using enum ::io::execution::execution_trigger;
+
+  using result_t = std::optional<std::size_t>;
+  using functor = small_functor<result_t() noexcept, sizeof(dialog)>;
+
+  auto zerocopy = dialog.zerocopy;
+  auto sockfd = static_cast<native_socket_type>(*dialog.socket);
+  try
+  {
+    auto executor = get_executor(dialog);
+    auto reap = functor([=]() noexcept { return zerocopy->reap(sockfd); });
+    auto disarm = [zerocopy]() noexcept { zerocopy->disarm(); };
+    auto rearm = [dialog](auto &&error) noexcept {
+      dialog.zerocopy->disarm();
+      if constexpr (std::is_same_v<std::decay_t<decltype(error)>,
+                                   std::error_code>)
+      {
+        if (error == std::errc::operation_would_block &&
+            dialog.zerocopy->try_arm())
+        {
+          reap_zerocopy(dialog);
+        }
+      }
+    };
+
+    auto sender = executor->set(dialog.socket, ERRQUEUE, std::move(reap));
+    executor->spawn(std::move(sender) |
+                    stdexec::then([](auto &&) noexcept {}) |
+                    stdexec::upon_error(std::move(rearm)) |
+                    stdexec::upon_stopped(disarm));
+  }
+  catch (...)
+  {
+    zerocopy->disarm();
+  }
+}
+#endif
+
 /**
  * @brief Handles asynchronous connect errors.
  * @tparam Mux The multiplexer type.
@@ -72,23 +154,32 @@ auto handle_connect_error(const socket_dialog<Mux> &dialog) -> void
 }
 
 /**
- * @brief A helper struct for ensuring fairness in scheduling asynchronous
- * operations.
+ * @brief The type of a sender that is scoped to an executor.
+ * @tparam Mux The multiplexer type.
+ * @tparam Fn The completion handler type.
  */
-struct fairness {
-  /// @brief The type of the counter.
-  using counter_type = std::uint8_t;
-
-  /**
-   * @brief Returns a reference to a static atomic counter.
-   * @return A reference to the counter.
-   */
-  static auto counter() -> std::atomic<counter_type> &
-  {
-    static std::atomic<counter_type> counter;
-    return counter;
-  }
-};
+template <Multiplexer Mux, Completion Fn>
+using scoped_sender_t =
+    decltype(std::declval<typename socket_dialog<Mux>::executor_type &>().set(
+        std::declval<std::shared_ptr<socket_handle>>(),
+        execution::execution_trigger{}, std::declval<Fn>()));
+
+/**
+ * @brief The type of the sender of an operation on a socket dialog.
+ * @details If the multiplexer completes the operation eagerly, the sender
+ * holds the result of an eager call into the socket API when there is one,
+ * and completes it without going through the executor.
+ * @tparam Mux The multiplexer type.
+ * @tparam Op The operation tag type.
+ * @tparam Fn The completion handler type.
+ */
+template <Multiplexer Mux, typename Op, Completion Fn>
+using operation_sender_t = std::conditional_t<
+    Mux::template is_eager_v<Op>,
+    execution::detail::eager_sender<
+        typename std::invoke_result_t<Fn>::value_type,
+        scoped_sender_t<Mux, Fn>>,
+    scoped_sender_t<Mux, Fn>>;
 } // namespace detail
 
 /**
@@ -112,6 +203,7 @@ auto tag_invoke([[maybe_unused]] accept_t *ptr,
   using result_t = std::pair<socket_dialog, std::span<const std::byte>>;
   using functor =
       small_functor<std::optional<result_t>() noexcept, sizeof(result_t)>;
+  using sender_t = operation_sender_t<Mux, accept_t, functor>;
   using enum execution_trigger;
 
   auto executor = get_executor(dialog);
@@ -119,33 +211,37 @@ auto tag_invoke([[maybe_unused]] accept_t *ptr,
 
   if constexpr (Mux::template is_eager_v<accept_t>)
   {
-    if (++fairness::counter())
+    auto &predictor = socket->read_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
     {
       auto [sock, addr] = ::io::accept(*socket, address);
       if (sock)
       {
-        auto res = result_t{{executor, executor->push(std::move(sock))}, addr};
-        return executor->set(socket, EAGER, // GCOVR_EXCL_LINE
-                             functor([res = std::move(res)]() noexcept {
-                               return std::optional<result_t>{std::move(res)};
-                             }));
+        predictor.hit();
+        return sender_t(
+            result_t{make_connection(executor, std::move(sock)), addr});
       }
 
       socket->set_error(errno);
       auto error = socket->get_error();
 
       if (error && error != std::errc::operation_would_block)
-        return executor->set(socket, EAGER, functor());
+      {
+        predictor.hit();
+        return sender_t(error);
+      }
+
+      predictor.miss();
     }
   }
 
-  return executor->set(
+  return sender_t(executor->set(
       socket, READ, functor([=, socket = socket.get()]() noexcept {
         auto [sock, addr] = ::io::accept(*socket, address);
         return (sock) ? std::optional<result_t>(
-                            {{executor, executor->push(std::move(sock))}, addr})
+                            {make_connection(executor, std::move(sock)), addr})
                       : std::nullopt;
-      }));
+      })));
 }
 
 /**
@@ -272,6 +368,7 @@ auto tag_invoke([[maybe_unused]] recvmsg_t *ptr,
   using result_t = std::streamsize;
   using functor = small_functor<std::optional<result_t>() noexcept,
                                 sizeof(dialog) + sizeof(msg) + sizeof(flags)>;
+  using sender_t = operation_sender_t<Mux, recvmsg_t, functor>;
   using enum execution_trigger;
 
   auto executor = get_executor(dialog);
@@ -279,22 +376,27 @@ auto tag_invoke([[maybe_unused]] recvmsg_t *ptr,
 
   if constexpr (Mux::template is_eager_v<recvmsg_t>)
   {
-    if (++fairness::counter())
+    auto &predictor = socket->read_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
     {
       result_t len = ::io::recvmsg(*socket, msg, flags);
 
       if (len >= 0)
       {
-        return executor->set(socket, EAGER, functor([len]() noexcept {
-                               return std::optional<result_t>{len};
-                             }));
+        predictor.hit();
+        return sender_t(len);
       }
 
       socket->set_error(errno);
       auto error = socket->get_error();
 
       if (error && error != std::errc::operation_would_block)
-        return executor->set(socket, EAGER, functor());
+      {
+        predictor.hit();
+        return sender_t(error);
+      }
+
+      predictor.miss();
     }
   }
 
@@ -307,17 +409,30 @@ auto tag_invoke([[maybe_unused]] recvmsg_t *ptr,
   if constexpr (requires { msg.msg_flags; })
     msg_flags = &msg.msg_flags;
 
-  return executor->set(
-      socket, READ, functor([=, socket = socket.get()]() mutable noexcept {
+  auto trigger = READ;
+#ifdef MSG_ERRQUEUE
+  // The error queue doesn't make the socket readable.
+  if (flags & MSG_ERRQUEUE)
+    trigger = ERRQUEUE;
+#endif
+
+  return sender_t(executor->set(
+      socket, trigger, functor([=, socket = socket.get()]() mutable noexcept {
         std::streamsize len = ::io::recvmsg(*socket, msghdr, flags);
         if (msg_flags)
           *msg_flags = msghdr.msg_flags;
         return (len < 0) ? std::nullopt : std::optional<result_t>{len};
-      }));
+      })));
 }
 
 /**
  * @brief Asynchronously sends a message on a socket.
+ * @details If the dialog has a write queue, the send is queued when it starts
+ * and coalesced with the other sends on the queue, see
+ * `socket_dialog::with_write_queue()`.
+ * Otherwise, if the dialog has a zero-copy tracker, the send waits for the
+ * socket to become writable and is made with `MSG_ZEROCOPY`, see
+ * `socket_dialog::with_zerocopy()`.
  * @tparam Mux The multiplexer type.
  * @tparam Message The message type.
  * @param dialog The socket dialog.
@@ -335,41 +450,333 @@ auto tag_invoke([[maybe_unused]] sendmsg_t *ptr,
   using namespace detail;
 
   using result_t = std::streamsize;
+  // The flags captured after a message are padded to its alignment.
   using functor = small_functor<std::optional<result_t>() noexcept,
-                                sizeof(dialog) + sizeof(msg) + sizeof(flags)>;
+                                sizeof(dialog) + sizeof(msg) +
+                                    alignof(Message)>;
+  using operation_t = operation_sender_t<Mux, sendmsg_t, functor>;
+  using sender_t = queued_sender<result_t, operation_t>;
   using enum io::execution::execution_trigger;
 
   auto executor = get_executor(dialog);
   auto &socket = dialog.socket;
 
+  if (auto writes = dialog.writes)
+  {
+    // The conversion only reads the message.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto msghdr = static_cast<socket_message_type>(const_cast<Message &>(msg));
+    if (!msghdr.msg_name && !msghdr.msg_control)
+    {
+      // The request is queued when the operation starts.
+      auto req = write_queue::make_request({msghdr.msg_iov, msghdr.msg_iovlen},
+                                           dialog.get_allocator());
+      auto send = functor(
+          [writes, req = req.get(), socket = socket.get(), flags]() noexcept {
+            auto sockfd = static_cast<native_socket_type>(*socket);
+            return writes->complete(*req, sockfd, flags | MSG_NOSIGNAL);
+          });
+      return sender_t(operation_t(executor->set(socket, WRITE, std::move(send))),
+                      std::move(writes), std::move(req));
+    }
+  }
+
+#if OS_LINUX
+  if (dialog.zerocopy)
+  {
+    return sender_t(operation_t(executor->set(
+        socket, WRITE,
+        functor([dialog, flags, msg = msg]() mutable noexcept {
+          auto msghdr = static_cast<socket_message_type>(msg);
+          auto sockfd = static_cast<native_socket_type>(*dialog.socket);
+          auto &zerocopy = dialog.zerocopy;
+
+          result_t len = zerocopy->send(sockfd, msghdr, flags | MSG_NOSIGNAL);
+          if (len >= 0 && zerocopy->try_arm())
+            reap_zerocopy(dialog);
+
+          return (len < 0) ? std::nullopt : std::optional<result_t>{len};
+        }))));
+  }
+#endif
+
   if constexpr (Mux::template is_eager_v<sendmsg_t>)
   {
-    if (++fairness::counter())
+    auto &predictor = socket->write_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
     {
       std::streamsize len = ::io::sendmsg(*socket, msg, flags | MSG_NOSIGNAL);
 
       if (len >= 0)
       {
-        return executor->set(socket, EAGER, functor([len]() noexcept {
-                               return std::optional<result_t>{len};
-                             }));
+        predictor.hit();
+        return sender_t(operation_t(len));
       }
 
       socket->set_error(errno);
       auto error = socket->get_error();
 
       if (error && error != std::errc::operation_would_block)
-        return executor->set(socket, EAGER, functor());
+      {
+        predictor.hit();
+        return sender_t(operation_t(error));
+      }
+
+      predictor.miss();
     }
   }
 
-  return executor->set(
+  return sender_t(operation_t(executor->set(
       socket, WRITE, functor([=, socket = socket.get()]() noexcept {
         result_t len = ::io::sendmsg(*socket, msg, flags | MSG_NOSIGNAL);
         return (len < 0) ? std::nullopt : std::optional<result_t>{len};
+      }))));
+}
+
+#if !OS_WINDOWS
+/**
+ * @brief Asynchronously receives into a buffer from the executor's pool.
+ * @details The operation waits for the socket to become readable before it
+ * takes a buffer, so a connection that is waiting for data doesn't hold one.
+ * If the receive fails, the buffer goes straight back to the pool.
+ * @tparam Mux The multiplexer type.
+ * @param dialog The socket dialog.
+ * @param flags The message flags.
+ * @return A sender that will contain a buffer that holds the bytes received,
+ * or an empty optional on error. An empty buffer means the end of the stream.
+ */
+template <Multiplexer Mux>
+auto tag_invoke([[maybe_unused]] recv_t *ptr, const socket_dialog<Mux> &dialog,
+                int flags) -> decltype(auto)
+{
+  using namespace ::io::detail;
+  using namespace ::io::execution;
+  using namespace detail;
+
+  using result_t = pooled_buffer;
+  using functor = small_functor<std::optional<result_t>() noexcept,
+                                sizeof(dialog) + sizeof(flags)>;
+  using enum execution_trigger;
+
+  auto executor = get_executor(dialog);
+  auto &socket = dialog.socket;
+
+  return executor->set(
+      socket, READ,
+      functor([=, pool = executor->buffers(),
+               socket = socket.get()]() noexcept -> std::optional<result_t> {
+        auto buf = pool->try_acquire();
+        if (!buf)
+        {
+          errno = ENOMEM;
+          return std::nullopt;
+        }
+
+        native_buffer_type iov = {.iov_base = buf.data(),
+                                  .iov_len = buf.capacity()};
+        auto msg = message_header{.msg_iov = std::span(&iov, 1)};
+        std::streamsize len = ::io::recvmsg(*socket, msg, flags);
+        if (len < 0)
+          return std::nullopt;
+
+        buf.resize(len);
+        return buf;
       }));
 }
 
+/**
+ * @brief Asynchronously receives a batch of messages from a socket.
+ * @tparam Mux The multiplexer type.
+ * @tparam Batch The message batch type.
+ * @param dialog The socket dialog.
+ * @param batch The batch to receive into. It must outlive the operation.
+ * @param flags The message flags.
+ * @return A sender that will contain the number of messages received, or an
+ * empty optional on error.
+ */
+template <Multiplexer Mux, MessageBatchLike Batch>
+auto tag_invoke([[maybe_unused]] recvmmsg_t *ptr,
+                const socket_dialog<Mux> &dialog, Batch &batch,
+                int flags) -> decltype(auto)
+{
+  using namespace ::io::detail;
+  using namespace ::io::execution;
+  using namespace detail;
+
+  using result_t = int;
+  using functor = small_functor<std::optional<result_t>() noexcept,
+                                sizeof(dialog) + sizeof(&batch) +
+                                    sizeof(flags)>;
+  using sender_t = operation_sender_t<Mux, recvmmsg_t, functor>;
+  using enum execution_trigger;
+
+  auto executor = get_executor(dialog);
+  auto &socket = dialog.socket;
+
+  if constexpr (Mux::template is_eager_v<recvmmsg_t>)
+  {
+    auto &predictor = socket->read_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
+    {
+      result_t count = ::io::recvmmsg(*socket, batch, flags);
+
+      if (count >= 0)
+      {
+        predictor.hit();
+        return sender_t(count);
+      }
+
+      socket->set_error(errno);
+      auto error = socket->get_error();
+
+      if (error && error != std::errc::operation_would_block)
+      {
+        predictor.hit();
+        return sender_t(error);
+      }
+
+      predictor.miss();
+    }
+  }
+
+  return sender_t(executor->set(
+      socket, READ,
+      functor([=, batch = &batch, socket = socket.get()]() noexcept {
+        result_t count = ::io::recvmmsg(*socket, *batch, flags);
+        return (count < 0) ? std::nullopt : std::optional<result_t>{count};
+      })));
+}
+
+/**
+ * @brief Asynchronously sends a batch of messages on a socket.
+ * @tparam Mux The multiplexer type.
+ * @tparam Batch The message batch type.
+ * @param dialog The socket dialog.
+ * @param batch The batch to send. It must outlive the operation.
+ * @param flags The message flags.
+ * @return A sender that will contain the number of messages sent, or an
+ * empty optional on error.
+ */
+template <Multiplexer Mux, MessageBatchLike Batch>
+auto tag_invoke([[maybe_unused]] sendmmsg_t *ptr,
+                const socket_dialog<Mux> &dialog, Batch &batch,
+                int flags) -> decltype(auto)
+{
+  using namespace ::io::detail;
+  using namespace detail;
+
+  using result_t = int;
+  using functor = small_functor<std::optional<result_t>() noexcept,
+                                sizeof(dialog) + sizeof(&batch) +
+                                    sizeof(flags)>;
+  using sender_t = operation_sender_t<Mux, sendmmsg_t, functor>;
+  using enum io::execution::execution_trigger;
+
+  auto executor = get_executor(dialog);
+  auto &socket = dialog.socket;
+
+  if constexpr (Mux::template is_eager_v<sendmmsg_t>)
+  {
+    auto &predictor = socket->write_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
+    {
+      result_t count = ::io::sendmmsg(*socket, batch, flags | MSG_NOSIGNAL);
+
+      if (count >= 0)
+      {
+        predictor.hit();
+        return sender_t(count);
+      }
+
+      socket->set_error(errno);
+      auto error = socket->get_error();
+
+      if (error && error != std::errc::operation_would_block)
+      {
+        predictor.hit();
+        return sender_t(error);
+      }
+
+      predictor.miss();
+    }
+  }
+
+  return sender_t(executor->set(
+      socket, WRITE,
+      functor([=, batch = &batch, socket = socket.get()]() noexcept {
+        result_t count = ::io::sendmmsg(*socket, *batch, flags | MSG_NOSIGNAL);
+        return (count < 0) ? std::nullopt : std::optional<result_t>{count};
+      })));
+}
+
+/**
+ * @brief Asynchronously sends part of a file on a socket.
+ * @details The data is sent with `io::sendfile()`, so it isn't copied through
+ * user space. The operation completes once `count` bytes have been sent or
+ * the end of the file is reached. After a partial send it waits for the
+ * socket to become writable again and continues where it stopped, see
+ * `sendfile_sender`. If an error occurs after some bytes were sent, it
+ * completes with the number of bytes sent.
+ * @tparam Mux The multiplexer type.
+ * @param dialog The socket dialog.
+ * @param fd The file descriptor to read from. It must stay open until the
+ * operation completes.
+ * @param offset The offset in the file to start reading from.
+ * @param count The number of bytes to send.
+ * @return A sender that will contain the number of bytes sent, or an empty
+ * optional on error.
+ */
+template <Multiplexer Mux>
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto tag_invoke([[maybe_unused]] sendfile_t *ptr,
+                const socket_dialog<Mux> &dialog, int fd,
+                std::streamoff offset, std::size_t count) -> decltype(auto)
+{
+  using namespace ::io::detail;
+  using namespace detail;
+
+  using lazy_t = sendfile_sender<Mux>;
+  using result_t = typename lazy_t::result_type;
+  using sender_t =
+      std::conditional_t<Mux::template is_eager_v<sendfile_t>,
+                         execution::detail::eager_sender<result_t, lazy_t>,
+                         lazy_t>;
+
+  auto executor = get_executor(dialog);
+  auto &socket = dialog.socket;
+
+  auto transfer = typename lazy_t::transfer{
+      .socket = socket.get(), .fd = fd, .offset = offset, .count = count};
+
+  if constexpr (Mux::template is_eager_v<sendfile_t>)
+  {
+    auto &predictor = socket->write_predictor();
+    if (predictor.should_try() && executor->try_eager(*socket))
+    {
+      if (auto len = transfer())
+      {
+        predictor.hit();
+        return sender_t(*len);
+      }
+
+      socket->set_error(errno);
+      auto error = socket->get_error();
+
+      if (error && error != std::errc::operation_would_block)
+      {
+        predictor.hit();
+        return sender_t(error);
+      }
+
+      predictor.miss();
+    }
+  }
+
+  // The sender continues from whatever the eager attempt already sent.
+  return sender_t(lazy_t(dialog, transfer));
+}
+#endif // !OS_WINDOWS
+
 /**
  * @brief Marks a socket as passive, that is, as a socket that will be used to
  * accept incoming connection requests.
@@ -0,0 +1,139 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file eager_predictor.hpp
+ * @brief This file defines a predictor for the outcome of eager socket
+ * operations.
+ */
+#pragma once
+#ifndef IO_EAGER_PREDICTOR_HPP
+#define IO_EAGER_PREDICTOR_HPP
+#include <atomic>
+#include <cstdint>
+namespace io::socket::detail {
+/**
+ * @brief Predicts whether an eager operation on a socket will complete
+ * without blocking.
+ * @details The predictor is a saturating counter of recent eager hits,
+ * incremented when an eager attempt completes and decremented when it
+ * fails with `EAGAIN`. While the counter is zero, eager attempts are
+ * skipped, except for one probe every `probe_interval` operations, so a
+ * socket that becomes busy again is noticed. Mostly idle sockets therefore
+ * stop paying for a syscall that would block, while bulk sockets keep
+ * completing inline.
+ *
+ * The score and the number of skipped attempts share one byte, which is
+ * only ever loaded and stored with relaxed ordering.
+ */
+class eager_predictor {
+public:
+  /** @brief The type of the packed state. */
+  using state_type = std::uint8_t;
+
+  /** @brief The highest score. */
+  static constexpr state_type max_score = 3;
+  /** @brief A cold socket probes once every `probe_interval` operations. */
+  static constexpr state_type probe_interval = 16;
+
+  /** @brief Constructs a predictor that starts with eager attempts. */
+  eager_predictor() = default;
+  /** @brief Deleted copy constructor. */
+  eager_predictor(const eager_predictor &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const eager_predictor &) -> eager_predictor & = delete;
+
+  /**
+   * @brief Decides whether the next operation should be tried eagerly.
+   * @return true if the socket is hot or a probe is due.
+   */
+  auto should_try() noexcept -> bool
+  {
+    auto state = state_.load(std::memory_order_relaxed);
+    if (score(state))
+      return true;
+
+    auto skips = static_cast<state_type>((skipped(state) + 1) % probe_interval);
+    state_.store(skips, std::memory_order_relaxed);
+    return skips == 0;
+  }
+
+  /** @brief Records an eager attempt that completed. */
+  auto hit() noexcept -> void
+  {
+    auto current = score(state_.load(std::memory_order_relaxed));
+    auto next = (current < max_score) ? current + 1 : max_score;
+    state_.store(static_cast<state_type>(next * probe_interval),
+                 std::memory_order_relaxed);
+  }
+
+  /** @brief Records an eager attempt that would have blocked. */
+  auto miss() noexcept -> void
+  {
+    auto current = score(state_.load(std::memory_order_relaxed));
+    auto next = current ? current - 1 : 0;
+    state_.store(static_cast<state_type>(next * probe_interval),
+                 std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Checks whether eager attempts are currently being made.
+   * @return true if the score is above zero.
+   */
+  [[nodiscard]] auto is_hot() const noexcept -> bool
+  {
+    return score(state_.load(std::memory_order_relaxed)) != 0;
+  }
+
+  /**
+   * @brief Swaps the state of two predictors.
+   * @param lhs The first predictor.
+   * @param rhs The second predictor.
+   */
+  friend auto swap(eager_predictor &lhs, eager_predictor &rhs) noexcept
+      -> void
+  {
+    auto tmp = lhs.state_.exchange(rhs.state_.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+    rhs.state_.store(tmp, std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * @brief Extracts the score from the packed state.
+   * @param state The packed state.
+   * @return The score.
+   */
+  static constexpr auto score(state_type state) noexcept -> state_type
+  {
+    return state / probe_interval;
+  }
+
+  /**
+   * @brief Extracts the number of skipped attempts from the packed state.
+   * @param state The packed state.
+   * @return The number of skipped attempts since the last probe.
+   */
+  static constexpr auto skipped(state_type state) noexcept -> state_type
+  {
+    return state % probe_interval;
+  }
+
+  /** @brief The score times `probe_interval` plus the skipped attempts. */
+  std::atomic<state_type> state_{max_score * probe_interval};
+};
+
+} // namespace io::socket::detail
+#endif // IO_EAGER_PREDICTOR_HPP
@@ -0,0 +1,313 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file io_uring_operations.hpp
+ * @brief Specializes the asynchronous socket operations for the io_uring
+ * multiplexer.
+ * @details These overloads are more specialized than the generic overloads in
+ * `async_operations.hpp`, so they are selected for any `socket_dialog` of a
+ * `basic_io_uring_multiplexer`. Each operation is submitted as a single
+ * submission queue entry and is completed from its completion queue entry,
+ * instead of waiting for readiness and then calling into the socket API.
+ */
+#pragma once
+#ifndef IO_IO_URING_OPERATIONS_HPP
+#define IO_IO_URING_OPERATIONS_HPP
+#include "async_operations.hpp"
+#include "io/detail/customization.hpp"
+#include "io/execution/executor.hpp"
+#include "io/execution/io_uring_multiplexer.hpp"
+#include "io/socket/socket_dialog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include <linux/io_uring.h>
+namespace io::socket {
+namespace detail {
+/**
+ * @brief Accepts a connection with `IORING_OP_ACCEPT`.
+ * @tparam Mux The multiplexer type.
+ */
+template <Multiplexer Mux> struct uring_accept {
+  /** @brief The socket dialog type. */
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+  /** @brief The value sent on completion. */
+  using value_type = std::pair<socket_dialog, std::span<const std::byte>>;
+
+  /**
+   * @brief Fills the submission queue entry.
+   * @param sqe The submission queue entry.
+   * @param fd The listening socket.
+   */
+  auto prepare(io_uring_sqe &sqe, int fd) noexcept -> void
+  {
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(address.data());
+    sqe.addr2 = reinterpret_cast<std::uintptr_t>(&addrlen);
+  }
+
+  /**
+   * @brief Pushes the accepted socket to the executor.
+   * @param result The accepted file descriptor.
+   * @return The accepted socket dialog and the peer address.
+   */
+  auto complete(int result) noexcept -> std::optional<value_type>
+  {
+    return value_type{make_connection(executor, socket_handle{result}),
+                      address.first(addrlen)};
+  }
+
+  /** @brief The executor that owns the accepted socket. */
+  std::shared_ptr<typename socket_dialog::executor_type> executor;
+  /** @brief A buffer for the peer address. */
+  std::span<std::byte> address;
+  /** @brief The length of the peer address. */
+  socklen_type addrlen = 0;
+};
+
+/** @brief Connects a socket with `IORING_OP_CONNECT`. */
+struct uring_connect {
+  /** @brief The value sent on completion. */
+  using value_type = int;
+
+  /**
+   * @brief Fills the submission queue entry.
+   * @param sqe The submission queue entry.
+   * @param fd The socket to connect.
+   */
+  auto prepare(io_uring_sqe &sqe, int fd) noexcept -> void
+  {
+    sqe.opcode = IORING_OP_CONNECT;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&address);
+    sqe.off = addrlen;
+  }
+
+  /**
+   * @brief Completes the connect.
+   * @return 0.
+   */
+  static auto complete(int /*result*/) noexcept -> std::optional<value_type>
+  {
+    return 0;
+  }
+
+  /** @brief A copy of the remote address. */
+  sockaddr_storage address{};
+  /** @brief The length of the remote address. */
+  socklen_type addrlen = 0;
+};
+
+/** @brief Receives a message with `IORING_OP_RECVMSG`. */
+struct uring_recvmsg {
+  /** @brief The value sent on completion. */
+  using value_type = std::streamsize;
+
+  /**
+   * @brief Fills the submission queue entry.
+   * @param sqe The submission queue entry.
+   * @param fd The socket to receive from.
+   */
+  auto prepare(io_uring_sqe &sqe, int fd) noexcept -> void
+  {
+    sqe.opcode = IORING_OP_RECVMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&msghdr);
+    sqe.len = 1;
+    sqe.msg_flags = static_cast<std::uint32_t>(flags);
+  }
+
+  /**
+   * @brief Copies the received message flags to the caller's message.
+   * @param result The number of bytes received.
+   * @return The number of bytes received.
+   */
+  auto complete(int result) const noexcept -> std::optional<value_type>
+  {
+    if (msg_flags)
+      *msg_flags = msghdr.msg_flags;
+    return result;
+  }
+
+  /** @brief The message header. */
+  socket_message_type msghdr{};
+  /** @brief The message flags. */
+  int flags = 0;
+  /** @brief The caller's message flags. */
+  int *msg_flags = nullptr;
+};
+
+/**
+ * @brief Sends a message with `IORING_OP_SENDMSG`.
+ * @details The message is copied into the operation, and the message header
+ * is built from the copy when the submission queue entry is filled, so the
+ * caller's message doesn't need to outlive the call.
+ * @tparam Message The message type.
+ */
+template <MessageLike Message> struct uring_sendmsg {
+  /** @brief The value sent on completion. */
+  using value_type = std::streamsize;
+
+  /**
+   * @brief Fills the submission queue entry.
+   * @param sqe The submission queue entry.
+   * @param fd The socket to send on.
+   */
+  auto prepare(io_uring_sqe &sqe, int fd) noexcept -> void
+  {
+    msghdr = static_cast<socket_message_type>(msg);
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&msghdr);
+    sqe.len = 1;
+    sqe.msg_flags = static_cast<std::uint32_t>(flags | MSG_NOSIGNAL);
+  }
+
+  /**
+   * @brief Completes the send.
+   * @param result The number of bytes sent.
+   * @return The number of bytes sent.
+   */
+  static auto complete(int result) noexcept -> std::optional<value_type>
+  {
+    return result;
+  }
+
+  /** @brief A copy of the message to send. */
+  Message msg;
+  /** @brief The message flags. */
+  int flags = 0;
+  /** @brief The message header. */
+  socket_message_type msghdr{};
+};
+} // namespace detail
+
+/**
+ * @brief Asynchronously accepts a new connection with io_uring.
+ * @tparam Allocator The multiplexer allocator type.
+ * @tparam Mutex The multiplexer mutex type.
+ * @param dialog The socket dialog.
+ * @param address A span to store the address of the connecting socket.
+ * @return A sender that completes with a pair containing the new socket
+ * dialog and its address.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto tag_invoke(
+    [[maybe_unused]] accept_t *ptr,
+    const socket_dialog<execution::basic_io_uring_multiplexer<Allocator, Mutex>>
+        &dialog,
+    std::span<std::byte> address) -> decltype(auto)
+{
+  using namespace detail;
+  using Mux = execution::basic_io_uring_multiplexer<Allocator, Mutex>;
+
+  auto executor = get_executor(dialog);
+  return executor->set(dialog.socket,
+                       uring_accept<Mux>{.executor = executor,
+                                         .address = address,
+                                         .addrlen = static_cast<socklen_type>(
+                                             address.size())});
+}
+
+/**
+ * @brief Asynchronously connects a socket to a remote address with io_uring.
+ * @details The address is copied into the operation, so it doesn't need to
+ * outlive the call.
+ * @tparam Allocator The multiplexer allocator type.
+ * @tparam Mutex The multiplexer mutex type.
+ * @param dialog The socket dialog.
+ * @param address The remote address to connect to.
+ * @return A sender that completes when the connection is established.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex>
+auto tag_invoke(
+    [[maybe_unused]] connect_t *ptr,
+    const socket_dialog<execution::basic_io_uring_multiplexer<Allocator, Mutex>>
+        &dialog,
+    std::span<const std::byte> address) -> decltype(auto)
+{
+  using namespace detail;
+
+  auto executor = get_executor(dialog);
+  auto op = uring_connect{};
+  op.addrlen = static_cast<socklen_type>(
+      std::min(address.size(), sizeof(op.address)));
+  std::memcpy(&op.address, address.data(), op.addrlen);
+
+  return executor->set(dialog.socket, std::move(op));
+}
+
+/**
+ * @brief Asynchronously receives a message with io_uring.
+ * @tparam Allocator The multiplexer allocator type.
+ * @tparam Mutex The multiplexer mutex type.
+ * @tparam Message The message type.
+ * @param dialog The socket dialog.
+ * @param msg The message to receive into.
+ * @param flags The message flags.
+ * @return A sender that completes with the number of bytes received.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex, MessageLike Message>
+auto tag_invoke(
+    [[maybe_unused]] recvmsg_t *ptr,
+    const socket_dialog<execution::basic_io_uring_multiplexer<Allocator, Mutex>>
+        &dialog,
+    Message &msg, int flags) -> decltype(auto)
+{
+  using namespace detail;
+
+  auto op = uring_recvmsg{.msghdr = static_cast<socket_message_type>(msg),
+                          .flags = flags};
+
+  if constexpr (requires { msg.flags; })
+    op.msg_flags = &msg.flags;
+
+  if constexpr (requires { msg.msg_flags; })
+    op.msg_flags = &msg.msg_flags;
+
+  return get_executor(dialog)->set(dialog.socket, std::move(op));
+}
+
+/**
+ * @brief Asynchronously sends a message with io_uring.
+ * @tparam Allocator The multiplexer allocator type.
+ * @tparam Mutex The multiplexer mutex type.
+ * @tparam Message The message type.
+ * @param dialog The socket dialog.
+ * @param msg The message to send.
+ * @param flags The message flags.
+ * @return A sender that completes with the number of bytes sent.
+ */
+template <AllocatorLike Allocator, BasicLockable Mutex, MessageLike Message>
+auto tag_invoke(
+    [[maybe_unused]] sendmsg_t *ptr,
+    const socket_dialog<execution::basic_io_uring_multiplexer<Allocator, Mutex>>
+        &dialog,
+    const Message &msg, int flags) -> decltype(auto)
+{
+  using namespace detail;
+
+  auto op = uring_sendmsg<Message>{.msg = msg, .flags = flags};
+
+  return get_executor(dialog)->set(dialog.socket, std::move(op));
+}
+
+} // namespace io::socket
+#endif // IO_IO_URING_OPERATIONS_HPP
@@ -22,12 +22,18 @@
 #define IO_SOCKET_IMPL_HPP
 #include "io/socket/detail/socket.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cerrno>
 #include <ios>
 #include <utility>
 
 #include <fcntl.h>
 #include <unistd.h>
+#if OS_LINUX
+#include <sys/sendfile.h>
+#endif
 namespace io::socket {
 inline auto operator+=(native_buffer_type &buf,
                        std::size_t len) noexcept -> native_buffer_type &
@@ -72,5 +78,110 @@ inline auto recvmsg(native_socket_type socket, socket_message_type *msg,
   return ::recvmsg(socket, msg, flags);
 }
 
+inline auto sendmmsg(native_socket_type socket, socket_mmsg_type *msgvec,
+                     unsigned int vlen, int flags) noexcept -> int
+{
+#if OS_LINUX
+  return ::sendmmsg(socket, msgvec, vlen, flags);
+#else
+  unsigned int count = 0;
+  for (; count < vlen; ++count)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto &msg = msgvec[count];
+    auto len = ::sendmsg(socket, &msg.msg_hdr, flags);
+    if (len < 0)
+      break;
+
+    msg.msg_len = static_cast<unsigned int>(len);
+  }
+  return (count || !vlen) ? static_cast<int>(count) : SOCKET_ERROR;
+#endif // OS_LINUX
+}
+
+inline auto recvmmsg(native_socket_type socket, socket_mmsg_type *msgvec,
+                     unsigned int vlen, int flags) noexcept -> int
+{
+#if OS_LINUX
+  return ::recvmmsg(socket, msgvec, vlen, flags, nullptr);
+#else
+  unsigned int count = 0;
+  for (; count < vlen; ++count)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto &msg = msgvec[count];
+    auto len = ::recvmsg(socket, &msg.msg_hdr, flags);
+    if (len < 0)
+      break;
+
+    msg.msg_len = static_cast<unsigned int>(len);
+  }
+  return (count || !vlen) ? static_cast<int>(count) : SOCKET_ERROR;
+#endif // OS_LINUX
+}
+
+#if OS_LINUX
+/**
+ * @brief Sends part of a file on a socket through a pipe with `splice`.
+ * @details A new pipe is used for each call so that bytes left in it when
+ * the socket would block are discarded when it is closed.
+ * @param socket The native socket handle.
+ * @param fd The file descriptor to read from.
+ * @param offset The offset in the file to start reading from.
+ * @param count The maximum number of bytes to send.
+ * @return The number of bytes sent, 0 at the end of the file, or
+ * `SOCKET_ERROR` on failure.
+ */
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline auto splice_file(native_socket_type socket, int fd,
+                        std::streamoff offset,
+                        std::size_t count) noexcept -> std::streamsize
+{
+  static constexpr unsigned int flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+
+  std::array<int, 2> pipe{};
+  if (::pipe2(pipe.data(), O_CLOEXEC | O_NONBLOCK) < 0)
+    return SOCKET_ERROR;
+
+  auto off = static_cast<loff_t>(offset);
+  auto len = ::splice(fd, &off, pipe[1], nullptr, count, flags);
+  if (len > 0)
+  {
+    len = ::splice(pipe[0], nullptr, socket, nullptr,
+                   static_cast<std::size_t>(len), flags);
+  }
+
+  auto error = errno;
+  ::close(pipe[0]);
+  ::close(pipe[1]);
+  errno = error;
+  return len;
+}
+#endif // OS_LINUX
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline auto sendfile(native_socket_type socket, int fd, std::streamoff offset,
+                     std::size_t count) noexcept -> std::streamsize
+{
+#if OS_LINUX
+  auto off = static_cast<off_t>(offset);
+  auto len = ::sendfile(socket, fd, &off, count);
+  if (len >= 0 || (errno != EINVAL && errno != ENOSYS))
+    return len;
+
+  return splice_file(socket, fd, offset, count);
+#else
+  static constexpr std::size_t chunk_size = 16384;
+
+  std::array<char, chunk_size> chunk{};
+  auto len = ::pread(fd, chunk.data(), std::min(count, chunk.size()),
+                     static_cast<off_t>(offset));
+  if (len <= 0)
+    return len;
+
+  return ::send(socket, chunk.data(), static_cast<std::size_t>(len), 0);
+#endif // OS_LINUX
+}
+
 } // namespace io::socket
 #endif // IO_SOCKET_POSIX_HPP
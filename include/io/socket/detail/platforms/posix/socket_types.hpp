@@ -20,6 +20,8 @@
 #pragma once
 #ifndef IO_SOCKET_TYPES_HPP
 #define IO_SOCKET_TYPES_HPP
+#include "io/config.h"
+
 #include <sys/socket.h>
 namespace io::socket {
 
@@ -38,6 +40,22 @@ using native_buffer_type = struct iovec;
 /** @brief The socket message type for POSIX systems. */
 using socket_message_type = struct msghdr;
 
+#if OS_LINUX
+/** @brief The batched socket message type for `recvmmsg`/`sendmmsg`. */
+using socket_mmsg_type = struct mmsghdr;
+#else
+/**
+ * @brief A batched socket message on POSIX systems without `recvmmsg`.
+ * @details Mirrors the layout of Linux's `struct mmsghdr`.
+ */
+struct socket_mmsg_type {
+  /** @brief The message header. */
+  socket_message_type msg_hdr;
+  /** @brief The number of bytes transferred for this message. */
+  unsigned int msg_len;
+};
+#endif // OS_LINUX
+
 /** @brief The generic socket address structure for POSIX systems. */
 using sockaddr_type = struct sockaddr;
 
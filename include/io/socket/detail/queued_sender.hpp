@@ -0,0 +1,179 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file queued_sender.hpp
+ * @brief This file defines a sender that queues a send on a write queue when
+ * it starts.
+ */
+#pragma once
+#ifndef IO_QUEUED_SENDER_HPP
+#define IO_QUEUED_SENDER_HPP
+#include "io/execution/detail/immovable.hpp"
+#include "write_queue.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+namespace io::socket::detail {
+/**
+ * @brief A sender for a send that may be coalesced by a write queue.
+ * @details A coalesced send makes its request when its sender is built, but
+ * the request is only pushed onto the queue when the operation starts, so
+ * the bytes of a sender that is never started are never sent. The request
+ * is erased from the queue when the operation completes, however it
+ * completes, so the bytes of a send that is stopped before it was sent
+ * aren't sent by the sends behind it either. A send without a request
+ * forwards to the wrapped sender.
+ * @tparam T The value type of the operation.
+ * @tparam Sender The type of the wrapped sender.
+ */
+template <typename T, stdexec::sender Sender> class queued_sender {
+public:
+  /** @brief The sender concept type. */
+  using sender_concept = stdexec::sender_t;
+  /** @brief The completion signatures for the sender. */
+  using completion_signatures =
+      stdexec::completion_signatures<stdexec::set_value_t(T),
+                                     stdexec::set_error_t(std::error_code),
+                                     stdexec::set_stopped_t()>;
+
+  /**
+   * @brief An operation state for the queued sender.
+   * @tparam Receiver The receiver type.
+   */
+  template <typename Receiver> class state : execution::immovable {
+    /** @brief Erases the request before completing the receiver. */
+    struct receiver {
+      /** @brief The receiver concept type. */
+      using receiver_concept = stdexec::receiver_t;
+
+      /** @brief Completes with a value. */
+      auto set_value(T value) && noexcept -> void
+      {
+        self->erase();
+        stdexec::set_value(std::move(self->receiver_), std::move(value));
+      }
+      /** @brief Completes with an error. */
+      template <typename Error>
+      auto set_error(Error &&error) && noexcept -> void
+      {
+        self->erase();
+        stdexec::set_error(std::move(self->receiver_),
+                           std::forward<Error>(error));
+      }
+      /** @brief Completes with `set_stopped()`. */
+      auto set_stopped() && noexcept -> void
+      {
+        self->erase();
+        stdexec::set_stopped(std::move(self->receiver_));
+      }
+      /** @brief Forwards the environment of the receiver. */
+      [[nodiscard]] auto get_env() const noexcept
+          -> stdexec::env_of_t<Receiver>
+      {
+        return stdexec::get_env(self->receiver_);
+      }
+
+      /** @brief The operation to complete. */
+      state *self = nullptr;
+    };
+
+  public:
+    /**
+     * @brief Connects a sender to a receiver.
+     * @param sender The sender to connect.
+     * @param receiver The receiver to complete.
+     */
+    state(queued_sender &&sender, Receiver receiver)
+        : receiver_{std::move(receiver)}, writes_{std::move(sender.writes_)},
+          request_{std::move(sender.request_)},
+          inner_{stdexec::connect(std::move(sender.sender_),
+                                  state::receiver{this})}
+    {}
+
+    /** @brief Erases the request of an operation that didn't complete. */
+    ~state() { erase(); }
+
+    /** @brief Starts the operation. */
+    auto start() noexcept -> void
+    {
+      if (writes_)
+        writes_->push(*request_);
+
+      stdexec::start(inner_);
+    }
+
+  private:
+    /** @brief Erases the request from the queue, if it is still queued. */
+    auto erase() noexcept -> void
+    {
+      if (writes_)
+        writes_->erase(*request_);
+    }
+
+    /** @brief The receiver to complete. */
+    Receiver receiver_;
+    /** @brief The write queue, if the send is coalesced. */
+    std::shared_ptr<write_queue> writes_;
+    /** @brief The request of the send, if it is coalesced. */
+    std::shared_ptr<write_queue::request> request_;
+    /** @brief The operation state of the wrapped sender. */
+    stdexec::connect_result_t<Sender, receiver> inner_;
+  };
+
+  /**
+   * @brief Constructs a sender for a send that isn't coalesced.
+   * @param sender The wrapped sender.
+   */
+  explicit queued_sender(Sender sender) : sender_{std::move(sender)} {}
+
+  /**
+   * @brief Constructs a sender for a coalesced send.
+   * @param sender The wrapped sender, which completes the request.
+   * @param writes The write queue.
+   * @param request The request of the send.
+   */
+  queued_sender(Sender sender, std::shared_ptr<write_queue> writes,
+                std::shared_ptr<write_queue::request> request)
+      : sender_{std::move(sender)}, writes_{std::move(writes)},
+        request_{std::move(request)}
+  {}
+
+  /**
+   * @brief Connects the sender to a receiver.
+   * @param receiver The receiver to connect to.
+   * @return The operation state.
+   */
+  template <typename Receiver>
+  auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>
+  {
+    return {std::move(*this), std::forward<Receiver>(receiver)};
+  }
+
+private:
+  /** @brief The wrapped sender. */
+  Sender sender_;
+  /** @brief The write queue, if the send is coalesced. */
+  std::shared_ptr<write_queue> writes_;
+  /** @brief The request of the send, if it is coalesced. */
+  std::shared_ptr<write_queue::request> request_;
+};
+
+} // namespace io::socket::detail
+#endif // IO_QUEUED_SENDER_HPP
@@ -0,0 +1,247 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file sendfile_sender.hpp
+ * @brief This file defines a sender that sends part of a file on a socket
+ * until it is done.
+ */
+#pragma once
+#ifndef IO_SENDFILE_SENDER_HPP
+#define IO_SENDFILE_SENDER_HPP
+#include "io/detail/concepts.hpp"
+#include "io/detail/customization.hpp"
+#include "io/detail/small_functor.hpp"
+#include "io/execution/detail/execution_trigger.hpp"
+#include "io/execution/detail/immovable.hpp"
+#include "io/socket/socket_dialog.hpp"
+#include "io/socket/socket_handle.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+namespace io::socket::detail {
+/**
+ * @brief A sender that sends part of a file on a socket.
+ * @details The operation waits for the socket to become writable and sends
+ * as much of the file as it can. If the socket would block before the
+ * transfer is done, the operation waits for it to become writable again and
+ * continues where it stopped. The multiplexer completes each wait with the
+ * result of one attempt, so the operation keeps its own count of the bytes
+ * sent across the waits.
+ * @tparam Mux The multiplexer type.
+ */
+template <Multiplexer Mux> class sendfile_sender {
+public:
+  /** @brief The value type of the operation. */
+  using result_type = std::streamsize;
+  /** @brief The sender concept type. */
+  using sender_concept = stdexec::sender_t;
+  /** @brief The completion signatures for the sender. */
+  using completion_signatures =
+      stdexec::completion_signatures<stdexec::set_value_t(result_type),
+                                     stdexec::set_error_t(std::error_code),
+                                     stdexec::set_stopped_t()>;
+
+  /** @brief The progress of a transfer. */
+  struct transfer {
+    /**
+     * @brief Sends as much of the rest of the transfer as the socket takes.
+     * @return The number of bytes sent once `count` bytes have been sent, the
+     * end of the file is reached, or an error occurs after some bytes were
+     * sent. Otherwise an empty optional with `errno` set.
+     */
+    auto operator()() noexcept -> std::optional<result_type>
+    {
+      while (static_cast<std::size_t>(sent) < count)
+      {
+        auto len = ::io::sendfile(*socket, fd, offset + sent,
+                                  count - static_cast<std::size_t>(sent));
+        if (len == 0)
+          break;
+
+        if (len < 0)
+        {
+          if (sent && errno != EAGAIN && errno != EWOULDBLOCK)
+            break;
+          return std::nullopt;
+        }
+
+        sent += len;
+      }
+      return sent;
+    }
+
+    /** @brief The socket to send on. */
+    socket_handle *socket = nullptr;
+    /** @brief The file descriptor to read from. */
+    int fd = -1;
+    /** @brief The offset in the file to start reading from. */
+    std::streamoff offset = 0;
+    /** @brief The number of bytes to send. */
+    std::size_t count = 0;
+    /** @brief The number of bytes sent so far. */
+    result_type sent = 0;
+  };
+
+  /**
+   * @brief An operation state for the sendfile sender.
+   * @tparam Receiver The receiver type.
+   */
+  template <typename Receiver> class state : execution::immovable {
+    /** @brief The completion handler of one wait. */
+    using functor = ::io::detail::small_functor<
+        std::optional<result_type>() noexcept, sizeof(void *)>;
+
+    /** @brief Waits again when the transfer would block. */
+    struct receiver {
+      /** @brief The receiver concept type. */
+      using receiver_concept = stdexec::receiver_t;
+
+      /** @brief Completes with the number of bytes sent. */
+      auto set_value(result_type value) && noexcept -> void
+      {
+        stdexec::set_value(std::move(self->receiver_), value);
+      }
+      /** @brief Waits again, or completes with an error. */
+      auto set_error(std::error_code error) && noexcept -> void
+      {
+        if (error == std::errc::operation_would_block)
+          return self->arm();
+
+        stdexec::set_error(std::move(self->receiver_), error);
+      }
+      /** @brief Completes with `set_stopped()`. */
+      auto set_stopped() && noexcept -> void
+      {
+        stdexec::set_stopped(std::move(self->receiver_));
+      }
+      /** @brief Forwards the environment of the receiver. */
+      [[nodiscard]] auto get_env() const noexcept
+          -> stdexec::env_of_t<Receiver>
+      {
+        return stdexec::get_env(self->receiver_);
+      }
+
+      /** @brief The operation to complete. */
+      state *self = nullptr;
+    };
+
+    /** @brief The operation state of one wait. */
+    using wait_state = decltype(stdexec::connect(
+        std::declval<typename socket_dialog<Mux>::executor_type &>().set(
+            std::declval<std::shared_ptr<socket_handle>>(),
+            execution::execution_trigger{}, std::declval<functor>()),
+        std::declval<receiver>()));
+
+    /**
+     * @brief Converts to the result of a function, so that the immovable
+     * wait state can be emplaced.
+     * @tparam Fn The function type.
+     */
+    template <typename Fn> struct emplace_from {
+      /** @brief Calls the function. */
+      operator std::invoke_result_t<Fn &>() && { return fn(); }
+      /** @brief The function. */
+      Fn fn;
+    };
+
+  public:
+    /**
+     * @brief Connects a sender to a receiver.
+     * @param sender The sender to connect.
+     * @param receiver The receiver to complete.
+     */
+    state(sendfile_sender &&sender, Receiver receiver)
+        : receiver_{std::move(receiver)}, dialog_{std::move(sender.dialog_)},
+          transfer_{sender.transfer_}
+    {}
+
+    /** @brief Starts the operation. */
+    auto start() noexcept -> void { arm(); }
+
+  private:
+    /**
+     * @brief Waits for the socket to become writable.
+     * @details Replaces the state of the previous wait, which has already
+     * completed. The multiplexer doesn't touch an operation state after it
+     * has completed it, so the previous wait can be destroyed from its own
+     * completion. If the executor is gone, the operation completes with
+     * `set_stopped()`.
+     */
+    auto arm() noexcept -> void
+    {
+      using enum execution::execution_trigger;
+
+      wait_.reset();
+      auto executor = dialog_.executor.lock();
+      if (!executor)
+        return stdexec::set_stopped(std::move(receiver_));
+
+      wait_.emplace(emplace_from{[&] {
+        return stdexec::connect(
+            executor->set(dialog_.socket, WRITE,
+                          functor([this]() noexcept { return transfer_(); })),
+            receiver{this});
+      }});
+      stdexec::start(*wait_);
+    }
+
+    /** @brief The receiver to complete. */
+    Receiver receiver_;
+    /** @brief The dialog of the socket. */
+    socket_dialog<Mux> dialog_;
+    /** @brief The progress of the transfer. */
+    transfer transfer_;
+    /** @brief The current wait, if one has been made. */
+    std::optional<wait_state> wait_;
+  };
+
+  /**
+   * @brief Constructs a sender that continues a transfer.
+   * @param dialog The dialog of the socket.
+   * @param progress The transfer, which may already have sent some bytes.
+   */
+  sendfile_sender(socket_dialog<Mux> dialog, transfer progress)
+      : dialog_{std::move(dialog)}, transfer_{progress}
+  {}
+
+  /**
+   * @brief Connects the sender to a receiver.
+   * @param receiver The receiver to connect to.
+   * @return The operation state.
+   */
+  template <typename Receiver>
+  auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>
+  {
+    return {std::move(*this), std::forward<Receiver>(receiver)};
+  }
+
+private:
+  /** @brief The dialog of the socket. */
+  socket_dialog<Mux> dialog_;
+  /** @brief The progress of the transfer. */
+  transfer transfer_;
+};
+
+} // namespace io::socket::detail
+#endif // IO_SENDFILE_SENDER_HPP
@@ -82,6 +82,58 @@ inline auto sendmsg(native_socket_type socket, const socket_message_type *msg,
  */
 inline auto recvmsg(native_socket_type socket, socket_message_type *msg,
                     int flags) noexcept -> std::streamsize;
+
+#if !OS_WINDOWS
+/**
+ * @brief Sends a batch of messages on a socket.
+ * @details Uses `sendmmsg` where it is available and falls back to one
+ * `sendmsg` per message elsewhere.
+ * @param socket The native socket handle.
+ * @param msgvec The messages to send. The `msg_len` of each sent message is
+ * set to the number of bytes sent.
+ * @param vlen The number of messages in `msgvec`.
+ * @param flags A bitwise OR of flags to modify the send behavior.
+ * @return The number of messages sent on success, or `SOCKET_ERROR` if no
+ * message could be sent.
+ */
+inline auto sendmmsg(native_socket_type socket, socket_mmsg_type *msgvec,
+                     unsigned int vlen, int flags) noexcept -> int;
+
+/**
+ * @brief Receives a batch of messages from a socket.
+ * @details Uses `recvmmsg` where it is available and falls back to one
+ * `recvmsg` per message elsewhere.
+ * @param socket The native socket handle.
+ * @param msgvec The messages to receive into. The `msg_len` of each received
+ * message is set to the number of bytes received.
+ * @param vlen The number of messages in `msgvec`.
+ * @param flags A bitwise OR of flags to modify the receive behavior.
+ * @return The number of messages received on success, or `SOCKET_ERROR` if
+ * no message could be received.
+ */
+inline auto recvmmsg(native_socket_type socket, socket_mmsg_type *msgvec,
+                     unsigned int vlen, int flags) noexcept -> int;
+
+/**
+ * @brief Sends part of a file on a socket.
+ * @details Uses `sendfile` on Linux. If the file can't be used with
+ * `sendfile`, the data is spliced through a pipe instead, so it still isn't
+ * copied through user space. Bytes that reach the pipe but not the socket are
+ * discarded with the pipe, and are read from the file again by the next call.
+ * Other systems read the data into a bounded buffer and send it. The file
+ * offset of `fd` is never changed. `sendfile` can't suppress `SIGPIPE`, so
+ * applications that send files to peers that may close should ignore it.
+ * @param socket The native socket handle.
+ * @param fd The file descriptor to read from.
+ * @param offset The offset in the file to start reading from.
+ * @param count The number of bytes to send.
+ * @return The number of bytes sent on success, 0 at the end of the file, or
+ * `SOCKET_ERROR` on failure.
+ */
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline auto sendfile(native_socket_type socket, int fd, std::streamoff offset,
+                     std::size_t count) noexcept -> std::streamsize;
+#endif // !OS_WINDOWS
 } // namespace io::socket
 
 #if OS_WINDOWS
@@ -234,6 +234,88 @@ auto tag_invoke([[maybe_unused]] recvmsg_t *ptr, const Socket &socket,
   return len;
 }
 
+#if !OS_WINDOWS
+/**
+ * @brief Receives a batch of messages from a socket.
+ * @tparam Socket The socket type.
+ * @tparam Batch The message batch type.
+ * @param socket The socket.
+ * @param batch The batch to receive into.
+ * @param flags The flags for the receive operation.
+ * @return The number of messages received, or -1 on error.
+ */
+template <SocketLike Socket, MessageBatchLike Batch>
+auto tag_invoke([[maybe_unused]] recvmmsg_t *ptr, const Socket &socket,
+                Batch &batch, int flags) -> int
+{
+  int count = -1;
+  auto msgvec = batch.prepare_recv();
+
+  while ((count = ::io::socket::recvmmsg(
+              static_cast<native_socket_type>(socket), msgvec.data(),
+              static_cast<unsigned int>(msgvec.size()), flags)) < 0)
+  {
+    if (errno != EINTR)
+      break;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Sends a batch of messages on a socket.
+ * @tparam Socket The socket type.
+ * @tparam Batch The message batch type.
+ * @param socket The socket.
+ * @param batch The batch to send.
+ * @param flags The flags for the send operation.
+ * @return The number of messages sent, or -1 on error.
+ */
+template <SocketLike Socket, MessageBatchLike Batch>
+auto tag_invoke([[maybe_unused]] sendmmsg_t *ptr, const Socket &socket,
+                Batch &batch, int flags) -> int
+{
+  int count = -1;
+  auto msgvec = batch.prepare_send();
+
+  while ((count = ::io::socket::sendmmsg(
+              static_cast<native_socket_type>(socket), msgvec.data(),
+              static_cast<unsigned int>(msgvec.size()), flags)) < 0)
+  {
+    if (errno != EINTR)
+      break;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Sends part of a file on a socket.
+ * @tparam Socket The socket type.
+ * @param socket The socket.
+ * @param fd The file descriptor to read from.
+ * @param offset The offset in the file to start reading from.
+ * @param count The number of bytes to send.
+ * @return The number of bytes sent, 0 at the end of the file, or -1 on error.
+ */
+template <SocketLike Socket>
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto tag_invoke([[maybe_unused]] sendfile_t *ptr, const Socket &socket,
+                int fd, std::streamoff offset,
+                std::size_t count) -> std::streamsize
+{
+  std::streamsize len = -1;
+  while ((len = ::io::socket::sendfile(static_cast<native_socket_type>(socket),
+                                       fd, offset, count)) < 0)
+  {
+    if (errno != EINTR)
+      break;
+  }
+
+  return len;
+}
+#endif // !OS_WINDOWS
+
 /**
  * @brief Sends a message on a socket.
  * @tparam Socket The socket type.
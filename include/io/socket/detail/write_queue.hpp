@@ -0,0 +1,333 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file write_queue.hpp
+ * @brief This file defines a queue that coalesces pending sends on a socket.
+ */
+#pragma once
+#ifndef IO_WRITE_QUEUE_HPP
+#define IO_WRITE_QUEUE_HPP
+#include "buffer_iterator.hpp"
+#include "io/socket/connection_arena.hpp"
+#include "io/socket/socket_message.hpp"
+#include "socket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+namespace io::socket::detail {
+/**
+ * @brief Coalesces the pending sends on one socket into fewer `sendmsg` calls.
+ * @details Each send makes a request with a copy of its I/O vectors, and
+ * pushes it onto the queue when its operation starts. When any request is
+ * completed, all the pending requests are gathered, in order, into one
+ * `sendmsg` of up to `iov_max` buffers, passing `MSG_MORE` if requests remain
+ * behind the ones that fit. The bytes sent are then attributed to the
+ * requests in order, so each request completes with its own byte count: a
+ * request that was only partly sent completes with the partial count, like a
+ * short `sendmsg`, and the requests behind it stay queued for the next call.
+ *
+ * The requests are linked into the queue, so the operation that owns a
+ * request must erase it when it completes, is stopped or is destroyed. A
+ * request that is erased before it is sent is never sent.
+ */
+class write_queue {
+public:
+  /** @brief The maximum number of buffers in one `sendmsg`. */
+#ifdef IOV_MAX
+  static constexpr std::size_t iov_max = IOV_MAX;
+#else
+  static constexpr std::size_t iov_max = 1024;
+#endif
+
+  /** @brief One queued send. */
+  struct request {
+    /** @brief The allocator for the buffers. */
+    using allocator_type = arena_allocator<native_buffer_type>;
+
+    /** @brief The buffers to send. */
+    std::vector<native_buffer_type, allocator_type> buffers;
+    /** @brief The total size of the buffers. */
+    std::size_t size = 0;
+    /** @brief The number of bytes sent. */
+    std::size_t sent = 0;
+    /** @brief The error that failed the request, or 0. */
+    int error = 0;
+    /** @brief True once the request has completed. */
+    bool done = false;
+    /** @brief True while the request is linked into the queue. */
+    bool queued = false;
+    /** @brief The next request in the queue. */
+    request *next = nullptr;
+    /** @brief The previous request in the queue. */
+    request *prev = nullptr;
+  };
+
+  /**
+   * @brief Makes a request for a send.
+   * @param buffers The buffers to send. They are copied, but the memory they
+   * point to must outlive the request.
+   * @param alloc The allocator for the request and its buffers, usually the
+   * allocator of the socket's dialog.
+   * @return The request. It isn't queued yet.
+   */
+  static auto make_request(std::span<const native_buffer_type> buffers,
+                           const arena_allocator<std::byte> &alloc)
+      -> std::shared_ptr<request>;
+
+  /**
+   * @brief Queues a request behind the pending ones.
+   * @param req The request, which must stay alive until it is erased.
+   */
+  auto push(request &req) noexcept -> void;
+
+  /**
+   * @brief Erases a request from the queue.
+   * @details Does nothing if the request isn't queued.
+   * @param req The request to erase.
+   */
+  auto erase(request &req) noexcept -> void;
+
+  /**
+   * @brief Completes a request, sending it and any other pending requests.
+   * @param req The request to complete. It must be queued or done.
+   * @param socket The socket to send on.
+   * @param flags The flags for `sendmsg`.
+   * @return The number of bytes sent for `req`, or an empty optional with
+   * `errno` set if it failed or the socket would block.
+   */
+  auto complete(request &req, native_socket_type socket,
+                int flags) noexcept -> std::optional<std::streamsize>;
+
+  /**
+   * @brief Gets the number of `sendmsg` calls made by the queue.
+   * @return The number of calls.
+   */
+  [[nodiscard]] auto syscalls() const noexcept -> std::size_t;
+
+private:
+  /**
+   * @brief Unlinks a request from the queue.
+   * @note Called with `mtx_` held.
+   * @param req The request to unlink.
+   */
+  auto unlink(request &req) noexcept -> void;
+
+  /**
+   * @brief Sends as many pending requests as fit in one `sendmsg`.
+   * @param socket The socket to send on.
+   * @param flags The flags for `sendmsg`.
+   * @return false if no request could be completed because the socket would
+   * block.
+   */
+  auto flush(native_socket_type socket, int flags) noexcept -> bool;
+
+  /** @brief The first pending request. */
+  request *head_ = nullptr;
+  /** @brief The last pending request. */
+  request *tail_ = nullptr;
+  /** @brief The buffers gathered for the next `sendmsg`. */
+  std::vector<native_buffer_type> iov_;
+  /** @brief The requests gathered for the next `sendmsg`. */
+  std::vector<request *> batch_;
+  /** @brief The number of `sendmsg` calls. */
+  std::size_t syscalls_ = 0;
+  /** @brief Guards the queue and its requests. */
+  mutable std::mutex mtx_;
+};
+
+inline auto
+write_queue::make_request(std::span<const native_buffer_type> buffers,
+                          const arena_allocator<std::byte> &alloc)
+    -> std::shared_ptr<request>
+{
+  using iterator = buffer_iterator<const native_buffer_type *>;
+
+  auto req = std::allocate_shared<request>(alloc);
+  req->buffers = {buffers.begin(), buffers.end(),
+                  request::allocator_type(alloc)};
+  for (auto it = iterator(buffers.data());
+       it != iterator(buffers.data() + buffers.size()); ++it)
+  {
+    req->size += (*it).size();
+  }
+
+  return req;
+}
+
+inline auto write_queue::push(request &req) noexcept -> void
+{
+  auto lock = std::lock_guard{mtx_};
+  req.queued = true;
+  req.next = nullptr;
+  req.prev = tail_;
+  if (tail_)
+    tail_->next = &req;
+  else
+    head_ = &req;
+  tail_ = &req;
+}
+
+inline auto write_queue::erase(request &req) noexcept -> void
+{
+  auto lock = std::lock_guard{mtx_};
+  if (req.queued)
+    unlink(req);
+}
+
+inline auto write_queue::complete(request &req, native_socket_type socket,
+                                  int flags) noexcept
+    -> std::optional<std::streamsize>
+{
+  auto lock = std::lock_guard{mtx_};
+  while (!req.done)
+  {
+    if (!flush(socket, flags))
+    {
+      errno = EWOULDBLOCK;
+      return std::nullopt;
+    }
+  }
+
+  if (req.error)
+  {
+    errno = req.error;
+    return std::nullopt;
+  }
+
+  return static_cast<std::streamsize>(req.sent);
+}
+
+inline auto write_queue::syscalls() const noexcept -> std::size_t
+{
+  auto lock = std::lock_guard{mtx_};
+  return syscalls_;
+}
+
+inline auto write_queue::unlink(request &req) noexcept -> void
+{
+  if (req.prev)
+    req.prev->next = req.next;
+  else
+    head_ = req.next;
+
+  if (req.next)
+    req.next->prev = req.prev;
+  else
+    tail_ = req.prev;
+
+  req.next = req.prev = nullptr;
+  req.queued = false;
+}
+
+inline auto write_queue::flush(native_socket_type socket,
+                               int flags) noexcept -> bool
+{
+  iov_.clear();
+  batch_.clear();
+
+  bool more = false;
+  bool progress = true;
+  try
+  {
+    for (auto *req = head_; req; req = req->next)
+    {
+      if (iov_.size() == iov_max)
+      {
+        more = true;
+        break;
+      }
+
+      auto count = std::min(req->buffers.size(), iov_max - iov_.size());
+      more = count < req->buffers.size();
+      iov_.insert(iov_.end(), req->buffers.begin(),
+                  req->buffers.begin() + static_cast<std::ptrdiff_t>(count));
+      batch_.push_back(req);
+    }
+  }
+  catch (const std::bad_alloc &)
+  {
+    // Send whatever could be gathered.
+    more = true;
+  }
+
+#ifdef MSG_MORE
+  if (more)
+    flags |= MSG_MORE;
+#endif
+
+  auto msghdr =
+      static_cast<socket_message_type>(message_header{.msg_iov = iov_});
+  std::streamsize len = -1;
+  while ((len = ::io::socket::sendmsg(socket, &msghdr, flags)) < 0)
+  {
+    if (errno != EINTR)
+      break;
+  }
+  ++syscalls_;
+
+  if (len < 0)
+  {
+    auto error = errno;
+    if (error == EAGAIN || error == EWOULDBLOCK)
+    {
+      batch_.clear();
+      return false;
+    }
+
+    for (auto *req : batch_)
+    {
+      req->error = error;
+      req->done = true;
+    }
+  }
+  else
+  {
+    // Attribute the bytes sent to the gathered requests in order.
+    auto remaining = static_cast<std::size_t>(len);
+    for (auto *req : batch_)
+    {
+      auto count = std::min(req->size, remaining);
+      if (!count && req->size)
+      {
+        progress = req != batch_.front();
+        break;
+      }
+
+      remaining -= count;
+      req->sent = count;
+      req->done = true;
+      if (count < req->size)
+        break;
+    }
+  }
+
+  // Drop the completed requests.
+  while (head_ && head_->done)
+    unlink(*head_);
+
+  batch_.clear();
+  return progress;
+}
+
+} // namespace io::socket::detail
+#endif // IO_WRITE_QUEUE_HPP
@@ -0,0 +1,305 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file zerocopy_tracker.hpp
+ * @brief This file defines the tracker for the `MSG_ZEROCOPY` sends on a
+ * socket.
+ */
+#pragma once
+#ifndef IO_ZEROCOPY_TRACKER_HPP
+#define IO_ZEROCOPY_TRACKER_HPP
+#include "io/config.h"
+#include "socket.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <ios>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if OS_LINUX
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#endif
+namespace io::socket::detail {
+/**
+ * @brief Tracks the `MSG_ZEROCOPY` sends on one socket until the kernel
+ * releases their buffers.
+ * @details The kernel numbers the successful zero-copy sends on a socket
+ * from 0, and reports ranges of numbers on the socket's error queue once it no
+ * longer references their buffers. The tracker sends under a lock so that
+ * its numbering matches the kernel's, keeps a copy of the I/O vectors of each
+ * send, and reads the error queue to report the released sends, in send
+ * order, to a callback. A send whose record can't be allocated, or that has
+ * nothing to send, is copied instead.
+ *
+ * Messages on the error queue that aren't zero-copy notifications are read
+ * and discarded.
+ */
+class zerocopy_tracker {
+public:
+  /** @brief Called with the buffers of a send once they are released. */
+  using release_callback =
+      std::function<void(std::span<const native_buffer_type>)>;
+
+  /**
+   * @brief Constructs a tracker.
+   * @param on_release The callback for released sends.
+   */
+  explicit zerocopy_tracker(release_callback on_release = {}) noexcept
+      : on_release_{std::move(on_release)}
+  {}
+
+  /**
+   * @brief Sends a message with `MSG_ZEROCOPY`.
+   * @param socket The socket to send on.
+   * @param msg The message to send.
+   * @param flags The flags for `sendmsg`.
+   * @return The number of bytes sent, or -1 with `errno` set on error.
+   */
+  auto send(native_socket_type socket, const socket_message_type &msg,
+            int flags) noexcept -> std::streamsize;
+
+  /**
+   * @brief Marks the tracker as waiting on the error queue.
+   * @return true if the caller must start waiting on the error queue, false
+   * if no sends are pending or another wait is already in progress.
+   */
+  auto try_arm() noexcept -> bool;
+
+  /** @brief Marks the tracker as no longer waiting on the error queue. */
+  auto disarm() noexcept -> void;
+
+  /**
+   * @brief Reads the error queue and reports the released sends.
+   * @details The tracker stays armed while sends are pending.
+   * @param socket The socket to read from.
+   * @return The number of sends released, or an empty optional with `errno`
+   * set to `EWOULDBLOCK` if sends are still pending.
+   */
+  auto reap(native_socket_type socket) noexcept -> std::optional<std::size_t>;
+
+  /**
+   * @brief Gets the number of sends whose buffers haven't been released.
+   * @return The number of pending sends.
+   */
+  [[nodiscard]] auto pending() const noexcept -> std::size_t;
+
+  /**
+   * @brief Gets the number of sends that the kernel copied anyway.
+   * @details The kernel copies when zero-copy isn't possible, for example
+   * over the loopback interface, which makes `MSG_ZEROCOPY` more expensive
+   * than a plain send.
+   * @return The number of copied sends.
+   */
+  [[nodiscard]] auto copied() const noexcept -> std::size_t;
+
+private:
+  /** @brief One zero-copy send. */
+  struct record {
+    /** @brief The buffers of the send. */
+    std::vector<native_buffer_type> buffers;
+    /** @brief True once the kernel has released the buffers. */
+    bool released = false;
+  };
+
+  /**
+   * @brief Marks a range of sends as released.
+   * @param first The number of the first released send.
+   * @param last The number of the last released send.
+   * @param copied Whether the kernel copied the sends.
+   */
+  auto release(std::uint32_t first, std::uint32_t last, bool copied) noexcept
+      -> void;
+
+  /** @brief The number of the first pending send. */
+  std::uint32_t first_ = 0;
+  /** @brief The pending sends, in send order. */
+  std::deque<record> pending_;
+  /** @brief The number of sends that the kernel copied. */
+  std::size_t copied_ = 0;
+  /** @brief Whether an operation is waiting on the error queue. */
+  bool armed_ = false;
+  /** @brief The callback for released sends. */
+  release_callback on_release_;
+  /** @brief Guards the tracker. */
+  mutable std::mutex mtx_;
+};
+
+#if OS_LINUX
+inline auto zerocopy_tracker::send(native_socket_type socket,
+                                   const socket_message_type &msg,
+                                   int flags) noexcept -> std::streamsize
+{
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < msg.msg_iovlen; ++i)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    size += msg.msg_iov[i].iov_len;
+  }
+
+  auto lock = std::lock_guard{mtx_};
+  try
+  {
+    if (size)
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      pending_.push_back({{msg.msg_iov, msg.msg_iov + msg.msg_iovlen}});
+      flags |= MSG_ZEROCOPY;
+    }
+  }
+  catch (const std::bad_alloc &)
+  {}
+
+  std::streamsize len = -1;
+  while ((len = ::io::socket::sendmsg(socket, &msg, flags)) < 0)
+  {
+    if (errno != EINTR)
+      break;
+  }
+
+  if (len < 0 && (flags & MSG_ZEROCOPY))
+  {
+    auto error = errno;
+    pending_.pop_back();
+    errno = error;
+  }
+
+  return len;
+}
+
+inline auto zerocopy_tracker::try_arm() noexcept -> bool
+{
+  auto lock = std::lock_guard{mtx_};
+  if (armed_ || pending_.empty())
+    return false;
+
+  return (armed_ = true);
+}
+
+inline auto zerocopy_tracker::disarm() noexcept -> void
+{
+  auto lock = std::lock_guard{mtx_};
+  armed_ = false;
+}
+
+inline auto zerocopy_tracker::reap(native_socket_type socket) noexcept
+    -> std::optional<std::size_t>
+{
+  static constexpr auto control_size =
+      CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6));
+
+  for (;;)
+  {
+    alignas(cmsghdr) std::array<char, control_size> control{};
+    socket_message_type msg{.msg_control = control.data(),
+                            .msg_controllen = control.size()};
+
+    std::streamsize len = -1;
+    while ((len = ::io::socket::recvmsg(socket, &msg,
+                                        MSG_ERRQUEUE | MSG_DONTWAIT)) < 0)
+    {
+      if (errno != EINTR)
+        break;
+    }
+
+    if (len < 0)
+      break;
+
+    for (auto *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+      {
+        continue;
+      }
+
+      sock_extended_err error{};
+      std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+      if (error.ee_errno == 0 && error.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+      {
+        release(error.ee_info, error.ee_data,
+                error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+      }
+    }
+  }
+
+  // Report the released sends in order, without holding the lock.
+  std::size_t count = 0;
+  auto lock = std::unique_lock{mtx_};
+  while (!pending_.empty() && pending_.front().released)
+  {
+    auto buffers = std::move(pending_.front().buffers);
+    pending_.pop_front();
+    ++first_;
+    ++count;
+
+    lock.unlock();
+    if (on_release_)
+      on_release_(buffers);
+    lock.lock();
+  }
+
+  if (pending_.empty())
+  {
+    armed_ = false;
+    return count;
+  }
+
+  errno = EWOULDBLOCK;
+  return std::nullopt;
+}
+
+inline auto zerocopy_tracker::pending() const noexcept -> std::size_t
+{
+  auto lock = std::lock_guard{mtx_};
+  return pending_.size();
+}
+
+inline auto zerocopy_tracker::copied() const noexcept -> std::size_t
+{
+  auto lock = std::lock_guard{mtx_};
+  return copied_;
+}
+
+inline auto zerocopy_tracker::release(std::uint32_t first, std::uint32_t last,
+                                      bool copied) noexcept -> void
+{
+  auto lock = std::lock_guard{mtx_};
+  // The numbers wrap around, so they are compared as offsets from `first_`.
+  auto begin = static_cast<std::uint32_t>(first - first_);
+  auto end = static_cast<std::uint32_t>(last - first_) + std::size_t{1};
+  for (auto i = std::size_t{begin}; i < end && i < pending_.size(); ++i)
+  {
+    if (!pending_[i].released && copied)
+      ++copied_;
+
+    pending_[i].released = true;
+  }
+}
+#endif // OS_LINUX
+
+} // namespace io::socket::detail
+#endif // IO_ZEROCOPY_TRACKER_HPP
@@ -0,0 +1,155 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file buffer_pool_impl.hpp
+ * @brief Implements the buffer pool.
+ */
+#pragma once
+#ifndef IO_BUFFER_POOL_IMPL_HPP
+#define IO_BUFFER_POOL_IMPL_HPP
+#include "io/socket/buffer_pool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <utility>
+namespace io::socket {
+
+inline pooled_buffer::pooled_buffer(pooled_buffer &&other) noexcept
+    : pool_{std::move(other.pool_)},
+      data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)}
+{}
+
+inline auto
+pooled_buffer::operator=(pooled_buffer &&other) noexcept -> pooled_buffer &
+{
+  if (this != &other)
+  {
+    reset();
+    pool_ = std::move(other.pool_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+inline pooled_buffer::~pooled_buffer() { reset(); }
+
+inline auto pooled_buffer::capacity() const noexcept -> size_type
+{
+  return data_ ? pool_->buffer_size() : 0;
+}
+
+inline auto pooled_buffer::resize(size_type size) noexcept -> void
+{
+  size_ = std::min(size, capacity());
+}
+
+inline auto pooled_buffer::reset() noexcept -> void
+{
+  if (data_)
+    pool_->release(std::exchange(data_, nullptr));
+
+  pool_.reset();
+  size_ = 0;
+}
+
+inline buffer_pool::buffer_pool(size_type buffer_size, size_type slab_size,
+                                std::pmr::memory_resource *upstream) noexcept
+    : buffer_size_{std::max(buffer_size, sizeof(node))},
+      slab_size_{std::max(slab_size, size_type{1})}, upstream_{upstream},
+      slabs_{upstream}
+{
+  static constexpr auto align = alignof(std::max_align_t);
+  buffer_size_ = (buffer_size_ + align - 1) / align * align;
+}
+
+inline buffer_pool::~buffer_pool()
+{
+  for (auto *slab : slabs_)
+    upstream_->deallocate(slab, buffer_size_ * slab_size_,
+                          alignof(std::max_align_t));
+}
+
+inline auto buffer_pool::acquire() -> pooled_buffer
+{
+  auto self = shared_from_this();
+  return {std::move(self), take()};
+}
+
+inline auto buffer_pool::try_acquire() noexcept -> pooled_buffer
+{
+  try
+  {
+    return acquire();
+  }
+  catch (...)
+  {
+    return {};
+  }
+}
+
+inline auto buffer_pool::capacity() const noexcept -> size_type
+{
+  return capacity_.load(std::memory_order_relaxed);
+}
+
+inline auto buffer_pool::grow() -> void
+{
+  // Reserve first so that the slab can't leak if the vector fails to grow.
+  if (slabs_.size() == slabs_.capacity())
+    slabs_.reserve(2 * slabs_.size() + 1);
+
+  auto *slab = static_cast<std::byte *>(upstream_->allocate(
+      buffer_size_ * slab_size_, alignof(std::max_align_t)));
+  slabs_.push_back(slab);
+
+  for (auto i = slab_size_; i > 0; --i)
+  {
+    auto *data = slab + (i - 1) * buffer_size_;
+    free_ = new (data) node{free_};
+  }
+
+  capacity_.store(capacity() + slab_size_, std::memory_order_relaxed);
+}
+
+inline auto buffer_pool::take() -> std::byte *
+{
+  auto lock = std::lock_guard(mtx_);
+  if (!free_)
+    free_ = returned_.exchange(nullptr, std::memory_order_acquire);
+
+  if (!free_)
+    grow();
+
+  auto *head = std::exchange(free_, free_->next);
+  head->~node();
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<std::byte *>(head);
+}
+
+inline auto buffer_pool::release(std::byte *data) noexcept -> void
+{
+  auto *head = new (data) node{returned_.load(std::memory_order_relaxed)};
+  while (!returned_.compare_exchange_weak(head->next, head,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed))
+  {}
+}
+
+} // namespace io::socket
+#endif // IO_BUFFER_POOL_IMPL_HPP
@@ -0,0 +1,215 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file connection_arena_impl.hpp
+ * @brief Implements the connection arena.
+ */
+#pragma once
+#ifndef IO_CONNECTION_ARENA_IMPL_HPP
+#define IO_CONNECTION_ARENA_IMPL_HPP
+#include "io/socket/connection_arena.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+namespace io::socket {
+
+template <typename T> struct connection_arena::first_block {
+  /** @brief The value type. */
+  using value_type = T;
+
+  /**
+   * @brief Constructs the allocator.
+   * @param pool The pool the block is given back to.
+   * @param data The block.
+   * @param rest Receives the part of the block that is left.
+   */
+  first_block(std::shared_ptr<buffer_pool> pool, std::byte *data,
+              std::span<std::byte> *rest) noexcept
+      : pool{std::move(pool)}, data{data}, rest{rest}
+  {}
+
+  /**
+   * @brief Constructs the allocator from one of another value type.
+   * @tparam U The value type of the other allocator.
+   * @param other The other allocator.
+   */
+  template <typename U>
+  first_block(const first_block<U> &other) noexcept
+      : pool{other.pool}, data{other.data}, rest{other.rest}
+  {}
+
+  /**
+   * @brief Places `n` objects at the start of the block.
+   * @param n The number of objects.
+   * @throws std::bad_alloc if they don't fit in the block.
+   * @return A pointer to the start of the block.
+   */
+  auto allocate(std::size_t n) -> T *
+  {
+    static constexpr auto align = alignof(std::max_align_t);
+    static_assert(alignof(T) <= align);
+
+    if (n > pool->buffer_size() / sizeof(T))
+      throw std::bad_alloc();
+
+    auto bytes = std::min((n * sizeof(T) + align - 1) / align * align,
+                          pool->buffer_size());
+    *rest = {data + bytes, pool->buffer_size() - bytes};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<T *>(data);
+  }
+
+  /** @brief Gives the block back to the pool. */
+  auto deallocate(T * /*ptr*/, std::size_t /*n*/) noexcept -> void
+  {
+    pool->release(data);
+  }
+
+  /** @brief Checks if two allocators place objects in the same block. */
+  template <typename U>
+  auto operator==(const first_block<U> &other) const noexcept -> bool
+  {
+    return data == other.data;
+  }
+
+  /** @brief The pool the block is given back to. */
+  std::shared_ptr<buffer_pool> pool;
+  /** @brief The block. */
+  std::byte *data;
+  /** @brief Receives the part of the block that is left. */
+  std::span<std::byte> *rest;
+};
+
+inline auto connection_arena::make(const std::shared_ptr<buffer_pool> &blocks)
+    -> std::shared_ptr<connection_arena>
+{
+  auto *data = blocks->take();
+  try
+  {
+    auto first = std::span<std::byte>{};
+    return std::allocate_shared<connection_arena>(
+        first_block<connection_arena>{blocks, data, &first}, private_tag{},
+        blocks, first);
+  }
+  catch (...)
+  {
+    blocks->release(data);
+    throw;
+  }
+}
+
+inline connection_arena::connection_arena(
+    private_tag /*tag*/, std::shared_ptr<buffer_pool> blocks,
+    const std::span<std::byte> &first) noexcept
+    : pool_{std::move(blocks)}, first_{first}, next_{first.data()},
+      end_{first.data() + first.size()}
+{}
+
+inline auto connection_arena::allocate(size_type bytes,
+                                       size_type alignment) -> void *
+{
+  if (oversized(bytes, alignment))
+    return ::operator new(bytes, std::align_val_t{alignment});
+
+  auto lock = std::lock_guard(mtx_);
+  void *ptr = next_;
+  auto space = static_cast<size_type>(end_ - next_);
+  if (!std::align(alignment, bytes, ptr, space))
+  {
+    grow();
+    ptr = next_;
+    space = static_cast<size_type>(end_ - next_);
+    std::align(alignment, bytes, ptr, space);
+  }
+
+  next_ = static_cast<std::byte *>(ptr) + bytes;
+  return ptr;
+}
+
+inline auto connection_arena::deallocate(void *ptr, size_type bytes,
+                                         size_type alignment) noexcept -> void
+{
+  if (oversized(bytes, alignment))
+  {
+    ::operator delete(ptr, bytes, std::align_val_t{alignment});
+    return;
+  }
+
+  auto lock = std::lock_guard(mtx_);
+  if (static_cast<std::byte *>(ptr) + bytes == next_)
+    next_ = static_cast<std::byte *>(ptr);
+}
+
+inline auto connection_arena::release() noexcept -> void
+{
+  auto lock = std::lock_guard(mtx_);
+  while (last_)
+  {
+    auto *previous = last_->previous;
+    last_->~block();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    pool_->release(reinterpret_cast<std::byte *>(last_));
+    last_ = previous;
+  }
+
+  next_ = first_.data();
+  end_ = first_.data() + first_.size();
+  count_ = 1;
+}
+
+inline auto
+connection_arena::oversized(size_type bytes,
+                            size_type alignment) const noexcept -> bool
+{
+  auto limit = pool_->buffer_size() - sizeof(block);
+  return bytes > limit || alignment > limit - bytes;
+}
+
+inline auto connection_arena::grow() -> void
+{
+  auto *data = pool_->take();
+  last_ = new (data) block{last_};
+  next_ = data + sizeof(block);
+  end_ = data + pool_->buffer_size();
+  ++count_;
+}
+
+template <typename T>
+auto arena_allocator<T>::allocate(std::size_t n) -> T *
+{
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+    throw std::bad_array_new_length();
+
+  if (!arena_)
+    return std::allocator<T>{}.allocate(n);
+
+  return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+auto arena_allocator<T>::deallocate(T *ptr, std::size_t n) noexcept -> void
+{
+  if (!arena_)
+    return std::allocator<T>{}.deallocate(ptr, n);
+
+  arena_->deallocate(ptr, n * sizeof(T), alignof(T));
+}
+
+} // namespace io::socket
+#endif // IO_CONNECTION_ARENA_IMPL_HPP
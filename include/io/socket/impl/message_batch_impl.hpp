@@ -0,0 +1,140 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file message_batch_impl.hpp
+ * @brief Implements the message batch.
+ */
+#pragma once
+#ifndef IO_MESSAGE_BATCH_IMPL_HPP
+#define IO_MESSAGE_BATCH_IMPL_HPP
+#include "io/socket/message_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+namespace io::socket {
+
+template <AllocatorLike Allocator>
+message_batch<Allocator>::message_batch(const Allocator &alloc)
+    : headers_(alloc), buffers_(alloc), addresses_(alloc)
+{}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::reserve(size_type count) -> void
+{
+  headers_.reserve(count);
+  buffers_.reserve(count);
+  addresses_.reserve(count);
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::push_back(
+    std::span<std::byte> buffer, std::span<const std::byte> address) -> void
+{
+  auto &storage = addresses_.emplace_back();
+  auto namelen = std::min(address.size(), sizeof(storage));
+  // An empty span may have a null data(), which memcpy must not be given.
+  if (namelen)
+    std::memcpy(&storage, address.data(), namelen);
+
+  buffers_.push_back({.iov_base = buffer.data(), .iov_len = buffer.size()});
+
+  auto &header = headers_.emplace_back();
+  header.msg_hdr.msg_namelen = static_cast<socklen_type>(namelen);
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::clear() noexcept -> void
+{
+  headers_.clear();
+  buffers_.clear();
+  addresses_.clear();
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::size() const noexcept -> size_type
+{
+  return headers_.size();
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::empty() const noexcept -> bool
+{
+  return headers_.empty();
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::buffer(size_type index) const noexcept
+    -> std::span<std::byte>
+{
+  const auto &buf = buffers_[index];
+  return {static_cast<std::byte *>(buf.iov_base), buf.iov_len};
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::data(size_type index) const noexcept
+    -> std::span<std::byte>
+{
+  auto buf = buffer(index);
+  return buf.first(std::min<std::size_t>(headers_[index].msg_len, buf.size()));
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::address(size_type index) const noexcept
+    -> std::span<const std::byte>
+{
+  const auto *storage = reinterpret_cast<const std::byte *>(&addresses_[index]);
+  auto namelen = std::min<std::size_t>(headers_[index].msg_hdr.msg_namelen,
+                                       sizeof(sockaddr_storage_type));
+  return {storage, namelen};
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::flags(size_type index) const noexcept -> int
+{
+  return headers_[index].msg_hdr.msg_flags;
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::prepare_recv() noexcept
+    -> std::span<socket_mmsg_type>
+{
+  for (size_type i = 0; i < headers_.size(); ++i)
+  {
+    headers_[i] = {.msg_hdr = {.msg_name = &addresses_[i],
+                               .msg_namelen = sizeof(sockaddr_storage_type),
+                               .msg_iov = &buffers_[i],
+                               .msg_iovlen = 1}};
+  }
+  return headers_;
+}
+
+template <AllocatorLike Allocator>
+auto message_batch<Allocator>::prepare_send() noexcept
+    -> std::span<socket_mmsg_type>
+{
+  for (size_type i = 0; i < headers_.size(); ++i)
+  {
+    auto namelen = headers_[i].msg_hdr.msg_namelen;
+    headers_[i] = {.msg_hdr = {.msg_name = namelen ? &addresses_[i] : nullptr,
+                               .msg_namelen = namelen,
+                               .msg_iov = &buffers_[i],
+                               .msg_iovlen = 1}};
+  }
+  return headers_;
+}
+
+} // namespace io::socket
+#endif // IO_MESSAGE_BATCH_IMPL_HPP
@@ -0,0 +1,217 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file message_operation_impl.hpp
+ * @brief Implements the re-armable receive and send operations.
+ */
+#pragma once
+#ifndef IO_MESSAGE_OPERATION_IMPL_HPP
+#define IO_MESSAGE_OPERATION_IMPL_HPP
+#include "io/detail/customization.hpp"
+#include "io/socket/detail/async_operations.hpp"
+#include "io/socket/message_operation.hpp"
+
+#include <cerrno>
+#include <functional>
+#include <memory>
+namespace io::socket {
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::syscall::
+operator()() const noexcept -> std::optional<std::streamsize>
+{
+  // The message may be gone along with a destroyed operation.
+  if (self->orphaned)
+  {
+    errno = ECANCELED;
+    return std::nullopt;
+  }
+
+  auto &header = self->header;
+  auto &socket = *self->dialog.socket;
+  header.msg_namelen = self->namelen;
+  header.msg_controllen = self->controllen;
+  header.msg_flags = 0;
+
+  std::streamsize len = -1;
+  if constexpr (Trigger == execution::execution_trigger::READ)
+  {
+    len = ::io::recvmsg(socket, header, self->flags);
+    if constexpr (requires { self->msg->flags; })
+    {
+      if (len >= 0)
+        self->msg->flags = header.msg_flags;
+    }
+  }
+  else
+  {
+    len = ::io::sendmsg(socket, header, self->flags | MSG_NOSIGNAL);
+  }
+
+  return (len < 0) ? std::nullopt : std::optional<std::streamsize>{len};
+}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+basic_message_operation<Trigger, Mux, Message, Handler>::core::core(
+    socket_dialog<Mux> dialog, Message &msg, int flags, Handler handler)
+    : dialog{std::move(dialog)}, msg{&msg},
+      header{static_cast<socket_message_type>(msg)},
+      namelen{header.msg_namelen}, controllen{header.msg_controllen},
+      flags{flags}, handler{std::move(handler)}, state{connect()}
+{}
+
+/**
+ * @details The sender is taken from the multiplexer directly instead of from
+ * the executor, which would nest it in its async scope for a single
+ * completion.
+ */
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::core::connect()
+    -> state_type
+{
+  auto executor = detail::get_executor(dialog);
+  return executor->Mux::set(dialog.socket, Trigger, syscall{this})
+      .connect(receiver{this});
+}
+
+/**
+ * @details The multiplexer doesn't touch the operation state after it has
+ * completed it, so an orphaned state can free itself here. The handoff is
+ * completed last, so the executor's scope stays open until the socket has
+ * been released.
+ */
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::core::finish(
+    std::error_code error, std::size_t len) noexcept -> void
+{
+  armed = false;
+  if (orphaned)
+  {
+    auto *done = release;
+    auto *state = handoff;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete this;
+    if (done)
+      done(state);
+    return;
+  }
+
+  std::invoke(handler, error, len);
+}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+basic_message_operation<Trigger, Mux, Message, Handler>::
+    basic_message_operation(dialog_type dialog, Message &msg, int flags,
+                            Handler handler)
+    : core_{std::make_unique<core>(std::move(dialog), msg, flags,
+                                   std::move(handler))}
+{}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+basic_message_operation<Trigger, Mux, Message,
+                        Handler>::~basic_message_operation()
+{
+  if (!core_->armed)
+    return;
+
+  // A cancelled operation that is already ready, or that is in flight on
+  // io_uring, completes on the next wait, and its state is still linked
+  // into the multiplexer until then. The completion frees it.
+  cancel();
+  if (!core_->armed)
+    return;
+
+  try
+  {
+    detail::get_executor(core_->dialog)->spawn(handoff{core_.get()});
+  }
+  catch (...)
+  {
+    // Without the handoff the state is still freed, but `on_empty()`
+    // doesn't wait for it.
+  }
+
+  core_->orphaned = true;
+  static_cast<void>(core_.release());
+}
+
+/**
+ * @details The I/O vectors are taken from the message again, so that a send
+ * continues after the bytes that the message's buffers were advanced by.
+ */
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::start() noexcept
+    -> bool
+{
+  auto &self = *core_;
+  if (self.stop.stop_requested())
+    return false;
+
+  if constexpr (requires { self.msg->buffers.native(); })
+  {
+    auto iov = self.msg->buffers.native();
+    self.header.msg_iov = iov.data();
+    self.header.msg_iovlen = iov.size();
+  }
+
+  self.armed = true;
+  self.state.start();
+  return true;
+}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::cancel() noexcept
+    -> void
+{
+  core_->stop.request_stop();
+}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::armed()
+    const noexcept -> bool
+{
+  return core_->armed;
+}
+
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+auto basic_message_operation<Trigger, Mux, Message, Handler>::dialog()
+    const noexcept -> const dialog_type &
+{
+  return core_->dialog;
+}
+
+} // namespace io::socket
+#endif // IO_MESSAGE_OPERATION_IMPL_HPP
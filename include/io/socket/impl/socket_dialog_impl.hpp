@@ -17,7 +17,10 @@
 #define IO_SOCKET_DIALOG_IMPL_HPP
 #include "io/error.hpp"
 #include "io/socket/socket_dialog.hpp"
+#include "io/socket/socket_option.hpp"
 
+#include <cerrno>
+#include <utility>
 namespace io::socket {
 
 template <Multiplexer Mux> socket_dialog<Mux>::operator bool() const noexcept
@@ -34,6 +37,35 @@ socket_dialog<Mux>::operator native_socket_type() const
   return static_cast<native_socket_type>(*socket);
 }
 
+template <Multiplexer Mux>
+auto socket_dialog<Mux>::with_write_queue() const -> socket_dialog
+{
+  return {executor, socket,
+          std::allocate_shared<detail::write_queue>(get_allocator()),
+          zerocopy, arena};
+}
+
+template <Multiplexer Mux>
+auto socket_dialog<Mux>::with_zerocopy(
+    detail::zerocopy_tracker::release_callback on_release) const
+    -> socket_dialog
+{
+#if OS_LINUX
+  socket_option<int> enable{1};
+  if (::io::setsockopt(*socket, SOL_SOCKET, SO_ZEROCOPY, enable))
+    throw_system_error(IO_ERROR_MESSAGE("setsockopt failed."));
+
+  return {executor, socket, writes,
+          std::allocate_shared<detail::zerocopy_tracker>(get_allocator(),
+                                                        std::move(on_release)),
+          arena};
+#else
+  errno = ENOTSUP;
+  throw_system_error(IO_ERROR_MESSAGE("Zero-copy sends are not supported."));
+  return *this;
+#endif
+}
+
 template <Multiplexer Mux>
 auto operator<=>(const socket_dialog<Mux> &lhs,
                  const socket_dialog<Mux> &rhs) -> std::strong_ordering
@@ -101,6 +101,8 @@ inline auto swap(socket_handle &lhs, socket_handle &rhs) noexcept -> void
   std::scoped_lock lock(lhs.mtx_, rhs.mtx_);
   swap_atomic(lhs.socket_, rhs.socket_);
   swap_atomic(lhs.error_, rhs.error_);
+  swap(lhs.read_predictor_, rhs.read_predictor_);
+  swap(lhs.write_predictor_, rhs.write_predictor_);
 }
 
 inline socket_handle::operator bool() const noexcept
@@ -142,6 +144,18 @@ inline auto socket_handle::get_error() const noexcept -> std::error_code
   return {error_.load(std::memory_order_relaxed), std::system_category()};
 }
 
+inline auto socket_handle::read_predictor() noexcept
+    -> detail::eager_predictor &
+{
+  return read_predictor_;
+}
+
+inline auto socket_handle::write_predictor() noexcept
+    -> detail::eager_predictor &
+{
+  return write_predictor_;
+}
+
 inline socket_handle::~socket_handle() { close(); }
 
 inline auto socket_handle::close() noexcept -> void
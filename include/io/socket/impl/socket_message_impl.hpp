@@ -24,27 +24,53 @@
 #include "io/socket/socket_message.hpp"
 #include <io/detail/concepts.hpp>
 
-#include <algorithm>
+#include <ranges>
 namespace io::socket {
 
 // message_buffer member function implementations
-template <AllocatorLike Allocator>
-message_buffer<Allocator>::message_buffer(const Allocator &alloc) noexcept(
+template <AllocatorLike Allocator, std::size_t N>
+message_buffer<Allocator, N>::message_buffer(const Allocator &alloc) noexcept(
     noexcept(Allocator()))
-    : buffer_(alloc)
+    : heap_(alloc)
 {}
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 template <ScatterGatherLike... Bufs>
-constexpr message_buffer<Allocator>::message_buffer(
+constexpr message_buffer<Allocator, N>::message_buffer(
     const Bufs &...bufs) noexcept
 {
   (push_back(bufs), ...);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
+constexpr message_buffer<Allocator, N>::message_buffer(
+    message_buffer &&other) noexcept
+    : inline_(other.inline_), heap_(std::move(other.heap_)),
+      size_(other.size_), head_(other.head_), bytes_(other.bytes_)
+{
+  other.clear();
+}
+
+template <AllocatorLike Allocator, std::size_t N>
+constexpr auto
+message_buffer<Allocator, N>::operator=(message_buffer &&other) noexcept
+    -> message_buffer &
+{
+  if (this != &other)
+  {
+    inline_ = other.inline_;
+    heap_ = std::move(other.heap_);
+    size_ = other.size_;
+    head_ = other.head_;
+    bytes_ = other.bytes_;
+    other.clear();
+  }
+  return *this;
+}
+
+template <AllocatorLike Allocator, std::size_t N>
 template <ScatterGatherLike Buf>
-constexpr auto message_buffer<Allocator>::push_back(const Buf &buf) -> void
+constexpr auto message_buffer<Allocator, N>::push_back(const Buf &buf) -> void
 {
   using element_type = std::remove_pointer_t<decltype(std::ranges::data(buf))>;
   using pointer_type = std::decay_t<element_type> *;
@@ -58,98 +84,139 @@ constexpr auto message_buffer<Allocator>::push_back(const Buf &buf) -> void
 #endif // OS_WINDOWS
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 constexpr auto
-message_buffer<Allocator>::push_back(native_buffer_type buf) -> void
+message_buffer<Allocator, N>::push_back(native_buffer_type buf) -> void
 {
-  buffer_.push_back(buf);
+  emplace_back(buf);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 template <typename... Args>
 constexpr auto
-message_buffer<Allocator>::emplace_back(Args &&...args) -> decltype(auto)
+message_buffer<Allocator, N>::emplace_back(Args &&...args) -> decltype(auto)
 {
-  return buffer_.emplace_back(std::forward<Args>(args)...);
+  native_buffer_type *buf = nullptr;
+  if (heap_.empty() && size_ < N)
+  {
+    buf = &(inline_[size_] = native_buffer_type(std::forward<Args>(args)...));
+  }
+  else
+  {
+    // Spill the inline buffers to the allocator before the first one that
+    // doesn't fit.
+    if (heap_.empty())
+    {
+      heap_.reserve(2 * N);
+      heap_.assign(inline_.begin(), inline_.end());
+    }
+    buf = &heap_.emplace_back(std::forward<Args>(args)...);
+  }
+
+  ++size_;
+  bytes_ += length(*buf);
+  return *buf;
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::begin() noexcept -> iterator
+message_buffer<Allocator, N>::begin() noexcept -> iterator
 {
-  return iterator(buffer_.begin());
+  return iterator(storage() + head_);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::begin() const noexcept -> const_iterator
+message_buffer<Allocator, N>::begin() const noexcept -> const_iterator
 {
-  return const_iterator(buffer_.cbegin());
+  return const_iterator(storage() + head_);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::end() noexcept -> iterator
+message_buffer<Allocator, N>::end() noexcept -> iterator
 {
-  return iterator(buffer_.end());
+  return iterator(storage() + size_);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::end() const noexcept -> const_iterator
+message_buffer<Allocator, N>::end() const noexcept -> const_iterator
 {
-  return const_iterator(buffer_.cend());
+  return const_iterator(storage() + size_);
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::size() const noexcept -> size_type
+message_buffer<Allocator, N>::size() const noexcept -> size_type
 {
-  return buffer_.size();
+  return size_ - head_;
 }
 
-template <AllocatorLike Allocator>
+template <AllocatorLike Allocator, std::size_t N>
 [[nodiscard]] constexpr auto
-message_buffer<Allocator>::empty() const noexcept -> bool
+message_buffer<Allocator, N>::bytes() const noexcept -> std::size_t
+{
+  return bytes_;
+}
+
+template <AllocatorLike Allocator, std::size_t N>
+[[nodiscard]] constexpr auto
+message_buffer<Allocator, N>::empty() const noexcept -> bool
+{
+  return bytes_ == 0;
+}
+
+template <AllocatorLike Allocator, std::size_t N>
+constexpr auto message_buffer<Allocator, N>::clear() noexcept -> void
+{
+  heap_.clear();
+  size_ = 0;
+  head_ = 0;
+  bytes_ = 0;
+}
+
+template <AllocatorLike Allocator, std::size_t N>
+constexpr auto message_buffer<Allocator, N>::length(
+    const native_buffer_type &buf) noexcept -> std::size_t
 {
-  std::size_t len = 0;
-  for (const auto &buf : buffer_)
-  {
 #if OS_WINDOWS
-    len += buf.len;
+  return buf.len;
 #else
-    len += buf.iov_len;
+  return buf.iov_len;
 #endif // OS_WINDOWS
-  }
-  return len == 0;
 }
 
-template <AllocatorLike Allocator>
-[[nodiscard]] constexpr message_buffer<Allocator>::operator bool()
+template <AllocatorLike Allocator, std::size_t N>
+[[nodiscard]] constexpr message_buffer<Allocator, N>::operator bool()
     const noexcept
 {
   return !empty();
 }
 
-template <AllocatorLike Allocator>
-auto message_buffer<Allocator>::operator+=(std::size_t len) noexcept
+template <AllocatorLike Allocator, std::size_t N>
+auto message_buffer<Allocator, N>::operator+=(std::size_t len) noexcept
     -> message_buffer &
 {
-  auto [ret, last] = std::ranges::remove_if(buffer_, [&](auto &buf) -> bool {
-    if (!len)
-      return false;
+  auto *buffers = storage();
+  for (; len && head_ < size_; ++head_)
+  {
+    auto &buf = buffers[head_];
+    auto count = length(buf);
+    if (len < count)
+    {
+      buf += len;
+      bytes_ -= len;
+      break;
+    }
 
-#if OS_WINDOWS
-    auto count = buf.len;
-#else
-    auto count = buf.iov_len;
-#endif // OS_WINDOWS
+    len -= count;
+    bytes_ -= count;
+  }
 
-    buf += len;
-    return (len < count) ? (len = 0) : (len -= count) >= 0;
-  });
+  if (head_ == size_)
+    clear();
 
-  buffer_.erase(ret, last);
   return *this;
 }
 
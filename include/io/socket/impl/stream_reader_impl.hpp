@@ -0,0 +1,113 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file stream_reader_impl.hpp
+ * @brief Implements the stream reader.
+ */
+#pragma once
+#ifndef IO_STREAM_READER_IMPL_HPP
+#define IO_STREAM_READER_IMPL_HPP
+#include "io/error.hpp"
+#include "io/socket/stream_reader.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <ios>
+#include <utility>
+namespace io::socket {
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+stream_reader<Mux, Allocator>::stream_reader(dialog_type dialog,
+                                             size_type capacity,
+                                             const Allocator &alloc)
+    : dialog_{std::move(dialog)},
+      buffer_(std::bit_ceil(std::max(capacity, size_type{1})), alloc)
+{}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::read(int flags) -> decltype(auto)
+{
+  auto free = capacity() - size();
+  if (!free)
+  {
+    errno = ENOBUFS;
+    throw_system_error(IO_ERROR_MESSAGE("The stream buffer is full."));
+  }
+
+  auto first = tail_ & (capacity() - 1);
+  auto len = std::min(free, capacity() - first);
+  iov_[0] = {.iov_base = buffer_.data() + first, .iov_len = len};
+  iov_[1] = {.iov_base = buffer_.data(), .iov_len = free - len};
+  header_ = {.msg_iov = std::span(iov_.data(), (free > len) ? 2 : 1)};
+
+  return ::io::recvmsg(dialog_, header_, flags) |
+         stdexec::then([this](std::streamsize len) noexcept {
+           tail_ += static_cast<size_type>(len);
+           return len;
+         });
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::data() noexcept -> buffers_type
+{
+  auto first = head_ & (capacity() - 1);
+  auto len = std::min(size(), capacity() - first);
+  return {std::span(buffer_.data() + first, len),
+          std::span(buffer_.data(), size() - len)};
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::consume(size_type len) noexcept -> void
+{
+  head_ += std::min(len, size());
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::size() const noexcept -> size_type
+{
+  return tail_ - head_;
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::capacity() const noexcept -> size_type
+{
+  return buffer_.size();
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::empty() const noexcept -> bool
+{
+  return head_ == tail_;
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::full() const noexcept -> bool
+{
+  return size() == capacity();
+}
+
+template <Multiplexer Mux, AllocatorLike Allocator>
+auto stream_reader<Mux, Allocator>::dialog() const noexcept
+    -> const dialog_type &
+{
+  return dialog_;
+}
+
+} // namespace io::socket
+#endif // IO_STREAM_READER_IMPL_HPP
@@ -0,0 +1,151 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file message_batch.hpp
+ * @brief Defines a batch of datagrams for `recvmmsg` and `sendmmsg`.
+ */
+#pragma once
+#ifndef IO_MESSAGE_BATCH_HPP
+#define IO_MESSAGE_BATCH_HPP
+#include "detail/socket.hpp"
+#include "io/detail/concepts.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+namespace io::socket {
+/**
+ * @brief A batch of single-buffer messages stored as parallel arrays.
+ *
+ * The native message headers, their I/O vectors and their addresses are kept
+ * in three contiguous arrays (structure of arrays), so a whole batch is
+ * transferred by a single `recvmmsg` or `sendmmsg` call without any
+ * per-message allocation. The headers are re-pointed at the other arrays
+ * just before each call, so the batch can grow between calls.
+ *
+ * @tparam Allocator The allocator for the arrays.
+ */
+template <AllocatorLike Allocator = std::allocator<std::byte>>
+class message_batch {
+  /** @brief Rebinds the allocator to another value type. */
+  template <typename T>
+  using rebind_alloc =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+  /** @brief The size type. */
+  using size_type = std::size_t;
+  /** @brief The array of native message headers. */
+  using header_array =
+      std::vector<socket_mmsg_type, rebind_alloc<socket_mmsg_type>>;
+  /** @brief The array of I/O vectors, one for each message. */
+  using buffer_array =
+      std::vector<native_buffer_type, rebind_alloc<native_buffer_type>>;
+  /** @brief The array of addresses, one for each message. */
+  using address_array =
+      std::vector<sockaddr_storage_type, rebind_alloc<sockaddr_storage_type>>;
+
+  /**
+   * @brief Constructs an empty batch.
+   * @param alloc The allocator to use for the arrays.
+   */
+  explicit message_batch(const Allocator &alloc = Allocator());
+
+  /**
+   * @brief Reserves room for a number of messages.
+   * @param count The number of messages.
+   */
+  auto reserve(size_type count) -> void;
+
+  /**
+   * @brief Appends a message.
+   * @param buffer The buffer to send from or receive into.
+   * @param address The destination of a sent message. It is ignored when
+   * receiving, and it is truncated to the size of `sockaddr_storage`.
+   */
+  auto push_back(std::span<std::byte> buffer,
+                 std::span<const std::byte> address = {}) -> void;
+
+  /** @brief Removes all messages. */
+  auto clear() noexcept -> void;
+
+  /** @brief Returns the number of messages in the batch. */
+  [[nodiscard]] auto size() const noexcept -> size_type;
+
+  /** @brief Checks if the batch is empty. */
+  [[nodiscard]] auto empty() const noexcept -> bool;
+
+  /**
+   * @brief Gets the buffer of a message.
+   * @param index The index of the message.
+   * @return The buffer passed to `push_back()`.
+   */
+  [[nodiscard]] auto buffer(size_type index) const noexcept
+      -> std::span<std::byte>;
+
+  /**
+   * @brief Gets the bytes transferred for a message by the last batched call.
+   * @param index The index of the message.
+   * @return The transferred part of the message's buffer.
+   */
+  [[nodiscard]] auto data(size_type index) const noexcept
+      -> std::span<std::byte>;
+
+  /**
+   * @brief Gets the address of a message.
+   * @param index The index of the message.
+   * @return The sender of a received message or the destination of a sent
+   * message. Empty if the message has no address.
+   */
+  [[nodiscard]] auto address(size_type index) const noexcept
+      -> std::span<const std::byte>;
+
+  /**
+   * @brief Gets the flags of a received message.
+   * @param index The index of the message.
+   * @return The `msg_flags` of the message.
+   */
+  [[nodiscard]] auto flags(size_type index) const noexcept -> int;
+
+  /**
+   * @brief Prepares the headers for `recvmmsg`.
+   * @details Every message will record the address of its sender.
+   * @return The native message vector.
+   */
+  auto prepare_recv() noexcept -> std::span<socket_mmsg_type>;
+
+  /**
+   * @brief Prepares the headers for `sendmmsg`.
+   * @details Messages without an address are sent to the connected peer.
+   * @return The native message vector.
+   */
+  auto prepare_send() noexcept -> std::span<socket_mmsg_type>;
+
+private:
+  /** @brief The native message headers. */
+  header_array headers_;
+  /** @brief The I/O vector of each message. */
+  buffer_array buffers_;
+  /** @brief The address of each message. */
+  address_array addresses_;
+};
+
+} // namespace io::socket
+
+#include "impl/message_batch_impl.hpp" // IWYU pragma: export
+
+#endif // IO_MESSAGE_BATCH_HPP
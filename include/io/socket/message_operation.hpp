@@ -0,0 +1,379 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file message_operation.hpp
+ * @brief Defines re-armable receive and send operations for steady-state
+ * message loops.
+ */
+#pragma once
+#ifndef IO_MESSAGE_OPERATION_HPP
+#define IO_MESSAGE_OPERATION_HPP
+#include "detail/socket.hpp"
+#include "io/detail/concepts.hpp"
+#include "io/execution/detail/execution_trigger.hpp"
+#include "socket_dialog.hpp"
+
+#include <stdexec/execution.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <system_error>
+#include <utility>
+namespace io::socket {
+/**
+ * @brief An operation that receives or sends a message over and over again.
+ *
+ * A sender built with `recvmsg` or `sendmsg` converts the message into a
+ * fresh native header, is nested in the executor's scope and is connected to
+ * a new operation state every time. This operation is bound to a socket and a
+ * message once instead: the native header and the operation state are built
+ * in one allocation when it is constructed, and `start()` re-arms the same
+ * state, which reuses its slot in the multiplexer's demultiplexing queue.
+ * Only the I/O vectors are refreshed before each call, so the message's
+ * buffers may be advanced or replaced between completions. A receive or send
+ * in steady state doesn't allocate.
+ *
+ * The handler is called with the error and the number of bytes transferred
+ * when the operation completes. It may call `start()` to re-arm the
+ * operation. A cancelled operation completes with
+ * `std::errc::operation_canceled`, and can't be re-armed afterwards.
+ *
+ * The operation runs outside of the executor's async scope, so it must be
+ * destroyed before the executor is destroyed. Its message must not be moved
+ * or destroyed while it is armed. Completions are delivered on the thread
+ * that waits on the executor, which is also the thread that must re-arm,
+ * cancel and destroy the operation.
+ *
+ * An armed operation can be destroyed at any time. The destructor cancels
+ * it, which completes it at once if it is still waiting for its socket.
+ * Otherwise, because it is already ready, or because it is in flight on
+ * io_uring, its state is handed off to the executor and freed by the pending
+ * completion, which arrives on the next wait. Until then the state is held
+ * in the executor's async scope, so `on_empty()` waits for it like for any
+ * other operation. That completion doesn't call the socket API and doesn't
+ * call the handler, so the message may be destroyed along with the
+ * operation.
+ *
+ * @tparam Trigger `READ` to receive messages or `WRITE` to send them.
+ * @tparam Mux The multiplexer type.
+ * @tparam Message The message type.
+ * @tparam Handler The completion handler type.
+ */
+template <execution::execution_trigger Trigger, Multiplexer Mux,
+          MessageLike Message, typename Handler>
+  requires std::invocable<Handler &, std::error_code, std::size_t>
+class basic_message_operation {
+  struct core;
+
+  /**
+   * @internal
+   * @brief Calls into the socket API when the socket is ready.
+   */
+  struct syscall {
+    /** @brief Receives or sends the message. */
+    auto operator()() const noexcept -> std::optional<std::streamsize>;
+    /** @brief The operation to call into the socket API for. */
+    core *self = nullptr;
+  };
+
+  /**
+   * @internal
+   * @brief Receives the completions of the operation state.
+   */
+  struct receiver {
+    /** @brief The receiver concept type. */
+    using receiver_concept = stdexec::receiver_t;
+
+    /** @brief Provides the stop token of the operation. */
+    struct env {
+      /** @brief The stop token. */
+      stdexec::inplace_stop_token token;
+      /** @brief Gets the stop token. */
+      [[nodiscard]] auto query(stdexec::get_stop_token_t) const noexcept
+          -> stdexec::inplace_stop_token
+      {
+        return token;
+      }
+    };
+
+    /** @brief Completes with the number of bytes transferred. */
+    auto set_value(std::streamsize len) && noexcept -> void
+    {
+      self->finish({}, static_cast<std::size_t>(len));
+    }
+    /** @brief Completes with an error. */
+    auto set_error(std::error_code error) && noexcept -> void
+    {
+      self->finish(error, 0);
+    }
+    /** @brief Completes with `operation_canceled`. */
+    auto set_stopped() && noexcept -> void
+    {
+      self->finish(std::make_error_code(std::errc::operation_canceled), 0);
+    }
+    /** @brief Gets the environment of the receiver. */
+    [[nodiscard]] auto get_env() const noexcept -> env
+    {
+      return {self->stop.get_token()};
+    }
+
+    /** @brief The operation to complete. */
+    core *self = nullptr;
+  };
+
+  /**
+   * @internal
+   * @brief Holds the executor's async scope open for a handed-off state.
+   * @details It is spawned when an armed operation is destroyed, and
+   * completes when the state is freed.
+   */
+  struct handoff {
+    /** @brief The sender concept type. */
+    using sender_concept = stdexec::sender_t;
+    /** @brief The completion signatures for the sender. */
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t()>;
+
+    /**
+     * @brief The operation state of the handoff.
+     * @tparam Receiver The receiver type.
+     */
+    template <typename Receiver> struct state {
+      /**
+       * @brief Completes the handoff.
+       * @param ptr The operation state.
+       */
+      static auto release(void *ptr) noexcept -> void
+      {
+        stdexec::set_value(std::move(static_cast<state *>(ptr)->receiver));
+      }
+      /** @brief Hands the completion over to the state. */
+      auto start() noexcept -> void
+      {
+        self->release = state::release;
+        self->handoff = this;
+      }
+
+      /** @brief The handed-off state. */
+      core *self = nullptr;
+      /** @brief The receiver to complete. */
+      Receiver receiver;
+    };
+
+    /**
+     * @brief Connects the handoff to a receiver.
+     * @param receiver The receiver to connect to.
+     * @return The operation state.
+     */
+    template <typename Receiver>
+    auto connect(Receiver &&receiver) -> state<std::decay_t<Receiver>>
+    {
+      return {.self = self, .receiver = std::forward<Receiver>(receiver)};
+    }
+
+    /** @brief The handed-off state. */
+    core *self = nullptr;
+  };
+
+  /** @brief The sender type of the multiplexer. */
+  using sender_type = decltype(std::declval<Mux &>().set(
+      std::declval<std::shared_ptr<socket_handle>>(), Trigger,
+      std::declval<syscall>()));
+  /** @brief The operation state type of the multiplexer. */
+  using state_type =
+      decltype(std::declval<sender_type>().connect(std::declval<receiver>()));
+
+  /**
+   * @internal
+   * @brief The state of the operation.
+   * @details It is allocated once, so that it can outlive an operation that
+   * is destroyed while the multiplexer still holds its operation state.
+   */
+  struct core {
+    /**
+     * @brief Constructs the state of an operation that isn't armed yet.
+     * @param dialog The socket to receive from or send to.
+     * @param msg The message to receive into or send.
+     * @param flags The flags for `recvmsg` or `sendmsg`.
+     * @param handler The completion handler.
+     */
+    core(socket_dialog<Mux> dialog, Message &msg, int flags, Handler handler);
+
+    /**
+     * @brief Connects a sender of the multiplexer to this state.
+     * @return The operation state.
+     */
+    auto connect() -> state_type;
+    /**
+     * @brief Disarms the operation and calls the handler, or frees the state
+     * if the operation has been destroyed.
+     * @param error The error, if any.
+     * @param len The number of bytes transferred.
+     */
+    auto finish(std::error_code error, std::size_t len) noexcept -> void;
+
+    /** @brief The socket to receive from or send to. */
+    socket_dialog<Mux> dialog;
+    /** @brief The message to receive into or send. */
+    Message *msg;
+    /** @brief The native message header. */
+    socket_message_type header;
+    /** @brief The size of the message's address. */
+    decltype(header.msg_namelen) namelen;
+    /** @brief The size of the message's control data. */
+    decltype(header.msg_controllen) controllen;
+    /** @brief The flags for `recvmsg` or `sendmsg`. */
+    int flags;
+    /** @brief Whether the operation is waiting to complete. */
+    bool armed = false;
+    /** @brief Whether the operation was destroyed while it was armed. */
+    bool orphaned = false;
+    /** @brief Completes the handoff of an orphaned state. */
+    void (*release)(void *) noexcept = nullptr;
+    /** @brief The operation state of the handoff. */
+    void *handoff = nullptr;
+    /** @brief The completion handler. */
+    Handler handler;
+    /** @brief Cancels the operation. */
+    stdexec::inplace_stop_source stop;
+    /** @brief The operation state of the multiplexer. */
+    state_type state;
+  };
+
+public:
+  /** @brief The socket dialog type. */
+  using dialog_type = socket_dialog<Mux>;
+  /** @brief The message type. */
+  using message_type = Message;
+  /** @brief The completion handler type. */
+  using handler_type = Handler;
+
+  /**
+   * @brief Constructs an operation that isn't armed yet.
+   * @param dialog The socket to receive from or send to.
+   * @param msg The message to receive into or send. It must outlive the
+   * operation.
+   * @param flags The flags for `recvmsg` or `sendmsg`.
+   * @param handler The completion handler.
+   * @throws std::invalid_argument if the dialog's executor has expired.
+   */
+  basic_message_operation(dialog_type dialog, Message &msg, int flags,
+                          Handler handler);
+
+  /** @brief Deleted copy constructor. */
+  basic_message_operation(const basic_message_operation &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const basic_message_operation &)
+      -> basic_message_operation & = delete;
+  /** @brief Deleted move constructor. */
+  basic_message_operation(basic_message_operation &&) = delete;
+  /** @brief Deleted move assignment. */
+  auto operator=(basic_message_operation &&)
+      -> basic_message_operation & = delete;
+  /**
+   * @brief Cancels the operation if it is armed.
+   * @details If the operation is still armed after it was cancelled, its
+   * state is freed when its pending completion arrives, and the handler isn't
+   * called.
+   */
+  ~basic_message_operation();
+
+  /**
+   * @brief Arms the operation.
+   * @details The operation must not be armed already. It may complete
+   * before this function returns.
+   * @return false if the operation was cancelled and isn't armed, true
+   * otherwise.
+   */
+  auto start() noexcept -> bool;
+
+  /**
+   * @brief Cancels the operation.
+   * @details If it is armed and still waiting for its socket, it completes
+   * with `operation_canceled` before this function returns. If it is already
+   * ready to complete, it still completes with its result on the next wait on
+   * the executor.
+   */
+  auto cancel() noexcept -> void;
+
+  /** @brief Checks if the operation is waiting to complete. */
+  [[nodiscard]] auto armed() const noexcept -> bool;
+
+  /** @brief Gets the socket dialog. */
+  [[nodiscard]] auto dialog() const noexcept -> const dialog_type &;
+
+private:
+  /** @brief The state of the operation. */
+  std::unique_ptr<core> core_;
+};
+
+/**
+ * @brief An operation that receives a message over and over again.
+ * @see basic_message_operation
+ * @tparam Mux The multiplexer type.
+ * @tparam Message The message type.
+ * @tparam Handler The completion handler type.
+ */
+template <Multiplexer Mux, MessageLike Message, typename Handler>
+class recv_operation
+    : public basic_message_operation<execution::execution_trigger::READ, Mux,
+                                     Message, Handler> {
+public:
+  /** @brief Use the base class constructor. */
+  using basic_message_operation<execution::execution_trigger::READ, Mux,
+                                Message,
+                                Handler>::basic_message_operation;
+};
+
+/**
+ * @brief An operation that sends a message over and over again.
+ * @details The handler is called after each `sendmsg`, which may be partial,
+ * so the handler advances the message's buffers by the number of bytes sent
+ * before it re-arms the operation for the rest of the message.
+ * @see basic_message_operation
+ * @tparam Mux The multiplexer type.
+ * @tparam Message The message type.
+ * @tparam Handler The completion handler type.
+ */
+template <Multiplexer Mux, MessageLike Message, typename Handler>
+class send_operation
+    : public basic_message_operation<execution::execution_trigger::WRITE, Mux,
+                                     Message, Handler> {
+public:
+  /** @brief Use the base class constructor. */
+  using basic_message_operation<execution::execution_trigger::WRITE, Mux,
+                                Message,
+                                Handler>::basic_message_operation;
+};
+
+/** @brief Deduces the template arguments of a receive operation. */
+template <Multiplexer Mux, MessageLike Message, typename Handler>
+recv_operation(socket_dialog<Mux>, Message &, int, Handler)
+    -> recv_operation<Mux, Message, Handler>;
+
+/** @brief Deduces the template arguments of a send operation. */
+template <Multiplexer Mux, MessageLike Message, typename Handler>
+send_operation(socket_dialog<Mux>, Message &, int, Handler)
+    -> send_operation<Mux, Message, Handler>;
+
+} // namespace io::socket
+
+#include "impl/message_operation_impl.hpp" // IWYU pragma: export
+
+#endif // IO_MESSAGE_OPERATION_HPP
@@ -20,7 +20,10 @@
 #pragma once
 #ifndef IO_SOCKET_DIALOG_HPP
 #define IO_SOCKET_DIALOG_HPP
+#include "detail/write_queue.hpp"
+#include "detail/zerocopy_tracker.hpp"
 #include "io/detail/concepts.hpp"
+#include "io/socket/connection_arena.hpp"
 #include "io/socket/socket_handle.hpp"
 
 #include <memory>
@@ -47,6 +50,65 @@ template <Multiplexer Mux> struct socket_dialog {
   std::weak_ptr<executor_type> executor;
   /** @brief A shared pointer to the socket handle. */
   std::shared_ptr<socket_handle> socket;
+  /**
+   * @brief The queue that coalesces sends, or nullptr if sends are not
+   * coalesced.
+   */
+  std::shared_ptr<detail::write_queue> writes;
+  /**
+   * @brief The tracker for `MSG_ZEROCOPY` sends, or nullptr if sends are
+   * copied.
+   */
+  std::shared_ptr<detail::zerocopy_tracker> zerocopy;
+  /**
+   * @brief The arena of the connection, or nullptr if the connection
+   * allocates from the heap.
+   */
+  std::shared_ptr<connection_arena> arena;
+  /**
+   * @brief Gets an allocator for the connection.
+   * @details Allocator-aware types such as `socket_message` and
+   * `stream_reader` can be given this allocator to place their memory in the
+   * connection's arena. Rebind it to the value type that is needed.
+   * @returns An allocator that uses the connection's arena, or the heap if
+   * there is none.
+   */
+  [[nodiscard]] auto get_allocator() const noexcept
+      -> arena_allocator<std::byte>
+  {
+    return arena_allocator<std::byte>{arena};
+  }
+  /**
+   * @brief Makes a copy of the dialog that coalesces its sends.
+   * @details Sends on the copy, and on copies of it, are queued instead of
+   * being attempted eagerly. When the socket becomes writable, all the
+   * queued sends are gathered into as few `sendmsg` calls as possible, and
+   * each sender completes with its own byte count. A send joins the queue
+   * when its operation starts, and leaves it when the operation completes or
+   * is stopped, so a stopped send is never sent. Sends that carry an
+   * address or control data are not coalesced. All the sends on the socket
+   * should go through dialogs that share the same queue, otherwise their
+   * order is not preserved.
+   * @returns A copy of the dialog with a new write queue.
+   */
+  [[nodiscard]] auto with_write_queue() const -> socket_dialog;
+  /**
+   * @brief Makes a copy of the dialog that sends with `MSG_ZEROCOPY`.
+   * @details Enables `SO_ZEROCOPY` on the socket. Sends on the copy, and on
+   * copies of it, complete with the number of bytes sent as soon as the
+   * kernel accepts them, but the kernel keeps reading from the buffers until
+   * the data is acknowledged. The buffers must stay valid and unmodified until
+   * `on_release` is called with them. `on_release` is called once for each
+   * send, in send order, from the thread that runs the executor. Sends that
+   * go through a write queue are copied. Zero-copy only pays off for large
+   * sends, of roughly 10 KB or more.
+   * @param on_release The callback for the released buffers.
+   * @throws std::system_error if the socket doesn't support zero-copy sends.
+   * @returns A copy of the dialog with a new zero-copy tracker.
+   */
+  [[nodiscard]] auto with_zerocopy(
+      detail::zerocopy_tracker::release_callback on_release = {}) const
+      -> socket_dialog;
   /**
    * @brief Checks if the socket_dialog is valid.
    * @returns `true` if the socket_dialog is valid, `false` otherwise.
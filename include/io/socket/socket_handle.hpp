@@ -20,6 +20,7 @@
 #pragma once
 #ifndef IO_SOCKET_HANDLE_HPP
 #define IO_SOCKET_HANDLE_HPP
+#include "detail/eager_predictor.hpp"
 #include "detail/socket.hpp"
 
 #include <atomic>
@@ -106,6 +107,12 @@ public:
   /** @brief Gets the last socket error. */
   auto get_error() const noexcept -> std::error_code;
 
+  /** @brief Gets the predictor for eager reads and accepts. */
+  auto read_predictor() noexcept -> detail::eager_predictor &;
+
+  /** @brief Gets the predictor for eager writes. */
+  auto write_predictor() noexcept -> detail::eager_predictor &;
+
   /** @brief Closes the managed socket. */
   ~socket_handle();
 
@@ -117,6 +124,10 @@ private:
   std::atomic<native_socket_type> socket_{INVALID_SOCKET};
   /** @brief The last error code on the socket. */
   std::atomic<int> error_;
+  /** @brief The recent outcome of eager reads and accepts. */
+  detail::eager_predictor read_predictor_;
+  /** @brief The recent outcome of eager writes. */
+  detail::eager_predictor write_predictor_;
   /** @brief A mutex for thread-safe access to the handle. */
   mutable mutex mtx_;
 };
@@ -24,8 +24,12 @@
 #include "detail/socket.hpp"
 #include "socket_address.hpp"
 
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <vector>
 namespace io::socket {
 /**
@@ -53,17 +57,29 @@ struct message_header {
  *
  * This class provides a convenient way to handle a collection of buffers
  * that can be used in readv/writev (scatter/gather) style I/O operations.
+ * Consumed buffers are skipped by advancing a head index instead of being
+ * erased, and the number of remaining bytes is cached, so a partial write
+ * costs time proportional to the buffers it consumes and emptiness checks
+ * are constant time. The storage is reused once every buffer is consumed.
+ *
+ * The first `N` buffers are stored inline, so small messages don't allocate.
+ * Adding a buffer beyond that moves all of them to storage obtained from the
+ * allocator, which is kept until the message buffer is destroyed.
+ *
+ * @tparam Allocator The allocator for the buffers that don't fit inline.
+ * @tparam N The number of buffers stored inline.
  */
-template <AllocatorLike Allocator = std::allocator<native_buffer_type>>
+template <AllocatorLike Allocator = std::allocator<native_buffer_type>,
+          std::size_t N = 4>
 class message_buffer {
 public:
-  /** @brief The underlying buffer type. */
+  /** @brief The storage for the buffers that don't fit inline. */
   using buffer_type = std::vector<native_buffer_type, Allocator>;
   /** @brief Iterator for the buffer that returns spans when dereferenced. */
-  using iterator = buffer_iterator<typename buffer_type::iterator>;
+  using iterator = buffer_iterator<native_buffer_type *>;
   /** @brief Constant iterator for the buffer that returns spans when
    * dereferenced. */
-  using const_iterator = buffer_iterator<typename buffer_type::const_iterator>;
+  using const_iterator = buffer_iterator<const native_buffer_type *>;
   /** @brief Size type for the buffer. */
   using size_type = typename buffer_type::size_type;
 
@@ -82,6 +98,31 @@ public:
   template <ScatterGatherLike... Bufs>
   constexpr message_buffer(const Bufs &...bufs) noexcept;
 
+  /** @brief Copy constructor. */
+  message_buffer(const message_buffer &other) = default;
+
+  /**
+   * @brief Move constructor.
+   * @details The moved from message buffer is left empty.
+   * @param other The message buffer to move from.
+   */
+  constexpr message_buffer(message_buffer &&other) noexcept;
+
+  /** @brief Copy assignment. */
+  auto operator=(const message_buffer &other) -> message_buffer & = default;
+
+  /**
+   * @brief Move assignment.
+   * @details The moved from message buffer is left empty.
+   * @param other The message buffer to move from.
+   * @return A reference to this message buffer.
+   */
+  constexpr auto operator=(message_buffer &&other) noexcept
+      -> message_buffer &;
+
+  /** @brief Destructor. */
+  ~message_buffer() = default;
+
   /**
    * @brief Adds a buffer to the collection.
    * @tparam B The type of the buffer, which must satisfy the ScatterGatherLike
@@ -123,9 +164,15 @@ public:
   /** @brief Returns the number of buffers in the collection. */
   [[nodiscard]] constexpr auto size() const noexcept -> size_type;
 
-  /** @brief Checks if the buffer collection is empty. */
+  /** @brief Returns the number of bytes left in the buffers. */
+  [[nodiscard]] constexpr auto bytes() const noexcept -> std::size_t;
+
+  /** @brief Checks if there are no bytes left in the buffers. */
   [[nodiscard]] constexpr auto empty() const noexcept -> bool;
 
+  /** @brief Removes all the buffers and keeps the storage. */
+  constexpr auto clear() noexcept -> void;
+
   /**
    * @brief Checks if the buffer collection is not empty.
    * @return True if not empty, false otherwise.
@@ -143,11 +190,47 @@ public:
    */
   auto operator+=(std::size_t len) noexcept -> message_buffer &;
 
-  /** @brief Returns a reference to the underlying array of native buffers. */
-  constexpr auto native() -> buffer_type & { return buffer_; }
+  /**
+   * @brief Returns the remaining native buffers.
+   * @details The lengths of the buffers must not be changed through the
+   * returned span, since the number of remaining bytes is cached.
+   */
+  constexpr auto native() noexcept -> std::span<native_buffer_type>
+  {
+    return {storage() + head_, size_ - head_};
+  }
 
 private:
-  buffer_type buffer_;
+  /** @brief Returns a pointer to the buffers, inline or not. */
+  constexpr auto storage() noexcept -> native_buffer_type *
+  {
+    return heap_.empty() ? inline_.data() : heap_.data();
+  }
+
+  /** @brief Returns a pointer to the buffers, inline or not. */
+  constexpr auto storage() const noexcept -> const native_buffer_type *
+  {
+    return heap_.empty() ? inline_.data() : heap_.data();
+  }
+
+  /**
+   * @brief Gets the length of a native buffer.
+   * @param buf The native buffer.
+   * @return The length in bytes.
+   */
+  static constexpr auto length(const native_buffer_type &buf) noexcept
+      -> std::size_t;
+
+  /** @brief The buffers while they fit inline. */
+  std::array<native_buffer_type, N> inline_{};
+  /** @brief The buffers once they don't fit inline. */
+  buffer_type heap_;
+  /** @brief The number of buffers, including the consumed ones. */
+  size_type size_ = 0;
+  /** @brief The index of the first buffer that isn't consumed. */
+  size_type head_ = 0;
+  /** @brief The number of bytes left in the buffers. */
+  std::size_t bytes_ = 0;
 };
 
 /**
@@ -190,6 +273,17 @@ struct socket_message {
   [[nodiscard]] explicit operator socket_message_type() noexcept;
 };
 
+namespace pmr {
+/**
+ * @brief A socket message that allocates its buffers and control data from a
+ * `std::pmr::memory_resource`.
+ * @tparam Addr The socket address type.
+ */
+template <SocketAddress Addr = sockaddr_storage_type>
+using socket_message =
+    ::io::socket::socket_message<Addr, std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
+
 } // namespace io::socket
 
 #include "impl/socket_message_impl.hpp" // IWYU pragma: export
@@ -0,0 +1,140 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file stream_reader.hpp
+ * @brief Defines a buffered reader for stream sockets.
+ */
+#pragma once
+#ifndef IO_STREAM_READER_HPP
+#define IO_STREAM_READER_HPP
+#include "detail/socket.hpp"
+#include "io/detail/concepts.hpp"
+#include "socket_dialog.hpp"
+#include "socket_message.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+namespace io::socket {
+/**
+ * @brief Reads a stream socket into a ring buffer that it owns.
+ *
+ * The buffer is allocated once, when the reader is constructed, and its
+ * capacity is rounded up to a power of two so that positions wrap with a
+ * mask. Each read is a single `recvmsg` with up to two I/O vectors, which
+ * cover the free space up to the end of the buffer and the free space that
+ * wraps around to its beginning. The received bytes are exposed in place, as
+ * up to two spans that can be pushed into a `message_buffer`, and they stay in
+ * the buffer until they are consumed.
+ *
+ * The reader must not be moved or destroyed while a read is pending.
+ *
+ * @tparam Mux The multiplexer type.
+ * @tparam Allocator The allocator for the buffer.
+ */
+template <Multiplexer Mux, AllocatorLike Allocator = std::allocator<std::byte>>
+class stream_reader {
+public:
+  /** @brief The socket dialog type. */
+  using dialog_type = socket_dialog<Mux>;
+  /** @brief The size type. */
+  using size_type = std::size_t;
+  /** @brief The readable bytes, in order. The second span may be empty. */
+  using buffers_type = std::array<std::span<std::byte>, 2>;
+
+  /** @brief The default capacity of the buffer. */
+  static constexpr size_type default_capacity = 4096;
+
+  /**
+   * @brief Constructs a reader.
+   * @param dialog The socket to read from.
+   * @param capacity The minimum capacity of the buffer. It is rounded up to a
+   * power of two.
+   * @param alloc The allocator for the buffer.
+   */
+  explicit stream_reader(dialog_type dialog,
+                         size_type capacity = default_capacity,
+                         const Allocator &alloc = Allocator());
+
+  /** @brief Deleted copy constructor. */
+  stream_reader(const stream_reader &) = delete;
+  /** @brief Deleted copy assignment. */
+  auto operator=(const stream_reader &) -> stream_reader & = delete;
+  /** @brief Default move constructor. */
+  stream_reader(stream_reader &&) noexcept = default;
+  /** @brief Default move assignment. */
+  auto operator=(stream_reader &&) noexcept -> stream_reader & = default;
+  /** @brief Default destructor. */
+  ~stream_reader() = default;
+
+  /**
+   * @brief Reads into the free space of the buffer.
+   * @param flags The flags for `recvmsg`.
+   * @throws std::system_error with `ENOBUFS` if the buffer is full.
+   * @return A sender that completes with the number of bytes read, 0 at the
+   * end of the stream.
+   */
+  auto read(int flags = 0) -> decltype(auto);
+
+  /**
+   * @brief Gets the readable bytes without copying them.
+   * @return The readable bytes as up to two spans.
+   */
+  [[nodiscard]] auto data() noexcept -> buffers_type;
+
+  /**
+   * @brief Releases bytes from the front of the readable bytes.
+   * @param len The number of bytes to release. It is clamped to `size()`.
+   */
+  auto consume(size_type len) noexcept -> void;
+
+  /** @brief Gets the number of readable bytes. */
+  [[nodiscard]] auto size() const noexcept -> size_type;
+
+  /** @brief Gets the capacity of the buffer. */
+  [[nodiscard]] auto capacity() const noexcept -> size_type;
+
+  /** @brief Checks if there are no readable bytes. */
+  [[nodiscard]] auto empty() const noexcept -> bool;
+
+  /** @brief Checks if there is no room left to read into. */
+  [[nodiscard]] auto full() const noexcept -> bool;
+
+  /** @brief Gets the socket dialog. */
+  [[nodiscard]] auto dialog() const noexcept -> const dialog_type &;
+
+private:
+  /** @brief The socket to read from. */
+  dialog_type dialog_;
+  /** @brief The ring buffer. */
+  std::vector<std::byte, Allocator> buffer_;
+  /** @brief The total number of bytes consumed. */
+  size_type head_ = 0;
+  /** @brief The total number of bytes read. */
+  size_type tail_ = 0;
+  /** @brief The I/O vectors of the pending read. */
+  std::array<native_buffer_type, 2> iov_{};
+  /** @brief The message of the pending read. */
+  message_header header_;
+};
+
+} // namespace io::socket
+
+#include "impl/stream_reader_impl.hpp" // IWYU pragma: export
+
+#endif // IO_STREAM_READER_HPP
@@ -0,0 +1,266 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace io::socket;
+using namespace io::execution;
+
+TEST(BufferPoolTest, ConstructionTest)
+{
+  auto pool = std::make_shared<buffer_pool>();
+  EXPECT_EQ(pool->buffer_size(), buffer_pool::default_buffer_size);
+  EXPECT_EQ(pool->capacity(), 0);
+
+  // Sizes are rounded up so that every buffer is suitably aligned.
+  auto odd = std::make_shared<buffer_pool>(1, 0);
+  EXPECT_EQ(odd->buffer_size() % alignof(std::max_align_t), 0);
+  EXPECT_GE(odd->buffer_size(), sizeof(void *));
+
+  auto buf = odd->acquire();
+  EXPECT_TRUE(buf);
+  EXPECT_EQ(odd->capacity(), 1);
+}
+
+TEST(BufferPoolTest, AcquireReleaseTest)
+{
+  auto pool = std::make_shared<buffer_pool>(64, 4);
+
+  std::vector<pooled_buffer> buffers;
+  std::set<std::byte *> addresses;
+  for (int i = 0; i < 8; ++i)
+  {
+    auto &buf = buffers.emplace_back(pool->acquire());
+    EXPECT_EQ(buf.capacity(), 64);
+    EXPECT_TRUE(buf.empty());
+    addresses.insert(buf.data());
+  }
+  EXPECT_EQ(addresses.size(), 8);
+  EXPECT_EQ(pool->capacity(), 8);
+
+  // Returned buffers are reused before any new slab is allocated.
+  auto *data = buffers.back().data();
+  buffers.pop_back();
+  buffers.push_back(pool->acquire());
+  EXPECT_EQ(buffers.back().data(), data);
+  EXPECT_EQ(pool->capacity(), 8);
+
+  buffers.clear();
+  for (int i = 0; i < 8; ++i)
+    buffers.push_back(pool->acquire());
+  EXPECT_EQ(pool->capacity(), 8);
+
+  buffers.push_back(pool->acquire());
+  EXPECT_EQ(pool->capacity(), 12);
+}
+
+TEST(BufferPoolTest, PooledBufferTest)
+{
+  auto pool = std::make_shared<buffer_pool>(64, 1);
+
+  pooled_buffer empty;
+  EXPECT_FALSE(empty);
+  EXPECT_EQ(empty.capacity(), 0);
+  empty.resize(10);
+  EXPECT_EQ(empty.size(), 0);
+
+  auto buf = pool->acquire();
+  buf.resize(100);
+  EXPECT_EQ(buf.size(), 64);
+  buf.resize(5);
+  EXPECT_EQ(buf.span().size(), 5);
+
+  auto *data = buf.data();
+  auto moved = std::move(buf);
+  EXPECT_FALSE(buf);
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved.size(), 5);
+
+  moved.reset();
+  EXPECT_FALSE(moved);
+  EXPECT_EQ(pool->acquire().data(), data);
+
+  // The buffer keeps the pool alive.
+  auto last = pool->acquire();
+  pool.reset();
+  EXPECT_EQ(last.capacity(), 64);
+}
+
+TEST(BufferPoolTest, CrossThreadReleaseTest)
+{
+  auto pool = std::make_shared<buffer_pool>(64, 16);
+
+  for (int round = 0; round < 100; ++round)
+  {
+    std::vector<pooled_buffer> buffers;
+    for (int i = 0; i < 16; ++i)
+      buffers.push_back(pool->acquire());
+
+    std::vector<std::thread> threads;
+    for (auto &buf : buffers)
+      threads.emplace_back([buf = std::move(buf)]() mutable { buf.reset(); });
+
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  EXPECT_EQ(pool->capacity(), 16);
+}
+
+TEST(BufferPoolTest, AsyncRecvTest)
+{
+  exec::async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+  auto pool = triggers.get_executor().lock()->buffers();
+
+  std::array<int, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto dialog = triggers.emplace(pair[0]);
+
+  std::optional<pooled_buffer> received;
+  scope.spawn(::io::recv(dialog, 0) |
+              stdexec::then([&](pooled_buffer buf) {
+                received.emplace(std::move(buf));
+              }) |
+              stdexec::upon_error([](auto) {}));
+
+  // No buffer is taken while the socket has nothing to read.
+  triggers.wait_for(0);
+  EXPECT_FALSE(received);
+  EXPECT_EQ(pool->capacity(), 0);
+
+  ASSERT_EQ(::write(pair[1], "hello", 5), 5);
+  while (triggers.wait_for(0));
+
+  ASSERT_TRUE(received);
+  ASSERT_EQ(received->size(), 5);
+  EXPECT_EQ(std::memcmp(received->data(), "hello", 5), 0);
+  EXPECT_EQ(pool->capacity(), buffer_pool::default_slab_size);
+
+  // The end of the stream is an empty buffer.
+  received.reset();
+  ::close(pair[1]);
+  scope.spawn(::io::recv(dialog, 0) |
+              stdexec::then([&](pooled_buffer buf) {
+                received.emplace(std::move(buf));
+              }) |
+              stdexec::upon_error([](auto) {}));
+  while (triggers.wait_for(0));
+
+  ASSERT_TRUE(received);
+  EXPECT_TRUE(received->empty());
+  EXPECT_EQ(pool->capacity(), buffer_pool::default_slab_size);
+}
+TEST(BufferPoolTest, LeaderFollowerRecvTest)
+{
+  static constexpr int pairs = 8;
+  static constexpr int messages = 64;
+  static constexpr int threads = 4;
+
+  exec::async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+  // One buffer per slab, so that concurrent receives also grow the pool.
+  auto pool = std::make_shared<buffer_pool>(64, 1);
+  triggers.get_executor().lock()->set_buffers(pool);
+
+  std::vector<std::array<int, 2>> sockets(pairs);
+  std::vector<socket_dialog<poll_multiplexer>> dialogs;
+  for (auto &pair : sockets)
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    dialogs.push_back(triggers.emplace(pair[0]));
+  }
+
+  std::atomic<int> received = 0;
+  std::atomic<bool> corrupted = false;
+  std::function<void(int)> reader = [&](int i) {
+    scope.spawn(::io::recv(dialogs[i], 0) |
+                stdexec::then([&, i](pooled_buffer buf) {
+                  for (auto byte : buf.span())
+                  {
+                    if (byte != static_cast<std::byte>('a' + i))
+                      corrupted = true;
+                  }
+                  std::this_thread::yield();
+                  if (!buf.empty() &&
+                      (received += static_cast<int>(buf.size())) <
+                          pairs * messages)
+                  {
+                    reader(i);
+                  }
+                }) |
+                stdexec::upon_error([](auto) {}));
+  };
+  for (int i = 0; i < pairs; ++i)
+    reader(i);
+
+  leader_follower<poll_multiplexer> lf{triggers, 4};
+  std::vector<std::thread> runners;
+  for (int i = 0; i < threads; ++i)
+  {
+    runners.emplace_back([&] {
+      auto start = std::chrono::steady_clock::now();
+      while (received < pairs * messages &&
+             std::chrono::steady_clock::now() - start <
+                 std::chrono::seconds(5))
+      {
+        lf.wait_for(10);
+      }
+    });
+  }
+
+  for (int n = 0; n < messages; ++n)
+  {
+    for (int i = 0; i < pairs; ++i)
+    {
+      char byte = static_cast<char>('a' + i);
+      ASSERT_EQ(::write(sockets[i][1], &byte, 1), 1);
+    }
+  }
+
+  for (auto &runner : runners)
+    runner.join();
+  EXPECT_EQ(received, pairs * messages);
+  EXPECT_FALSE(corrupted);
+  // Every buffer was given back, so no more than one per thread was needed.
+  EXPECT_LE(pool->capacity(), threads);
+  std::set<std::byte *> addresses;
+  std::vector<pooled_buffer> buffers;
+  for (std::size_t i = 0; i < pool->capacity(); ++i)
+    addresses.insert(buffers.emplace_back(pool->acquire()).data());
+  EXPECT_EQ(addresses.size(), pool->capacity());
+
+  for (auto &pair : sockets)
+    ::close(pair[1]);
+}
+// NOLINTEND
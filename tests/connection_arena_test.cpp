@@ -0,0 +1,265 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace io::socket;
+using namespace io::execution;
+
+namespace {
+auto contains(const void *block, std::size_t size, const void *ptr) -> bool
+{
+  auto begin = reinterpret_cast<std::uintptr_t>(block);
+  auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+  return addr >= begin && addr < begin + size;
+}
+} // namespace
+
+TEST(ConnectionArenaTest, MakeTest)
+{
+  auto pool = std::make_shared<buffer_pool>(
+      connection_arena::default_block_size, 1);
+
+  auto arena = connection_arena::make(pool);
+  EXPECT_EQ(arena->blocks(), 1);
+  EXPECT_EQ(pool->capacity(), 1);
+
+  auto *ptr = arena->allocate(100);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t),
+            0);
+  EXPECT_TRUE(contains(arena.get(), pool->buffer_size(), ptr));
+
+  // The arena and its first block are given back when it is destroyed.
+  auto *first = static_cast<void *>(arena.get());
+  arena.reset();
+  arena = connection_arena::make(pool);
+  EXPECT_EQ(static_cast<void *>(arena.get()), first);
+  EXPECT_EQ(pool->capacity(), 1);
+
+  // A block that can't hold the arena is rejected.
+  auto small = std::make_shared<buffer_pool>(16, 1);
+  EXPECT_THROW((void)connection_arena::make(small), std::bad_alloc);
+  EXPECT_NO_THROW((void)small->acquire());
+  EXPECT_EQ(small->capacity(), 1);
+}
+
+TEST(ConnectionArenaTest, GrowReleaseTest)
+{
+  auto pool = std::make_shared<buffer_pool>(1024, 4);
+  auto arena = connection_arena::make(pool);
+
+  std::vector<void *> allocations;
+  for (int i = 0; i < 8; ++i)
+    allocations.push_back(arena->allocate(256, 8));
+  EXPECT_GT(arena->blocks(), 1);
+
+  // Only the most recent allocation is reclaimed.
+  auto *last = allocations.back();
+  arena->deallocate(last, 256, 8);
+  EXPECT_EQ(arena->allocate(256, 8), last);
+
+  arena->release();
+  EXPECT_EQ(arena->blocks(), 1);
+  EXPECT_EQ(arena->allocate(256, 8), allocations.front());
+
+  // Allocations that don't fit in a block go to the heap.
+  auto blocks = arena->blocks();
+  auto *big = arena->allocate(4096);
+  EXPECT_FALSE(contains(arena.get(), pool->buffer_size(), big));
+  EXPECT_EQ(arena->blocks(), blocks);
+  arena->deallocate(big, 4096);
+}
+
+TEST(ConnectionArenaTest, AllocatorTest)
+{
+  auto pool = std::make_shared<buffer_pool>(
+      connection_arena::default_block_size, 1);
+  auto arena = connection_arena::make(pool);
+  std::weak_ptr<connection_arena> weak = arena;
+
+  {
+    auto alloc = arena_allocator<int>(std::move(arena));
+    std::vector<int, arena_allocator<int>> values(alloc);
+    values.assign({1, 2, 3});
+    EXPECT_TRUE(contains(weak.lock().get(), pool->buffer_size(),
+                         values.data()));
+
+    auto rebound = arena_allocator<char>(alloc);
+    EXPECT_EQ(rebound, alloc);
+    EXPECT_NE(arena_allocator<char>(), alloc);
+
+    // The allocators keep the arena alive.
+    EXPECT_FALSE(weak.expired());
+  }
+  EXPECT_TRUE(weak.expired());
+
+  // Without an arena, the allocator uses the heap.
+  std::vector<int, arena_allocator<int>> values;
+  values.assign({1, 2, 3});
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_THROW((void)values.get_allocator().allocate(SIZE_MAX),
+               std::bad_array_new_length);
+
+  // Allocator-aware messages can live in an arena.
+  arena = connection_arena::make(pool);
+  auto alloc = arena_allocator<std::byte>(arena);
+  using message_type = socket_message<sockaddr_in, arena_allocator<std::byte>>;
+  auto message = message_type{.buffers{alloc},
+                              .control = message_type::control_type(alloc)};
+  std::array<char, 8> buf{};
+  for (int i = 0; i < 6; ++i)
+    message.buffers.push_back(buf);
+  EXPECT_TRUE(contains(arena.get(), pool->buffer_size(),
+                       message.buffers.native().data()));
+}
+
+TEST(ConnectionArenaTest, AcceptTest)
+{
+  exec::async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+  auto executor = triggers.get_executor().lock();
+  auto pool = std::make_shared<buffer_pool>(
+      connection_arena::default_block_size, 1);
+  executor->set_arena_blocks(pool);
+  EXPECT_EQ(executor->arena_blocks(), pool);
+
+  auto accept_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto connect_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  EXPECT_FALSE(connect_dialog.arena);
+
+  auto address = make_address<sockaddr_in>();
+  address->sin_family = AF_INET;
+  address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(::io::bind(accept_dialog, address), 0);
+  ASSERT_EQ(::io::listen(accept_dialog, 1), 0);
+  auto bound_address = make_address<sockaddr_in>();
+  (void)::io::getsockname(accept_dialog, bound_address);
+
+  auto client_addr = make_address<sockaddr_in>();
+  auto future = scope.spawn_future(
+      stdexec::when_all(::io::accept(accept_dialog, client_addr),
+                        ::io::connect(connect_dialog, bound_address)));
+  while (triggers.wait_for(0));
+
+  auto [accept_result, connect_result] =
+      stdexec::sync_wait(std::move(future)).value();
+  ASSERT_EQ(connect_result, 0);
+  auto dialog = std::move(accept_result.first);
+  ASSERT_TRUE(dialog);
+  ASSERT_TRUE(dialog.arena);
+
+  // The socket handle and the write queue are placed in the arena.
+  auto *block = static_cast<void *>(dialog.arena.get());
+  EXPECT_TRUE(contains(block, pool->buffer_size(), dialog.socket.get()));
+  auto queued = dialog.with_write_queue();
+  EXPECT_EQ(queued.arena, dialog.arena);
+  EXPECT_TRUE(contains(block, pool->buffer_size(), queued.writes.get()));
+  EXPECT_EQ(dialog.get_allocator().arena(), dialog.arena);
+  EXPECT_EQ(pool->capacity(), 1);
+
+  // The arena is given back once the last reference to the socket is gone.
+  std::weak_ptr<connection_arena> weak = dialog.arena;
+  auto socket = dialog.socket;
+  dialog = {};
+  queued = {};
+  EXPECT_FALSE(weak.expired());
+  socket.reset();
+  EXPECT_TRUE(weak.expired());
+  weak.reset();
+  auto buffer = pool->acquire();
+  EXPECT_TRUE(contains(buffer.data(), buffer.capacity(), block));
+  EXPECT_EQ(pool->capacity(), 1);
+}
+TEST(ConnectionArenaTest, SharedPoolTest)
+{
+  static constexpr int threads = 4;
+  static constexpr int rounds = 200;
+  auto pool = std::make_shared<buffer_pool>(1024, 1);
+
+  // Each thread owns its arenas, but all of them share the pool.
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; ++i)
+  {
+    workers.emplace_back([&pool] {
+      for (int round = 0; round < rounds; ++round)
+      {
+        auto arena = connection_arena::make(pool);
+        for (int j = 0; j < 8; ++j)
+          std::memset(arena->allocate(256), 0xff, 256);
+      }
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+
+  // Each arena held at most three blocks, and all of them came back.
+  EXPECT_LE(pool->capacity(), 3 * threads);
+  std::vector<pooled_buffer> buffers;
+  std::set<std::byte *> addresses;
+  for (std::size_t i = 0; i < pool->capacity(); ++i)
+    addresses.insert(buffers.emplace_back(pool->acquire()).data());
+  EXPECT_EQ(addresses.size(), pool->capacity());
+}
+
+TEST(ConnectionArenaTest, ConcurrentAllocateTest)
+{
+  static constexpr int threads = 4;
+  static constexpr int rounds = 200;
+  static constexpr std::size_t size = 64;
+  auto pool = std::make_shared<buffer_pool>(1024, 1);
+  auto arena = connection_arena::make(pool);
+
+  // A connection's objects can be released off its strand, for example by
+  // a stop callback, so every thread allocates from the same arena.
+  std::atomic<bool> overlapped = false;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; ++i)
+  {
+    workers.emplace_back([&, i] {
+      auto mark = static_cast<unsigned char>(i + 1);
+      for (int round = 0; round < rounds; ++round)
+      {
+        auto *ptr = static_cast<unsigned char *>(arena->allocate(size));
+        std::memset(ptr, mark, size);
+        std::this_thread::yield();
+        for (std::size_t j = 0; j < size; ++j)
+        {
+          if (ptr[j] != mark)
+            overlapped = true;
+        }
+        arena->deallocate(ptr, size);
+      }
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+
+  EXPECT_FALSE(overlapped);
+  arena->release();
+  EXPECT_EQ(arena->blocks(), 1);
+}
+// NOLINTEND
@@ -0,0 +1,103 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/execution/detail/eager_budget.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace io::execution::detail;
+
+class EagerBudgetTest : public ::testing::Test {
+protected:
+  std::array<int, 2> sockets{};
+};
+
+TEST_F(EagerBudgetTest, DefaultBudgetTest)
+{
+  eager_budget budget;
+  auto *socket = &sockets[0];
+  auto *other = &sockets[1];
+
+  // Alternate sockets so that only the executor budget applies.
+  for (std::size_t i = 0; i < eager_budget::default_budget; ++i)
+    EXPECT_TRUE(budget.try_acquire((i % 2) ? socket : other));
+
+  EXPECT_FALSE(budget.try_acquire(socket));
+  EXPECT_TRUE(budget.try_acquire(socket));
+
+  auto stats = budget.stats();
+  EXPECT_EQ(stats.eager, eager_budget::default_budget + 1);
+  EXPECT_EQ(stats.budget_fallbacks, 1);
+  EXPECT_EQ(stats.socket_fallbacks, 0);
+}
+
+TEST_F(EagerBudgetTest, EmptyBudgetTest)
+{
+  eager_budget budget{0};
+
+  for (int i = 0; i < 4; ++i)
+    EXPECT_FALSE(budget.try_acquire(&sockets[0]));
+
+  auto stats = budget.stats();
+  EXPECT_EQ(stats.eager, 0);
+  EXPECT_EQ(stats.budget_fallbacks, 4);
+}
+
+TEST_F(EagerBudgetTest, SocketLimitTest)
+{
+  eager_budget budget{100, 3};
+  auto *socket = &sockets[0];
+  auto *other = &sockets[1];
+
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(budget.try_acquire(socket));
+
+  // The hot socket falls back, but other sockets are unaffected.
+  EXPECT_TRUE(budget.try_acquire(other));
+  EXPECT_TRUE(budget.try_acquire(socket));
+
+  for (int i = 0; i < 2; ++i)
+    EXPECT_TRUE(budget.try_acquire(socket));
+
+  EXPECT_FALSE(budget.try_acquire(socket));
+  EXPECT_TRUE(budget.try_acquire(socket));
+
+  auto stats = budget.stats();
+  EXPECT_EQ(stats.eager, 8);
+  EXPECT_EQ(stats.budget_fallbacks, 0);
+  EXPECT_EQ(stats.socket_fallbacks, 1);
+}
+
+TEST_F(EagerBudgetTest, SetLimitsTest)
+{
+  eager_budget budget{1};
+  auto *socket = &sockets[0];
+
+  EXPECT_TRUE(budget.try_acquire(socket));
+  budget.set_limits(2);
+  EXPECT_TRUE(budget.try_acquire(socket));
+  EXPECT_TRUE(budget.try_acquire(socket));
+  EXPECT_FALSE(budget.try_acquire(socket));
+
+  budget.set_limits(0);
+  EXPECT_FALSE(budget.try_acquire(socket));
+
+  auto stats = budget.stats();
+  EXPECT_EQ(stats.eager, 3);
+  EXPECT_EQ(stats.budget_fallbacks, 2);
+}
+// NOLINTEND
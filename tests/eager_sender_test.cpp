@@ -0,0 +1,125 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/execution/detail/eager_sender.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <system_error>
+#include <vector>
+
+using namespace io::execution::detail;
+
+struct chain;
+
+struct chain_receiver {
+  using receiver_concept = stdexec::receiver_t;
+
+  struct env {};
+
+  auto set_value(int value) && noexcept -> void;
+  auto set_error(std::error_code error) && noexcept -> void;
+  auto set_stopped() && noexcept -> void {}
+  auto get_env() const noexcept -> env { return {}; }
+
+  chain *self;
+};
+
+using sender_type = eager_sender<int, decltype(stdexec::just(0))>;
+using state_type = sender_type::state<chain_receiver>;
+
+// Starts the next operation from the completion of the previous one, like a
+// reader loop on a socket that always has data.
+struct chain {
+  auto next() -> void
+  {
+    if (started == length)
+      return;
+
+    auto value = started++;
+    auto &op = ops.emplace_back(sender_type(value), chain_receiver{this});
+    op.start();
+  }
+
+  int length = 0;
+  int started = 0;
+  std::size_t depth = 0;
+  std::size_t max_depth = 0;
+  std::vector<int> values;
+  std::error_code error;
+  std::list<state_type> ops;
+};
+
+auto chain_receiver::set_value(int value) && noexcept -> void
+{
+  self->values.push_back(value);
+  self->max_depth = std::max(self->max_depth, ++self->depth);
+  self->next();
+  --self->depth;
+}
+
+auto chain_receiver::set_error(std::error_code error) && noexcept -> void
+{
+  self->error = error;
+}
+
+TEST(EagerSenderTest, ValueTest)
+{
+  chain loop{.length = 1};
+  loop.next();
+
+  EXPECT_EQ(loop.values, std::vector<int>{0});
+  EXPECT_FALSE(loop.error);
+}
+
+TEST(EagerSenderTest, ErrorTest)
+{
+  chain loop;
+  auto error = std::make_error_code(std::errc::connection_reset);
+  state_type op{sender_type(error), chain_receiver{&loop}};
+  op.start();
+
+  EXPECT_TRUE(loop.values.empty());
+  EXPECT_EQ(loop.error, error);
+}
+
+TEST(EagerSenderTest, LazyTest)
+{
+  chain loop;
+  state_type op{sender_type(stdexec::just(42)), chain_receiver{&loop}};
+  op.start();
+
+  EXPECT_EQ(loop.values, std::vector<int>{42});
+  EXPECT_FALSE(loop.error);
+}
+
+TEST(EagerSenderTest, TrampolineTest)
+{
+  chain loop{.length = 10000};
+  loop.next();
+
+  // Every completion ran, in order, without nesting deeper than the
+  // trampoline allows.
+  ASSERT_EQ(loop.values.size(), 10000);
+  EXPECT_TRUE(std::ranges::is_sorted(loop.values));
+  EXPECT_EQ(loop.values.back(), 9999);
+  EXPECT_EQ(loop.max_depth, trampoline::max_depth);
+  EXPECT_EQ(loop.depth, 0);
+}
+// NOLINTEND
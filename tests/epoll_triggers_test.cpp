@@ -0,0 +1,149 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace io::execution;
+
+class EpollTriggersTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epfd, 0);
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()), 0);
+  }
+
+  void TearDown() override
+  {
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+    ::close(epfd);
+  }
+
+  int epfd = -1;
+  std::array<int, 2> sockets{};
+  basic_triggers<epoll_multiplexer> triggers;
+};
+
+TEST_F(EpollTriggersTest, EpollErrorHandlingTest)
+{
+  handle_epoll_error({EINTR, std::system_category()});
+  EXPECT_THROW(handle_epoll_error({EBADF, std::system_category()}),
+               std::system_error);
+}
+
+TEST_F(EpollTriggersTest, MakeEpollEventsTest)
+{
+  using enum execution_trigger;
+  EXPECT_EQ(make_epoll_events(READ), EPOLLIN);
+  EXPECT_EQ(make_epoll_events(WRITE), EPOLLOUT);
+  EXPECT_EQ(make_epoll_events(EAGER), 0);
+}
+
+TEST_F(EpollTriggersTest, EpollCtlTest)
+{
+  std::array<epoll_event, 2> events{};
+
+  // A stale registered interest set is re-added.
+  EXPECT_EQ(epoll_ctl_(epfd, sockets[1], EPOLLIN, EPOLLOUT), 0);
+  ASSERT_EQ(epoll_wait_(epfd, events, 0), 1);
+  EXPECT_EQ(events[0].data.fd, sockets[1]);
+  EXPECT_EQ(events[0].events, EPOLLOUT);
+
+  // A stale unregistered interest set is modified.
+  EXPECT_EQ(epoll_ctl_(epfd, sockets[1], 0, EPOLLIN), 0);
+  EXPECT_EQ(epoll_wait_(epfd, events, 0), 0);
+
+  EXPECT_EQ(epoll_ctl_(epfd, sockets[1], EPOLLIN, 0), 0);
+  EXPECT_EQ(epoll_ctl_(epfd, sockets[1], EPOLLIN, 0), 0);
+  EXPECT_EQ(epoll_ctl_(epfd, -1, EPOLLIN, 0), 0);
+
+  EXPECT_EQ(epoll_ctl_(epfd, -1, 0, EPOLLIN), EBADF);
+  EXPECT_EQ(epoll_ctl_(-1, sockets[1], 0, EPOLLIN), EBADF);
+}
+
+TEST_F(EpollTriggersTest, EpollWaitTest)
+{
+  std::array<epoll_event, 1> events{};
+  EXPECT_EQ(epoll_wait_(epfd, events, 0), 0);
+  EXPECT_THROW(epoll_wait_(-1, events, 0), std::system_error);
+}
+
+TEST_F(EpollTriggersTest, PersistentInterestTest)
+{
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<char, 1> buf{};
+  int reads = 0;
+
+  auto read_socket = std::make_shared<socket_handle>(::dup(sockets[0]));
+  auto read = [&] {
+    return triggers.set(read_socket, trigger::READ, [&] {
+      ++reads;
+      return std::optional(::read(sockets[0], buf.data(), buf.size()));
+    });
+  };
+
+  // The second read is registered before the first one is handled, so the
+  // interest set is retained across waits.
+  auto resubmit = [&](auto) {
+    scope.spawn(read() | stdexec::then([](auto) {}));
+  };
+  scope.spawn(read() | stdexec::then(resubmit));
+  ASSERT_EQ(::write(sockets[1], "ab", 2), 2);
+  EXPECT_EQ(triggers.wait_for(0), 1);
+  EXPECT_EQ(triggers.wait_for(0), 1);
+  EXPECT_EQ(reads, 2);
+
+  // All interest is dropped once there are no pending operations.
+  EXPECT_EQ(triggers.wait_for(-1), 0);
+}
+
+TEST_F(EpollTriggersTest, ReusedDescriptorTest)
+{
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<char, 1> buf{};
+
+  for (int i = 0; i < 2; ++i)
+  {
+    auto read_socket = std::make_shared<socket_handle>(::dup(sockets[0]));
+    scope.spawn(triggers.set(read_socket, trigger::READ, [&] {
+      return std::optional(::read(sockets[0], buf.data(), buf.size()));
+    }) | stdexec::then([](auto) {}));
+    read_socket.reset();
+
+    ASSERT_EQ(::write(sockets[1], "a", 1), 1);
+    EXPECT_EQ(triggers.wait_for(0), 1);
+    EXPECT_EQ(buf[0], 'a');
+    buf[0] = 0;
+  }
+}
+// NOLINTEND
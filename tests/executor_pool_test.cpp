@@ -0,0 +1,172 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace io::execution;
+
+template <typename Mux> class ExecutorPoolTest : public ::testing::Test {
+protected:
+  using socket_dialog = ::io::socket::socket_dialog<Mux>;
+
+  static auto loopback() -> ::io::socket::socket_address<sockaddr_in>
+  {
+    auto address = ::io::socket::make_address<sockaddr_in>();
+    address->sin_family = AF_INET;
+    address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address->sin_port = 0;
+    return address;
+  }
+
+  static auto port(const socket_dialog &dialog) -> int
+  {
+    auto address = ::io::socket::make_address<sockaddr_in>();
+    ::io::getsockname(dialog, address);
+    return ntohs(address->sin_port);
+  }
+};
+
+using Multiplexers =
+    ::testing::Types<poll_multiplexer, epoll_multiplexer, io_uring_multiplexer>;
+TYPED_TEST_SUITE(ExecutorPoolTest, Multiplexers);
+
+TYPED_TEST(ExecutorPoolTest, SizeTest)
+{
+  executor_pool<TypeParam> pool{3};
+  EXPECT_EQ(pool.size(), 3);
+
+  executor_pool<TypeParam> empty{0};
+  EXPECT_EQ(empty.size(), 1);
+
+  executor_pool<TypeParam> hardware;
+  EXPECT_GE(hardware.size(), 1);
+}
+
+TYPED_TEST(ExecutorPoolTest, StopBeforeRunTest)
+{
+  executor_pool<TypeParam> pool{2};
+  pool.stop();
+
+  auto runner = std::async(std::launch::async, [&] { pool.run(); });
+  ASSERT_EQ(runner.wait_for(std::chrono::seconds(2)),
+            std::future_status::ready);
+  runner.get();
+  for (std::size_t i = 0; i < pool.size(); ++i)
+    EXPECT_EQ(pool.pin_error(i), 0);
+
+  // The pool can be run again after it has stopped.
+  auto again = std::async(std::launch::async, [&] { pool.run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(again.wait_for(std::chrono::seconds(0)),
+            std::future_status::timeout);
+  pool.stop();
+  ASSERT_EQ(again.wait_for(std::chrono::seconds(2)),
+            std::future_status::ready);
+  again.get();
+}
+
+TYPED_TEST(ExecutorPoolTest, MakeListenersTest)
+{
+  executor_pool<TypeParam> pool{3};
+  auto listeners = pool.make_listeners(this->loopback());
+  ASSERT_EQ(listeners.size(), 3);
+
+  auto first = this->port(listeners.front());
+  EXPECT_NE(first, 0);
+  for (std::size_t i = 0; i < listeners.size(); ++i)
+  {
+    EXPECT_EQ(this->port(listeners[i]), first);
+    EXPECT_EQ(listeners[i].executor.lock(), pool[i].get_executor().lock());
+  }
+}
+
+TYPED_TEST(ExecutorPoolTest, AcceptTest)
+{
+  using socket_dialog = typename TestFixture::socket_dialog;
+  using async_scope = exec::async_scope;
+  static constexpr int clients = 8;
+
+  executor_pool<TypeParam> pool{2};
+  auto listeners = pool.make_listeners(this->loopback());
+  auto address = ::io::socket::make_address<sockaddr_in>();
+  ::io::getsockname(listeners.front(), address);
+
+  async_scope scope;
+  std::atomic<int> accepted = 0;
+  std::atomic<int> pending = 0;
+  std::function<void(const socket_dialog &)> acceptor =
+      [&](const socket_dialog &server) {
+        ++pending;
+        scope.spawn(::io::accept(server) | stdexec::then([&, server](auto) {
+                      if (++accepted == clients)
+                        pool.stop();
+                      else if (accepted < clients)
+                        acceptor(server);
+                      --pending;
+                    }) |
+                    stdexec::upon_error([&](auto) { --pending; }));
+      };
+  for (const auto &listener : listeners)
+    acceptor(listener);
+
+  auto runner = std::async(std::launch::async, [&] { pool.run(); });
+
+  std::vector<::io::socket::socket_handle> connections;
+  for (int i = 0; i < clients; ++i)
+  {
+    auto &client = connections.emplace_back(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(::io::connect(client, address), 0);
+  }
+
+  auto status = runner.wait_for(std::chrono::seconds(5));
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status != std::future_status::ready)
+    pool.stop();
+  runner.get();
+  EXPECT_EQ(accepted, clients);
+
+  // Complete the accepts that are still pending.
+  for (const auto &listener : listeners)
+    ::shutdown(static_cast<int>(listener), SHUT_RDWR);
+  for (int i = 0; i < 100 && pending; ++i)
+  {
+    for (std::size_t j = 0; j < pool.size(); ++j)
+      pool[j].wait_for(10);
+  }
+  EXPECT_EQ(pending, 0);
+}
+
+TEST(PinThreadTest, PinThread)
+{
+  std::promise<void> done;
+  std::thread thread([future = done.get_future()] { future.wait(); });
+  EXPECT_EQ(pin_thread(thread, 0), 0);
+  EXPECT_EQ(pin_thread(thread, 1000), 0);
+  done.set_value();
+  thread.join();
+}
+// NOLINTEND
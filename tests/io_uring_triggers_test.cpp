@@ -0,0 +1,204 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <cstring>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace io::socket;
+using namespace io::execution;
+
+class IoUringTriggersTest : public ::testing::Test {
+protected:
+  template <typename Fn> auto run_until(Fn &&done) -> void
+  {
+    for (int i = 0; i < 100 && !done(); ++i)
+      triggers.wait_for(10);
+  }
+
+  basic_triggers<io_uring_multiplexer> triggers;
+};
+
+TEST_F(IoUringTriggersTest, UringTest)
+{
+  io::execution::detail::uring ring{4};
+
+  int count = 0;
+  while (auto *sqe = ring.get_sqe())
+  {
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = ++count;
+  }
+  ASSERT_EQ(count, 4);
+  EXPECT_EQ(ring.flush(), 4);
+  EXPECT_EQ(ring.enter(4, 0), 4);
+  EXPECT_EQ(ring.enter(0, 10), 0);
+
+  int sum = 0;
+  EXPECT_EQ(ring.for_each_cqe([&](const io_uring_cqe &cqe) {
+    sum += static_cast<int>(cqe.user_data);
+  }),
+            4);
+  EXPECT_EQ(sum, 10);
+  EXPECT_EQ(ring.flush(), 0);
+  EXPECT_EQ(ring.enter(0, 0), 0);
+}
+
+TEST_F(IoUringTriggersTest, UringErrorHandlingTest)
+{
+  handle_uring_error({EINTR, std::system_category()});
+  EXPECT_THROW(handle_uring_error({EBADF, std::system_category()}),
+               std::system_error);
+}
+
+TEST_F(IoUringTriggersTest, ConnectAcceptOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  auto accept_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto connect_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto address = make_address<sockaddr_in>();
+  address->sin_family = AF_INET;
+  address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address->sin_port = 0;
+
+  ASSERT_EQ(::io::bind(accept_dialog, address), 0);
+  ASSERT_EQ(::io::listen(accept_dialog, 1), 0);
+
+  auto bound_address = make_address<sockaddr_in>();
+  ::io::getsockname(accept_dialog, bound_address);
+
+  auto client_addr = make_address<sockaddr_in>();
+  std::optional<int> connected;
+  socket_dialog<io_uring_multiplexer> accepted;
+  scope.spawn(::io::connect(connect_dialog, bound_address) |
+              stdexec::then([&](int status) { connected = status; }) |
+              stdexec::upon_error([](auto) {}));
+  scope.spawn(::io::accept(accept_dialog, client_addr) |
+              stdexec::then([&](auto result) {
+                accepted = std::move(result.first);
+              }) |
+              stdexec::upon_error([](auto) {}));
+
+  run_until([&] { return connected && accepted; });
+
+  EXPECT_EQ(connected, 0);
+  ASSERT_TRUE(accepted);
+
+  auto peer_address = make_address<sockaddr_in>();
+  ::io::getsockname(connect_dialog, peer_address);
+  EXPECT_EQ(peer_address, client_addr);
+  EXPECT_TRUE(::io::fcntl(accepted, F_GETFL) & O_NONBLOCK);
+}
+
+TEST_F(IoUringTriggersTest, ConnectErrorOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  auto listen_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto connect_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto address = make_address<sockaddr_in>();
+  address->sin_family = AF_INET;
+  address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address->sin_port = 0;
+
+  // Bind without listening to reserve a port that refuses connections.
+  ASSERT_EQ(::io::bind(listen_dialog, address), 0);
+  auto bound_address = make_address<sockaddr_in>();
+  ::io::getsockname(listen_dialog, bound_address);
+
+  std::error_code error;
+  scope.spawn(::io::connect(connect_dialog, bound_address) |
+              stdexec::then([](int) {}) |
+              stdexec::upon_error([&](auto err) {
+                if constexpr (std::is_same_v<decltype(err), std::error_code>)
+                  error = err;
+              }));
+
+  run_until([&] { return static_cast<bool>(error); });
+  EXPECT_EQ(error, std::errc::connection_refused);
+}
+
+TEST_F(IoUringTriggersTest, SendmsgRecvmsgOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  const char *message = "Hello, World!";
+  void *send_buf = reinterpret_cast<void *>(const_cast<char *>(message));
+  std::array<char, 14> recv_buf{};
+  socket_message send_msg;
+  send_msg.buffers.emplace_back(send_buf, ::strnlen(message, 14));
+  socket_message recv_msg;
+  recv_msg.buffers.emplace_back(recv_buf.data(), recv_buf.size());
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+
+  auto send_dialog = triggers.emplace(pair[0]);
+  auto recv_dialog = triggers.emplace(pair[1]);
+
+  std::streamsize send_len = -1;
+  std::streamsize recv_len = -1;
+  scope.spawn(::io::recvmsg(recv_dialog, recv_msg, 0) |
+              stdexec::then([&](auto len) { recv_len = len; }) |
+              stdexec::upon_error([](auto) {}));
+  scope.spawn(::io::sendmsg(send_dialog, send_msg, 0) |
+              stdexec::then([&](auto len) { send_len = len; }) |
+              stdexec::upon_error([](auto) {}));
+
+  run_until([&] { return send_len > -1 && recv_len > -1; });
+
+  EXPECT_EQ(send_len, 13);
+  EXPECT_EQ(recv_len, send_len);
+  EXPECT_EQ(::strncmp(message, recv_buf.data(), 14), 0);
+  EXPECT_EQ(recv_msg.flags, 0);
+}
+
+TEST_F(IoUringTriggersTest, SendmsgErrorOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<char, 1> buf{};
+  socket_message msg;
+  msg.buffers.emplace_back(buf.data(), buf.size());
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+
+  auto send_dialog = triggers.emplace(pair[0]);
+  ::close(pair[1]);
+
+  std::error_code error;
+  scope.spawn(::io::sendmsg(send_dialog, msg, 0) | stdexec::then([](auto) {}) |
+              stdexec::upon_error([&](auto err) {
+                if constexpr (std::is_same_v<decltype(err), std::error_code>)
+                  error = err;
+              }));
+
+  run_until([&] { return static_cast<bool>(error); });
+  EXPECT_EQ(error, std::errc::broken_pipe);
+}
+// NOLINTEND
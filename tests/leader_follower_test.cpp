@@ -0,0 +1,171 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace io::execution;
+
+template <typename Mux> class LeaderFollowerTest : public ::testing::Test {
+protected:
+  basic_triggers<Mux> triggers;
+};
+
+using Multiplexers =
+    ::testing::Types<poll_multiplexer, epoll_multiplexer, io_uring_multiplexer>;
+TYPED_TEST_SUITE(LeaderFollowerTest, Multiplexers);
+
+TYPED_TEST(LeaderFollowerTest, NothingToWaitForTest)
+{
+  leader_follower<TypeParam> lf{this->triggers};
+  EXPECT_EQ(lf.wait_for(0), 0);
+  EXPECT_EQ(lf.wait(), 0);
+}
+
+TYPED_TEST(LeaderFollowerTest, FollowerTimeoutTest)
+{
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<int, 2> sockets{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()), 0);
+
+  std::atomic<bool> idle_done = false;
+  auto idle = std::make_shared<socket_handle>(sockets[0]);
+  scope.spawn(triggers.set(idle, trigger::READ,
+                           [] { return std::optional(0); }) |
+              stdexec::then([&](int) { idle_done = true; }) |
+              stdexec::upon_error([](auto) {}));
+
+  leader_follower<TypeParam> lf{triggers};
+  // io_uring cancels requests when the thread that submitted them exits.
+  lf.wait_for(0);
+
+  auto leader = std::async(std::launch::async, [&] {
+    while (!idle_done)
+      lf.wait();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // The leader is blocked, so this thread follows until it times out.
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(lf.wait_for(20), 0);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(15));
+
+  ::write(sockets[1], "a", 1);
+  auto status = leader.wait_for(std::chrono::seconds(2));
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status != std::future_status::ready)
+    triggers.notify();
+  leader.get();
+  EXPECT_TRUE(idle_done);
+}
+
+TYPED_TEST(LeaderFollowerTest, ThreadsTest)
+{
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+  static constexpr int pairs = 8;
+  static constexpr int readers = 2;
+  static constexpr int messages = 64;
+  static constexpr int threads = 4;
+
+  async_scope scope;
+  std::vector<std::array<int, 2>> sockets(pairs);
+  std::vector<std::shared_ptr<socket_handle>> handles;
+  for (auto &pair : sockets)
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    handles.push_back(std::make_shared<socket_handle>(pair[0]));
+  }
+
+  std::array<std::atomic<int>, pairs> busy{};
+  std::array<std::atomic<int>, pairs> counts{};
+  std::atomic<bool> overlapped = false;
+  std::atomic<int> received = 0;
+  std::function<void(int)> reader = [&](int i) {
+    auto fd = sockets[i][0];
+    scope.spawn(triggers.set(handles[i], trigger::READ,
+                             [fd]() -> std::optional<int> {
+                               char byte = 0;
+                               auto len = ::recv(fd, &byte, 1, MSG_DONTWAIT);
+                               if (len < 0 && errno == EAGAIN)
+                                 return std::nullopt;
+                               return static_cast<int>(len);
+                             }) |
+                stdexec::then([&, i](int len) {
+                  if (busy[i]++)
+                    overlapped = true;
+                  std::this_thread::yield();
+                  --busy[i];
+                  ++received;
+                  if (len == 1 && ++counts[i] <= messages - readers)
+                    reader(i);
+                }) |
+                stdexec::upon_error([](auto) {}));
+  };
+  for (int i = 0; i < pairs; ++i)
+  {
+    for (int j = 0; j < readers; ++j)
+      reader(i);
+  }
+
+  leader_follower<TypeParam> lf{triggers, 4};
+  std::vector<std::future<void>> runners;
+  for (int i = 0; i < threads; ++i)
+  {
+    runners.push_back(std::async(std::launch::async, [&] {
+      auto start = std::chrono::steady_clock::now();
+      while (received < pairs * messages &&
+             std::chrono::steady_clock::now() - start <
+                 std::chrono::seconds(5))
+      {
+        lf.wait_for(10);
+      }
+    }));
+  }
+
+  for (int n = 0; n < messages; ++n)
+  {
+    for (auto &pair : sockets)
+      ASSERT_EQ(::write(pair[1], "a", 1), 1);
+  }
+
+  for (auto &runner : runners)
+    runner.get();
+  EXPECT_EQ(received, pairs * messages);
+  EXPECT_FALSE(overlapped);
+}
+// NOLINTEND
@@ -0,0 +1,198 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace io::socket;
+using namespace io::execution;
+
+class MessageBatchTest : public ::testing::Test {
+protected:
+  static constexpr std::size_t batch_size = 4;
+
+  void SetUp() override
+  {
+    for (std::size_t i = 0; i < batch_size; ++i)
+    {
+      send_bufs[i].fill(static_cast<std::byte>('a' + i));
+      send_batch.push_back(send_bufs[i]);
+      recv_batch.push_back(recv_bufs[i]);
+    }
+  }
+
+  std::array<std::array<std::byte, 8>, batch_size> send_bufs{};
+  std::array<std::array<std::byte, 16>, batch_size> recv_bufs{};
+  message_batch<> send_batch;
+  message_batch<> recv_batch;
+};
+
+TEST_F(MessageBatchTest, ConstructionTest)
+{
+  message_batch<> batch;
+  EXPECT_TRUE(batch.empty());
+
+  batch.reserve(batch_size);
+  batch.push_back(recv_bufs[0]);
+  EXPECT_EQ(batch.size(), 1);
+  EXPECT_EQ(batch.buffer(0).data(), recv_bufs[0].data());
+  EXPECT_EQ(batch.buffer(0).size(), recv_bufs[0].size());
+  EXPECT_TRUE(batch.address(0).empty());
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(MessageBatchTest, EmptyAddressTest)
+{
+  message_batch<> batch;
+  batch.push_back(send_bufs[0]);
+  batch.push_back(send_bufs[1], std::span<const std::byte>{});
+  ASSERT_EQ(batch.size(), 2);
+
+  auto msgvec = batch.prepare_send();
+  for (std::size_t i = 0; i < batch.size(); ++i)
+  {
+    EXPECT_TRUE(batch.address(i).empty());
+    EXPECT_EQ(msgvec[i].msg_hdr.msg_name, nullptr);
+    EXPECT_EQ(msgvec[i].msg_hdr.msg_namelen, 0);
+    EXPECT_EQ(batch.buffer(i).data(), send_bufs[i].data());
+  }
+}
+
+TEST_F(MessageBatchTest, PrepareSendTest)
+{
+  auto address = make_address<sockaddr_in>();
+  address->sin_family = AF_INET;
+  send_batch.push_back(send_bufs[0], address);
+
+  auto msgvec = send_batch.prepare_send();
+  ASSERT_EQ(msgvec.size(), batch_size + 1);
+  EXPECT_EQ(msgvec[0].msg_hdr.msg_name, nullptr);
+  EXPECT_EQ(msgvec[0].msg_hdr.msg_iovlen, 1);
+  EXPECT_NE(msgvec[batch_size].msg_hdr.msg_name, nullptr);
+  EXPECT_EQ(msgvec[batch_size].msg_hdr.msg_namelen, sizeof(sockaddr_in));
+  EXPECT_EQ(send_batch.address(batch_size).size(), sizeof(sockaddr_in));
+}
+
+TEST_F(MessageBatchTest, SyncSendRecvTest)
+{
+  std::array<int, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, pair.data()), 0);
+  socket_handle sender{pair[0]};
+  socket_handle receiver{pair[1]};
+
+  EXPECT_EQ(::io::sendmmsg(sender, send_batch, 0), batch_size);
+  EXPECT_EQ(::io::recvmmsg(receiver, recv_batch, 0), batch_size);
+
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    EXPECT_EQ(send_batch.data(i).size(), send_bufs[i].size());
+    auto data = recv_batch.data(i);
+    ASSERT_EQ(data.size(), send_bufs[i].size());
+    EXPECT_EQ(std::memcmp(data.data(), send_bufs[i].data(), data.size()), 0);
+  }
+}
+
+TEST_F(MessageBatchTest, SyncRecvErrorTest)
+{
+  std::array<int, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, pair.data()), 0);
+  socket_handle sender{pair[0]};
+  socket_handle receiver{pair[1]};
+
+  EXPECT_EQ(::io::recvmmsg(receiver, recv_batch, MSG_DONTWAIT), -1);
+  EXPECT_EQ(errno, EAGAIN);
+}
+
+TEST_F(MessageBatchTest, UdpAddressTest)
+{
+  socket_handle sender{AF_INET, SOCK_DGRAM, IPPROTO_UDP};
+  socket_handle receiver{AF_INET, SOCK_DGRAM, IPPROTO_UDP};
+
+  auto address = make_address<sockaddr_in>();
+  address->sin_family = AF_INET;
+  address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(::io::bind(receiver, address), 0);
+  ASSERT_EQ(::io::bind(sender, address), 0);
+
+  auto receiver_address = make_address<sockaddr_in>();
+  ::io::getsockname(receiver, receiver_address);
+  auto sender_address = make_address<sockaddr_in>();
+  ::io::getsockname(sender, sender_address);
+
+  message_batch<> batch;
+  for (auto &buf : send_bufs)
+    batch.push_back(buf, receiver_address);
+
+  ASSERT_EQ(::io::sendmmsg(sender, batch, 0), batch_size);
+  ASSERT_EQ(::io::recvmmsg(receiver, recv_batch, 0), batch_size);
+
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    auto from = recv_batch.address(i);
+    ASSERT_EQ(from.size(), sizeof(sockaddr_in));
+    EXPECT_EQ(std::memcmp(from.data(), sender_address.begin(), from.size()),
+              0);
+  }
+}
+
+template <typename Mux> class AsyncMessageBatchTest : public MessageBatchTest {
+protected:
+  basic_triggers<Mux> triggers;
+};
+
+using Multiplexers = ::testing::Types<poll_multiplexer
+#if OS_LINUX
+                                      ,
+                                      epoll_multiplexer
+#endif
+                                      >;
+TYPED_TEST_SUITE(AsyncMessageBatchTest, Multiplexers);
+
+TYPED_TEST(AsyncMessageBatchTest, AsyncSendRecvTest)
+{
+  using async_scope = exec::async_scope;
+  async_scope scope;
+
+  std::array<int, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, pair.data()), 0);
+  auto sender = this->triggers.emplace(pair[0]);
+  auto receiver = this->triggers.emplace(pair[1]);
+
+  // Start the receive first so that it waits on the multiplexer.
+  auto recv = scope.spawn_future(::io::recvmmsg(receiver, this->recv_batch, 0));
+  auto send = scope.spawn_future(::io::sendmmsg(sender, this->send_batch, 0));
+  while (this->triggers.wait_for(0));
+
+  auto [sent, received] =
+      stdexec::sync_wait(stdexec::when_all(std::move(send), std::move(recv)))
+          .value();
+  EXPECT_EQ(sent, this->batch_size);
+  EXPECT_EQ(received, this->batch_size);
+  EXPECT_EQ(this->recv_batch.data(3).size(), this->send_bufs[3].size());
+}
+// NOLINTEND
@@ -0,0 +1,332 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace io::socket;
+using namespace io::execution;
+
+class MessageOperationTest : public ::testing::Test {
+protected:
+  using handler_type = std::function<void(std::error_code, std::size_t)>;
+  using recv_type =
+      recv_operation<poll_multiplexer, socket_message<>, handler_type>;
+  using send_type =
+      send_operation<poll_multiplexer, socket_message<>, handler_type>;
+
+  void SetUp() override
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    dialog = triggers.emplace(pair[0]);
+  }
+
+  void TearDown() override { ::close(pair[1]); }
+
+  basic_triggers<poll_multiplexer> triggers;
+  std::array<int, 2> pair{};
+  socket_dialog<poll_multiplexer> dialog;
+};
+
+TEST_F(MessageOperationTest, RecvLoopTest)
+{
+  std::array<char, 4> buf{};
+  socket_message<> msg{.buffers = {buf}};
+  std::string received;
+  int completions = 0;
+
+  recv_type op{dialog, msg, 0, [&](std::error_code error, std::size_t len) {
+                 ASSERT_FALSE(error);
+                 ++completions;
+                 received.append(buf.data(), len);
+                 if (received.size() < 12)
+                 {
+                   EXPECT_TRUE(op.start());
+                 }
+               }};
+  EXPECT_FALSE(op.armed());
+  EXPECT_EQ(op.dialog(), dialog);
+
+  ASSERT_TRUE(op.start());
+  EXPECT_TRUE(op.armed());
+
+  for (const auto *chunk : {"abcd", "efgh", "ijkl"})
+  {
+    ASSERT_EQ(::write(pair[1], chunk, 4), 4);
+    while (triggers.wait_for(0));
+  }
+
+  EXPECT_FALSE(op.armed());
+  EXPECT_EQ(completions, 3);
+  EXPECT_EQ(received, "abcdefghijkl");
+}
+
+TEST_F(MessageOperationTest, SendLoopTest)
+{
+  std::string data = "hello, world";
+  socket_message<> msg{.buffers = {std::span(data)}};
+  std::size_t sent = 0;
+
+  send_type op{dialog, msg, 0, [&](std::error_code error, std::size_t len) {
+                 ASSERT_FALSE(error);
+                 sent += len;
+                 msg.buffers += len;
+                 if (!msg.buffers.empty())
+                   op.start();
+               }};
+
+  ASSERT_TRUE(op.start());
+  while (triggers.wait_for(0));
+  EXPECT_EQ(sent, data.size());
+
+  std::array<char, 32> buf{};
+  ASSERT_EQ(::read(pair[1], buf.data(), buf.size()), 12);
+  EXPECT_EQ(std::string(buf.data(), 12), data);
+
+  // The same operation sends the message again once it is replaced.
+  msg.buffers = {std::span(data).first(5)};
+  ASSERT_TRUE(op.start());
+  while (triggers.wait_for(0));
+  EXPECT_EQ(sent, data.size() + 5);
+  ASSERT_EQ(::read(pair[1], buf.data(), buf.size()), 5);
+}
+
+TEST_F(MessageOperationTest, CancelTest)
+{
+  std::array<char, 4> buf{};
+  socket_message<> msg{.buffers = {buf}};
+  std::error_code result;
+  int completions = 0;
+
+  recv_operation op{dialog, msg, 0,
+                    [&](std::error_code error, std::size_t) {
+                      ++completions;
+                      result = error;
+                    }};
+
+  ASSERT_TRUE(op.start());
+  while (triggers.wait_for(0));
+  EXPECT_TRUE(op.armed());
+  EXPECT_EQ(completions, 0);
+
+  op.cancel();
+  EXPECT_FALSE(op.armed());
+  EXPECT_EQ(completions, 1);
+  EXPECT_EQ(result, std::errc::operation_canceled);
+
+  EXPECT_FALSE(op.start());
+  EXPECT_FALSE(op.armed());
+}
+
+TEST_F(MessageOperationTest, CancelReadyTest)
+{
+  std::array<int, 2> other{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, other.data()), 0);
+  auto second = triggers.emplace(other[0]);
+
+  std::array<char, 4> buf{};
+  socket_message<> msg{.buffers = {buf}};
+  std::array<char, 4> second_buf{};
+  socket_message<> second_msg{.buffers = {second_buf}};
+  std::array<std::error_code, 2> results;
+  std::array<recv_type *, 2> ops{};
+  bool armed_after_cancel = false;
+  std::size_t cancelled = 0;
+
+  auto handler = [&](std::size_t index) -> handler_type {
+    return [&, index](std::error_code error, std::size_t) {
+      results[index] = error;
+      // The other operation is ready too, so cancelling it is deferred.
+      auto *peer = ops[1 - index];
+      if (peer->armed())
+      {
+        peer->cancel();
+        cancelled = 1 - index;
+        armed_after_cancel = peer->armed();
+      }
+    };
+  };
+  recv_type first_op{dialog, msg, 0, handler(0)};
+  recv_type second_op{second, second_msg, 0, handler(1)};
+  ops = {&first_op, &second_op};
+
+  ASSERT_TRUE(first_op.start());
+  ASSERT_TRUE(second_op.start());
+  ASSERT_EQ(::write(pair[1], "a", 1), 1);
+  ASSERT_EQ(::write(other[1], "b", 1), 1);
+
+  for (int i = 0; i < 100 && (first_op.armed() || second_op.armed()); ++i)
+    triggers.wait_for(10);
+
+  EXPECT_TRUE(armed_after_cancel);
+  EXPECT_FALSE(first_op.armed());
+  EXPECT_FALSE(second_op.armed());
+  // The cancelled operation still completes with its bytes.
+  EXPECT_FALSE(results[0]);
+  EXPECT_FALSE(results[1]);
+  EXPECT_FALSE(ops[cancelled]->start());
+
+  ::close(other[1]);
+}
+
+TEST_F(MessageOperationTest, DestroyArmedTest)
+{
+  std::array<char, 4> buf{};
+  socket_message<> msg{.buffers = {buf}};
+  std::error_code result;
+  auto uses = dialog.socket.use_count();
+
+  // An operation that is still waiting is cancelled at once.
+  std::optional<recv_type> op;
+  op.emplace(dialog, msg, 0,
+             [&](std::error_code error, std::size_t) { result = error; });
+  ASSERT_TRUE(op->start());
+  while (triggers.wait_for(0));
+  op.reset();
+  EXPECT_EQ(result, std::errc::operation_canceled);
+  EXPECT_EQ(dialog.socket.use_count(), uses);
+}
+
+TEST_F(MessageOperationTest, DestroyReadyTest)
+{
+  std::array<int, 2> other{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, other.data()), 0);
+  auto second = triggers.emplace(other[0]);
+  std::array<socket_dialog<poll_multiplexer>, 2> dialogs{dialog, second};
+  std::array<long, 2> uses{dialog.socket.use_count(),
+                           second.socket.use_count()};
+
+  std::array<std::array<char, 4>, 2> bufs{};
+  std::array<std::optional<socket_message<>>, 2> msgs;
+  std::array<std::optional<recv_type>, 2> ops;
+  std::array<int, 2> completions{};
+
+  auto handler = [&](std::size_t index) -> handler_type {
+    return [&, index](std::error_code, std::size_t) {
+      ++completions[index];
+      // The other operation is ready too, so its state outlives it.
+      auto peer = 1 - index;
+      if (ops[peer] && ops[peer]->armed())
+      {
+        ops[peer].reset();
+        msgs[peer].reset();
+      }
+    };
+  };
+  for (std::size_t i = 0; i < ops.size(); ++i)
+  {
+    msgs[i].emplace(socket_message<>{.buffers = {bufs[i]}});
+    ops[i].emplace(dialogs[i], *msgs[i], 0, handler(i));
+    ASSERT_TRUE(ops[i]->start());
+  }
+  ASSERT_EQ(::write(pair[1], "a", 1), 1);
+  ASSERT_EQ(::write(other[1], "b", 1), 1);
+
+  for (int i = 0; i < 100 && (completions[0] + completions[1]) == 0; ++i)
+    triggers.wait_for(10);
+  while (triggers.wait_for(0));
+
+  // Only one handler ran, and the destroyed operation's state was freed
+  // without reading into its message.
+  EXPECT_EQ(completions[0] + completions[1], 1);
+  EXPECT_EQ(dialog.socket.use_count(), uses[0]);
+  EXPECT_EQ(second.socket.use_count(), uses[1]);
+  auto fd = completions[0] ? other[0] : pair[0];
+  std::array<char, 4> unread{};
+  EXPECT_EQ(::recv(fd, unread.data(), unread.size(), MSG_DONTWAIT), 1);
+
+  ::close(other[1]);
+}
+
+template <typename Mux>
+class MessageOperationMuxTest : public ::testing::Test {};
+
+using Multiplexers = ::testing::Types<
+    poll_multiplexer, epoll_multiplexer, io_uring_multiplexer,
+    basic_poll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_epoll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_io_uring_multiplexer<std::allocator<char>, null_mutex>>;
+TYPED_TEST_SUITE(MessageOperationMuxTest, Multiplexers);
+
+TYPED_TEST(MessageOperationMuxTest, DestroyInFlightTest)
+{
+  using handler_type = std::function<void(std::error_code, std::size_t)>;
+  using recv_type = recv_operation<TypeParam, socket_message<>, handler_type>;
+
+  basic_triggers<TypeParam> triggers;
+  std::array<int, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+
+  int completions = 0;
+  {
+    auto dialog = triggers.emplace(pair[0]);
+    std::array<char, 4> buf{};
+    socket_message<> msg{.buffers = {buf}};
+    recv_type op{dialog, msg, 0,
+                 [&](std::error_code, std::size_t) { ++completions; }};
+    ASSERT_TRUE(op.start());
+    while (triggers.wait_for(0));
+    EXPECT_TRUE(op.armed());
+  }
+
+  // The socket never becomes ready, but the handed-off state is freed by
+  // the cancellation, which closes the socket.
+  for (int i = 0; i < 100 && ::fcntl(pair[0], F_GETFD) != -1; ++i)
+    triggers.wait_for(10);
+
+  EXPECT_EQ(completions, 0);
+  EXPECT_EQ(::fcntl(pair[0], F_GETFD), -1);
+  EXPECT_EQ(errno, EBADF);
+
+  // The handoff no longer holds the executor's scope open.
+  stdexec::sync_wait(triggers.on_empty());
+  ::close(pair[1]);
+}
+
+TEST_F(MessageOperationTest, ErrorTest)
+{
+  std::string data = "x";
+  socket_message<> msg{.buffers = {std::span(data)}};
+  std::error_code result;
+
+  send_operation op{dialog, msg, 0,
+                    [&](std::error_code error, std::size_t) {
+                      result = error;
+                    }};
+
+  ::close(pair[1]);
+  pair[1] = -1;
+
+  ASSERT_TRUE(op.start());
+  while (triggers.wait_for(0));
+  EXPECT_FALSE(op.armed());
+  EXPECT_TRUE(result);
+}
+// NOLINTEND
@@ -46,6 +46,27 @@ int poll(struct pollfd *fds, nfds_t nfds, int timeout)
   return 0;
 }
 
+static int epoll_wait_call_count = 0;
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout)
+{
+  if (exception_test)
+  {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  epoll_wait_call_count++;
+  if (timeout > 0 && epoll_wait_call_count <= interruptions)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(8));
+    errno = EINTR;
+    return -1;
+  }
+
+  return 0;
+}
+
 class MockPollTest : public ::testing::Test {
 protected:
   void SetUp() override {}
@@ -67,5 +88,25 @@ TEST_F(MockPollTest, TestExceptionsPoll_)
 {
   exception_test = true;
   EXPECT_THROW(poll_(list, 0), std::system_error);
+  exception_test = false;
+}
+
+TEST_F(MockPollTest, TestEpollWait_)
+{
+  std::array<epoll_event, 1> events{};
+  epoll_wait_call_count = 0;
+  interruptions = 3;
+  auto ret = epoll_wait_(-1, events, 10);
+
+  EXPECT_EQ(ret, 0);
+  EXPECT_LT(epoll_wait_call_count, interruptions + 1);
+}
+
+TEST_F(MockPollTest, TestExceptionsEpollWait_)
+{
+  std::array<epoll_event, 1> events{};
+  exception_test = true;
+  EXPECT_THROW(epoll_wait_(-1, events, 0), std::system_error);
+  exception_test = false;
 }
 // NOLINTEND
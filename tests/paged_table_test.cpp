@@ -0,0 +1,102 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/execution/detail/paged_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace io::execution::detail;
+
+class PagedTableTest : public ::testing::Test {
+protected:
+  using table_type = paged_table<int, std::allocator<int>, 4>;
+
+  void SetUp() override {}
+  void TearDown() override {}
+
+  table_type table;
+};
+
+TEST_F(PagedTableTest, InsertTest)
+{
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_EQ(table.pages(), 0);
+  EXPECT_EQ(table.find(0), nullptr);
+
+  table[1] = 1;
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(table.pages(), 1);
+  ASSERT_NE(table.find(1), nullptr);
+  EXPECT_EQ(*table.find(1), 1);
+  EXPECT_EQ(table.find(0), nullptr);
+  EXPECT_EQ(table.find(2), nullptr);
+
+  table[1] = 2;
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(*table.find(1), 2);
+}
+
+TEST_F(PagedTableTest, SparseInsertTest)
+{
+  table[1'000'000] = 1;
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(table.pages(), 1);
+  EXPECT_EQ(table.find(999'999), nullptr);
+  ASSERT_NE(table.find(1'000'000), nullptr);
+  EXPECT_EQ(*table.find(1'000'000), 1);
+  EXPECT_EQ(table.find(2'000'000), nullptr);
+}
+
+TEST_F(PagedTableTest, StableReferenceTest)
+{
+  auto *ptr = &table[0];
+  table[1'000] = 1;
+  table[3] = 3;
+  EXPECT_EQ(ptr, table.find(0));
+}
+
+TEST_F(PagedTableTest, EraseTest)
+{
+  table[0] = 1;
+  table[1] = 2;
+  table[4] = 3;
+  EXPECT_EQ(table.size(), 3);
+  EXPECT_EQ(table.pages(), 2);
+
+  table.erase(0);
+  EXPECT_EQ(table.size(), 2);
+  EXPECT_EQ(table.pages(), 2);
+  EXPECT_EQ(table.find(0), nullptr);
+  EXPECT_EQ(*table.find(1), 2);
+
+  table.erase(1);
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(table.pages(), 1);
+
+  table.erase(1);
+  table.erase(100);
+  EXPECT_EQ(table.size(), 1);
+
+  EXPECT_EQ(table[0], 0);
+  EXPECT_EQ(table.pages(), 2);
+
+  table.erase(0);
+  table.erase(4);
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_EQ(table.pages(), 0);
+}
+// NOLINTEND
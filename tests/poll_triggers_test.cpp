@@ -20,9 +20,19 @@
 #include <stdexec/execution.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory_resource>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <unistd.h>
 
 using namespace io::execution;
 
@@ -31,15 +41,27 @@ protected:
   basic_triggers<poll_multiplexer> triggers;
 };
 
-TEST_F(PollTriggersTest, AllocatorConstructionTest)
+template <typename Mux> class TriggersTest : public ::testing::Test {
+protected:
+  basic_triggers<Mux> triggers;
+};
+
+using Multiplexers = ::testing::Types<
+    poll_multiplexer, epoll_multiplexer, io_uring_multiplexer,
+    basic_poll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_epoll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_io_uring_multiplexer<std::allocator<char>, null_mutex>>;
+TYPED_TEST_SUITE(TriggersTest, Multiplexers);
+
+TYPED_TEST(TriggersTest, AllocatorConstructionTest)
 {
   std::allocator<std::byte> alloc;
-  basic_triggers<poll_multiplexer> triggers1{alloc};
+  basic_triggers<TypeParam> triggers1{alloc};
 }
 
-TEST_F(PollTriggersTest, MoveConstructorTest)
+TYPED_TEST(TriggersTest, MoveConstructorTest)
 {
-  basic_triggers<poll_multiplexer> triggers1;
+  basic_triggers<TypeParam> triggers1;
   auto ptr1 = triggers1.get_executor().lock();
   EXPECT_TRUE(ptr1);
   auto *addr1 = ptr1.get();
@@ -51,9 +73,9 @@ TEST_F(PollTriggersTest, MoveConstructorTest)
   EXPECT_TRUE(addr1 == addr2);
 }
 
-TEST_F(PollTriggersTest, MoveAssignmentTest)
+TYPED_TEST(TriggersTest, MoveAssignmentTest)
 {
-  basic_triggers<poll_multiplexer> triggers1, triggers2;
+  basic_triggers<TypeParam> triggers1, triggers2;
   auto ptr1 = triggers1.get_executor().lock();
   auto ptr2 = triggers2.get_executor().lock();
   EXPECT_TRUE(ptr1 && ptr2);
@@ -68,16 +90,17 @@ TEST_F(PollTriggersTest, MoveAssignmentTest)
   EXPECT_TRUE(addr2 == addr1);
 }
 
-TEST_F(PollTriggersTest, SelfSwapTest)
+TYPED_TEST(TriggersTest, SelfSwapTest)
 {
-  basic_triggers<poll_multiplexer> triggers1;
+  basic_triggers<TypeParam> triggers1;
   using std::swap;
   swap(triggers1, triggers1);
   EXPECT_TRUE(&triggers1 == &triggers1);
 }
 
-TEST_F(PollTriggersTest, PushHandleTest)
+TYPED_TEST(TriggersTest, PushHandleTest)
 {
+  auto &triggers = this->triggers;
   using socket_handle = ::io::socket::socket_handle;
   socket_handle socket{AF_INET, SOCK_STREAM, IPPROTO_TCP};
   auto sockfd = static_cast<int>(socket);
@@ -88,8 +111,9 @@ TEST_F(PollTriggersTest, PushHandleTest)
   EXPECT_TRUE(sockfd == *ptr);
 }
 
-TEST_F(PollTriggersTest, EmplaceHandleTest)
+TYPED_TEST(TriggersTest, EmplaceHandleTest)
 {
+  auto &triggers = this->triggers;
   auto dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
   auto ptr = dialog.socket;
   EXPECT_TRUE(ptr);
@@ -102,6 +126,88 @@ TEST_F(PollTriggersTest, EmplaceHandleTest)
   EXPECT_TRUE(*ptr == sockfd);
 }
 
+class counting_resource : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0;
+  std::size_t outstanding = 0;
+
+private:
+  auto do_allocate(std::size_t bytes, std::size_t align) -> void * override
+  {
+    ++allocations;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  auto do_deallocate(void *ptr, std::size_t bytes,
+                     std::size_t align) -> void override
+  {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+  }
+  auto do_is_equal(const std::pmr::memory_resource &other) const noexcept
+      -> bool override
+  {
+    return this == &other;
+  }
+};
+
+template <typename Mux> class PmrTriggersTest : public ::testing::Test {};
+
+using PmrMultiplexers =
+    ::testing::Types<pmr::poll_multiplexer, pmr::epoll_multiplexer,
+                     pmr::io_uring_multiplexer>;
+TYPED_TEST_SUITE(PmrTriggersTest, PmrMultiplexers);
+
+TYPED_TEST(PmrTriggersTest, MemoryResourceTest)
+{
+  using namespace io::socket;
+  counting_resource resource;
+  {
+    basic_triggers<TypeParam> triggers{&resource};
+    auto executor = triggers.get_executor().lock();
+    EXPECT_EQ(executor->get_allocator().resource(), &resource);
+    auto allocations = resource.allocations;
+    EXPECT_GT(allocations, 0);
+
+    // Socket handles come from the resource.
+    std::array<int, 2> pair{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    auto reader = triggers.emplace(pair[0]);
+    auto writer = triggers.emplace(pair[1]);
+    EXPECT_EQ(resource.allocations, allocations + 2);
+
+    // So do the receive buffers and the multiplexer's tables.
+    exec::async_scope scope;
+    std::optional<pooled_buffer> received;
+    scope.spawn(::io::recv(reader, 0) |
+                stdexec::then([&](pooled_buffer buf) {
+                  received.emplace(std::move(buf));
+                }) |
+                stdexec::upon_error([](auto) {}));
+    ASSERT_EQ(::write(pair[1], "hello", 5), 5);
+    while (!received)
+      triggers.wait_for(0);
+    EXPECT_EQ(received->size(), 5);
+    EXPECT_GE(resource.outstanding,
+              buffer_pool::default_buffer_size *
+                  buffer_pool::default_slab_size);
+
+    // Messages can use the same resource.
+    std::array<char, 8> buf{};
+    using message_type = io::socket::pmr::socket_message<>;
+    auto message = message_type{
+        .buffers{&resource}, .control = message_type::control_type(&resource)};
+    allocations = resource.allocations;
+    for (int i = 0; i < 5; ++i)
+      message.buffers.push_back(buf);
+    EXPECT_EQ(resource.allocations, allocations + 1);
+
+    received.reset();
+    while (triggers.wait_for(0));
+  }
+  EXPECT_EQ(resource.outstanding, 0);
+}
+
 TEST_F(PollTriggersTest, PollErrorHandlingTest)
 {
   handle_poll_error({EINTR, std::system_category()});
@@ -111,8 +217,8 @@ TEST_F(PollTriggersTest, PollErrorHandlingTest)
 
 TEST_F(PollTriggersTest, PollTest)
 {
-  auto list = poll_(poll_multiplexer::vector_type{}, 0);
-  EXPECT_TRUE(list.empty());
+  poll_multiplexer::vector_type list;
+  EXPECT_TRUE(poll_(list, 0).empty());
 }
 
 TEST_F(PollTriggersTest, PollSetErrorTest)
@@ -133,12 +239,41 @@ TEST_F(PollTriggersTest, PollClearEventsTest)
 {
   poll_multiplexer::vector_type list{
       {.fd = 1, .events = POLLIN, .revents = POLLERR}};
-  clear_event({.fd = 1, .events = POLLIN, .revents = POLLERR}, list);
-  EXPECT_EQ(list[0].events, 0);
+  poll_multiplexer::map_type demux;
+  demux[1].index = 0;
+  clear_event({.fd = 1, .events = POLLIN, .revents = POLLERR}, list, demux);
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(demux[1].index, poll_multiplexer::demultiplexer::npos);
 }
 
-TEST_F(PollTriggersTest, SubmitTest)
+TEST_F(PollTriggersTest, PollCompactEventsTest)
 {
+  poll_multiplexer::vector_type list;
+  poll_multiplexer::map_type demux;
+  update_or_insert_event(&list, {.fd = 0, .events = POLLIN}, demux[0]);
+  update_or_insert_event(&list, {.fd = 1, .events = POLLIN}, demux[1]);
+  update_or_insert_event(&list, {.fd = 2, .events = POLLOUT}, demux[2]);
+  update_or_insert_event(&list, {.fd = 0, .events = POLLOUT}, demux[0]);
+  ASSERT_EQ(list.size(), 3);
+  EXPECT_EQ(list[0].events, POLLIN | POLLOUT);
+
+  clear_event({.fd = 0, .events = POLLIN, .revents = POLLIN}, list, demux);
+  ASSERT_EQ(list.size(), 3);
+  EXPECT_EQ(list[0].events, POLLOUT);
+
+  clear_event({.fd = 0, .events = POLLOUT, .revents = POLLOUT}, list, demux);
+  ASSERT_EQ(list.size(), 2);
+  EXPECT_EQ(list[demux[2].index].fd, 2);
+  EXPECT_EQ(list[demux[1].index].fd, 1);
+  EXPECT_EQ(demux[0].index, poll_multiplexer::demultiplexer::npos);
+
+  clear_event({.fd = 0, .events = POLLIN, .revents = POLLIN}, list, demux);
+  EXPECT_EQ(list.size(), 2);
+}
+
+TYPED_TEST(TriggersTest, SubmitTest)
+{
+  auto &triggers = this->triggers;
   using trigger = execution_trigger;
   using socket_handle = ::io::socket::socket_handle;
   using async_scope = exec::async_scope;
@@ -191,20 +326,141 @@ TEST_F(PollTriggersTest, SubmitTest)
                std::system_error);
 }
 
-TEST_F(PollTriggersTest, WaitTest)
+TYPED_TEST(TriggersTest, WouldBlockTest)
+{
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<int, 2> sockets{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()), 0);
+  auto read_socket = std::make_shared<socket_handle>(sockets[0]);
+
+  // The handler reports that the socket would block, as if another reader
+  // had taken the data. The multiplexer completes the operation with the
+  // error instead of waiting again.
+  int calls = 0;
+  std::error_code error;
+  scope.spawn(triggers.set(read_socket, trigger::READ,
+                           [&]() -> std::optional<int> {
+                             ++calls;
+                             errno = EWOULDBLOCK;
+                             return std::nullopt;
+                           }) |
+              stdexec::then([](int) {}) |
+              stdexec::upon_error([&](auto err) {
+                if constexpr (std::is_same_v<decltype(err), std::error_code>)
+                  error = err;
+              }));
+
+  ASSERT_EQ(::write(sockets[1], "a", 1), 1);
+  for (int i = 0; i < 100 && !error; ++i)
+    triggers.wait_for(10);
+  while (triggers.wait_for(0));
+
+  EXPECT_EQ(error, std::errc::operation_would_block);
+  EXPECT_EQ(calls, 1);
+  stdexec::sync_wait(scope.on_empty());
+}
+
+TYPED_TEST(TriggersTest, ErrorQueueTest)
 {
-  basic_triggers<poll_multiplexer> triggers1;
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(listener, 0);
+  sockaddr_in address{.sin_family = AF_INET};
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrlen = sizeof(address);
+  ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr *>(&address), addrlen),
+            0);
+  ASSERT_EQ(::listen(listener, 1), 0);
+  ASSERT_EQ(
+      ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addrlen),
+      0);
+  int client = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(::connect(client, reinterpret_cast<sockaddr *>(&address), addrlen),
+            0);
+  int server = ::accept(listener, nullptr, nullptr);
+  ASSERT_GE(server, 0);
+  ::close(listener);
+
+  int enable = 1;
+  ASSERT_EQ(
+      ::setsockopt(client, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)),
+      0);
+  auto socket = std::make_shared<socket_handle>(client);
+
+  // A read that is pending when the zero-copy notification arrives must not
+  // be failed by the POLLERR that announces it.
+  char byte = 0;
+  std::atomic<bool> read_done = false;
+  std::atomic<bool> read_failed = false;
+  scope.spawn(triggers.set(socket, trigger::READ,
+                           [&]() -> std::optional<int> {
+                             auto len = ::recv(client, &byte, 1, MSG_DONTWAIT);
+                             if (len < 0)
+                               return std::nullopt;
+                             return len;
+                           }) |
+              stdexec::then([&](int) { read_done = true; }) |
+              stdexec::upon_error([&](auto) { read_failed = true; }));
+
+  int notifications = 0;
+  std::atomic<bool> reaped = false;
+  scope.spawn(triggers.set(socket, trigger::ERRQUEUE,
+                           [&]() -> std::optional<int> {
+                             std::array<char, 128> control{};
+                             msghdr msg{.msg_control = control.data(),
+                                        .msg_controllen = control.size()};
+                             auto len = ::recvmsg(client, &msg,
+                                                  MSG_ERRQUEUE | MSG_DONTWAIT);
+                             if (len < 0)
+                               return std::nullopt;
+                             return ++notifications;
+                           }) |
+              stdexec::then([&](int) { reaped = true; }) |
+              stdexec::upon_error([](auto) {}));
+
+  ASSERT_EQ(::send(client, "abcd", 4, MSG_ZEROCOPY), 4);
+  for (int i = 0; i < 100 && !reaped; ++i)
+    triggers.wait_for(10);
+
+  EXPECT_TRUE(reaped);
+  EXPECT_EQ(notifications, 1);
+  EXPECT_FALSE(read_done);
+  EXPECT_FALSE(read_failed);
+
+  ASSERT_EQ(::send(server, "a", 1, 0), 1);
+  for (int i = 0; i < 100 && !read_done; ++i)
+    triggers.wait_for(10);
+
+  EXPECT_TRUE(read_done);
+  EXPECT_FALSE(read_failed);
+  EXPECT_EQ(byte, 'a');
+  ::close(server);
+}
+
+TYPED_TEST(TriggersTest, WaitTest)
+{
+  basic_triggers<TypeParam> triggers1;
   EXPECT_EQ(triggers1.wait(), 0);
 }
 
-TEST_F(PollTriggersTest, AsyncAcceptTest)
+TYPED_TEST(TriggersTest, AsyncAcceptTest)
 {
   using ::io::socket::make_address;
   using async_scope = exec::async_scope;
 
   async_scope scope;
 
-  basic_triggers<poll_multiplexer> triggers1;
+  basic_triggers<TypeParam> triggers1;
   auto dialog = triggers1.emplace(AF_INET, SOCK_STREAM, 0);
 
   auto address = make_address<struct sockaddr_in>();
@@ -242,8 +498,9 @@ TEST_F(PollTriggersTest, AsyncAcceptTest)
 TEST_F(PollTriggersTest, UpdateOrInsertEventTest)
 {
   std::vector<pollfd> list{{.fd = 0, .events = 0, .revents = 0}};
+  poll_multiplexer::demultiplexer demux{.index = 0};
   pollfd pfd = {.fd = 0, .events = POLLIN, .revents = 0};
-  update_or_insert_event(&list, pfd);
+  update_or_insert_event(&list, pfd, demux);
 
   EXPECT_EQ(list[0].events, POLLIN);
 }
@@ -260,8 +517,9 @@ TEST_F(PollTriggersTest, HandleGetSockOptErrorTest)
                std::system_error);
 }
 
-TEST_F(PollTriggersTest, OnEmptyTest)
+TYPED_TEST(TriggersTest, OnEmptyTest)
 {
+  auto &triggers = this->triggers;
   using namespace stdexec;
   bool empty = false;
   sender auto on_empty =
@@ -270,4 +528,338 @@ TEST_F(PollTriggersTest, OnEmptyTest)
 
   ASSERT_TRUE(empty);
 }
+TYPED_TEST(TriggersTest, NotifyTest)
+{
+  if constexpr (std::is_same_v<typename TypeParam::mutex, null_mutex>)
+    GTEST_SKIP();
+
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<int, 2> sockets{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()), 0);
+
+  // Keep interest registered so that the wait blocks.
+  std::atomic<bool> idle_done = false;
+  auto idle = std::make_shared<socket_handle>(sockets[0]);
+  scope.spawn(triggers.set(idle, trigger::READ,
+                           [] { return std::optional(0); }) |
+              stdexec::then([&](int) { idle_done = true; }) |
+              stdexec::upon_error([](auto) {}));
+  // io_uring cancels requests when the thread that submitted them exits.
+  triggers.wait_for(0);
+
+  auto waiter =
+      std::async(std::launch::async, [&] { return triggers.wait_for(-1); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  triggers.notify();
+
+  auto status = waiter.wait_for(std::chrono::seconds(2));
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status != std::future_status::ready)
+    ::write(sockets[1], "a", 1);
+  EXPECT_EQ(waiter.get(), 0);
+
+  ::write(sockets[1], "a", 1);
+  while (!idle_done)
+    triggers.wait_for(10);
+}
+
+TYPED_TEST(TriggersTest, CrossThreadSetTest)
+{
+  if constexpr (std::is_same_v<typename TypeParam::mutex, null_mutex>)
+    GTEST_SKIP();
+
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  std::array<int, 2> idle_pair{};
+  std::array<int, 2> ready_pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, idle_pair.data()), 0);
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, ready_pair.data()), 0);
+
+  std::atomic<bool> idle_done = false;
+  auto idle = std::make_shared<socket_handle>(idle_pair[0]);
+  scope.spawn(triggers.set(idle, trigger::READ,
+                           [] { return std::optional(0); }) |
+              stdexec::then([&](int) { idle_done = true; }) |
+              stdexec::upon_error([](auto) {}));
+  // io_uring cancels requests when the thread that submitted them exits.
+  triggers.wait_for(0);
+
+  std::atomic<bool> ready_done = false;
+  auto waiter = std::async(std::launch::async, [&] {
+    while (!ready_done)
+      triggers.wait_for(-1);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // Interest registered from this thread must wake up the blocked wait.
+  ::write(ready_pair[1], "a", 1);
+  auto ready = std::make_shared<socket_handle>(ready_pair[0]);
+  scope.spawn(triggers.set(ready, trigger::READ,
+                           [] { return std::optional(0); }) |
+              stdexec::then([&](int) { ready_done = true; }) |
+              stdexec::upon_error([](auto) {}));
+
+  auto status = waiter.wait_for(std::chrono::seconds(2));
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status != std::future_status::ready)
+    ::write(idle_pair[1], "a", 1);
+  waiter.get();
+  EXPECT_TRUE(ready_done);
+
+  ::write(idle_pair[1], "a", 1);
+  while (!idle_done)
+    triggers.wait_for(10);
+}
+TYPED_TEST(TriggersTest, ScheduleAfterTest)
+{
+  auto &triggers = this->triggers;
+  using async_scope = exec::async_scope;
+  using clock = std::chrono::steady_clock;
+  using namespace std::chrono_literals;
+
+  async_scope scope;
+  std::vector<int> order;
+  auto start = clock::now();
+  for (int delay : {30, 10, 20})
+  {
+    scope.spawn(triggers.schedule_after(std::chrono::milliseconds(delay)) |
+                stdexec::then([&, delay] { order.push_back(delay); }));
+  }
+
+  while (order.size() < 3 && clock::now() - start < 2s)
+    triggers.wait_for(-1);
+
+  EXPECT_GE(clock::now() - start, 30ms);
+  EXPECT_EQ(order, (std::vector<int>{10, 20, 30}));
+  EXPECT_EQ(triggers.wait_for(0), 0);
+}
+
+TYPED_TEST(TriggersTest, ScheduleAtTest)
+{
+  auto &triggers = this->triggers;
+  using async_scope = exec::async_scope;
+  using clock = std::chrono::steady_clock;
+
+  async_scope scope;
+  bool fired = false;
+  scope.spawn(triggers.schedule_at(clock::now() - std::chrono::seconds(1)) |
+              stdexec::then([&] { fired = true; }));
+
+  for (int i = 0; i < 100 && !fired; ++i)
+    triggers.wait_for(10);
+  EXPECT_TRUE(fired);
+}
+
+/** @brief A receiver with a stop token. */
+struct stoppable_receiver {
+  using receiver_concept = stdexec::receiver_t;
+
+  struct env {
+    stdexec::inplace_stop_token token;
+    auto query(stdexec::get_stop_token_t) const noexcept
+        -> stdexec::inplace_stop_token
+    {
+      return token;
+    }
+  };
+
+  template <typename... Args> auto set_value(Args &&...) && noexcept -> void
+  {
+    *result = 1;
+  }
+  auto set_stopped() && noexcept -> void { *result = 2; }
+  auto set_error(std::error_code) && noexcept -> void { *result = 3; }
+  auto get_env() const noexcept -> env { return {source->get_token()}; }
+
+  stdexec::inplace_stop_source *source;
+  int *result;
+};
+
+TYPED_TEST(TriggersTest, ScheduleStopTest)
+{
+  auto &triggers = this->triggers;
+  using namespace std::chrono_literals;
+
+  stdexec::inplace_stop_source source;
+  int result = 0;
+  auto op = stdexec::connect(triggers.schedule_after(1h),
+                             stoppable_receiver{&source, &result});
+  stdexec::start(op);
+  EXPECT_EQ(triggers.wait_for(0), 0);
+  EXPECT_EQ(result, 0);
+
+  source.request_stop();
+  EXPECT_EQ(result, 2);
+  EXPECT_EQ(triggers.wait_for(0), 0);
+
+  // A stop that was requested before the timer starts.
+  int stopped = 0;
+  auto late = stdexec::connect(triggers.schedule_after(1h),
+                               stoppable_receiver{&source, &stopped});
+  stdexec::start(late);
+  EXPECT_EQ(stopped, 2);
+}
+
+TYPED_TEST(TriggersTest, CrossThreadScheduleTest)
+{
+  if constexpr (std::is_same_v<typename TypeParam::mutex, null_mutex>)
+    GTEST_SKIP();
+
+  auto &triggers = this->triggers;
+  using async_scope = exec::async_scope;
+  using namespace std::chrono_literals;
+
+  async_scope scope;
+  std::atomic<bool> long_done = false;
+  std::atomic<bool> short_done = false;
+  scope.spawn(triggers.schedule_after(10s) |
+              stdexec::then([&] { long_done = true; }));
+
+  auto waiter = std::async(std::launch::async, [&] {
+    while (!short_done)
+      triggers.wait_for(-1);
+  });
+  std::this_thread::sleep_for(20ms);
+
+  // An earlier deadline from this thread must shorten the blocked wait.
+  scope.spawn(triggers.schedule_after(10ms) |
+              stdexec::then([&] { short_done = true; }));
+
+  auto status = waiter.wait_for(2s);
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status != std::future_status::ready)
+    short_done = true;
+  triggers.notify();
+  waiter.get();
+  EXPECT_FALSE(long_done);
+}
+
+template <typename Mux> class CancelTest : public ::testing::Test {
+protected:
+  auto SetUp() -> void override
+  {
+    int status = ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data());
+    ASSERT_EQ(status, 0);
+    read_socket = std::make_shared<socket_handle>(sockets[0]);
+    write_socket = std::make_shared<socket_handle>(sockets[1]);
+  }
+
+  auto read() -> decltype(auto)
+  {
+    return triggers.set(read_socket, execution_trigger::READ, [&] {
+      return std::optional(::read(sockets[0], buf.data(), buf.size()));
+    });
+  }
+
+  using socket_handle = ::io::socket::socket_handle;
+
+  basic_triggers<Mux> triggers;
+  std::array<int, 2> sockets{};
+  std::array<char, 2> buf{};
+  std::shared_ptr<socket_handle> read_socket;
+  std::shared_ptr<socket_handle> write_socket;
+};
+
+TYPED_TEST_SUITE(CancelTest, Multiplexers);
+
+TYPED_TEST(CancelTest, StopTest)
+{
+  auto &triggers = this->triggers;
+
+  stdexec::inplace_stop_source source;
+  int result = 0;
+  auto op =
+      stdexec::connect(this->read(), stoppable_receiver{&source, &result});
+  stdexec::start(op);
+  EXPECT_EQ(triggers.wait_for(0), 0);
+  EXPECT_EQ(result, 0);
+
+  // io_uring cancels a submitted operation on the next wait.
+  source.request_stop();
+  while (result == 0)
+    triggers.wait_for(-1);
+  EXPECT_EQ(result, 2);
+
+  // The interest was dropped, so there is nothing left to wait for.
+  EXPECT_EQ(triggers.wait_for(-1), 0);
+
+  // A stop that was requested before the operation starts.
+  int stopped = 0;
+  auto late =
+      stdexec::connect(this->read(), stoppable_receiver{&source, &stopped});
+  stdexec::start(late);
+  EXPECT_EQ(stopped, 2);
+  EXPECT_EQ(triggers.wait_for(-1), 0);
+}
+
+TYPED_TEST(CancelTest, StopOneOfManyTest)
+{
+  auto &triggers = this->triggers;
+
+  stdexec::inplace_stop_source first_source;
+  stdexec::inplace_stop_source second_source;
+  int first = 0;
+  int second = 0;
+  auto first_op = stdexec::connect(this->read(),
+                                   stoppable_receiver{&first_source, &first});
+  auto second_op = stdexec::connect(
+      this->read(), stoppable_receiver{&second_source, &second});
+  stdexec::start(first_op);
+  stdexec::start(second_op);
+
+  first_source.request_stop();
+  EXPECT_EQ(first, 2);
+
+  // The other operation still waits for the socket.
+  ASSERT_EQ(::write(this->sockets[1], "a", 1), 1);
+  EXPECT_EQ(triggers.wait_for(-1), 1);
+  EXPECT_EQ(second, 1);
+  EXPECT_EQ(this->buf[0], 'a');
+}
+
+TYPED_TEST(CancelTest, DeadlineTest)
+{
+  auto &triggers = this->triggers;
+  using namespace std::chrono_literals;
+
+  exec::async_scope scope;
+  std::error_code error;
+  bool done = false;
+  scope.spawn(io::with_deadline(triggers, this->read(), 10ms) |
+              stdexec::then([&](auto) { done = true; }) |
+              stdexec::upon_error([&](auto err) {
+                if constexpr (std::is_same_v<decltype(err), std::error_code>)
+                  error = err;
+                done = true;
+              }));
+
+  while (!done)
+    triggers.wait_for(-1);
+  EXPECT_EQ(error, std::errc::timed_out);
+  EXPECT_EQ(triggers.wait_for(-1), 0);
+
+  ssize_t received = 0;
+  done = false;
+  ASSERT_EQ(::write(this->sockets[1], "b", 1), 1);
+  scope.spawn(io::with_deadline(triggers, this->read(), 10s) |
+              stdexec::then([&](auto len) {
+                received = len;
+                done = true;
+              }) |
+              stdexec::upon_error([&](auto) { done = true; }));
+
+  while (!done)
+    triggers.wait_for(-1);
+  EXPECT_EQ(received, 1);
+  EXPECT_EQ(this->buf[0], 'b');
+}
 // NOLINTEND
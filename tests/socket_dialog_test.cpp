@@ -18,6 +18,11 @@
 #include <gtest/gtest.h>
 #include <stdexec/execution.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <gtest/gtest.h>
@@ -30,7 +35,13 @@ using namespace io::socket::detail;
 
 class SocketDialogTest : public ::testing::TestWithParam<bool> {
 protected:
-  void SetUp() override { is_lazy_ = GetParam(); }
+  void SetUp() override
+  {
+    is_lazy_ = GetParam();
+    // An empty eager budget forces lazy evaluation.
+    if (is_lazy_)
+      triggers.get_executor().lock()->set_eager_budget(0);
+  }
   void TearDown() override {}
 
   bool is_lazy_ = false;
@@ -43,11 +54,6 @@ TEST_P(SocketDialogTest, ConnectAcceptOperation)
 
   async_scope scope;
 
-  if (is_lazy_)
-  {
-    // Set the fairness counter to max value to force lazy evaluation.
-    fairness::counter() = -1;
-  }
   auto accept_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
   auto connect_dialog = triggers.emplace(AF_INET, SOCK_STREAM, IPPROTO_TCP);
   auto address = make_address<sockaddr_in>();
@@ -101,22 +107,10 @@ TEST_P(SocketDialogTest, SendmsgRecvmsgOperation)
   auto send_dialog = triggers.emplace(pair[0]);
   auto recv_dialog = triggers.emplace(pair[1]);
 
-  if (is_lazy_)
-  {
-    // Set the fairness counter to max value to force lazy evaluation.
-    fairness::counter() = -1;
-  }
-
   stdexec::sender auto send_sender = ::io::sendmsg(send_dialog, send_msg, 0);
   stdexec::sender auto send_future = scope.spawn_future(std::move(send_sender));
   while (triggers.wait_for(0));
 
-  if (is_lazy_)
-  {
-    // Set the fairness counter to max value to force lazy evaluation.
-    fairness::counter() = -1;
-  }
-
   stdexec::sender auto recv_sender = ::io::recvmsg(recv_dialog, recv_msg, 0);
   stdexec::sender auto recv_future = scope.spawn_future(std::move(recv_sender));
   while (triggers.wait_for(0));
@@ -128,6 +122,144 @@ TEST_P(SocketDialogTest, SendmsgRecvmsgOperation)
 
   EXPECT_EQ(send_len, recv_len);
   EXPECT_EQ(::strncmp(message, recv_buf.data(), 14), 0);
+
+  auto stats = triggers.get_executor().lock()->eager_stats();
+  if (is_lazy_)
+  {
+    EXPECT_EQ(stats.eager, 0);
+    EXPECT_EQ(stats.budget_fallbacks, 2);
+  }
+  else
+  {
+    EXPECT_EQ(stats.eager, 2);
+    EXPECT_EQ(stats.budget_fallbacks, 0);
+  }
+}
+
+TEST_P(SocketDialogTest, SendfileOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  // Larger than the socket buffers, so the transfer is sent in parts.
+  std::vector<char> contents(1 << 21);
+  for (std::size_t i = 0; i < contents.size(); ++i)
+    contents[i] = static_cast<char>(i * 31);
+
+  std::FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file),
+            contents.size());
+  ASSERT_EQ(std::fflush(file), 0);
+  int fd = ::fileno(file);
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]);
+  auto recv_dialog = triggers.emplace(pair[1]);
+
+  static constexpr std::streamoff offset = 7;
+  // Asks for more than is left so that the transfer stops at the end of the
+  // file.
+  auto future = scope.spawn_future(
+      ::io::sendfile(send_dialog, fd, offset, contents.size()));
+
+  std::vector<char> received;
+  std::array<char, 65536> buf{};
+  auto expected = contents.size() - offset;
+  for (int i = 0; i < 100000 && received.size() < expected; ++i)
+  {
+    triggers.wait_for(0);
+    auto len = ::recv(pair[1], buf.data(), buf.size(), MSG_DONTWAIT);
+    if (len > 0)
+      received.insert(received.end(), buf.begin(), buf.begin() + len);
+  }
+  while (triggers.wait_for(0));
+
+  auto [sent] = stdexec::sync_wait(std::move(future)).value();
+  EXPECT_EQ(sent, expected);
+  ASSERT_EQ(received.size(), expected);
+  EXPECT_TRUE(std::equal(received.begin(), received.end(),
+                         contents.begin() + offset));
+  EXPECT_EQ(::lseek(fd, 0, SEEK_CUR), contents.size());
+
+  std::fclose(file);
+}
+
+TEST_P(SocketDialogTest, ZerocopySendOperation)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  // AF_UNIX sockets don't support MSG_ZEROCOPY, so this needs TCP.
+  int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(listener, 0);
+  sockaddr_in address{.sin_family = AF_INET};
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrlen = sizeof(address);
+  ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr *>(&address), addrlen),
+            0);
+  ASSERT_EQ(::listen(listener, 1), 0);
+  ASSERT_EQ(
+      ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addrlen),
+      0);
+
+  int client = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(client, 0);
+  ASSERT_EQ(::connect(client, reinterpret_cast<sockaddr *>(&address), addrlen),
+            0);
+  int server = ::accept(listener, nullptr, nullptr);
+  ASSERT_GE(server, 0);
+  ::close(listener);
+
+  static constexpr std::size_t count = 8;
+  static constexpr std::size_t size = 1 << 16;
+  std::vector<std::vector<char>> buffers(count, std::vector<char>(size));
+  for (std::size_t i = 0; i < count; ++i)
+    std::ranges::fill(buffers[i], static_cast<char>(i));
+
+  std::vector<const void *> released;
+  auto send_dialog = triggers.emplace(client).with_zerocopy(
+      [&](std::span<const native_buffer_type> bufs) {
+        ASSERT_EQ(bufs.size(), 1);
+        released.push_back(bufs.front().iov_base);
+      });
+  ASSERT_TRUE(send_dialog.zerocopy);
+
+  std::vector<socket_message<>> messages(count);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    messages[i].buffers.emplace_back(buffers[i].data(), buffers[i].size());
+    scope.spawn(::io::sendmsg(send_dialog, messages[i], 0) |
+                stdexec::then([&](auto len) { total += len; }) |
+                stdexec::upon_error([](auto) {}));
+  }
+
+  std::vector<char> received;
+  std::array<char, 65536> buf{};
+  for (int i = 0; i < 100000 && (received.size() < count * size ||
+                                 send_dialog.zerocopy->pending());
+       ++i)
+  {
+    triggers.wait_for(0);
+    auto len = ::recv(server, buf.data(), buf.size(), MSG_DONTWAIT);
+    if (len > 0)
+      received.insert(received.end(), buf.begin(), buf.begin() + len);
+  }
+  while (triggers.wait_for(0));
+
+  EXPECT_EQ(total, count * size);
+  ASSERT_EQ(received.size(), count * size);
+  for (std::size_t i = 0; i < count; ++i)
+    EXPECT_EQ(received[i * size], static_cast<char>(i));
+
+  EXPECT_EQ(send_dialog.zerocopy->pending(), 0);
+  ASSERT_EQ(released.size(), count);
+  for (std::size_t i = 0; i < count; ++i)
+    EXPECT_EQ(released[i], buffers[i].data());
+
+  ::close(server);
 }
 
 INSTANTIATE_TEST_SUITE_P(SocketDialogTests, SocketDialogTest, ::testing::Bool(),
@@ -176,6 +308,292 @@ TEST_F(SocketDialogHelperTest, ShutdownTest)
   EXPECT_EQ(::io::shutdown(dialog, SHUT_RD), 0);
 }
 
+TEST_F(SocketDialogHelperTest, EagerPredictorTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]);
+  auto recv_dialog = triggers.emplace(pair[1]);
+  auto executor = triggers.get_executor().lock();
+
+  std::array<char, 4> recv_buf{};
+  std::array<socket_message<>, 4> msgs;
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+    msgs[i].buffers.emplace_back(&recv_buf[i], 1);
+
+  // Every eager read on an idle socket misses until the socket cools down.
+  auto recv0 = scope.spawn_future(::io::recvmsg(recv_dialog, msgs[0], 0));
+  auto recv1 = scope.spawn_future(::io::recvmsg(recv_dialog, msgs[1], 0));
+  auto recv2 = scope.spawn_future(::io::recvmsg(recv_dialog, msgs[2], 0));
+  EXPECT_FALSE(recv_dialog.socket->read_predictor().is_hot());
+  EXPECT_EQ(executor->eager_stats().eager, eager_predictor::max_score);
+
+  // A cold socket skips the eager attempt.
+  auto recv3 = scope.spawn_future(::io::recvmsg(recv_dialog, msgs[3], 0));
+  EXPECT_EQ(executor->eager_stats().eager, eager_predictor::max_score);
+  EXPECT_TRUE(send_dialog.socket->write_predictor().is_hot());
+
+  const char *message = "abcd";
+  ASSERT_EQ(::send(pair[0], message, 4, MSG_NOSIGNAL), 4);
+  while (triggers.wait_for(0));
+
+  auto [len0, len1, len2, len3] =
+      stdexec::sync_wait(stdexec::when_all(std::move(recv0), std::move(recv1),
+                                           std::move(recv2), std::move(recv3)))
+          .value();
+  EXPECT_EQ(len0 + len1 + len2 + len3, 4);
+  EXPECT_EQ(::strncmp(message, recv_buf.data(), 4), 0);
+}
+
+TEST_F(SocketDialogHelperTest, WriteQueueTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]).with_write_queue();
+  auto recv_dialog = triggers.emplace(pair[1]);
+  ASSERT_TRUE(send_dialog.writes);
+
+  std::string_view first = "Hello";
+  std::string_view second = ", ";
+  std::string_view third = "World!";
+  auto send0 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = first}, 0));
+  auto send1 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = second}, 0));
+  auto send2 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = third}, 0));
+  while (triggers.wait_for(0));
+
+  auto [len0, len1, len2] =
+      stdexec::sync_wait(stdexec::when_all(std::move(send0), std::move(send1),
+                                           std::move(send2)))
+          .value();
+  EXPECT_EQ(len0, first.size());
+  EXPECT_EQ(len1, second.size());
+  EXPECT_EQ(len2, third.size());
+  EXPECT_EQ(send_dialog.writes->syscalls(), 1);
+
+  std::array<char, 14> recv_buf{};
+  ASSERT_EQ(::recv(pair[1], recv_buf.data(), recv_buf.size(), 0), 13);
+  EXPECT_EQ(std::string_view(recv_buf.data(), 13), "Hello, World!");
+}
+
+TEST_F(SocketDialogHelperTest, WriteQueueErrorTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]).with_write_queue();
+  {
+    auto recv_dialog = triggers.emplace(pair[1]);
+  }
+
+  std::string_view message = "Hello, World!";
+  auto send0 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = message}, 0));
+  auto send1 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = message}, 0));
+  while (triggers.wait_for(0));
+
+  EXPECT_THROW(stdexec::sync_wait(std::move(send0)), std::system_error);
+  EXPECT_THROW(stdexec::sync_wait(std::move(send1)), std::system_error);
+  EXPECT_EQ(send_dialog.writes->syscalls(), 1);
+}
+
+/** @brief A receiver with a stop token. */
+struct stoppable_receiver {
+  using receiver_concept = stdexec::receiver_t;
+
+  struct env {
+    stdexec::inplace_stop_token token;
+    auto query(stdexec::get_stop_token_t) const noexcept
+        -> stdexec::inplace_stop_token
+    {
+      return token;
+    }
+  };
+
+  template <typename... Args> auto set_value(Args &&...) && noexcept -> void
+  {
+    *result = 1;
+  }
+  auto set_stopped() && noexcept -> void { *result = 2; }
+  auto set_error(std::error_code) && noexcept -> void { *result = 3; }
+  auto get_env() const noexcept -> env { return {source->get_token()}; }
+
+  stdexec::inplace_stop_source *source;
+  int *result;
+};
+
+TEST_F(SocketDialogHelperTest, WriteQueueStopTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]).with_write_queue();
+  auto recv_dialog = triggers.emplace(pair[1]);
+
+  std::string_view first = "Hello, ";
+  std::string_view second = "World!";
+  stdexec::inplace_stop_source source;
+  int result = 0;
+  auto op = stdexec::connect(
+      ::io::sendmsg(send_dialog, socket_message<>{.buffers = first}, 0),
+      stoppable_receiver{&source, &result});
+  stdexec::start(op);
+  auto send1 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = second}, 0));
+
+  // The stopped send is taken off the queue before it is sent.
+  source.request_stop();
+  EXPECT_EQ(result, 2);
+  while (triggers.wait_for(0));
+
+  auto [len1] = stdexec::sync_wait(std::move(send1)).value();
+  EXPECT_EQ(len1, second.size());
+  EXPECT_EQ(send_dialog.writes->syscalls(), 1);
+
+  std::array<char, 14> recv_buf{};
+  ASSERT_EQ(::recv(pair[1], recv_buf.data(), recv_buf.size(), 0),
+            static_cast<ssize_t>(second.size()));
+  EXPECT_EQ(std::string_view(recv_buf.data(), second.size()), second);
+}
+
+TEST_F(SocketDialogHelperTest, WriteQueueLazyTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]).with_write_queue();
+  auto recv_dialog = triggers.emplace(pair[1]);
+
+  std::string_view first = "Hello, ";
+  std::string_view second = "World!";
+  // A send that is never started is never queued.
+  auto send0 =
+      ::io::sendmsg(send_dialog, socket_message<>{.buffers = first}, 0);
+  auto send1 = scope.spawn_future(::io::sendmsg(
+      send_dialog, socket_message<>{.buffers = second}, 0));
+  while (triggers.wait_for(0));
+
+  auto [len1] = stdexec::sync_wait(std::move(send1)).value();
+  EXPECT_EQ(len1, second.size());
+
+  std::array<char, 14> recv_buf{};
+  ASSERT_EQ(::recv(pair[1], recv_buf.data(), recv_buf.size(), 0),
+            static_cast<ssize_t>(second.size()));
+  EXPECT_EQ(std::string_view(recv_buf.data(), second.size()), second);
+}
+
+TEST_F(SocketDialogHelperTest, SendfileTest)
+{
+  std::string_view contents = "Hello, World!";
+  std::FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file),
+            contents.size());
+  ASSERT_EQ(std::fflush(file), 0);
+  int fd = ::fileno(file);
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_socket = socket_handle(pair[0]);
+  auto recv_socket = socket_handle(pair[1]);
+
+  EXPECT_EQ(::io::sendfile(send_socket, fd, 7, 5), 5);
+  // The pipe fallback sends the same bytes.
+  EXPECT_EQ(splice_file(pair[0], fd, 12, 1), 1);
+  // Both stop at the end of the file.
+  EXPECT_EQ(::io::sendfile(send_socket, fd, 13, 5), 0);
+  EXPECT_EQ(splice_file(pair[0], fd, 13, 5), 0);
+
+  std::array<char, 6> recv_buf{};
+  ASSERT_EQ(::recv(pair[1], recv_buf.data(), recv_buf.size(), 0), 6);
+  EXPECT_EQ(std::string_view(recv_buf.data(), 6), "World!");
+
+  EXPECT_EQ(::io::sendfile(send_socket, -1, 0, 5), -1);
+  EXPECT_EQ(errno, EBADF);
+
+  std::fclose(file);
+}
+
+template <typename Mux> class SendfileMuxTest : public ::testing::Test {};
+
+using Multiplexers = ::testing::Types<
+    poll_multiplexer, epoll_multiplexer, io_uring_multiplexer,
+    basic_poll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_epoll_multiplexer<std::allocator<char>, null_mutex>,
+    basic_io_uring_multiplexer<std::allocator<char>, null_mutex>>;
+TYPED_TEST_SUITE(SendfileMuxTest, Multiplexers);
+
+TYPED_TEST(SendfileMuxTest, PartialSendTest)
+{
+  using async_scope = exec::async_scope;
+
+  async_scope scope;
+  basic_triggers<TypeParam> triggers;
+  // Larger than the socket buffers, so the transfer would block part way and
+  // must wait for the socket to become writable again.
+  std::vector<char> contents(1 << 21);
+  for (std::size_t i = 0; i < contents.size(); ++i)
+    contents[i] = static_cast<char>(i * 31);
+
+  std::FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file),
+            contents.size());
+  ASSERT_EQ(std::fflush(file), 0);
+  int fd = ::fileno(file);
+
+  std::array<native_socket_type, 2> pair{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+  auto send_dialog = triggers.emplace(pair[0]);
+  auto recv_dialog = triggers.emplace(pair[1]);
+
+  auto future = scope.spawn_future(
+      ::io::sendfile(send_dialog, fd, 0, contents.size()));
+
+  std::vector<char> received;
+  std::array<char, 65536> buf{};
+  for (int i = 0; i < 100000 && received.size() < contents.size(); ++i)
+  {
+    triggers.wait_for(0);
+    auto len = ::recv(pair[1], buf.data(), buf.size(), MSG_DONTWAIT);
+    if (len > 0)
+      received.insert(received.end(), buf.begin(), buf.begin() + len);
+  }
+  while (triggers.wait_for(0));
+
+  auto [sent] = stdexec::sync_wait(std::move(future)).value();
+  EXPECT_EQ(sent, contents.size());
+  ASSERT_EQ(received.size(), contents.size());
+  EXPECT_TRUE(std::equal(received.begin(), received.end(), contents.begin()));
+
+  std::fclose(file);
+}
+
 class SocketDialogComparisonTest : public ::testing::Test {
 protected:
   void SetUp() override
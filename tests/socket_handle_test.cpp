@@ -479,6 +479,46 @@ TEST_F(SocketHandleTest, ErrorHandlingThreadSafety)
   EXPECT_EQ(final_error.category(), std::system_category());
 }
 
+TEST_F(SocketHandleTest, EagerPredictorColdAndProbe)
+{
+  using detail::eager_predictor;
+  socket_handle handle(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  auto &predictor = handle.read_predictor();
+
+  // A new socket starts hot and cools down after a run of misses.
+  for (int i = 0; i < eager_predictor::max_score; ++i)
+  {
+    EXPECT_TRUE(predictor.is_hot());
+    EXPECT_TRUE(predictor.should_try());
+    predictor.miss();
+  }
+  EXPECT_FALSE(predictor.is_hot());
+
+  // A cold socket only probes once every probe_interval operations.
+  for (int i = 1; i < eager_predictor::probe_interval; ++i)
+    EXPECT_FALSE(predictor.should_try());
+  EXPECT_TRUE(predictor.should_try());
+
+  // A successful probe warms the socket up again.
+  predictor.hit();
+  EXPECT_TRUE(predictor.is_hot());
+  EXPECT_TRUE(predictor.should_try());
+
+  // Reads and writes are predicted separately.
+  EXPECT_TRUE(handle.write_predictor().is_hot());
+}
+
+TEST_F(SocketHandleTest, EagerPredictorMovesWithHandle)
+{
+  socket_handle handle(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  for (int i = 0; i < detail::eager_predictor::max_score; ++i)
+    handle.write_predictor().miss();
+
+  socket_handle moved(std::move(handle));
+  EXPECT_FALSE(moved.write_predictor().is_hot());
+  EXPECT_TRUE(moved.read_predictor().is_hot());
+}
+
 class SocketHandleRAIITest : public ::testing::Test {
 protected:
   int create_and_get_socket()
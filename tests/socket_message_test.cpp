@@ -91,6 +91,134 @@ TEST_F(SocketMessageTest, CompoundAdditionTest)
   EXPECT_FALSE(buffers);
 }
 
+TEST_F(SocketMessageTest, ConsumeCursorTest)
+{
+  std::vector<char> buf1(100);
+  std::vector<char> buf2(200);
+  std::vector<char> buf3(300);
+  message_buffer<> buffers{buf1, buf2, buf3};
+  EXPECT_EQ(buffers.bytes(), 600);
+
+  buffers += 150;
+  EXPECT_EQ(buffers.size(), 2);
+  EXPECT_EQ(buffers.bytes(), 450);
+  EXPECT_EQ((*buffers.begin()).size(), 150);
+  EXPECT_EQ((*buffers.begin()).data(),
+            reinterpret_cast<std::byte *>(buf2.data() + 50));
+
+  auto native = buffers.native();
+  ASSERT_EQ(native.size(), 2);
+  EXPECT_EQ(native[0].iov_len, 150);
+  EXPECT_EQ(native[1].iov_base, buf3.data());
+
+  // Buffers can be appended after a partial write.
+  buffers.push_back(buf1);
+  EXPECT_EQ(buffers.size(), 3);
+  EXPECT_EQ(buffers.bytes(), 550);
+  EXPECT_EQ(buffers.end() - buffers.begin(), 3);
+
+  buffers += 450;
+  EXPECT_EQ(buffers.size(), 1);
+  EXPECT_EQ(buffers.bytes(), 100);
+
+  // The storage is reused once every buffer is consumed.
+  buffers += 100;
+  EXPECT_EQ(buffers.size(), 0);
+  EXPECT_TRUE(buffers.native().empty());
+  buffers.push_back(buf2);
+  EXPECT_EQ(buffers.native().front().iov_base, buf2.data());
+
+  buffers.clear();
+  EXPECT_EQ(buffers.size(), 0);
+  EXPECT_EQ(buffers.bytes(), 0);
+  EXPECT_TRUE(buffers.empty());
+
+  // The header of a message only points at the remaining buffers.
+  socket_message message;
+  message.buffers.push_back(buf1);
+  message.buffers.push_back(buf2);
+  message.buffers += 100;
+  auto header = static_cast<socket_message_type>(message);
+  EXPECT_EQ(header.msg_iovlen, 1);
+  EXPECT_EQ(header.msg_iov[0].iov_base, buf2.data());
+}
+
+template <typename T> struct counting_allocator {
+  using value_type = T;
+  static inline std::size_t allocations = 0;
+
+  counting_allocator() = default;
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &) noexcept
+  {}
+
+  auto allocate(std::size_t n) -> T *
+  {
+    ++allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+  auto deallocate(T *ptr, std::size_t n) noexcept -> void
+  {
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+  auto operator==(const counting_allocator &) const -> bool = default;
+};
+
+TEST_F(SocketMessageTest, InlineStorageTest)
+{
+  using allocator = counting_allocator<native_buffer_type>;
+  std::array<std::vector<char>, 6> bufs;
+  for (std::size_t i = 0; i < bufs.size(); ++i)
+    bufs[i].resize(10 * (i + 1));
+
+  allocator::allocations = 0;
+  message_buffer<allocator, 4> buffers;
+  for (std::size_t i = 0; i < 4; ++i)
+    buffers.push_back(bufs[i]);
+  EXPECT_EQ(allocator::allocations, 0);
+  EXPECT_EQ(buffers.size(), 4);
+  EXPECT_EQ(buffers.bytes(), 100);
+
+  // The fifth buffer spills every buffer to the allocator.
+  buffers.push_back(bufs[4]);
+  buffers.push_back(bufs[5]);
+  EXPECT_EQ(allocator::allocations, 1);
+  ASSERT_EQ(buffers.size(), 6);
+  EXPECT_EQ(buffers.bytes(), 210);
+  auto native = buffers.native();
+  for (std::size_t i = 0; i < bufs.size(); ++i)
+  {
+    EXPECT_EQ(native[i].iov_base, bufs[i].data());
+    EXPECT_EQ(native[i].iov_len, bufs[i].size());
+  }
+
+  buffers += 25;
+  auto copy = buffers;
+  EXPECT_EQ(copy.size(), 5);
+  EXPECT_EQ(copy.bytes(), 185);
+  EXPECT_EQ((*copy.begin()).size(), 5);
+
+  auto moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 5);
+  EXPECT_EQ(moved.bytes(), 185);
+  EXPECT_EQ(copy.size(), 0);
+  EXPECT_TRUE(copy.native().empty());
+
+  // Clearing goes back to the inline storage.
+  allocator::allocations = 0;
+  buffers.clear();
+  buffers.push_back(bufs[0]);
+  EXPECT_EQ(allocator::allocations, 0);
+  EXPECT_EQ(buffers.native().front().iov_base, bufs[0].data());
+
+  // Small messages don't allocate after a move either.
+  message_buffer<allocator, 4> small{bufs[0], bufs[1]};
+  auto small_moved = std::move(small);
+  EXPECT_EQ(allocator::allocations, 0);
+  EXPECT_EQ(small_moved.bytes(), 30);
+  EXPECT_EQ(small_moved.native()[1].iov_base, bufs[1].data());
+}
+
 TEST_F(SocketMessageTest, IteratorEmptyBuffer)
 {
   message_buffer<> buffers;
@@ -0,0 +1,140 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace io::socket;
+using namespace io::execution;
+
+class StreamReaderTest : public ::testing::Test {
+protected:
+  using reader_type = stream_reader<poll_multiplexer>;
+
+  void SetUp() override
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    dialog = triggers.emplace(pair[0]);
+  }
+
+  void TearDown() override { ::close(pair[1]); }
+
+  auto read(reader_type &reader) -> std::streamsize
+  {
+    auto future = scope.spawn_future(reader.read());
+    while (triggers.wait_for(0));
+    auto [len] = stdexec::sync_wait(std::move(future)).value();
+    return len;
+  }
+
+  static auto to_string(reader_type &reader) -> std::string
+  {
+    std::string str;
+    for (auto span : reader.data())
+      str.append(reinterpret_cast<const char *>(span.data()), span.size());
+    return str;
+  }
+
+  exec::async_scope scope;
+  basic_triggers<poll_multiplexer> triggers;
+  std::array<int, 2> pair{};
+  socket_dialog<poll_multiplexer> dialog;
+};
+
+TEST_F(StreamReaderTest, ConstructionTest)
+{
+  reader_type reader{dialog, 10};
+  EXPECT_EQ(reader.capacity(), 16);
+  EXPECT_EQ(reader.size(), 0);
+  EXPECT_TRUE(reader.empty());
+  EXPECT_FALSE(reader.full());
+  EXPECT_EQ(reader.dialog(), dialog);
+
+  reader_type small{dialog, 0};
+  EXPECT_EQ(small.capacity(), 1);
+
+  reader_type defaulted{dialog};
+  EXPECT_EQ(defaulted.capacity(), reader_type::default_capacity);
+}
+
+TEST_F(StreamReaderTest, ReadConsumeTest)
+{
+  reader_type reader{dialog, 16};
+
+  ASSERT_EQ(::write(pair[1], "hello, world", 12), 12);
+  EXPECT_EQ(read(reader), 12);
+  EXPECT_EQ(reader.size(), 12);
+  EXPECT_EQ(to_string(reader), "hello, world");
+  EXPECT_TRUE(reader.data()[1].empty());
+
+  reader.consume(7);
+  EXPECT_EQ(to_string(reader), "world");
+
+  reader.consume(100);
+  EXPECT_TRUE(reader.empty());
+}
+
+TEST_F(StreamReaderTest, WraparoundTest)
+{
+  reader_type reader{dialog, 16};
+
+  ASSERT_EQ(::write(pair[1], "0123456789ab", 12), 12);
+  ASSERT_EQ(read(reader), 12);
+  reader.consume(10);
+
+  // The free space wraps around, so one read fills both of its parts.
+  ASSERT_EQ(::write(pair[1], "cdefghijklmn", 12), 12);
+  EXPECT_EQ(read(reader), 12);
+  EXPECT_EQ(reader.size(), 14);
+  EXPECT_FALSE(reader.full());
+
+  auto buffers = reader.data();
+  EXPECT_EQ(buffers[0].size(), 6);
+  EXPECT_EQ(buffers[1].size(), 8);
+  EXPECT_EQ(to_string(reader), "abcdefghijklmn");
+
+  auto message = message_buffer<>{buffers[0], buffers[1]};
+  EXPECT_EQ(message.size(), 2);
+
+  ASSERT_EQ(::write(pair[1], "opqr", 4), 4);
+  EXPECT_EQ(read(reader), 2);
+  EXPECT_TRUE(reader.full());
+  EXPECT_THROW(reader.read(), std::system_error);
+
+  reader.consume(14);
+  EXPECT_EQ(read(reader), 2);
+  EXPECT_EQ(to_string(reader), "opqr");
+}
+
+TEST_F(StreamReaderTest, EndOfStreamTest)
+{
+  reader_type reader{dialog, 16};
+
+  ::shutdown(pair[1], SHUT_WR);
+  EXPECT_EQ(read(reader), 0);
+  EXPECT_TRUE(reader.empty());
+}
+// NOLINTEND
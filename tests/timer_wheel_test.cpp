@@ -0,0 +1,147 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/execution/detail/timer_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace io::execution::detail;
+using namespace std::chrono_literals;
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+  using time_point = timer_wheel::time_point;
+
+  auto advance(std::chrono::milliseconds elapsed) -> std::vector<timer_node *>
+  {
+    std::vector<timer_node *> expired;
+    wheel.advance(epoch + elapsed,
+                  [&](timer_node *node) { expired.push_back(node); });
+    return expired;
+  }
+
+  time_point epoch = timer_wheel::clock::now();
+  timer_wheel wheel{epoch};
+};
+
+TEST_F(TimerWheelTest, EmptyTest)
+{
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.next_expiry());
+  EXPECT_TRUE(advance(1h).empty());
+}
+
+TEST_F(TimerWheelTest, ExpiryTest)
+{
+  // One deadline on each level and one beyond the range of the wheel.
+  std::vector<std::chrono::milliseconds> deadlines{
+      5ms, 300ms, 70s, 5h, std::chrono::hours(24 * 60)};
+  std::vector<timer_node> nodes(deadlines.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+    wheel.insert(&nodes[i], epoch + deadlines[i]);
+  EXPECT_EQ(wheel.size(), nodes.size());
+
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    ASSERT_TRUE(wheel.next_expiry());
+    EXPECT_LE(*wheel.next_expiry(), epoch + deadlines[i]);
+
+    EXPECT_TRUE(advance(deadlines[i] - 1ms).empty());
+    EXPECT_TRUE(nodes[i].is_linked());
+
+    auto expired = advance(deadlines[i]);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.front(), &nodes[i]);
+    EXPECT_FALSE(nodes[i].is_linked());
+  }
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, EraseTest)
+{
+  timer_node first;
+  timer_node second;
+  wheel.insert(&first, epoch + 10ms);
+  wheel.insert(&second, epoch + 10ms);
+
+  wheel.erase(&first);
+  EXPECT_FALSE(first.is_linked());
+  EXPECT_EQ(wheel.size(), 1);
+
+  auto expired = advance(10ms);
+  ASSERT_EQ(expired.size(), 1);
+  EXPECT_EQ(expired.front(), &second);
+
+  wheel.insert(&first, epoch + 20ms);
+  wheel.erase(&first);
+  EXPECT_FALSE(wheel.next_expiry());
+  EXPECT_TRUE(advance(1h).empty());
+}
+
+TEST_F(TimerWheelTest, PastDeadlineTest)
+{
+  timer_node node;
+  EXPECT_TRUE(advance(100ms).empty());
+
+  wheel.insert(&node, epoch);
+  auto expired = advance(101ms);
+  ASSERT_EQ(expired.size(), 1);
+  EXPECT_EQ(expired.front(), &node);
+}
+
+TEST_F(TimerWheelTest, MillionTimersTest)
+{
+  static constexpr std::size_t count = 1'000'000;
+  static constexpr std::int64_t range = 600'000;
+
+  std::mt19937_64 engine{42};
+  std::uniform_int_distribution<std::int64_t> dist{1, range};
+  std::vector<timer_node> nodes(count);
+  std::vector<std::int64_t> deadlines(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    deadlines[i] = dist(engine);
+    wheel.insert(&nodes[i], epoch + std::chrono::milliseconds(deadlines[i]));
+  }
+
+  // Cancel every other timer, like idle timeouts that are reset.
+  for (std::size_t i = 0; i < count; i += 2)
+    wheel.erase(&nodes[i]);
+  EXPECT_EQ(wheel.size(), count / 2);
+
+  std::size_t expired = 0;
+  bool late = false;
+  for (std::int64_t now = 0; now <= range; now += 997)
+  {
+    wheel.advance(epoch + std::chrono::milliseconds(now),
+                  [&](timer_node *node) {
+                    auto i = static_cast<std::size_t>(node - nodes.data());
+                    late |= deadlines[i] > now || deadlines[i] <= now - 997;
+                    ++expired;
+                  });
+  }
+  wheel.advance(epoch + std::chrono::milliseconds(range),
+                [&](timer_node *) { ++expired; });
+
+  EXPECT_EQ(expired, count / 2);
+  EXPECT_FALSE(late);
+  EXPECT_TRUE(wheel.empty());
+}
+// NOLINTEND
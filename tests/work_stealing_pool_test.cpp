@@ -0,0 +1,241 @@
+/* Copyright 2025 Kevin Exton
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// NOLINTBEGIN
+#include "io/io.hpp"
+
+#include <exec/async_scope.hpp>
+#include <gtest/gtest.h>
+#include <stdexec/execution.hpp>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace io::execution;
+
+TEST(WorkStealingDequeTest, PushPopStealTest)
+{
+  detail::work_stealing_deque<int> deque;
+  std::array<int, 3> values{1, 2, 3};
+
+  deque.reset(values.size());
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_EQ(deque.steal(), nullptr);
+
+  for (auto &value : values)
+    deque.push(&value);
+
+  // The owner pops LIFO while thieves steal FIFO.
+  EXPECT_EQ(deque.pop(), &values[2]);
+  EXPECT_EQ(deque.steal(), &values[0]);
+  EXPECT_EQ(deque.pop(), &values[1]);
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_EQ(deque.steal(), nullptr);
+
+  deque.reset(1);
+  EXPECT_EQ(deque.capacity(), 3);
+  deque.push(&values[0]);
+  EXPECT_EQ(deque.steal(), &values[0]);
+}
+
+TEST(WorkStealingDequeTest, ConcurrentStealTest)
+{
+  static constexpr int size = 10000;
+  static constexpr int thieves = 3;
+
+  detail::work_stealing_deque<int> deque;
+  std::vector<int> values(size);
+  std::vector<std::atomic<int>> taken(size);
+  deque.reset(size);
+  for (auto &value : values)
+    deque.push(&value);
+
+  std::atomic<int> count = 0;
+  auto take = [&](int *value) {
+    ++taken[value - values.data()];
+    ++count;
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thieves; ++i)
+  {
+    threads.emplace_back([&] {
+      while (count < size)
+      {
+        if (auto *value = deque.steal())
+          take(value);
+      }
+    });
+  }
+  while (count < size)
+  {
+    if (auto *value = deque.pop())
+      take(value);
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (auto &value : taken)
+    EXPECT_EQ(value, 1);
+}
+
+template <typename Mux> class WorkStealingPoolTest : public ::testing::Test {
+protected:
+  basic_triggers<Mux> triggers;
+};
+
+using Multiplexers =
+    ::testing::Types<poll_multiplexer, epoll_multiplexer, io_uring_multiplexer>;
+TYPED_TEST_SUITE(WorkStealingPoolTest, Multiplexers);
+
+TYPED_TEST(WorkStealingPoolTest, SizeTest)
+{
+  work_stealing_pool<TypeParam> pool{this->triggers, 3};
+  EXPECT_EQ(pool.size(), 3);
+
+  work_stealing_pool<TypeParam> single{this->triggers, 0};
+  EXPECT_EQ(single.size(), 1);
+  EXPECT_EQ(single.wait_for(0), 0);
+}
+
+TYPED_TEST(WorkStealingPoolTest, OrderTest)
+{
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+  static constexpr int pairs = 16;
+  static constexpr int reads = 4;
+
+  async_scope scope;
+  std::vector<std::array<int, 2>> sockets(pairs);
+  std::vector<std::shared_ptr<socket_handle>> handles;
+  for (auto &pair : sockets)
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    handles.push_back(std::make_shared<socket_handle>(pair[0]));
+  }
+
+  std::array<std::array<int, reads>, pairs> order{};
+  std::array<std::atomic<int>, pairs> counts{};
+  std::array<std::atomic<int>, pairs> busy{};
+  std::atomic<bool> overlapped = false;
+  std::atomic<int> done = 0;
+  for (int i = 0; i < pairs; ++i)
+  {
+    for (int j = 0; j < reads; ++j)
+    {
+      auto fd = sockets[i][0];
+      scope.spawn(triggers.set(handles[i], trigger::READ,
+                               [fd]() -> std::optional<int> {
+                                 char byte = 0;
+                                 auto len = ::recv(fd, &byte, 1, MSG_DONTWAIT);
+                                 if (len < 0 && errno == EAGAIN)
+                                   return std::nullopt;
+                                 return byte;
+                               }) |
+                  stdexec::then([&, i](int byte) {
+                    if (busy[i]++)
+                      overlapped = true;
+                    order[i][counts[i]++] = byte;
+                    std::this_thread::yield();
+                    --busy[i];
+                    ++done;
+                  }) |
+                  stdexec::upon_error([](auto) {}));
+    }
+  }
+
+  work_stealing_pool<TypeParam> pool{triggers, 4};
+  // Submit the reads before any data arrives.
+  pool.wait_for(0);
+  for (auto &pair : sockets)
+    ASSERT_EQ(::write(pair[1], "abcd", reads), reads);
+
+  for (int n = 0; n < 100 && done < pairs * reads; ++n)
+    pool.wait_for(10);
+
+  EXPECT_EQ(done, pairs * reads);
+  EXPECT_FALSE(overlapped);
+  for (auto &bytes : order)
+    EXPECT_EQ(bytes, (std::array<int, reads>{'a', 'b', 'c', 'd'}));
+}
+
+TYPED_TEST(WorkStealingPoolTest, IdleWorkersSleepTest)
+{
+  using namespace std::chrono;
+  auto &triggers = this->triggers;
+  using trigger = execution_trigger;
+  using socket_handle = ::io::socket::socket_handle;
+  using async_scope = exec::async_scope;
+  static constexpr int pairs = 2;
+  static constexpr auto busy = milliseconds(200);
+
+  async_scope scope;
+  std::vector<std::array<int, 2>> sockets(pairs);
+  std::vector<std::shared_ptr<socket_handle>> handles;
+  for (auto &pair : sockets)
+  {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    handles.push_back(std::make_shared<socket_handle>(pair[0]));
+  }
+
+  std::atomic<int> done = 0;
+  for (int i = 0; i < pairs; ++i)
+  {
+    auto fd = sockets[i][0];
+    scope.spawn(triggers.set(handles[i], trigger::READ,
+                             [fd]() -> std::optional<int> {
+                               char byte = 0;
+                               auto len = ::recv(fd, &byte, 1, MSG_DONTWAIT);
+                               if (len < 0 && errno == EAGAIN)
+                                 return std::nullopt;
+                               return byte;
+                             }) |
+                stdexec::then([&, i](int) {
+                  // One long batch; the other workers have nothing to do.
+                  if (i == 0)
+                    std::this_thread::sleep_for(busy);
+                  ++done;
+                }) |
+                stdexec::upon_error([](auto) {}));
+  }
+
+  work_stealing_pool<TypeParam> pool{triggers, 4};
+  pool.wait_for(0);
+  for (auto &pair : sockets)
+    ASSERT_EQ(::write(pair[1], "a", 1), 1);
+
+  auto cpu_time = [] {
+    timespec now{};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return seconds(now.tv_sec) + nanoseconds(now.tv_nsec);
+  };
+  auto start = cpu_time();
+  for (int n = 0; n < 100 && done < pairs; ++n)
+    pool.wait_for(10);
+  auto used = cpu_time() - start;
+
+  EXPECT_EQ(done, pairs);
+  // Spinning workers would use about one busy period of CPU each.
+  EXPECT_LT(used, busy / 2);
+}
+// NOLINTEND